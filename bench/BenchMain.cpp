@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/Logging.h>
+#include <Utilities/SIMD.h>
+
+#include <revision_data.h>
+
+#if defined(PN_SIMD_AVX2)
+constexpr const char* SIMD_ARCH = "AVX2";
+#elif defined(PN_SIMD_SSE41)
+constexpr const char* SIMD_ARCH = "SSE41";
+#else
+constexpr const char* SIMD_ARCH = "NONE";
+#endif
+
+// benchmark_main plus the revision the suite was built from, so JSON results from different
+// builds can be told apart when they are compared
+int main(int argc, char** argv) {
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+	pn::InitLogger();
+
+	benchmark::AddCustomContext("revision", _HASH);
+	benchmark::AddCustomContext("revision_date", _DATE);
+	benchmark::AddCustomContext("branch", _BRANCH);
+	benchmark::AddCustomContext("compiler", COMPILER_ID " " COMPILER_VERSION);
+	benchmark::AddCustomContext("cxx_flags", COMPILER_CXX_FLAGS);
+	benchmark::AddCustomContext("simd", SIMD_ARCH);
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
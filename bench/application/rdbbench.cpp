@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <Application/ResourceDatabase.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace pn;
+
+namespace ApplicationBenchmark {
+	pn::vector<rdb::mesh_resource_id_t> AddMeshes(const size_t n) {
+		pn::vector<rdb::mesh_resource_id_t> ids;
+		for (size_t i = 0; i < n; ++i) {
+			mesh_buffer_t mesh{};
+			mesh.name = "bench_mesh_" + std::to_string(i);
+			mesh.index_count = static_cast<unsigned int>(i);
+			PushBack(ids, rdb::AddMeshResource(std::move(mesh)));
+		}
+		rdb::CommitChanges();
+		return ids;
+	}
+
+	void RemoveMeshes(const pn::vector<rdb::mesh_resource_id_t>& ids) {
+		for (const auto id : ids) {
+			rdb::RemoveMeshResource(id);
+		}
+		rdb::CommitChanges();
+	}
+
+	// Random order so the lookups don't just stream through the slot table
+	pn::vector<rdb::mesh_resource_id_t> Shuffled(pn::vector<rdb::mesh_resource_id_t> ids) {
+		std::shuffle(ids.begin(), ids.end(), std::mt19937(6));
+		return ids;
+	}
+
+	void BM_GetMeshResourceById(benchmark::State& state) {
+		const auto ids = AddMeshes(state.range(0));
+		const auto order = Shuffled(ids);
+		for (auto _ : state) {
+			unsigned int total = 0;
+			for (const auto id : order) {
+				total += rdb::GetMeshResource(id).index_count;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		RemoveMeshes(ids);
+	}
+	BENCHMARK(BM_GetMeshResourceById)->Arg(64)->Arg(4096);
+
+	void BM_GetMeshResourceByName(benchmark::State& state) {
+		const auto ids = AddMeshes(state.range(0));
+		pn::vector<string> names;
+		for (const auto id : Shuffled(ids)) {
+			PushBack(names, rdb::GetMeshResource(id).name);
+		}
+		for (auto _ : state) {
+			unsigned int total = 0;
+			for (const auto& name : names) {
+				total += rdb::GetMeshResource(name).index_count;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		RemoveMeshes(ids);
+	}
+	BENCHMARK(BM_GetMeshResourceByName)->Arg(64)->Arg(4096);
+
+	// Names hashed ahead of time, as with literals, leaving only the index lookup
+	void BM_GetMeshResourceByStringId(benchmark::State& state) {
+		const auto ids = AddMeshes(state.range(0));
+		pn::vector<string_id_t> names;
+		for (const auto id : Shuffled(ids)) {
+			PushBack(names, string_id_t(rdb::GetMeshResource(id).name));
+		}
+		for (auto _ : state) {
+			unsigned int total = 0;
+			for (const auto name : names) {
+				total += rdb::GetMeshResource(name).index_count;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		RemoveMeshes(ids);
+	}
+	BENCHMARK(BM_GetMeshResourceByStringId)->Arg(64)->Arg(4096);
+
+	// Cost of publishing a frame's worth of new meshes on top of an existing database
+	void BM_CommitMeshes(benchmark::State& state) {
+		const auto existing = AddMeshes(4096);
+		for (auto _ : state) {
+			const auto ids = AddMeshes(state.range(0));
+			state.PauseTiming();
+			RemoveMeshes(ids);
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		RemoveMeshes(existing);
+	}
+	BENCHMARK(BM_CommitMeshes)->Arg(16)->Arg(256);
+}
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <Graphics/CookedMesh.h>
+#include <Graphics/MeshCook.h>
+#include <IO/FileUtil.h>
+
+// everything here starts from an Assimp import
+#if !defined(PN_NO_ASSIMP)
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+using namespace pn;
+
+namespace GraphicsBenchmark {
+	const string MESH_DIR = string(PN_BENCH_RESOURCE_DIR) + "mesh/";
+
+	// Arg indexes into this list
+	const pn::vector<string> MESH_FILES = { "cube_family.fbx", "monkey.fbx", "round_sphere.fbx", "torus.fbx" };
+
+	bytes ReadMeshFile(benchmark::State& state) {
+		const auto& file = MESH_FILES[state.range(0)];
+		state.SetLabel(file);
+		return ReadFile(MESH_DIR + file);
+	}
+
+	// Assimp parse plus conversion, what a load pays without a cooked file
+	void BM_ImportMeshSource(benchmark::State& state) {
+		const auto file_data = ReadMeshFile(state);
+		for (auto _ : state) {
+			cooked_mesh_source_t source;
+			if (!ImportMeshSource(file_data, DEFAULT_MESH_LOAD_DATA, source)) {
+				state.SkipWithError("Import failed");
+				break;
+			}
+			benchmark::DoNotOptimize(source.meshes.data());
+		}
+		state.SetBytesProcessed(state.iterations() * Size(file_data));
+	}
+	BENCHMARK(BM_ImportMeshSource)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+	// Only the copy out of the Assimp scene
+	void BM_ConvertAIMesh(benchmark::State& state) {
+		const auto file_data = ReadMeshFile(state);
+		Assimp::Importer importer;
+		const auto* scene = importer.ReadFileFromMemory(file_data.data(), Size(file_data), MeshLoadDataToAssimp(DEFAULT_MESH_LOAD_DATA));
+		if (scene == nullptr) {
+			state.SkipWithError("Import failed");
+			return;
+		}
+
+		size_t vertices = 0;
+		for (auto _ : state) {
+			for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+				cooked_submesh_source_t mesh;
+				ConvertAIMesh(scene->mMeshes[i], mesh);
+				vertices += Size(mesh.vertices);
+			}
+		}
+		state.SetItemsProcessed(vertices);
+	}
+	BENCHMARK(BM_ConvertAIMesh)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+
+	// Writing and validating the cooked file, both sides of the cache
+	void BM_CookedMeshRoundTrip(benchmark::State& state) {
+		cooked_mesh_source_t source;
+		if (!ImportMeshSource(ReadMeshFile(state), DEFAULT_MESH_LOAD_DATA, source)) {
+			state.SkipWithError("Import failed");
+			return;
+		}
+
+		size_t bytes_written = 0;
+		for (auto _ : state) {
+			const auto cooked = WriteCookedMesh(source);
+			cooked_mesh_view_t view;
+			benchmark::DoNotOptimize(OpenCookedMesh(cooked.data(), Size(cooked), view));
+			bytes_written += Size(cooked);
+		}
+		state.SetBytesProcessed(bytes_written);
+	}
+	BENCHMARK(BM_CookedMeshRoundTrip)->DenseRange(0, 3)->Unit(benchmark::kMicrosecond);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <System/Jobs.h>
+
+#include <atomic>
+#include <cmath>
+
+using namespace pn;
+
+namespace JobsBenchmark {
+	// Enough arithmetic per element that the work, not memory bandwidth, dominates
+	float Work(const size_t i) {
+		float x = static_cast<float>(i);
+		for (int k = 0; k < 32; ++k) {
+			x = sqrtf(x * 1.0001f + 1.0f);
+		}
+		return x;
+	}
+
+	// Same workload over 1..N threads, items_per_second shows the scaling
+	void BM_ParallelForScaling(benchmark::State& state) {
+		jobs::Init(static_cast<unsigned>(state.range(0)) - 1);
+		pn::vector<float> out(1 << 18);
+		for (auto _ : state) {
+			jobs::ParallelFor(0, out.size(), 1024, [&](size_t b, size_t e) {
+				for (size_t i = b; i < e; ++i) out[i] = Work(i);
+			});
+			benchmark::ClobberMemory();
+		}
+		jobs::Shutdown();
+		state.SetItemsProcessed(state.iterations() * out.size());
+	}
+	BENCHMARK(BM_ParallelForScaling)->DenseRange(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+	// Overhead of scheduling and running an empty job
+	void BM_JobOverhead(benchmark::State& state) {
+		jobs::Init(static_cast<unsigned>(state.range(0)) - 1);
+		const int JOB_COUNT = 1024;
+		for (auto _ : state) {
+			jobs::counter_t counter;
+			for (int i = 0; i < JOB_COUNT; ++i) {
+				jobs::Run([] {}, &counter);
+			}
+			jobs::WaitForCounter(counter);
+		}
+		jobs::Shutdown();
+		state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+	}
+	BENCHMARK(BM_JobOverhead)->DenseRange(1, 4)->UseRealTime();
+}
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/MathBatch.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace MathBenchmark {
+	pn::vector<vec3f> RandomPoints(const size_t n) {
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+		pn::vector<vec3f> result(n);
+		for (auto& v : result) {
+			v = vec3f(dist(rng), dist(rng), dist(rng));
+		}
+		return result;
+	}
+
+	const mat4f BENCH_TRANSFORM = SRTMatrix(vec3f(1.0f, 2.0f, 0.5f), vec3f(0.3f, 1.2f, -0.4f), vec3f(5.0f, -3.0f, 7.0f));
+	const quaternion BENCH_ROTATION = EulerToQuaternion(vec3f(0.3f, 1.2f, -0.4f));
+
+	void BM_TransformPointsAoS(benchmark::State& state) {
+		auto points = RandomPoints(state.range(0));
+		for (auto _ : state) {
+			for (auto& p : points) {
+				p = (vec4f(p, 1.0f) * BENCH_TRANSFORM).xyz();
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_TransformPointsAoS)->Arg(1 << 10)->Arg(1 << 16);
+
+	void BM_TransformPointsSoA(benchmark::State& state) {
+		auto points = ToSoA(RandomPoints(state.range(0)));
+		for (auto _ : state) {
+			TransformPoints(BENCH_TRANSFORM, points);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_TransformPointsSoA)->Arg(1 << 10)->Arg(1 << 16);
+
+	void BM_RotatePointsAoS(benchmark::State& state) {
+		auto points = RandomPoints(state.range(0));
+		for (auto _ : state) {
+			for (auto& p : points) {
+				p = RotatePoint(p, BENCH_ROTATION);
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_RotatePointsAoS)->Arg(1 << 10)->Arg(1 << 16);
+
+	void BM_RotatePointsSoA(benchmark::State& state) {
+		auto points = ToSoA(RandomPoints(state.range(0)));
+		for (auto _ : state) {
+			RotatePoints(BENCH_ROTATION, points);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_RotatePointsSoA)->Arg(1 << 10)->Arg(1 << 16);
+
+	void BM_NormalizeVectorsSoA(benchmark::State& state) {
+		auto points = ToSoA(RandomPoints(state.range(0)));
+		for (auto _ : state) {
+			NormalizeVectors(points);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_NormalizeVectorsSoA)->Arg(1 << 10)->Arg(1 << 16);
+}
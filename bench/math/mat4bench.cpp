@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/Math.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace MathBenchmark {
+	mat4f RandomSRT(std::mt19937& rng) {
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> scale_dist(0.1f, 4.0f);
+		return SRTMatrix(
+			vec3f(scale_dist(rng), scale_dist(rng), scale_dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng))
+		);
+	}
+
+	// Same shape of work as UpdateModelConstantCBuffer: model * view * proj and an inverse transpose
+	template<mat4f (*MultiplyF)(const mat4f&, const mat4f&), mat4f (*InverseF)(const mat4f&), mat4f (*TransposeF)(const mat4f&)>
+	void BM_ModelConstants(benchmark::State& state) {
+		std::mt19937 rng(1);
+		const int N = 1024;
+		std::vector<mat4f> models;
+		for (int i = 0; i < N; ++i) models.push_back(RandomSRT(rng));
+		const mat4f view = RandomSRT(rng);
+		const mat4f proj = PerspectiveFov(Rad(60.0f), 1.3f, 0.01f, 1000.0f);
+
+		for (auto _ : state) {
+			for (const auto& model : models) {
+				mat4f model_view = MultiplyF(model, view);
+				mat4f mvit = TransposeF(InverseF(model_view));
+				mat4f mvp = MultiplyF(model_view, proj);
+				benchmark::DoNotOptimize(mvit);
+				benchmark::DoNotOptimize(mvp);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * N);
+	}
+	BENCHMARK_TEMPLATE(BM_ModelConstants, scalar::Multiply, scalar::Inverse, scalar::Transpose);
+	BENCHMARK_TEMPLATE(BM_ModelConstants, Multiply, Inverse, Transpose);
+
+	template<mat4f (*MultiplyF)(const mat4f&, const mat4f&)>
+	void BM_Mat4fMultiply(benchmark::State& state) {
+		std::mt19937 rng(2);
+		mat4f a = RandomSRT(rng);
+		const mat4f b = RandomSRT(rng);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(a = MultiplyF(a, b));
+		}
+	}
+	BENCHMARK_TEMPLATE(BM_Mat4fMultiply, scalar::Multiply);
+	BENCHMARK_TEMPLATE(BM_Mat4fMultiply, Multiply);
+
+	template<mat4f (*InverseF)(const mat4f&)>
+	void BM_Mat4fInverse(benchmark::State& state) {
+		std::mt19937 rng(3);
+		mat4f a = RandomSRT(rng);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(a = InverseF(a));
+		}
+	}
+	BENCHMARK_TEMPLATE(BM_Mat4fInverse, scalar::Inverse);
+	BENCHMARK_TEMPLATE(BM_Mat4fInverse, Inverse);
+
+	template<mat4f (*TransposeF)(const mat4f&)>
+	void BM_Mat4fTranspose(benchmark::State& state) {
+		std::mt19937 rng(4);
+		mat4f a = RandomSRT(rng);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(a = TransposeF(a));
+		}
+	}
+	BENCHMARK_TEMPLATE(BM_Mat4fTranspose, scalar::Transpose);
+	BENCHMARK_TEMPLATE(BM_Mat4fTranspose, Transpose);
+
+	void BM_QuaternionToRotationMatrix(benchmark::State& state) {
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+		std::vector<quaternion> rotations(1024);
+		for (auto& q : rotations) {
+			q = EulerToQuaternion(vec3f(dist(rng), dist(rng), dist(rng)));
+		}
+		for (auto _ : state) {
+			for (const auto& q : rotations) {
+				benchmark::DoNotOptimize(QuaternionToRotationMatrix(q));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * rotations.size());
+	}
+	BENCHMARK(BM_QuaternionToRotationMatrix);
+}
@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/Heap.h>
+#include <Utilities/Memory.h>
+#include <Utilities/UtilityTypes.h>
+#include <Utilities/frame_string.h>
+
+using namespace pn;
+
+namespace MemoryBenchmark {
+	struct particle_t {
+		float position[3];
+		float velocity[3];
+		float life;
+		int id;
+	};
+
+	constexpr int OBJECT_COUNT = 1024;
+
+	void BM_PoolAllocatorCreateRelease(benchmark::State& state) {
+		pool_allocator<particle_t> pool(OBJECT_COUNT);
+		pn::vector<particle_t*> objects(OBJECT_COUNT);
+		for (auto _ : state) {
+			for (auto& object : objects) {
+				object = pool.Create();
+			}
+			benchmark::ClobberMemory();
+			for (auto* object : objects) {
+				pool.Release(object);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	}
+	BENCHMARK(BM_PoolAllocatorCreateRelease);
+
+	// Every thread shares the pool, most of the work should stay in the per-thread magazines
+	void BM_PoolAllocatorThreaded(benchmark::State& state) {
+		static pool_allocator<particle_t> pool(OBJECT_COUNT);
+		pn::vector<particle_t*> objects(OBJECT_COUNT / 4);
+		for (auto _ : state) {
+			for (auto& object : objects) {
+				object = pool.Create();
+			}
+			benchmark::ClobberMemory();
+			for (auto* object : objects) {
+				pool.Release(object);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * (OBJECT_COUNT / 4));
+	}
+	BENCHMARK(BM_PoolAllocatorThreaded)->ThreadRange(1, 8)->UseRealTime();
+
+	// Baseline for the pool
+	void BM_NewDelete(benchmark::State& state) {
+		pn::vector<particle_t*> objects(OBJECT_COUNT);
+		for (auto _ : state) {
+			for (auto& object : objects) {
+				object = new particle_t();
+			}
+			benchmark::ClobberMemory();
+			for (auto* object : objects) {
+				delete object;
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	}
+	BENCHMARK(BM_NewDelete);
+
+	// Mixed sizes, freed in a different order than allocated, against the same pattern on new/delete
+	void BM_TlsfHeapMixed(benchmark::State& state) {
+		tlsf_heap heap(256 * 1024 * 1024);
+		pn::vector<void*> objects(OBJECT_COUNT);
+		for (auto _ : state) {
+			for (int i = 0; i < OBJECT_COUNT; ++i) {
+				objects[i] = heap.Allocate(16 + (i * 37) % 2000);
+			}
+			benchmark::ClobberMemory();
+			for (int i = 0; i < OBJECT_COUNT; ++i) {
+				heap.Free(objects[(i * 7) % OBJECT_COUNT]);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	}
+	BENCHMARK(BM_TlsfHeapMixed);
+
+	void BM_NewDeleteMixed(benchmark::State& state) {
+		pn::vector<char*> objects(OBJECT_COUNT);
+		for (auto _ : state) {
+			for (int i = 0; i < OBJECT_COUNT; ++i) {
+				objects[i] = new char[16 + (i * 37) % 2000];
+			}
+			benchmark::ClobberMemory();
+			for (int i = 0; i < OBJECT_COUNT; ++i) {
+				delete[] objects[(i * 7) % OBJECT_COUNT];
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	}
+	BENCHMARK(BM_NewDeleteMixed);
+
+	void BM_LinearAllocatorAllocate(benchmark::State& state) {
+		const auto size = static_cast<unsigned int>(state.range(0));
+		linear_allocator frame(size * OBJECT_COUNT);
+		for (auto _ : state) {
+			for (int i = 0; i < OBJECT_COUNT; ++i) {
+				benchmark::DoNotOptimize(frame.Allocate(size));
+			}
+			frame.Release();
+		}
+		state.SetItemsProcessed(state.iterations() * OBJECT_COUNT);
+	}
+	BENCHMARK(BM_LinearAllocatorAllocate)->Arg(16)->Arg(256);
+
+	// Builds a short label out of four pieces, the way debug and UI text is put together each frame
+	void BM_FrameStringConcat(benchmark::State& state) {
+		linear_allocator frame(1 << 20);
+		frame_string::SetFrameAllocator(&frame);
+		const string suffix = "_lod0";
+		for (auto _ : state) {
+			for (int i = 0; i < 256; ++i) {
+				frame_string name("mesh_");
+				auto label = "[" + name + "sphere" + suffix;
+				benchmark::DoNotOptimize(label.data());
+			}
+			frame.Release();
+		}
+		state.SetItemsProcessed(state.iterations() * 256);
+		frame_string::SetFrameAllocator(nullptr);
+	}
+	BENCHMARK(BM_FrameStringConcat);
+
+	// A per-frame UI line formatted in place, against fmt::format into a std::string
+	void BM_FrameStringFormat(benchmark::State& state) {
+		linear_allocator frame(1 << 20);
+		frame_string::SetFrameAllocator(&frame);
+		for (auto _ : state) {
+			for (int i = 0; i < 256; ++i) {
+				frame_string line;
+				line.Format("entity {} at ({:.2f}, {:.2f}, {:.2f}) lod {}", i, 1.5f, -2.25f, 10.0f, "high");
+				benchmark::DoNotOptimize(line.data());
+			}
+			frame.Release();
+		}
+		state.SetItemsProcessed(state.iterations() * 256);
+		frame_string::SetFrameAllocator(nullptr);
+	}
+	BENCHMARK(BM_FrameStringFormat);
+
+	void BM_StdStringFormat(benchmark::State& state) {
+		for (auto _ : state) {
+			for (int i = 0; i < 256; ++i) {
+				auto line = fmt::format("entity {} at ({:.2f}, {:.2f}, {:.2f}) lod {}", i, 1.5f, -2.25f, 10.0f, "high");
+				benchmark::DoNotOptimize(line.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * 256);
+	}
+	BENCHMARK(BM_StdStringFormat);
+
+	// Same label through std::string, for comparison
+	void BM_StdStringConcat(benchmark::State& state) {
+		const string suffix = "_lod0";
+		for (auto _ : state) {
+			for (int i = 0; i < 256; ++i) {
+				string name("mesh_");
+				auto label = "[" + name + "sphere" + suffix;
+				benchmark::DoNotOptimize(label.data());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * 256);
+	}
+	BENCHMARK(BM_StdStringConcat);
+}
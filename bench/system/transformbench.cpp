@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <System/TransformSystem.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace SystemBenchmark {
+	// Wide, shallow scene: a few roots with several levels of children, roughly like a loaded level
+	void BuildScene(transform_hierarchy_t& h, pn::vector<transform_id_t>& ids, const size_t n) {
+		std::mt19937 rng(4);
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		for (size_t i = 0; i < n; ++i) {
+			transform_t local;
+			local.position = vec3f(dist(rng), dist(rng), dist(rng));
+			local.rotation = EulerToQuaternion(vec3f(dist(rng), dist(rng), dist(rng)));
+			auto parent = (i < 16) ? INVALID_TRANSFORM_ID : ids[rng() % (i / 4 + 1)];
+			PushBack(ids, CreateTransform(h, local, parent));
+		}
+		UpdateTransforms(h);
+	}
+
+	void BM_UpdateAllTransforms(benchmark::State& state) {
+		transform_hierarchy_t h;
+		pn::vector<transform_id_t> ids;
+		BuildScene(h, ids, state.range(0));
+		for (auto _ : state) {
+			for (auto& dirty : h.local_dirty) dirty = 1;
+			UpdateTransforms(h);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_UpdateAllTransforms)->Arg(1 << 12)->Arg(1 << 15)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+
+	void BM_UpdateFewTransforms(benchmark::State& state) {
+		transform_hierarchy_t h;
+		pn::vector<transform_id_t> ids;
+		BuildScene(h, ids, state.range(0));
+		std::mt19937 rng(5);
+		for (auto _ : state) {
+			for (int i = 0; i < 64; ++i) {
+				SetPosition(h, ids[rng() % ids.size()], vec3f(1.0f, 2.0f, 3.0f));
+			}
+			UpdateTransforms(h);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_UpdateFewTransforms)->Arg(1 << 12)->Arg(1 << 15)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+
+	// The same scene walked through transform_t parent pointers, for comparison
+	void BM_UpdatePointerTransforms(benchmark::State& state) {
+		transform_hierarchy_t h;
+		pn::vector<transform_id_t> ids;
+		BuildScene(h, ids, state.range(0));
+		pn::vector<transform_t> transforms(ids.size());
+		for (size_t i = 0; i < ids.size(); ++i) {
+			transforms[i] = GetTransform(h, ids[i]);
+			auto parent = GetParent(h, ids[i]);
+			if (parent != INVALID_TRANSFORM_ID) SetParent(transforms[i], &transforms[parent]);
+		}
+		for (auto _ : state) {
+			for (auto& t : transforms) MarkDirty(t);
+			for (auto& t : transforms) benchmark::DoNotOptimize(LocalToWorldMatrix(t));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_UpdatePointerTransforms)->Arg(1 << 12)->Arg(1 << 15)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+
+	// One long parent chain: moving the root dirties everything, the leaf query walks back up it
+	void BM_LocalToWorldDeepChain(benchmark::State& state) {
+		pn::vector<transform_t> chain(state.range(0));
+		for (size_t i = 0; i < chain.size(); ++i) {
+			chain[i].position = vec3f(0.0f, 1.0f, 0.0f);
+			chain[i].rotation = EulerToQuaternion(vec3f(0.0f, 0.1f, 0.0f));
+			if (i > 0) SetParent(chain[i], &chain[i - 1]);
+		}
+		float x = 0.0f;
+		for (auto _ : state) {
+			SetPosition(chain[0], vec3f(x += 0.001f, 0.0f, 0.0f));
+			benchmark::DoNotOptimize(LocalToWorldMatrix(chain.back()));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_LocalToWorldDeepChain)->Arg(8)->Arg(64)->Arg(512);
+}
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/StringId.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+using namespace pn;
+
+namespace UtilitiesBenchmark {
+	// Keys the engine actually looks up: entity/handle integers, interned ids and asset names
+	template<typename K>
+	K MakeKey(const size_t i);
+
+	template<>
+	uint32_t MakeKey<uint32_t>(const size_t i) {
+		return static_cast<uint32_t>(i * 7919);
+	}
+
+	template<>
+	string_id_t MakeKey<string_id_t>(const size_t i) {
+		return string_id_t("mesh_" + std::to_string(i));
+	}
+
+	template<>
+	string MakeKey<string>(const size_t i) {
+		return "resources/meshes/mesh_" + std::to_string(i) + ".fbx";
+	}
+
+	template<typename K>
+	vector<K> MakeKeys(const size_t n) {
+		vector<K> keys;
+		for (size_t i = 0; i < n; ++i) {
+			PushBack(keys, MakeKey<K>(i));
+		}
+		std::shuffle(keys.begin(), keys.end(), std::mt19937(11));
+		return keys;
+	}
+
+	template<typename Map>
+	void BM_MapFind(benchmark::State& state) {
+		using key_t = typename Map::key_type;
+		const auto keys = MakeKeys<key_t>(state.range(0));
+		Map m;
+		for (size_t i = 0; i < Size(keys); ++i) {
+			m.emplace(keys[i], static_cast<int>(i));
+		}
+		for (auto _ : state) {
+			int total = 0;
+			for (const auto& key : keys) {
+				total += m.find(key)->second;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(state.iterations() * Size(keys));
+	}
+
+	// Keys that aren't in the map, the probe has to reach an empty slot
+	template<typename Map>
+	void BM_MapMiss(benchmark::State& state) {
+		using key_t = typename Map::key_type;
+		const auto keys = MakeKeys<key_t>(2 * state.range(0));
+		Map m;
+		for (size_t i = 0; i < Size(keys) / 2; ++i) {
+			m.emplace(keys[i], static_cast<int>(i));
+		}
+		for (auto _ : state) {
+			size_t found = 0;
+			for (size_t i = Size(keys) / 2; i < Size(keys); ++i) {
+				found += m.count(keys[i]);
+			}
+			benchmark::DoNotOptimize(found);
+		}
+		state.SetItemsProcessed(state.iterations() * Size(keys) / 2);
+	}
+
+	template<typename Map>
+	void BM_MapInsert(benchmark::State& state) {
+		using key_t = typename Map::key_type;
+		const auto keys = MakeKeys<key_t>(state.range(0));
+		for (auto _ : state) {
+			Map m;
+			for (size_t i = 0; i < Size(keys); ++i) {
+				m.emplace(keys[i], static_cast<int>(i));
+			}
+			benchmark::DoNotOptimize(m.size());
+		}
+		state.SetItemsProcessed(state.iterations() * Size(keys));
+	}
+
+	template<typename Map>
+	void BM_MapIterate(benchmark::State& state) {
+		using key_t = typename Map::key_type;
+		const auto keys = MakeKeys<key_t>(state.range(0));
+		Map m;
+		for (size_t i = 0; i < Size(keys); ++i) {
+			m.emplace(keys[i], static_cast<int>(i));
+		}
+		for (auto _ : state) {
+			int total = 0;
+			for (const auto& entry : m) {
+				total += entry.second;
+			}
+			benchmark::DoNotOptimize(total);
+		}
+		state.SetItemsProcessed(state.iterations() * Size(keys));
+	}
+
+	template<typename K>
+	using std_map = std::unordered_map<K, int>;
+
+	BENCHMARK_TEMPLATE(BM_MapFind, pn::map<uint32_t, int>)->Arg(64)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapFind, std_map<uint32_t>)->Arg(64)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapFind, pn::map<string_id_t, int>)->Arg(64)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapFind, std_map<string_id_t>)->Arg(64)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapFind, pn::map<string, int>)->Arg(64)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapFind, std_map<string>)->Arg(64)->Arg(16384);
+
+	BENCHMARK_TEMPLATE(BM_MapMiss, pn::map<uint32_t, int>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapMiss, std_map<uint32_t>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapMiss, pn::map<string, int>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapMiss, std_map<string>)->Arg(16384);
+
+	BENCHMARK_TEMPLATE(BM_MapInsert, pn::map<uint32_t, int>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapInsert, std_map<uint32_t>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapInsert, pn::map<string_id_t, int>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapInsert, std_map<string_id_t>)->Arg(16384);
+
+	BENCHMARK_TEMPLATE(BM_MapIterate, pn::map<uint32_t, int>)->Arg(16384);
+	BENCHMARK_TEMPLATE(BM_MapIterate, std_map<uint32_t>)->Arg(16384);
+}
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/Profile.h>
+
+using namespace pn;
+
+namespace UtilitiesBenchmark {
+	// Scopes per drain, well inside a thread's ring
+	constexpr int SCOPES_PER_FRAME = 1024;
+
+	void BM_ProfileScope(benchmark::State& state) {
+		SetProfilerEnabled(state.range(0) != 0);
+		for (auto _ : state) {
+			for (int i = 0; i < SCOPES_PER_FRAME; ++i) {
+				PN_PROFILE_SCOPE("bench scope");
+				benchmark::ClobberMemory();
+			}
+			state.PauseTiming();
+			EndProfileFrame();
+			state.ResumeTiming();
+		}
+		SetProfilerEnabled(true);
+		state.SetItemsProcessed(state.iterations() * SCOPES_PER_FRAME);
+	}
+	BENCHMARK(BM_ProfileScope)->Arg(1)->Arg(0);
+
+	void BM_ProfileNestedScopes(benchmark::State& state) {
+		for (auto _ : state) {
+			for (int i = 0; i < SCOPES_PER_FRAME / 4; ++i) {
+				PN_PROFILE_SCOPE("bench outer");
+				{
+					PN_PROFILE_SCOPE("bench middle");
+					for (int j = 0; j < 2; ++j) {
+						PN_PROFILE_SCOPE("bench inner");
+						benchmark::ClobberMemory();
+					}
+				}
+			}
+			state.PauseTiming();
+			EndProfileFrame();
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * SCOPES_PER_FRAME);
+	}
+	BENCHMARK(BM_ProfileNestedScopes);
+
+	// Draining a frame and building its tree, per event
+	void BM_EndProfileFrame(benchmark::State& state) {
+		for (auto _ : state) {
+			state.PauseTiming();
+			for (int i = 0; i < SCOPES_PER_FRAME / 4; ++i) {
+				PN_PROFILE_SCOPE("bench outer");
+				PN_PROFILE_SCOPE("bench middle");
+				PN_PROFILE_SCOPE("bench inner");
+				PN_PROFILE_SCOPE("bench leaf");
+			}
+			state.ResumeTiming();
+			EndProfileFrame();
+		}
+		state.SetItemsProcessed(state.iterations() * SCOPES_PER_FRAME);
+	}
+	BENCHMARK(BM_EndProfileFrame);
+}
@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/SmallVector.h>
+#include <Utilities/UtilityTypes.h>
+
+using namespace pn;
+
+namespace UtilitiesBenchmark {
+	// A short list built and thrown away, like the per-draw vertex buffer arrays
+	template<typename Vector>
+	void BM_ShortVector(benchmark::State& state) {
+		const int count = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			Vector v;
+			for (int i = 0; i < count; ++i) {
+				PushBack(v, i);
+			}
+			benchmark::DoNotOptimize(v.data());
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+	BENCHMARK_TEMPLATE(BM_ShortVector, vector<int>)->Arg(4)->Arg(8);
+	BENCHMARK_TEMPLATE(BM_ShortVector, small_vector<int, 8>)->Arg(4)->Arg(8)->Arg(32);
+	BENCHMARK_TEMPLATE(BM_ShortVector, fixed_vector<int, 8>)->Arg(4)->Arg(8);
+}
@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include <Utilities/UtilityTypes.h>
+
+using namespace pn;
+
+namespace UtilitiesBenchmark {
+	// A config-style line with state.range(0) fields
+	string MakeLine(const int fields) {
+		string line;
+		for (int i = 0; i < fields; ++i) {
+			if (i > 0) line += ',';
+			line += "field" + std::to_string(i);
+		}
+		return line;
+	}
+
+	void BM_Split(benchmark::State& state) {
+		const auto line = MakeLine(static_cast<int>(state.range(0)));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(Split(line, ','));
+		}
+		state.SetBytesProcessed(state.iterations() * Size(line));
+	}
+	BENCHMARK(BM_Split)->Arg(4)->Arg(64);
+}
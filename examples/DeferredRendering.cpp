@@ -1,30 +1,30 @@
-#include <Graphics\Window.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
-#include <Graphics\ProjectionMatrix.h>
-#include <Graphics\RenderSystem.h>
-#include <Graphics\GBuffer.h>
+#include <Graphics/Window.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
+#include <Graphics/ProjectionMatrix.h>
+#include <Graphics/RenderSystem.h>
+#include <Graphics/GBuffer.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\frame_string.h>
-#include <Utilities\Profile.h>
+#include <Utilities/Logging.h>
+#include <Utilities/frame_string.h>
+#include <Utilities/Profile.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
 
-#include <UI\UIUtil.h>
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/UIUtil.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 #include <chrono>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
-#include <System\Flycam.h>
+#include <System/Flycam.h>
 
 using namespace pn;
 
@@ -89,10 +89,15 @@ void Init() {
 
 	// ---------- LOAD RESOURCES ----------------
 
-	LoadMesh(GetResourcePath("dragon.fbx"));
-	LoadMesh(GetResourcePath("reflection_sphere.fbx"));
-	LoadMesh(GetResourcePath("round_sphere.fbx"));
-	LoadMesh(GetResourcePath("cubemap.fbx"));
+	const mesh_load_handle_t mesh_loads[] = {
+		LoadMeshAsync(GetResourcePath("dragon.fbx")),
+		LoadMeshAsync(GetResourcePath("reflection_sphere.fbx")),
+		LoadMeshAsync(GetResourcePath("round_sphere.fbx")),
+		LoadMeshAsync(GetResourcePath("cubemap.fbx"))
+	};
+	for (auto handle : mesh_loads) {
+		WaitForMeshLoad(handle);
+	}
 	
 	dragon.mesh        = pn::rdb::GetMeshResource("default");
 	dragon.transform.position = vec3f(0.0f, -4.0f, 9.0f);
@@ -268,7 +273,7 @@ void Render() {
 	SetDepthStencilState(less_equal_depth);
 
 	SetProgramResource("cubemap", cubemap_texture);
-	cubemap.transform.position = MAIN_CAMERA.transform.position;
+	SetPosition(cubemap.transform, MAIN_CAMERA.transform.position);
 	Draw(cubemap);
 
 	/*SetShaderProgram(simple_texture_shader);
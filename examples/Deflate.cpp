@@ -1,30 +1,30 @@
-#include <Graphics\Window.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
-#include <Graphics\ProjectionMatrix.h>
-#include <Graphics\RenderSystem.h>
-#include <Graphics\GBuffer.h>
-#include <Graphics\Lighting.h>
+#include <Graphics/Window.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
+#include <Graphics/ProjectionMatrix.h>
+#include <Graphics/RenderSystem.h>
+#include <Graphics/GBuffer.h>
+#include <Graphics/Lighting.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\Profile.h>
+#include <Utilities/Logging.h>
+#include <Utilities/Profile.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
 
-#include <UI\UIUtil.h>
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/UIUtil.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 #include <chrono>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
-#include <System\Flycam.h>
+#include <System/Flycam.h>
 
 using namespace pn;
 
@@ -67,9 +67,14 @@ dx_resource_view cubemap_texture;
 
 
 void LoadResources() {
-	LoadMesh(GetResourcePath("cubemap.fbx"));
-	LoadMesh(GetResourcePath("plane.fbx"));
-	LoadMesh(GetResourcePath("sphere.fbx"));
+	const mesh_load_handle_t mesh_loads[] = {
+		LoadMeshAsync(GetResourcePath("cubemap.fbx")),
+		LoadMeshAsync(GetResourcePath("plane.fbx")),
+		LoadMeshAsync(GetResourcePath("sphere.fbx"))
+	};
+	for (auto handle : mesh_loads) {
+		WaitForMeshLoad(handle);
+	}
 
 	height_map      = LoadTexture2D(GetResourcePath("height.jpg"));
 	cubemap_texture = LoadCubemap(GetResourcePath("space-cubemap.dds"));
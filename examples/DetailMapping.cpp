@@ -1,10 +1,10 @@
-#include <Utilities\Profile.h>
+#include <Utilities/Profile.h>
 
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
 struct alignas(16) directional_light_t {
 	pn::vec3f direction;
@@ -1,27 +1,27 @@
-#include <Graphics\Window.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
-#include <Graphics\ProjectionMatrix.h>
-#include <Graphics\RenderSystem.h>
+#include <Graphics/Window.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
+#include <Graphics/ProjectionMatrix.h>
+#include <Graphics/RenderSystem.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\frame_string.h>
-#include <Utilities\Profile.h>
+#include <Utilities/Logging.h>
+#include <Utilities/frame_string.h>
+#include <Utilities/Profile.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
 
-#include <UI\UIUtil.h>
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/UIUtil.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 #include <chrono>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
 // -- Uniform buffer data definitions ----
 
@@ -83,19 +83,18 @@ void Init() {
 
 	// ---------- LOAD RESOURCES ----------------
 
-	pn::StartProfile("Loading all meshes");
-
 	{
-		pn::StartProfile("Loading wave mesh");
-		auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("water.fbx"));
-		pn::EndProfile();
+		PN_PROFILE_SCOPE("Loading all meshes");
+
+		{
+			PN_PROFILE_SCOPE("Loading wave mesh");
+			auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("water.fbx"));
+		}
 
 		wave_mesh_buffer = pn::rdb::GetMeshResource("Plane");
 		
 	}
 
-	pn::EndProfile();
-
 	// --------- LOAD TEXTURES -------------
 
 	tex	= pn::LoadTexture2D(pn::GetResourcePath("image.png"));
@@ -1,28 +1,28 @@
-#include <Graphics\Window.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
-#include <Graphics\ProjectionMatrix.h>
+#include <Graphics/Window.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
+#include <Graphics/ProjectionMatrix.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\frame_string.h>
-#include <Utilities\Profile.h>
+#include <Utilities/Logging.h>
+#include <Utilities/frame_string.h>
+#include <Utilities/Profile.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
 
-#include <UI\UIUtil.h>
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/UIUtil.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 #include <chrono>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
-#include <System\Flycam.h>
+#include <System/Flycam.h>
 
 using namespace pn;
 
@@ -73,14 +73,13 @@ shader_program_t cubemap_shader;
 mesh_buffer_t    cubemap_mesh_buffer;
 
 // ---- misc --------
-pn::linear_allocator frame_alloc(1024 * 1024);
-
 pn::string recomp() {
 	auto vs_byte_code = pn::CompileVertexShader(pn::GetResourcePath("water.hlsl"));
 	if (pn::Size(vs_byte_code) > 0) {
 		wave_program.vertex_shader_data.shader		= pn::CreateVertexShader(vs_byte_code);
 		wave_program.input_layout_data				= pn::CreateInputLayout(vs_byte_code);
 		wave_program.vertex_shader_data.reflection	= pn::GetShaderReflector(vs_byte_code);
+		wave_program.vertex_shader_data.bindings	= pn::GetShaderBindings(wave_program.vertex_shader_data.reflection);
 	}
 	else {
 		return "Compilation error, check log.";
@@ -90,6 +89,7 @@ pn::string recomp() {
 	if (pn::Size(ps_byte_code) > 0) {
 		wave_program.pixel_shader_data.shader		= pn::CreatePixelShader(ps_byte_code);
 		wave_program.pixel_shader_data.reflection	= pn::GetShaderReflector(ps_byte_code);
+		wave_program.pixel_shader_data.bindings		= pn::GetShaderBindings(wave_program.pixel_shader_data.reflection);
 	}
 	else {
 		return "Compilation error, check log.";
@@ -117,29 +117,26 @@ void Init() {
 		cubemap_mesh_buffer = rdb::GetMeshResource("Cubemap");
 	}
 
-	pn::StartProfile("Loading all meshes");
-
 	{
-		pn::StartProfile("Loading wave mesh");
-		auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("water.fbx"));
-		pn::EndProfile();
+		PN_PROFILE_SCOPE("Loading all meshes");
+
+		{
+			PN_PROFILE_SCOPE("Loading wave mesh");
+			auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("water.fbx"));
+		}
 
 		wave_mesh_buffer = pn::rdb::GetMeshResource("Plane");
-		
-	}
 
-	{
-		/*pn::StartProfile("Loading monkey mesh");
-		auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("monkey.fbx"));
-		pn::EndProfile();
+		/*{
+			PN_PROFILE_SCOPE("Loading monkey mesh");
+			auto mesh_handle = pn::LoadMesh(pn::GetResourcePath("monkey.fbx"));
+		}
 
 		while (monkey_mesh_buffer.index_count == 0) {
 			monkey_mesh_buffer = pn::rdb::GetMeshResource(mesh_handle++);
 		}*/
 	}
 
-	pn::EndProfile();
-
 	// --------- LOAD TEXTURES -------------
 
 	tex				= pn::LoadTexture2D(pn::GetResourcePath("image.png"));
@@ -173,11 +170,6 @@ void Init() {
 	wave_transform.position	= { 0, 0, 15 };
 	wave_transform.scale	= { 1, 1, 1 };
 	wave_transform.rotation = pn::EulerToQuaternion( 0.698f, 3.069f, 0.f );
-
-	// --------- INIT CUSTOM ALLOCATORS -----------
-	pn::frame_string::SetFrameAllocator(&frame_alloc);
-
-
 }
 
 void Update() {
@@ -248,7 +240,7 @@ void Render() {
 	SetStandardShaderProgram(cubemap_shader);
 	SetVertexBuffers(cubemap_mesh_buffer);
 
-	cubemap_transform.position = MAIN_CAMERA.transform.position;
+	SetPosition(cubemap_transform, MAIN_CAMERA.transform.position);
 	UpdateModelConstantCBuffer(cubemap_transform);
 
 	SetProgramResource("cubemap", cubemap);
@@ -1,26 +1,26 @@
-#include <Graphics\Window.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\MeshLoadUtil.h>
-#include <Graphics\TextureLoadUtil.h>
-#include <Graphics\ProjectionMatrix.h>
+#include <Graphics/Window.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/MeshLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
+#include <Graphics/ProjectionMatrix.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\frame_string.h>
-#include <Utilities\Profile.h>
+#include <Utilities/Logging.h>
+#include <Utilities/frame_string.h>
+#include <Utilities/Profile.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
 
-#include <UI\UIUtil.h>
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/UIUtil.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 #include <chrono>
 
-#include <Application\ResourceDatabase.h>
-#include <Application\MainLoop.inc>
+#include <Application/ResourceDatabase.h>
+#include <Application/MainLoop.inc>
 
 void Init() {}
 
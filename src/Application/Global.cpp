@@ -1,11 +1,15 @@
 
 #include <fstream>
 
-#include <json11\json11.hpp>
+#include <json11/json11.hpp>
 
-#include <Application\Global.h>
-#include <IO\PathUtil.h>
-#include <Utilities\JsonUtil.h>
+#include <Application/Global.h>
+#include <IO/AssetCache.h>
+#include <IO/PathUtil.h>
+#include <Utilities/FrameArena.h>
+#include <Utilities/JsonUtil.h>
+#include <Utilities/MemoryTracking.h>
+#include <Utilities/ProfileCapture.h>
 
 namespace pn {
 
@@ -75,6 +79,44 @@ void LoadEngineConfiguration() {
 			pn::SetResourceDirectoryName(LogValueInfo("Resources Folder Name: {}", as_string(resources["name"], "resources")));
 		}
 	}
+
+	// the asset cache is on unless the configuration turns it off
+	const Json& cache = config["cache"];
+	if (as_bool(cache["enabled"], true)) {
+		LogDebug("Loading Asset Cache Configuration");
+		const auto cache_path = pn::GetWorkingDirectory() + LogValueInfo("Asset Cache Folder Name: {}", as_string(cache["name"], "cache"));
+		const auto cache_size = static_cast<uint64_t>(LogValueInfo("Asset Cache Size (MB): {}", as_int(cache["max_size_mb"], 1024)));
+		pn::InitAssetCache(cache_path, cache_size * 1024 * 1024);
+	}
+
+	// per-frame scratch memory, split between the job threads
+	const Json& frame_arena = config["frame_arena"];
+	const auto frame_arena_size = static_cast<size_t>(LogValueDebug("Frame Arena Size per Thread (KB): {}", as_int(frame_arena["size_kb"], static_cast<int>(DEFAULT_FRAME_ARENA_SIZE / 1024))));
+	const auto frame_arena_count = static_cast<unsigned>(LogValueDebug("Frame Arena Count: {}", as_int(frame_arena["count"], static_cast<int>(DEFAULT_FRAME_ARENA_COUNT))));
+	pn::InitFrameArenas(frame_arena_size * 1024, frame_arena_count);
+
+	// budgets per memory tag, e.g. "memory_budgets": { "mesh": 256, "ui": 8 }
+	const Json& memory_budgets = config["memory_budgets"];
+	for (const auto& budget : memory_budgets.object_items()) {
+		memory_tag_t tag;
+		if (!MemoryTagFromName(budget.first, tag)) {
+			LogError("Unknown memory tag in memory_budgets: {}", budget.first);
+			continue;
+		}
+		const auto budget_mb = as_int(budget.second, 0);
+		LogDebug("Memory Budget of {} (MB): {}", budget.first, budget_mb);
+		SetMemoryBudget(tag, static_cast<size_t>(budget_mb) * 1024 * 1024);
+	}
+
+	// a Chrome trace of the first frames, e.g. "profile_capture": { "frames": 300, "path": "startup.json" }
+	const Json& profile_capture = config["profile_capture"];
+	if (profile_capture.is_object()) {
+		const auto frames = LogValueDebug("Profile Capture Frames: {}", as_int(profile_capture["frames"], static_cast<int>(DEFAULT_PROFILE_CAPTURE_FRAMES)));
+		const auto path = LogValueDebug("Profile Capture Path: {}", as_string(profile_capture["path"], DEFAULT_PROFILE_CAPTURE_PATH));
+		if (frames > 0) {
+			pn::StartProfileCapture(static_cast<uint32_t>(frames), path);
+		}
+	}
 }
 
 void Exit() {
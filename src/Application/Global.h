@@ -1,6 +1,8 @@
 #pragma once
 
-#include <Graphics\Window.h>
+#if defined(PN_BACKEND_D3D11)
+#include <Graphics/Window.h>
+#endif
 
 namespace pn {
 
@@ -10,7 +12,9 @@ namespace app {
 
 // -------- VARIABLES -----------
 
+#if defined(PN_BACKEND_D3D11)
 extern pn::application_window_desc window_desc;
+#endif
 
 extern double FPS;
 extern double FIXED_DT;
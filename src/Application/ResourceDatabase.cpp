@@ -1,65 +1,497 @@
-#include <Application\ResourceDatabase.h>
+#include <Application/ResourceDatabase.h>
+
+#include <Utilities/Logging.h>
+#include <Utilities/MemoryTracking.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace pn::rdb {
 
+// ----- CONSTANTS ---------
+
+constexpr uint32_t	CHUNK_SIZE		= 256;
+constexpr uint64_t	IDLE_EPOCH		= UINT64_MAX;
+
+// free_cursor of a replaced snapshot, far enough past any free list that late claims miss
+constexpr uint64_t	CLOSED_CURSOR	= uint64_t(1) << 62;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Everything the rdb knows about a mesh lives in one entry, so a stale id can't find a
+// transform or child list left behind by an earlier mesh
+struct mesh_entry_t {
+	mesh_resource_t		mesh;
+	mesh_transform_t	transform;
+	mesh_children_t		children;
+};
+
+struct mesh_slot_t {
+	uint32_t							generation = 0;		// odd while live, like slot_map_t
+	std::shared_ptr<const mesh_entry_t>	entry;
+};
+
+struct mesh_chunk_t {
+	mesh_slot_t	slots[CHUNK_SIZE];
+};
+
+using name_index_t = pn::map<string_id_t, pn::vector<mesh_resource_id_t>>;	// interned names, oldest first
+
+// Never changes once published, apart from free_cursor. A commit copies the pointers and only
+// clones the chunks, entries and index it touches, everything else is shared with the last one.
+struct snapshot_t {
+	pn::vector<std::shared_ptr<const mesh_chunk_t>>	chunks;
+	std::shared_ptr<const name_index_t>				names;
+	std::shared_ptr<const mesh_children_t>			root_children;
+
+	// ids for recycled slots, handed out by AllocateId through free_cursor
+	pn::vector<mesh_resource_id_t>					free_ids;
+	mutable std::atomic<uint64_t>					free_cursor{ 0 };
+};
+
+enum class op_type_t {
+	ADD,
+	REMOVE,
+	SET_TRANSFORM,
+	RESET_TRANSFORM,
+	ADD_CHILD,
+	REMOVE_CHILD
+};
+
+struct staged_op_t {
+	op_type_t			type;
+	mesh_resource_id_t	id;
+	mesh_resource_id_t	child;
+	mesh_resource_t		mesh;
+	mesh_transform_t	transform;
+};
+
+// One per thread that has used the rdb, recycled once the thread exits
+struct thread_record_t {
+	std::atomic<uint64_t>		epoch{ IDLE_EPOCH };	// epoch of the oldest snapshot the thread may be reading
+	int							read_depth	= 0;
+	std::mutex					ops_lock;				// only contended while a commit takes the ops
+	pn::vector<staged_op_t>		ops;
+	bool						in_use		= true;		// guarded by registry_lock
+};
+
+// Mutable state of one CommitChanges call
+struct commit_t {
+	std::shared_ptr<snapshot_t>								next;
+	pn::vector<std::shared_ptr<mesh_chunk_t>>				writable_chunks;	// null until cloned
+	pn::map<uint32_t, std::shared_ptr<mesh_entry_t>>		writable_entries;	// by slot index
+	std::shared_ptr<name_index_t>							names;
+	std::shared_ptr<mesh_children_t>						root_children;
+};
+
 // ------- VARIABLES ------------
 
-resource_id_t									asset_count = 1; // keep 0 reserved as NULL value
+std::atomic<const snapshot_t*>							published{ nullptr };
+std::atomic<uint64_t>									global_epoch{ 0 };
+std::atomic<uint32_t>									next_slot{ 0 };
+
+// ---- writer side
+std::mutex												commit_lock;
+std::shared_ptr<const snapshot_t>						current;		// owns published
+pn::vector<std::pair<uint64_t, std::shared_ptr<const snapshot_t>>>	retired;	// tagged with the epoch they were replaced in
+
+std::mutex												registry_lock;
+pn::vector<std::unique_ptr<thread_record_t>>			thread_records;
+
+// returned for misses in release builds
+const mesh_resource_t									EMPTY_MESH{};
+const mesh_transform_t									EMPTY_TRANSFORM{};
+const mesh_children_t									EMPTY_CHILDREN{};
+
+#pragma region Threads
+
+struct thread_record_holder_t {
+	thread_record_t* record = nullptr;
 
-pn::map<mesh_resource_id_t, mesh_resource_t>	meshes{};
-pn::map<mesh_resource_id_t, transform_t>		mesh_transforms{};
-pn::map<mesh_resource_id_t, mesh_children_t>	mesh_children{};
+	~thread_record_holder_t() {
+		if (record == nullptr) return;
+		// staged ops stay behind, the next commit still picks them up
+		std::lock_guard<std::mutex> lock(registry_lock);
+		record->in_use = false;
+	}
+};
 
-// -------- FUNCTIONS ------------
+static thread_local thread_record_holder_t THREAD_RECORD;
 
-resource_id_t GetNextAssetId() {
-	return asset_count++;
+static thread_record_t& GetThreadRecord() {
+	if (THREAD_RECORD.record == nullptr) {
+		std::lock_guard<std::mutex> lock(registry_lock);
+		for (auto& record : thread_records) {
+			if (!record->in_use) {
+				record->in_use = true;
+				THREAD_RECORD.record = record.get();
+				break;
+			}
+		}
+		if (THREAD_RECORD.record == nullptr) {
+			thread_records.emplace_back(std::make_unique<thread_record_t>());
+			THREAD_RECORD.record = thread_records.back().get();
+		}
+	}
+	return *THREAD_RECORD.record;
 }
 
-mesh_resource_id_t	AddMeshResource(mesh_resource_t& mesh) {
-	auto new_id = GetNextAssetId();
-	mesh.id		= new_id;
-	pn::Insert(meshes, new_id, mesh);
-	return new_id;
+// Announces the epoch before the snapshot is loaded. A commit that doesn't see the
+// announcement has already published its replacement, so the old snapshot can't be loaded.
+static void BeginRead(thread_record_t& record) {
+	if (record.read_depth++ == 0) {
+		record.epoch.store(global_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+	}
+}
+
+static void EndRead(thread_record_t& record) {
+	if (--record.read_depth == 0) {
+		record.epoch.store(IDLE_EPOCH, std::memory_order_release);
+	}
+}
+
+static void Stage(staged_op_t&& op) {
+	memory_tag_scope tag(memory_tag_t::RESOURCES);
+	auto& record = GetThreadRecord();
+	std::lock_guard<std::mutex> lock(record.ops_lock);
+	PushBack(record.ops, std::move(op));
+}
+
+// Recycled slots come from the published free list, claimed with one fetch_add. Once that's
+// used up, or closed by a commit, fresh slots are taken from the end.
+static mesh_resource_id_t AllocateId() {
+	auto& record = GetThreadRecord();
+	mesh_resource_id_t id = NULL_RESOURCE_ID;
+
+	BeginRead(record);
+	const auto* snapshot = published.load(std::memory_order_seq_cst);
+	if (snapshot != nullptr && !snapshot->free_ids.empty()) {
+		const auto i = snapshot->free_cursor.fetch_add(1, std::memory_order_acq_rel);
+		if (i < Size(snapshot->free_ids)) {
+			id = snapshot->free_ids[i];
+		}
+	}
+	EndRead(record);
+
+	if (id == NULL_RESOURCE_ID) {
+		id = MakeSlotHandle(next_slot.fetch_add(1, std::memory_order_relaxed), 1);
+	}
+	return id;
+}
+
+#pragma endregion
+
+#pragma region Snapshot
+
+static const mesh_entry_t* FindEntry(const snapshot_t* snapshot, const mesh_resource_id_t id) {
+	if (snapshot == nullptr) return nullptr;
+
+	const uint32_t index = SlotIndex(id);
+	const uint32_t chunk = index / CHUNK_SIZE;
+	if (chunk >= Size(snapshot->chunks)) return nullptr;
+
+	const auto& slot = snapshot->chunks[chunk]->slots[index % CHUNK_SIZE];
+	if (slot.generation != SlotGeneration(id) || (slot.generation & 1) == 0) return nullptr;
+	return slot.entry.get();
+}
+
+static const mesh_entry_t* FindEntry(const mesh_resource_id_t id) {
+	auto& record = GetThreadRecord();
+	BeginRead(record);
+	const auto* entry = FindEntry(published.load(std::memory_order_seq_cst), id);
+	EndRead(record);
+	return entry;
+}
+
+static const mesh_entry_t* GetEntry(const mesh_resource_id_t id) {
+	const auto* entry = FindEntry(id);
+	if (entry == nullptr) {
+		LogError("Stale or unknown mesh id in rdb: {:#x}", id);
+		assert(false);
+	}
+	return entry;
+}
+
+static mesh_slot_t& WritableSlot(commit_t& commit, const uint32_t index) {
+	auto& chunks = commit.next->chunks;
+	const uint32_t chunk = index / CHUNK_SIZE;
+	while (chunk >= Size(chunks)) {
+		auto fresh = std::make_shared<mesh_chunk_t>();
+		PushBack(chunks, std::shared_ptr<const mesh_chunk_t>(fresh));
+		PushBack(commit.writable_chunks, fresh);
+	}
+	if (commit.writable_chunks[chunk] == nullptr) {
+		commit.writable_chunks[chunk] = std::make_shared<mesh_chunk_t>(*chunks[chunk]);
+		chunks[chunk] = commit.writable_chunks[chunk];
+	}
+	return commit.writable_chunks[chunk]->slots[index % CHUNK_SIZE];
+}
+
+static mesh_entry_t* WritableEntry(commit_t& commit, const mesh_resource_id_t id) {
+	const uint32_t index = SlotIndex(id);
+	if (FindEntry(commit.next.get(), id) == nullptr) {
+		LogError("Stale or unknown mesh id in rdb: {:#x}", id);
+		return nullptr;
+	}
+
+	auto it = commit.writable_entries.find(index);
+	if (it != commit.writable_entries.end()) {
+		return it->second.get();
+	}
+
+	auto& slot = WritableSlot(commit, index);
+	auto entry = std::make_shared<mesh_entry_t>(*slot.entry);
+	slot.entry = entry;
+	commit.writable_entries.emplace(index, entry);
+	return entry.get();
+}
+
+static name_index_t& WritableNames(commit_t& commit) {
+	if (commit.names == nullptr) {
+		commit.names = std::make_shared<name_index_t>(*commit.next->names);
+		commit.next->names = commit.names;
+	}
+	return *commit.names;
+}
+
+static mesh_children_t& WritableRootChildren(commit_t& commit) {
+	if (commit.root_children == nullptr) {
+		commit.root_children = std::make_shared<mesh_children_t>(*commit.next->root_children);
+		commit.next->root_children = commit.root_children;
+	}
+	return *commit.root_children;
 }
-void				RemoveMeshResource(const mesh_resource_id_t key) {
-	pn::Remove(meshes, key);
+
+static void ApplyAdd(commit_t& commit, staged_op_t& op) {
+	const uint32_t index = SlotIndex(op.id);
+	auto& slot = WritableSlot(commit, index);
+	assert((slot.generation & 1) == 0);
+
+	auto entry = std::make_shared<mesh_entry_t>();
+	entry->mesh = std::move(op.mesh);
+	slot.generation = SlotGeneration(op.id);
+	slot.entry = entry;
+	commit.writable_entries[index] = entry;
+	PushBack(WritableNames(commit)[InternString(entry->mesh.name)], op.id);
 }
-mesh_resource_t		GetMeshResource(const mesh_resource_id_t key) {
-	return pn::Get(meshes, key);
+
+static void ApplyRemove(commit_t& commit, const mesh_resource_id_t id) {
+	const auto* entry = FindEntry(commit.next.get(), id);
+	if (entry == nullptr) return;
+
+	auto& names = WritableNames(commit);
+	const string_id_t name(entry->mesh.name);
+	auto& ids = names.at(name);
+	pn::Erase(ids, id);
+	if (ids.empty()) {
+		names.erase(name);
+	}
+
+	const uint32_t index = SlotIndex(id);
+	auto& slot = WritableSlot(commit, index);
+	slot.entry.reset();
+	++slot.generation;
+	commit.writable_entries.erase(index);
+	PushBack(commit.next->free_ids, MakeSlotHandle(index, slot.generation + 1));
 }
-mesh_resource_t		GetMeshResource(const pn::string& name) {
-	for (const auto& mesh : meshes) {
-		auto& mesh_resource = mesh.second;
-		if (mesh_resource.name == name) return mesh_resource;
+
+static void Apply(commit_t& commit, staged_op_t& op) {
+	switch (op.type) {
+	case op_type_t::ADD:
+		ApplyAdd(commit, op);
+		break;
+	case op_type_t::REMOVE:
+		ApplyRemove(commit, op.id);
+		break;
+	case op_type_t::SET_TRANSFORM:
+	case op_type_t::RESET_TRANSFORM:
+		if (auto* entry = WritableEntry(commit, op.id)) {
+			entry->transform = (op.type == op_type_t::SET_TRANSFORM) ? op.transform : mesh_transform_t{};
+		}
+		break;
+	case op_type_t::ADD_CHILD:
+		if (op.id == NULL_RESOURCE_ID) {
+			PushBack(WritableRootChildren(commit), op.child);
+		} else if (auto* entry = WritableEntry(commit, op.id)) {
+			PushBack(entry->children, op.child);
+		}
+		break;
+	case op_type_t::REMOVE_CHILD:
+		if (op.id == NULL_RESOURCE_ID) {
+			pn::Erase(WritableRootChildren(commit), op.child);
+		} else if (auto* entry = WritableEntry(commit, op.id)) {
+			pn::Erase(entry->children, op.child);
+		}
+		break;
 	}
-	LogError("Couldn't find requested mesh in rdb: {}", name);
-	assert(false);
 }
 
-void				AddMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform) {
-	pn::Insert(mesh_transforms, mesh_id, transform);
+// Frees the snapshots no reader can still be holding
+static void Reclaim() {
+	uint64_t oldest = IDLE_EPOCH;
+	{
+		std::lock_guard<std::mutex> lock(registry_lock);
+		for (const auto& record : thread_records) {
+			oldest = std::min(oldest, record->epoch.load(std::memory_order_seq_cst));
+		}
+	}
+	retired.erase(std::remove_if(retired.begin(), retired.end(), [oldest](const auto& r) { return r.first < oldest; }), retired.end());
 }
-void				RemoveMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform) {
-	pn::Remove(mesh_transforms, mesh_id);
+
+#pragma endregion
+
+#pragma region Functions
+
+read_scope_t::read_scope_t() {
+	BeginRead(GetThreadRecord());
 }
-mesh_transform_t	GetMeshTransform(const mesh_resource_id_t mesh_id) {
-	return pn::Get(mesh_transforms, mesh_id);
+
+read_scope_t::~read_scope_t() {
+	EndRead(GetThreadRecord());
 }
 
-void				AddMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id) {
-	if (!pn::Contains(mesh_children, mesh_id)) {
-		pn::Insert(mesh_children, mesh_id, mesh_children_t{});
+void					CommitChanges() {
+	memory_tag_scope tag(memory_tag_t::RESOURCES);
+	std::lock_guard<std::mutex> commit_guard(commit_lock);
+
+	pn::vector<pn::vector<staged_op_t>> batches;
+	{
+		std::lock_guard<std::mutex> lock(registry_lock);
+		for (auto& record : thread_records) {
+			std::lock_guard<std::mutex> ops_guard(record->ops_lock);
+			if (record->ops.empty()) continue;
+			PushBack(batches, pn::vector<staged_op_t>{});
+			batches.back().swap(record->ops);
+		}
+	}
+
+	if (batches.empty()) {
+		Reclaim();
+		return;
+	}
+
+	commit_t commit;
+	commit.next = std::make_shared<snapshot_t>();
+	auto& next = *commit.next;
+	if (current != nullptr) {
+		next.chunks = current->chunks;
+		next.names = current->names;
+		next.root_children = current->root_children;
+
+		// whatever AllocateId didn't claim before the close carries over
+		const auto claimed = std::min<uint64_t>(current->free_cursor.exchange(CLOSED_CURSOR, std::memory_order_acq_rel), Size(current->free_ids));
+		next.free_ids.assign(current->free_ids.begin() + claimed, current->free_ids.end());
+	} else {
+		next.names = std::make_shared<name_index_t>();
+		next.root_children = std::make_shared<mesh_children_t>();
+	}
+	commit.writable_chunks.resize(Size(next.chunks));
+
+	// adds first, a thread may reference a mesh another thread hasn't committed yet
+	for (auto& batch : batches) {
+		for (auto& op : batch) {
+			if (op.type == op_type_t::ADD) Apply(commit, op);
+		}
 	}
-	auto& children = pn::Get(mesh_children, mesh_id);
-	pn::PushBack(children, child_id);
+	for (auto& batch : batches) {
+		for (auto& op : batch) {
+			if (op.type != op_type_t::ADD) Apply(commit, op);
+		}
+	}
+
+	published.store(commit.next.get(), std::memory_order_seq_cst);
+	auto replaced = std::move(current);
+	current = commit.next;
+	const auto epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst);
+	if (replaced != nullptr) {
+		retired.emplace_back(epoch, std::move(replaced));
+	}
+	Reclaim();
+}
+
+mesh_resource_id_t		AddMeshResource(mesh_resource_t&& mesh) {
+	const auto new_id = AllocateId();
+	mesh.id = new_id;
+	Stage({ op_type_t::ADD, new_id, NULL_RESOURCE_ID, std::move(mesh), mesh_transform_t{} });
+	return new_id;
+}
+void					RemoveMeshResource(const mesh_resource_id_t key) {
+	Stage({ op_type_t::REMOVE, key, NULL_RESOURCE_ID, mesh_resource_t{}, mesh_transform_t{} });
 }
-void				RemoveMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id) {
-	mesh_children_t& children = pn::Get(mesh_children, mesh_id);
-	pn::Erase(children, child_id);
+bool					IsValidMesh(const mesh_resource_id_t key) {
+	return FindEntry(key) != nullptr;
 }
-mesh_children_t		GetMeshChildren(const mesh_resource_id_t mesh_id) {
-	return pn::Get(mesh_children, mesh_id);
+
+const mesh_resource_t&	GetMeshResource(const mesh_resource_id_t key) {
+	const auto* entry = GetEntry(key);
+	return (entry != nullptr) ? entry->mesh : EMPTY_MESH;
+}
+const mesh_resource_t*	FindMeshResource(const mesh_resource_id_t key) {
+	const auto* entry = FindEntry(key);
+	return (entry != nullptr) ? &entry->mesh : nullptr;
+}
+
+mesh_resource_id_t		FindMeshResourceId(const string_id_t name) {
+	auto& record = GetThreadRecord();
+	BeginRead(record);
+
+	mesh_resource_id_t result = NULL_RESOURCE_ID;
+	const auto* snapshot = published.load(std::memory_order_seq_cst);
+	if (snapshot != nullptr) {
+		// interning rejects colliding names, so the hash alone identifies the name
+		const auto it = snapshot->names->find(name);
+		if (it != snapshot->names->end()) {
+			result = it->second.front();
+		}
+	}
+
+	EndRead(record);
+	return result;
 }
+const mesh_resource_t*	FindMeshResource(const string_id_t name) {
+	return FindMeshResource(FindMeshResourceId(name));
+}
+const mesh_resource_t&	GetMeshResource(const string_id_t name) {
+	const auto* mesh = FindMeshResource(name);
+	if (mesh == nullptr) {
+		LogError("Couldn't find requested mesh in rdb: {}", StringIdName(name));
+		assert(false);
+		return EMPTY_MESH;
+	}
+	return *mesh;
+}
+
+void					AddMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform) {
+	Stage({ op_type_t::SET_TRANSFORM, mesh_id, NULL_RESOURCE_ID, mesh_resource_t{}, transform });
+}
+void					RemoveMeshTransform(const mesh_resource_id_t mesh_id) {
+	Stage({ op_type_t::RESET_TRANSFORM, mesh_id, NULL_RESOURCE_ID, mesh_resource_t{}, mesh_transform_t{} });
+}
+const mesh_transform_t&	GetMeshTransform(const mesh_resource_id_t mesh_id) {
+	const auto* entry = GetEntry(mesh_id);
+	return (entry != nullptr) ? entry->transform : EMPTY_TRANSFORM;
+}
+
+void					AddMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id) {
+	Stage({ op_type_t::ADD_CHILD, mesh_id, child_id, mesh_resource_t{}, mesh_transform_t{} });
+}
+void					RemoveMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id) {
+	Stage({ op_type_t::REMOVE_CHILD, mesh_id, child_id, mesh_resource_t{}, mesh_transform_t{} });
+}
+const mesh_children_t&	GetMeshChildren(const mesh_resource_id_t mesh_id) {
+	if (mesh_id == NULL_RESOURCE_ID) {
+		auto& record = GetThreadRecord();
+		BeginRead(record);
+		const auto* snapshot = published.load(std::memory_order_seq_cst);
+		EndRead(record);
+		return (snapshot != nullptr) ? *snapshot->root_children : EMPTY_CHILDREN;
+	}
+	const auto* entry = GetEntry(mesh_id);
+	return (entry != nullptr) ? entry->children : EMPTY_CHILDREN;
+}
+
+#pragma endregion
 
-} // namespace pn::rdb
\ No newline at end of file
+} // namespace pn::rdb
@@ -1,35 +1,73 @@
 #pragma once
 
-#include <Application\ResourceDatabaseTypes.h>
+#include <Application/ResourceDatabaseTypes.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/StringId.h>
+#include <Utilities/UtilityTypes.h>
 
-#include <Graphics\DirectX.h>
+#include <Graphics/MeshBuffer.h>
 
 namespace pn::rdb {
 
 // ----- TYPEDEFS ----------
 using mesh_resource_t	= pn::mesh_buffer_t;
 using mesh_transform_t	= pn::transform_t;
-using mesh_children_t	= pn::vector<mesh_resource_id_t>;
+using mesh_children_t	= pn::small_vector<mesh_resource_id_t, 4>;	// most meshes are leaves or have a few parts
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Any thread can add, change or remove resources. Changes are staged per thread and become
+// visible to everyone once CommitChanges merges them. Reads never lock, they go through an
+// immutable snapshot that each commit replaces.
+//
+// References returned by the getters point into a snapshot. On the main thread, which does the
+// committing, they stay valid until its next CommitChanges. Other threads have to keep a
+// read_scope_t alive for as long as they use them.
+struct read_scope_t {
+	read_scope_t();
+	~read_scope_t();
+
+	read_scope_t(const read_scope_t&)				= delete;
+	read_scope_t& operator=(const read_scope_t&)	= delete;
+};
 
 // -------- FUNCTIONS ------------
 
+// Merges every thread's staged changes and publishes them. Called by the main loop at the
+// start of every frame and by the mesh loader once a mesh is registered.
+void					CommitChanges();
+
 // ----- MESH DATA FUNCTIONS -----------
 
-mesh_resource_id_t		AddMeshResource(mesh_resource_t& mesh);
-void				RemoveMeshResource(const mesh_resource_id_t key);
-mesh_resource_t		GetMeshResource(const mesh_resource_id_t key);
-mesh_resource_t		GetMeshResource(const pn::string& name);
+// The id is usable right away by the calling thread's later Add*/Remove* calls. Getters and
+// IsValidMesh only see the mesh after the next CommitChanges.
+
+mesh_resource_id_t		AddMeshResource(mesh_resource_t&& mesh);
+void					RemoveMeshResource(const mesh_resource_id_t key);
+
+// Stale ids, and ids whose removal has been committed, are never valid again
+bool					IsValidMesh(const mesh_resource_id_t key);
+
+// Asserts on a stale id, and returns an empty mesh in release builds
+const mesh_resource_t&	GetMeshResource(const mesh_resource_id_t key);
+const mesh_resource_t*	FindMeshResource(const mesh_resource_id_t key);
+
+// Constant time through the name index, keyed by the interned name, so a lookup compares
+// integers only and literals can be hashed at compile time. If several meshes share a name, the
+// oldest one wins. GetMeshResource logs and returns an empty mesh if there's no match.
+const mesh_resource_t&	GetMeshResource(const pn::string_id_t name);
+const mesh_resource_t*	FindMeshResource(const pn::string_id_t name);
+mesh_resource_id_t		FindMeshResourceId(const pn::string_id_t name);
 
-void				AddMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform);
-void				RemoveMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform);
-mesh_transform_t	GetMeshTransform(const mesh_resource_id_t mesh_id);
+void					AddMeshTransform(const mesh_resource_id_t mesh_id, const mesh_transform_t& transform);
+void					RemoveMeshTransform(const mesh_resource_id_t mesh_id);
+const mesh_transform_t&	GetMeshTransform(const mesh_resource_id_t mesh_id);
 
-void				AddMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id);
-void				RemoveMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id);
-mesh_children_t		GetMeshChildren(const mesh_resource_id_t mesh_id);
+// NULL_RESOURCE_ID is a valid parent, its children are the roots of every loaded hierarchy
+void					AddMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id);
+void					RemoveMeshChild(const mesh_resource_id_t mesh_id, const mesh_resource_id_t child_id);
+const mesh_children_t&	GetMeshChildren(const mesh_resource_id_t mesh_id);
 
-} // namespace pn::rdb
\ No newline at end of file
+} // namespace pn::rdb
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <Utilities/SlotMap.h>
+
 namespace pn::rdb {
 
 // ----- TYPEDEFS ----------
 
-using resource_id_t			= unsigned long long;
+// Slot index + generation, a removed resource's id never resolves to a newer resource
+using resource_id_t			= pn::slot_handle_t;
 using mesh_resource_id_t	= resource_id_t;
 
-}
\ No newline at end of file
+constexpr resource_id_t		NULL_RESOURCE_ID = pn::NULL_SLOT_HANDLE;
+
+}
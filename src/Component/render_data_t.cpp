@@ -1,4 +1,4 @@
-#include <Component\render_data_t.h>
+#include <Component/render_data_t.h>
 
 namespace pn {
 
@@ -1,10 +1,8 @@
 #pragma once
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
-#include <Graphics\DirectX.h>
-
-#include <Application\ResourceDatabase.h>
+#include <Application/ResourceDatabaseTypes.h>
 
 namespace pn {
 
@@ -1,25 +1,47 @@
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
-#include <Utilities\Logging.h>
+#include <Utilities/Logging.h>
 
-#include <imgui\imgui_internal.h>
+namespace pn {
 
-#include <UI\UIUtil.h>
+// A dirty transform always has a dirty subtree (rebuilding a world matrix rebuilds the parent's first),
+// so propagation can stop at the first child that is already dirty.
+static void MarkWorldDirty(const transform_t& t) {
+	t.world_dirty = true;
+	t.inverse_dirty = true;
+	for (auto* child : t.children) {
+		if (!child->world_dirty) {
+			MarkWorldDirty(*child);
+		}
+	}
+}
 
-namespace pn {
+const pn::mat4f& LocalMatrix(const transform_t& transform) {
+	if (transform.local_dirty) {
+		transform.local_matrix = TransformToMatrix(transform);
+		transform.local_dirty = false;
+	}
+	return transform.local_matrix;
+}
 
-pn::mat4f LocalToWorldMatrix(const transform_t& transform) {
-	auto cur_srt = TransformToMatrix(transform);
-	auto* cur_parent = transform.parent;
-	while (cur_parent != nullptr) {
-		cur_srt *= TransformToMatrix(*cur_parent);
-		cur_parent = cur_parent->parent;
+const pn::mat4f& LocalToWorldMatrix(const transform_t& transform) {
+	if (transform.world_dirty) {
+		if (transform.parent != nullptr) {
+			transform.world_matrix = LocalMatrix(transform) * LocalToWorldMatrix(*transform.parent);
+		} else {
+			transform.world_matrix = LocalMatrix(transform);
+		}
+		transform.world_dirty = false;
 	}
-	return cur_srt;
+	return transform.world_matrix;
 }
 
-pn::mat4f WorldToLocalMatrix(const transform_t& transform) {
-	return Inverse(LocalToWorldMatrix(transform));
+const pn::mat4f& WorldToLocalMatrix(const transform_t& transform) {
+	if (transform.inverse_dirty || transform.world_dirty) {
+		transform.inverse_world_matrix = Inverse(LocalToWorldMatrix(transform));
+		transform.inverse_dirty = false;
+	}
+	return transform.inverse_world_matrix;
 }
 
 pn::vec3f TransformPoint(const transform_t& transform, const pn::vec3f& point) {
@@ -72,40 +94,60 @@ pn::mat4f TransformToMatrix(const transform_t& transform) {
 	return SRTMatrix(transform.scale, transform.rotation, transform.position);
 }
 
+void MarkDirty(transform_t& t) {
+	t.local_dirty = true;
+	MarkWorldDirty(t);
+}
+
+void SetPosition(transform_t& t, const vec3f& position) {
+	t.position = position;
+	MarkDirty(t);
+}
+
+void SetRotation(transform_t& t, const quaternion& rotation) {
+	t.rotation = rotation;
+	MarkDirty(t);
+}
+
+void SetScale(transform_t& t, const vec3f& scale) {
+	t.scale = scale;
+	MarkDirty(t);
+}
+
+void SetParent(transform_t& t, transform_t* parent) {
+	assert(parent != &t);
+	if (t.parent != nullptr) {
+		pn::Erase(t.parent->children, &t);
+	}
+	t.parent = parent;
+	if (parent != nullptr) {
+		pn::PushBack(parent->children, &t);
+	}
+	MarkWorldDirty(t);
+}
+
 void TranslateLocal(transform_t& t, const vec3f& translation) {
 	auto local_translation = RotateVector(translation, t.rotation);
 	t.position += local_translation;
+	MarkDirty(t);
 }
 
 void TranslateWorld(transform_t& t, const vec3f& translation) {
 	t.position += translation;
+	MarkDirty(t);
 }
 
 void RotateLocal(transform_t& t, const vec3f& axis, const float angle) {
 	auto rotation_axis = RotateVector(axis, t.rotation);
 	auto rotation = AxisAngleToQuaternion(rotation_axis, angle);
 	t.rotation *= rotation;
+	MarkDirty(t);
 }
 
 void RotateWorld(transform_t& t, const vec3f& axis, const float angle) {
 	auto rotation = AxisAngleToQuaternion(axis, angle);
 	t.rotation *= rotation;
+	MarkDirty(t);
 }
 
-namespace gui {
-
-template<>
-void EditStruct(pn::transform_t& transform) {
-	if (!pn::gui::IsGUIOn()) return;
-	DragFloat3("position", &transform.position.x, -INFINITY, INFINITY);
-	DragRotation("rotation", &transform.rotation,
-				 TransformDirection(transform, vec3f::UnitX),
-				 TransformDirection(transform, vec3f::UnitY),
-				 TransformDirection(transform, vec3f::UnitZ)
-	);
-	DragFloat3("scale", &transform.scale.x, -INFINITY, INFINITY);
-}
-
-} // namespace gui
-
 } // namespace pn
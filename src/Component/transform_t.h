@@ -1,12 +1,12 @@
 #pragma once
 
-#include <Utilities\Math.h>
-#include <Utilities\UtilityTypes.h>
-
-#include <UI\EditStruct.h>
+#include <Utilities/Math.h>
+#include <Utilities/UtilityTypes.h>
 
 namespace pn {
 
+// position, rotation and scale can be written directly, but the cached matrices only
+// notice through the mutators below or a call to MarkDirty afterwards.
 struct transform_t {
 	using transform_ref = transform_t*;
 	pn::vec3f					position	= { 0, 0, 0 };
@@ -14,10 +14,19 @@ struct transform_t {
 	pn::vec3f					scale		= { 1, 1, 1 };
 	transform_ref				parent		= nullptr;
 	pn::vector<transform_ref>	children;
+
+	// cache, rebuilt lazily by the matrix queries
+	mutable pn::mat4f			local_matrix;
+	mutable pn::mat4f			world_matrix;
+	mutable pn::mat4f			inverse_world_matrix;
+	mutable bool				local_dirty		= true;
+	mutable bool				world_dirty		= true;
+	mutable bool				inverse_dirty	= true;
 };
 
-pn::mat4f LocalToWorldMatrix(const transform_t& transform);
-pn::mat4f WorldToLocalMatrix(const transform_t& transform);
+const pn::mat4f& LocalMatrix(const transform_t& transform);
+const pn::mat4f& LocalToWorldMatrix(const transform_t& transform);
+const pn::mat4f& WorldToLocalMatrix(const transform_t& transform);
 
 pn::vec3f TransformPoint(const transform_t& transform, const pn::vec3f& point);
 pn::vec3f TransformDirection(const transform_t& transform, const pn::vec3f& direction);
@@ -37,18 +46,21 @@ pn::vec4f InverseTransformVector(const transform_t& transform, const pn::vec4f&
 
 pn::mat4f TransformToMatrix(const transform_t& transform);
 
+// Invalidates the cached matrices of t and its whole subtree
+void MarkDirty(transform_t& t);
+
+void SetPosition(transform_t& t, const vec3f& position);
+void SetRotation(transform_t& t, const quaternion& rotation);
+void SetScale(transform_t& t, const vec3f& scale);
+
+// Detaches t from its current parent, if any. Pass nullptr to make t a root.
+void SetParent(transform_t& t, transform_t* parent);
+
 void TranslateLocal(transform_t& t, const vec3f& translation);
 void TranslateWorld(transform_t& t, const vec3f& translation);
 
 void RotateLocal(transform_t& t, const vec3f& axis, const float angle);
 void RotateWorld(transform_t& t, const vec3f& axis, const float angle);
 
-namespace gui {
-
-template<>
-void EditStruct(pn::transform_t& transform);
-
-} // namespace gui
-
 } // namespace pn
 
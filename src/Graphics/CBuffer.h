@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Graphics\DirectX.h>
+#include <Graphics/DirectX.h>
 
 namespace pn {
 
@@ -21,12 +21,12 @@ struct cbuffer {
 // ------- FUNCTIONS ------------
 
 template<typename T>
-void SetProgramConstant(const pn::string& buffer_name, const cbuffer<T>& cbuffer) {
+void SetProgramConstant(const pn::string_id_t buffer_name, const cbuffer<T>& cbuffer) {
 	SetProgramConstant(buffer_name, cbuffer.buffer);
 }
 
 template<typename T, int N>
-void SetProgramConstant(const pn::string& buffer_name, const cbuffer_array<T, N>& cbuffer) {
+void SetProgramConstant(const pn::string_id_t buffer_name, const cbuffer_array<T, N>& cbuffer) {
 	SetProgramConstant(buffer_name, cbuffer.buffer);
 }
 
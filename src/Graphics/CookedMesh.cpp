@@ -0,0 +1,257 @@
+#include <Graphics/CookedMesh.h>
+
+#include <Utilities/Logging.h>
+
+#include <cstring>
+
+namespace pn {
+
+#pragma region Internal
+
+static uint64_t AlignUp(const uint64_t offset) {
+	return (offset + COOKED_MESH_ALIGNMENT - 1) & ~uint64_t(COOKED_MESH_ALIGNMENT - 1);
+}
+
+template<typename T>
+static void PutStream(pn::bytes& file, uint64_t& offset, cooked_stream_t& stream, const pn::vector<T>& data) {
+	stream.element_size = sizeof(T);
+	stream.count = static_cast<uint32_t>(Size(data));
+	stream.offset = 0;
+	if (data.empty()) return;
+
+	offset = AlignUp(offset);
+	stream.offset = offset;
+	std::memcpy(file.data() + offset, data.data(), Size(data) * sizeof(T));
+	offset += Size(data) * sizeof(T);
+}
+
+static uint64_t StreamBytes(const cooked_submesh_source_t& mesh) {
+	uint64_t size = 0;
+	auto add = [&size](const size_t count, const size_t element_size) {
+		if (count > 0) size = AlignUp(size) + count * element_size;
+	};
+	add(Size(mesh.vertices), sizeof(pn::vec3f));
+	add(Size(mesh.normals), sizeof(pn::vec3f));
+	add(Size(mesh.tangents), sizeof(pn::vec3f));
+	add(Size(mesh.bitangents), sizeof(pn::vec3f));
+	add(Size(mesh.colors), sizeof(pn::vec4f));
+	add(Size(mesh.uvs), sizeof(pn::vec2f));
+	add(Size(mesh.uv2s), sizeof(pn::vec2f));
+	add(Size(mesh.indices), sizeof(uint32_t));
+	return size + COOKED_MESH_ALIGNMENT;
+}
+
+// The size GetStream reads each stream's elements as, in mesh_stream_t order
+static const uint32_t STREAM_ELEMENT_SIZES[static_cast<size_t>(mesh_stream_t::COUNT)] = {
+	sizeof(pn::vec3f),
+	sizeof(pn::vec3f),
+	sizeof(pn::vec3f),
+	sizeof(pn::vec3f),
+	sizeof(pn::vec4f),
+	sizeof(pn::vec2f),
+	sizeof(pn::vec2f),
+	sizeof(uint32_t),
+};
+
+static bool InBounds(const cooked_mesh_view_t& view, const uint64_t offset, const uint64_t count, const uint64_t element_size) {
+	return offset <= view.size && count <= (view.size - offset) / element_size;
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+pn::bytes							WriteCookedMesh(const cooked_mesh_source_t& source) {
+	cooked_mesh_header_t header{};
+	header.magic			= COOKED_MESH_MAGIC;
+	header.version			= COOKED_MESH_VERSION;
+	header.load_flags		= source.load_flags;
+	header.mesh_count		= static_cast<uint32_t>(Size(source.meshes));
+	header.node_count		= static_cast<uint32_t>(Size(source.nodes));
+	header.node_mesh_count	= static_cast<uint32_t>(Size(source.node_meshes));
+
+	uint64_t offset = sizeof(cooked_mesh_header_t);
+	header.mesh_table_offset = offset = AlignUp(offset);
+	offset += Size(source.meshes) * sizeof(cooked_submesh_t);
+	header.node_table_offset = offset = AlignUp(offset);
+	offset += Size(source.nodes) * sizeof(cooked_node_t);
+	header.node_mesh_offset = offset = AlignUp(offset);
+	offset += Size(source.node_meshes) * sizeof(uint32_t);
+	header.name_offset = offset;
+
+	pn::vector<cooked_submesh_t> table(Size(source.meshes));
+	uint64_t data_size = 0;
+	for (size_t i = 0; i < Size(source.meshes); ++i) {
+		const auto& mesh = source.meshes[i];
+		table[i].topology = mesh.topology;
+		table[i].name_offset = static_cast<uint32_t>(offset - header.name_offset);
+		table[i].name_length = static_cast<uint32_t>(Size(mesh.name));
+		offset += Size(mesh.name);
+		data_size += StreamBytes(mesh);
+	}
+
+	// sized for the worst case padding, trimmed to file_size at the end
+	pn::bytes file(offset + data_size + COOKED_MESH_ALIGNMENT, 0);
+	for (size_t i = 0; i < Size(source.meshes); ++i) {
+		const auto& mesh = source.meshes[i];
+		auto& streams = table[i].streams;
+		std::memcpy(file.data() + header.name_offset + table[i].name_offset, mesh.name.data(), Size(mesh.name));
+
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::VERTICES)], mesh.vertices);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::NORMALS)], mesh.normals);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::TANGENTS)], mesh.tangents);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::BITANGENTS)], mesh.bitangents);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::COLORS)], mesh.colors);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::UVS)], mesh.uvs);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::UV2S)], mesh.uv2s);
+		PutStream(file, offset, streams[static_cast<size_t>(mesh_stream_t::INDICES)], mesh.indices);
+	}
+	header.file_size = offset;
+	Resize(file, offset);
+
+	std::memcpy(file.data(), &header, sizeof(header));
+	if (!table.empty()) {
+		std::memcpy(file.data() + header.mesh_table_offset, table.data(), Size(table) * sizeof(cooked_submesh_t));
+	}
+	if (!source.nodes.empty()) {
+		std::memcpy(file.data() + header.node_table_offset, source.nodes.data(), Size(source.nodes) * sizeof(cooked_node_t));
+	}
+	if (!source.node_meshes.empty()) {
+		std::memcpy(file.data() + header.node_mesh_offset, source.node_meshes.data(), Size(source.node_meshes) * sizeof(uint32_t));
+	}
+
+	return file;
+}
+
+bool								OpenCookedMesh(const char* data, const size_t size, cooked_mesh_view_t& view) {
+	view = cooked_mesh_view_t{};
+	if (data == nullptr || size < sizeof(cooked_mesh_header_t)) {
+		LogError("Cooked mesh: file too small ({} bytes)", size);
+		return false;
+	}
+	if (reinterpret_cast<uintptr_t>(data) % COOKED_MESH_ALIGNMENT != 0) {
+		LogError("Cooked mesh: data must be {}-byte aligned", COOKED_MESH_ALIGNMENT);
+		return false;
+	}
+
+	const auto* header = reinterpret_cast<const cooked_mesh_header_t*>(data);
+	if (header->magic != COOKED_MESH_MAGIC) {
+		LogError("Cooked mesh: bad magic {:#x}", header->magic);
+		return false;
+	}
+	if (header->version != COOKED_MESH_VERSION) {
+		LogError("Cooked mesh: version {} isn't supported, expected {}", header->version, COOKED_MESH_VERSION);
+		return false;
+	}
+	if (header->file_size != size) {
+		LogError("Cooked mesh: header says {} bytes, file has {}", header->file_size, size);
+		return false;
+	}
+
+	cooked_mesh_view_t candidate{ data, size, header };
+	if ((header->mesh_table_offset | header->node_table_offset | header->node_mesh_offset) % COOKED_MESH_ALIGNMENT != 0
+		|| !InBounds(candidate, header->mesh_table_offset, header->mesh_count, sizeof(cooked_submesh_t))
+		|| !InBounds(candidate, header->node_table_offset, header->node_count, sizeof(cooked_node_t))
+		|| !InBounds(candidate, header->node_mesh_offset, header->node_mesh_count, sizeof(uint32_t))
+		|| header->name_offset > size) {
+		LogError("Cooked mesh: tables out of bounds");
+		return false;
+	}
+
+	for (const auto& mesh : GetMeshes(candidate)) {
+		if (!InBounds(candidate, header->name_offset + mesh.name_offset, mesh.name_length, 1)) {
+			LogError("Cooked mesh: name out of bounds");
+			return false;
+		}
+		for (size_t i = 0; i < static_cast<size_t>(mesh_stream_t::COUNT); ++i) {
+			const auto& stream = mesh.streams[i];
+			if (stream.count == 0) continue;
+			if (stream.element_size != STREAM_ELEMENT_SIZES[i]) {
+				LogError("Cooked mesh: stream {} has {}-byte elements, expected {}", i, stream.element_size, STREAM_ELEMENT_SIZES[i]);
+				return false;
+			}
+			if (stream.offset % COOKED_MESH_ALIGNMENT != 0
+				|| !InBounds(candidate, stream.offset, stream.count, stream.element_size)) {
+				LogError("Cooked mesh: stream out of bounds");
+				return false;
+			}
+		}
+	}
+
+	const auto nodes = GetNodes(candidate);
+	for (size_t i = 0; i < Size(nodes); ++i) {
+		const auto& node = nodes[i];
+		if (node.parent >= static_cast<int32_t>(i) || (node.parent < 0 && i > 0)) {
+			LogError("Cooked mesh: node {} has parent {}", i, node.parent);
+			return false;
+		}
+		if (node.first_mesh > header->node_mesh_count || node.mesh_count > header->node_mesh_count - node.first_mesh) {
+			LogError("Cooked mesh: node mesh range out of bounds");
+			return false;
+		}
+	}
+	for (const auto mesh_index : pn::span<const uint32_t>(reinterpret_cast<const uint32_t*>(data + header->node_mesh_offset), header->node_mesh_count)) {
+		if (mesh_index >= header->mesh_count) {
+			LogError("Cooked mesh: node references mesh {} of {}", mesh_index, header->mesh_count);
+			return false;
+		}
+	}
+
+	view = candidate;
+	return true;
+}
+
+pn::span<const cooked_submesh_t>	GetMeshes(const cooked_mesh_view_t& view) {
+	return pn::span<const cooked_submesh_t>(
+		reinterpret_cast<const cooked_submesh_t*>(view.data + view.header->mesh_table_offset),
+		view.header->mesh_count
+	);
+}
+
+pn::span<const cooked_node_t>		GetNodes(const cooked_mesh_view_t& view) {
+	return pn::span<const cooked_node_t>(
+		reinterpret_cast<const cooked_node_t*>(view.data + view.header->node_table_offset),
+		view.header->node_count
+	);
+}
+
+pn::span<const uint32_t>			GetNodeMeshes(const cooked_mesh_view_t& view, const cooked_node_t& node) {
+	const auto* node_meshes = reinterpret_cast<const uint32_t*>(view.data + view.header->node_mesh_offset);
+	return pn::span<const uint32_t>(node_meshes + node.first_mesh, node.mesh_count);
+}
+
+pn::string							GetMeshName(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh) {
+	return pn::string(view.data + view.header->name_offset + mesh.name_offset, mesh.name_length);
+}
+
+transform_t							GetNodeTransform(const cooked_node_t& node) {
+	transform_t transform;
+	transform.position	= vec3f(node.position[0], node.position[1], node.position[2]);
+	transform.rotation	= quaternion(node.rotation[0], node.rotation[1], node.rotation[2], node.rotation[3]);
+	transform.scale		= vec3f(node.scale[0], node.scale[1], node.scale[2]);
+	return transform;
+}
+
+void								SetNodeTransform(cooked_node_t& node, const transform_t& transform) {
+	node.position[0] = transform.position.x;
+	node.position[1] = transform.position.y;
+	node.position[2] = transform.position.z;
+	node.rotation[0] = transform.rotation.x;
+	node.rotation[1] = transform.rotation.y;
+	node.rotation[2] = transform.rotation.z;
+	node.rotation[3] = transform.rotation.w;
+	node.scale[0] = transform.scale.x;
+	node.scale[1] = transform.scale.y;
+	node.scale[2] = transform.scale.z;
+}
+
+pn::string							CookedMeshPath(const pn::string& source_path) {
+	const auto dot = source_path.find_last_of('.');
+	const auto slash = source_path.find_last_of("\\/");
+	const bool has_extension = dot != pn::string::npos && (slash == pn::string::npos || dot > slash);
+	return (has_extension ? source_path.substr(0, dot) : source_path) + "." + COOKED_MESH_EXTENSION;
+}
+
+#pragma endregion
+
+} // namespace pn
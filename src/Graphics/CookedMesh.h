@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Component/transform_t.h>
+
+#include <Utilities/Math.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <cstdint>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr uint32_t		COOKED_MESH_MAGIC		= 0x48534D50; // "PMSH"
+constexpr uint32_t		COOKED_MESH_VERSION		= 1;
+
+// every stream starts on this boundary so the loader can point straight into the file
+constexpr uint32_t		COOKED_MESH_ALIGNMENT	= 16;
+
+constexpr const char*	COOKED_MESH_EXTENSION	= "pnmesh";
+
+// same value as D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST, the format itself doesn't depend on D3D
+constexpr uint32_t		COOKED_TOPOLOGY_TRIANGLE_LIST = 4;
+
+// ----- TYPEDEFS ----------
+
+enum class mesh_stream_t : uint32_t {
+	VERTICES,		// vec3f
+	NORMALS,		// vec3f
+	TANGENTS,		// vec3f
+	BITANGENTS,		// vec3f
+	COLORS,			// vec4f
+	UVS,			// vec2f
+	UV2S,			// vec2f
+	INDICES,		// uint32
+	COUNT
+};
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// File layout, all offsets are from the start of the file:
+//   header | mesh table | node table | node mesh indices | names | stream data
+struct cooked_mesh_header_t {
+	uint32_t	magic;
+	uint32_t	version;
+	uint64_t	file_size;
+	uint32_t	load_flags;			// importer flags the file was cooked with
+	uint32_t	mesh_count;
+	uint32_t	node_count;
+	uint32_t	node_mesh_count;
+	uint64_t	mesh_table_offset;
+	uint64_t	node_table_offset;
+	uint64_t	node_mesh_offset;
+	uint64_t	name_offset;
+};
+
+struct cooked_stream_t {
+	uint64_t	offset;
+	uint32_t	count;				// 0 if the mesh doesn't have the stream
+	uint32_t	element_size;
+};
+
+struct cooked_submesh_t {
+	cooked_stream_t	streams[static_cast<size_t>(mesh_stream_t::COUNT)];
+	uint32_t		topology;
+	uint32_t		name_offset;	// from the start of the names
+	uint32_t		name_length;
+	uint32_t		padding;
+};
+
+// Nodes are stored depth first, a parent always comes before its children
+struct cooked_node_t {
+	float		position[3];
+	float		rotation[4];		// x, y, z, w
+	float		scale[3];
+	int32_t		parent;				// -1 for the root
+	uint32_t	first_mesh;			// into the node mesh indices
+	uint32_t	mesh_count;
+};
+
+// One mesh of a cooked_mesh_source_t, owns its streams
+struct cooked_submesh_source_t {
+	pn::vector<pn::vec3f>		vertices;
+	pn::vector<pn::vec3f>		normals;
+	pn::vector<pn::vec3f>		tangents;
+	pn::vector<pn::vec3f>		bitangents;
+	pn::vector<pn::vec4f>		colors;
+	pn::vector<pn::vec2f>		uvs;
+	pn::vector<pn::vec2f>		uv2s;
+	pn::vector<uint32_t>		indices;
+	uint32_t					topology = COOKED_TOPOLOGY_TRIANGLE_LIST;
+	pn::string					name;
+};
+
+// Everything WriteCookedMesh needs, in the same shape the file stores it
+struct cooked_mesh_source_t {
+	pn::vector<cooked_submesh_source_t>	meshes;
+	pn::vector<cooked_node_t>			nodes;
+	pn::vector<uint32_t>				node_meshes;
+	uint32_t							load_flags = 0;
+};
+
+// Read-only view over a cooked file in memory. Doesn't own the data.
+struct cooked_mesh_view_t {
+	const char*					data	= nullptr;
+	size_t						size	= 0;
+	const cooked_mesh_header_t*	header	= nullptr;
+};
+
+// -------- FUNCTIONS ------------
+
+pn::bytes							WriteCookedMesh(const cooked_mesh_source_t& source);
+
+// Checks the header, the table bounds and every stream against size. The data has to stay alive,
+// and aligned to COOKED_MESH_ALIGNMENT, for as long as the view is used.
+bool								OpenCookedMesh(const char* data, const size_t size, cooked_mesh_view_t& view);
+
+pn::span<const cooked_submesh_t>	GetMeshes(const cooked_mesh_view_t& view);
+pn::span<const cooked_node_t>		GetNodes(const cooked_mesh_view_t& view);
+pn::span<const uint32_t>			GetNodeMeshes(const cooked_mesh_view_t& view, const cooked_node_t& node);
+pn::string							GetMeshName(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh);
+
+transform_t							GetNodeTransform(const cooked_node_t& node);
+void								SetNodeTransform(cooked_node_t& node, const transform_t& transform);
+
+// Source path with its extension replaced by COOKED_MESH_EXTENSION
+pn::string							CookedMeshPath(const pn::string& source_path);
+
+template<typename T>
+pn::span<const T>					GetStream(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh, const mesh_stream_t stream) {
+	const auto& s = mesh.streams[static_cast<size_t>(stream)];
+	assert(s.count == 0 || s.element_size == sizeof(T));
+	return pn::span<const T>(reinterpret_cast<const T*>(view.data + s.offset), s.count);
+}
+
+} // namespace pn
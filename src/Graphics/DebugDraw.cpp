@@ -1,8 +1,8 @@
-#include <Graphics\DebugDraw.h>
-#include <Graphics\DirectX.h>
-#include <Graphics\RenderSystem.h>
+#include <Graphics/DebugDraw.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/RenderSystem.h>
 
-#include <IO\PathUtil.h>
+#include <IO/PathUtil.h>
 
 namespace pn::debug {
 
@@ -31,9 +31,9 @@ void DrawLine(vec3f origin, vec3f direction, float length, vec4f color) {
 	auto line_mesh_buffer = CreateMeshBuffer(line);
 
 	SetShaderProgram(debug_draw_shader);
-	SetProgramConstant("global_constants", global_constants);
-	SetProgramConstant("camera_constants", camera_constants);
-	SetProgramConstant("options", options);
+	SetProgramConstant(GLOBAL_CONSTANTS_NAME, global_constants);
+	SetProgramConstant(CAMERA_CONSTANTS_NAME, camera_constants);
+	SetProgramConstant("options"_id, options);
 
 	options.data.color = color;
 	UpdateBuffer(options);
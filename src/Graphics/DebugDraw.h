@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Utilities\Math.h>
+#include <Utilities/Math.h>
 
 namespace pn {
 
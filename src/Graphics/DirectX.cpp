@@ -1,12 +1,17 @@
-#include <Graphics\DirectX.h>
+#include <Graphics/DirectX.h>
+#include <Graphics/CookedMesh.h>
+#include <Graphics/MeshBuffer.h>
 
 #include <functional>
 #include <memory>
 
 #include <d3dcompiler.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/AssetCache.h>
+#include <IO/FileUtil.h>
+#include <IO/PathUtil.h>
+
+#include <Utilities/Hash.h>
 
 using namespace std::placeholders;
 
@@ -284,6 +289,55 @@ mesh_buffer_t			CreateMeshBuffer(const mesh_t& mesh) {
 	return mesh_buffer;
 }
 
+// Buffers are filled straight from the cooked streams, there's no intermediate mesh_t
+mesh_buffer_t			CreateMeshBuffer(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh) {
+	mesh_buffer_t mesh_buffer;
+
+	const auto vertices = GetStream<vec3f>(view, mesh, mesh_stream_t::VERTICES);
+	if (vertices.empty()) {
+		LogError("Mesh has no vertices");
+		return mesh_buffer;
+	}
+
+	mesh_buffer.name		= GetMeshName(view, mesh);
+	mesh_buffer.vertices	= CreateVertexBuffer(vertices.data(), vertices.size());
+	const auto indices = GetStream<uint32_t>(view, mesh, mesh_stream_t::INDICES);
+	if (!indices.empty()) {
+		mesh_buffer.indices		= CreateIndexBuffer(indices.data(), indices.size());
+		mesh_buffer.index_count = static_cast<unsigned int>(indices.size());
+	}
+	mesh_buffer.topology	= static_cast<D3D_PRIMITIVE_TOPOLOGY>(mesh.topology);
+
+	const auto normals = GetStream<vec3f>(view, mesh, mesh_stream_t::NORMALS);
+	if (!normals.empty()) {
+		mesh_buffer.normals		= CreateVertexBuffer(normals.data(), normals.size());
+	}
+
+	const auto tangents = GetStream<vec3f>(view, mesh, mesh_stream_t::TANGENTS);
+	const auto bitangents = GetStream<vec3f>(view, mesh, mesh_stream_t::BITANGENTS);
+	if (!tangents.empty()) {
+		mesh_buffer.tangents	= CreateVertexBuffer(tangents.data(), tangents.size());
+		mesh_buffer.bitangents	= CreateVertexBuffer(bitangents.data(), bitangents.size());
+	}
+
+	const auto colors = GetStream<vec4f>(view, mesh, mesh_stream_t::COLORS);
+	if (!colors.empty()) {
+		mesh_buffer.colors		= CreateVertexBuffer(colors.data(), colors.size());
+	}
+
+	const auto uvs = GetStream<vec2f>(view, mesh, mesh_stream_t::UVS);
+	if (!uvs.empty()) {
+		mesh_buffer.uvs			= CreateVertexBuffer(uvs.data(), uvs.size());
+	}
+
+	const auto uv2s = GetStream<vec2f>(view, mesh, mesh_stream_t::UV2S);
+	if (!uv2s.empty()) {
+		mesh_buffer.uv2s		= CreateVertexBuffer(uv2s.data(), uv2s.size());
+	}
+
+	return mesh_buffer;
+}
+
 vector<mesh_buffer_t>	CreateMeshBuffer(dx_device device, const pn::vector<mesh_t>& meshs) {
 	pn::vector<mesh_buffer_t> mesh_buffers;
 	for (const auto& mesh : meshs) {
@@ -304,12 +358,64 @@ dx_resource_view        CreateShaderResourceView(dx_resource resource, const D3D
 
 // -------------- SHADER CREATION -------------
 
+// Hash of the source and, recursively, of every file it pulls in with #include "...". Includes are
+// resolved relative to the including file, the same way D3D_COMPILE_STANDARD_FILE_INCLUDE does.
+uint64_t HashShaderSource(const pn::string& filename, pn::vector<pn::string>& visited) {
+	if (std::find(visited.begin(), visited.end(), filename) != visited.end()) {
+		return 0;
+	}
+	PushBack(visited, filename);
+
+	const auto source = pn::ReadFile(filename);
+	uint64_t hash = Hash64(source);
+
+	const auto slash = filename.find_last_of("\\/");
+	const pn::string directory = (slash == pn::string::npos) ? "" : filename.substr(0, slash + 1);
+	const pn::string text(source.begin(), source.end());
+	const pn::string INCLUDE = "#include";
+	for (auto pos = text.find(INCLUDE); pos != pn::string::npos; pos = text.find(INCLUDE, pos + 1)) {
+		const auto open = text.find_first_not_of(" \t", pos + INCLUDE.size());
+		if (open == pn::string::npos || text[open] != '"') continue;
+		const auto close = text.find('"', open + 1);
+		if (close == pn::string::npos) break;
+		hash = HashCombine(hash, HashShaderSource(directory + text.substr(open + 1, close - open - 1), visited));
+	}
+	return hash;
+}
+
+asset_key_t ShaderCacheKey(
+	const pn::string& filename,
+	const D3D_SHADER_MACRO* defines,
+	const pn::string& entry_point,
+	const pn::string& shader_type,
+	unsigned int flags) {
+	pn::vector<pn::string> visited;
+	const uint64_t source_hash = HashShaderSource(filename, visited);
+
+	uint64_t options_hash = HashCombine(Hash64(entry_point), Hash64(shader_type));
+	options_hash = HashCombine(options_hash, flags);
+	for (auto* define = defines; define != nullptr && define->Name != nullptr; ++define) {
+		options_hash = HashCombine(options_hash, Hash64(pn::string(define->Name)));
+		options_hash = HashCombine(options_hash, Hash64(pn::string(define->Definition ? define->Definition : "")));
+	}
+	return MakeAssetKey("cso", source_hash, options_hash);
+}
+
 pn::bytes CompileShader(
 	const pn::string& filename,
 	const D3D_SHADER_MACRO* defines,
 	const pn::string& entry_point,
 	const pn::string& shader_type,
 	unsigned int flags) {
+	asset_key_t cache_key;
+	if (IsAssetCacheEnabled()) {
+		cache_key = ShaderCacheKey(filename, defines, entry_point, shader_type, flags);
+		pn::bytes cached_bytes;
+		if (ReadCachedAsset(cache_key, cached_bytes)) {
+			return cached_bytes;
+		}
+	}
+
 	pn::wstring wfilename(filename.size(), L'#');
 	mbstowcs(wfilename.data(), filename.c_str(), filename.size());
 	ID3DBlob* byte_code = nullptr;
@@ -333,6 +439,7 @@ pn::bytes CompileShader(
 	if (byte_code != nullptr) {
 		return_bytes.resize(byte_code->GetBufferSize());
 		memcpy(return_bytes.data(), byte_code->GetBufferPointer(), byte_code->GetBufferSize());
+		StoreCachedAsset(cache_key, return_bytes);
 	}
 	return return_bytes;
 }
@@ -344,10 +451,12 @@ shader_program_t		CompileShaderProgram(const pn::string& filename, const D3D_SHA
 	program.vertex_shader_data.shader		= pn::CreateVertexShader(vs_byte_code);
 	program.input_layout_data				= pn::CreateInputLayout(vs_byte_code);
 	program.vertex_shader_data.reflection	= pn::GetShaderReflector(vs_byte_code);
+	program.vertex_shader_data.bindings		= pn::GetShaderBindings(program.vertex_shader_data.reflection);
 
 	auto ps_byte_code						= pn::CompilePixelShader(filename, defines, flags);
 	program.pixel_shader_data.shader		= pn::CreatePixelShader(ps_byte_code);
 	program.pixel_shader_data.reflection	= pn::GetShaderReflector(ps_byte_code);
+	program.pixel_shader_data.bindings		= pn::GetShaderBindings(program.pixel_shader_data.reflection);
 
 	return program;
 }
@@ -395,6 +504,13 @@ input_layout_data_t CreateInputLayout(const pn::bytes& vs_byte_code, const verte
 	}
 
 	auto layout = input_layout_data_t(ptr, desc);
+	for (const auto& element : desc) {
+		const auto stream = GetVertexStream(element.SemanticName, element.SemanticIndex);
+		if (stream == vertex_stream_t::UNKNOWN) {
+			LogError("Input element {}{} has no mesh stream, it won't be bound", element.SemanticName, element.SemanticIndex);
+		}
+		PushBack(layout.streams, stream);
+	}
 	return layout;
 }
 
@@ -529,6 +645,51 @@ unsigned int					GetShaderResourceStartSlot(dx_shader_reflection reflector, cons
 	return binding_desc.BindPoint;
 }
 
+shader_bindings_t				GetShaderBindings(dx_shader_reflection reflector) {
+	shader_bindings_t bindings;
+	D3D11_SHADER_DESC shader_desc;
+	if (FAILED(reflector->GetDesc(&shader_desc))) {
+		LogError("Couldn't get shader description from reflector");
+		return bindings;
+	}
+
+	Reserve(bindings, shader_desc.BoundResources);
+	for (unsigned int i = 0; i < shader_desc.BoundResources; ++i) {
+		D3D11_SHADER_INPUT_BIND_DESC binding_desc;
+		if (FAILED(reflector->GetResourceBindingDesc(i, &binding_desc))) {
+			LogError("Couldn't get resource binding description {} from reflector", i);
+			continue;
+		}
+		PushBack(bindings, shader_binding_t{ InternString(binding_desc.Name), binding_desc.BindPoint });
+	}
+	return bindings;
+}
+
+unsigned int					GetShaderResourceStartSlot(const shader_bindings_t& bindings, const string_id_t name) {
+	// a handful of bindings per shader, a scan beats hashing
+	for (const auto& binding : bindings) {
+		if (binding.name == name) return binding.slot;
+	}
+	return 0;
+}
+
+vertex_stream_t					GetVertexStream(const char* semantic_name, const unsigned int semantic_index) {
+	switch (HashStringId(semantic_name)) {
+	case "POSITION"_id.Hash():	return vertex_stream_t::VERTICES;
+	case "NORMAL"_id.Hash():	return vertex_stream_t::NORMALS;
+	case "COLOR"_id.Hash():		return vertex_stream_t::COLORS;
+	case "TEXCOORD"_id.Hash():
+		if (semantic_index == 0) return vertex_stream_t::UVS;
+		if (semantic_index == 1) return vertex_stream_t::UV2S;
+		break;
+	case "TANGENT"_id.Hash():
+		if (semantic_index == 0) return vertex_stream_t::TANGENTS;
+		if (semantic_index == 1) return vertex_stream_t::BITANGENTS;
+		break;
+	}
+	return vertex_stream_t::UNKNOWN;
+}
+
 // --------- VIEWPORT --------------
 
 void SetViewport(const int width, const int height, const int top_left_x, const int top_left_y) {
@@ -617,52 +778,52 @@ void SetInputLayout(const input_layout_data_t& layout_desc) {
 	_context->IASetInputLayout(layout_desc.ptr.Get());
 }
 
-void SetVSConstant(dx_shader_reflection reflection, const pn::string& buffer_name, const dx_buffer& buffer) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, buffer_name);
+void SetVSConstant(const shader_bindings_t& bindings, const string_id_t buffer_name, const dx_buffer& buffer) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, buffer_name);
 	if (start_slot == 0) return;
 	_context->VSSetConstantBuffers(start_slot, 1, buffer.GetAddressOf());
 }
-void SetPSConstant(dx_shader_reflection reflection, const pn::string& buffer_name, const dx_buffer& buffer) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, buffer_name);
+void SetPSConstant(const shader_bindings_t& bindings, const string_id_t buffer_name, const dx_buffer& buffer) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, buffer_name);
 	if (start_slot == 0) return;
 	_context->PSSetConstantBuffers(start_slot, 1, buffer.GetAddressOf());
 }
-void SetProgramConstant(const shader_program_t& program, const pn::string& buffer_name, const dx_buffer& buffer) {
-	SetVSConstant(program.vertex_shader_data.reflection, buffer_name, buffer);
-	SetPSConstant(program.pixel_shader_data.reflection, buffer_name, buffer);
+void SetProgramConstant(const shader_program_t& program, const string_id_t buffer_name, const dx_buffer& buffer) {
+	SetVSConstant(program.vertex_shader_data.bindings, buffer_name, buffer);
+	SetPSConstant(program.pixel_shader_data.bindings, buffer_name, buffer);
 }
 
-void SetVSShaderResource(dx_shader_reflection reflection, const pn::string& resource_name, dx_resource_view& resource_view) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, resource_name);
+void SetVSShaderResource(const shader_bindings_t& bindings, const string_id_t resource_name, dx_resource_view& resource_view) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, resource_name);
 	if (start_slot == 0) return;
 	_context->VSSetShaderResources(start_slot, 1, resource_view.GetAddressOf());
 }
 
-void SetPSShaderResource(dx_shader_reflection reflection, const pn::string& resource_name, dx_resource_view& resource_view) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, resource_name);
+void SetPSShaderResource(const shader_bindings_t& bindings, const string_id_t resource_name, dx_resource_view& resource_view) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, resource_name);
 	if (start_slot == 0) return;
 	_context->PSSetShaderResources(start_slot, 1, resource_view.GetAddressOf());
 }
 
-void SetProgramResource(const shader_program_t& program, const pn::string& resource_name, dx_resource_view& resource_view) {
-	SetVSShaderResource(program.vertex_shader_data.reflection, resource_name, resource_view);
-	SetPSShaderResource(program.pixel_shader_data.reflection, resource_name, resource_view);
+void SetProgramResource(const shader_program_t& program, const string_id_t resource_name, dx_resource_view& resource_view) {
+	SetVSShaderResource(program.vertex_shader_data.bindings, resource_name, resource_view);
+	SetPSShaderResource(program.pixel_shader_data.bindings, resource_name, resource_view);
 }
 
 
-void SetVSSampler(dx_shader_reflection reflection, const pn::string& sampler_name, dx_sampler_state& sampler_state) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, sampler_name);
+void SetVSSampler(const shader_bindings_t& bindings, const string_id_t sampler_name, dx_sampler_state& sampler_state) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, sampler_name);
 	if (start_slot == 0) return;
 	_context->VSSetSamplers(start_slot, 1, sampler_state.GetAddressOf());
 }
-void SetPSSampler(dx_shader_reflection reflection, const pn::string& sampler_name, dx_sampler_state& sampler_state) {
-	unsigned int start_slot = GetShaderResourceStartSlot(reflection, sampler_name);
+void SetPSSampler(const shader_bindings_t& bindings, const string_id_t sampler_name, dx_sampler_state& sampler_state) {
+	unsigned int start_slot = GetShaderResourceStartSlot(bindings, sampler_name);
 	if (start_slot == 0) return;
 	_context->PSSetSamplers(start_slot, 1, sampler_state.GetAddressOf());
 }
-void SetProgramSampler(const shader_program_t& program, const pn::string& sampler_name, dx_sampler_state& sampler_state) {
-	SetVSSampler(program.vertex_shader_data.reflection, sampler_name, sampler_state);
-	SetPSSampler(program.pixel_shader_data.reflection, sampler_name, sampler_state);
+void SetProgramSampler(const shader_program_t& program, const string_id_t sampler_name, dx_sampler_state& sampler_state) {
+	SetVSSampler(program.vertex_shader_data.bindings, sampler_name, sampler_state);
+	SetPSSampler(program.pixel_shader_data.bindings, sampler_name, sampler_state);
 }
 
 
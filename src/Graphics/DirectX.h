@@ -7,14 +7,15 @@
 
 #include <wrl.h> // ComPtr
 
-#include <Application\ResourceDatabaseTypes.h>
+#include <Application/ResourceDatabaseTypes.h>
 
-#include <Graphics\Window.h>
-#include <Graphics\ProjectionMatrix.h>
+#include <Graphics/Window.h>
+#include <Graphics/ProjectionMatrix.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\Math.h>
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/Logging.h>
+#include <Utilities/Math.h>
+#include <Utilities/StringId.h>
+#include <Utilities/UtilityTypes.h>
 
 
 namespace pn {
@@ -127,6 +128,18 @@ struct input_element_desc {
 	}
 };
 
+// The mesh_buffer_t stream that feeds an input element
+enum class vertex_stream_t : uint8_t {
+	VERTICES,
+	NORMALS,
+	TANGENTS,
+	BITANGENTS,
+	COLORS,
+	UVS,
+	UV2S,
+	UNKNOWN
+};
+
 struct input_layout_data_t {
 	input_layout_data_t() : ptr(nullptr), desc() {}
 	input_layout_data_t(dx_input_layout ptr, vertex_input_desc desc) :
@@ -134,8 +147,19 @@ struct input_layout_data_t {
 
 	dx_input_layout ptr;
 	vertex_input_desc desc;
+	// one per element of desc, resolved from the semantics once. A layout can't have more
+	// elements than the input assembler has slots.
+	pn::fixed_vector<vertex_stream_t, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> streams;
+};
+
+// Where a shader expects a named cbuffer, texture or sampler
+struct shader_binding_t {
+	pn::string_id_t	name;
+	unsigned int	slot;
 };
 
+using shader_bindings_t = pn::vector<shader_binding_t>;
+
 struct mesh_t {
 	pn::vector<pn::vec3f>		vertices;
 	pn::vector<pn::vec4f>		colors;
@@ -179,6 +203,7 @@ template<typename DxShaderPtrT>
 struct shader_data_t {
 	DxShaderPtrT			shader;
 	dx_shader_reflection	reflection;
+	shader_bindings_t		bindings;	// read from the reflection once, so binding by name needs no lookup through it
 };
 
 struct shader_program_t {
@@ -361,6 +386,14 @@ D3D11_SHADER_INPUT_BIND_DESC	GetResourceBindingDesc(dx_shader_reflection reflect
 
 unsigned int					GetShaderResourceStartSlot(dx_shader_reflection reflector, const pn::string& name);
 
+// Every resource the shader binds, with the names interned
+shader_bindings_t				GetShaderBindings(dx_shader_reflection reflector);
+
+// 0 if the shader doesn't use name, like the reflection lookup
+unsigned int					GetShaderResourceStartSlot(const shader_bindings_t& bindings, const pn::string_id_t name);
+
+vertex_stream_t					GetVertexStream(const char* semantic_name, const unsigned int semantic_index);
+
 // ----------- VIEWPORT -----------------------
 
 void SetViewport(const int width, const int height, const int top_left_x = 0, const int top_left_y = 0);
@@ -396,17 +429,17 @@ void SetInputLayout(const input_layout_data_t& layout_desc);
 
 void SetVertexBuffers(const mesh_buffer_t& mesh_buffer);
 
-void SetVSConstant(dx_shader_reflection reflection, const pn::string& buffer_name, const dx_buffer& buffer);
-void SetPSConstant(dx_shader_reflection reflection, const pn::string& buffer_name, const dx_buffer& buffer);
-void SetProgramConstant(const shader_program_t& program, const pn::string& buffer_name, const dx_buffer& buffer);
+void SetVSConstant(const shader_bindings_t& bindings, const pn::string_id_t buffer_name, const dx_buffer& buffer);
+void SetPSConstant(const shader_bindings_t& bindings, const pn::string_id_t buffer_name, const dx_buffer& buffer);
+void SetProgramConstant(const shader_program_t& program, const pn::string_id_t buffer_name, const dx_buffer& buffer);
 
-void SetVSShaderResource(dx_shader_reflection reflection, const pn::string& resource_name, dx_resource_view& resource_view);
-void SetPSShaderResource(dx_shader_reflection reflection, const pn::string& resource_name, dx_resource_view& resource_view);
-void SetProgramResource(const shader_program_t& program, const pn::string& resource_name, dx_resource_view& resource_view);
+void SetVSShaderResource(const shader_bindings_t& bindings, const pn::string_id_t resource_name, dx_resource_view& resource_view);
+void SetPSShaderResource(const shader_bindings_t& bindings, const pn::string_id_t resource_name, dx_resource_view& resource_view);
+void SetProgramResource(const shader_program_t& program, const pn::string_id_t resource_name, dx_resource_view& resource_view);
 
-void SetVSSampler(dx_shader_reflection reflection, const pn::string& sampler_name, dx_sampler_state& sampler_state);
-void SetPSSampler(dx_shader_reflection reflection, const pn::string& sampler_name, dx_sampler_state& sampler_state);
-void SetProgramSampler(const shader_program_t& program, const pn::string& sampler_name, dx_sampler_state& sampler_state);
+void SetVSSampler(const shader_bindings_t& bindings, const pn::string_id_t sampler_name, dx_sampler_state& sampler_state);
+void SetPSSampler(const shader_bindings_t& bindings, const pn::string_id_t sampler_name, dx_sampler_state& sampler_state);
+void SetProgramSampler(const shader_program_t& program, const pn::string_id_t sampler_name, dx_sampler_state& sampler_state);
 
 
 // ---------- BLENDING -----------------
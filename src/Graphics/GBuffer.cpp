@@ -1,7 +1,7 @@
-#include <Graphics\GBuffer.h>
-#include <Graphics\RenderSystem.h>
+#include <Graphics/GBuffer.h>
+#include <Graphics/RenderSystem.h>
 
-#include <IO\PathUtil.h>
+#include <IO/PathUtil.h>
 
 namespace pn {
 
@@ -1,9 +1,9 @@
 #pragma once
 
-#include <Graphics\DirectX.h>
+#include <Graphics/DirectX.h>
 
-#include <UI\EditorUI.h>
-#include <UI\EditStruct.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
 namespace pn {
 
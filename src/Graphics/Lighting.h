@@ -1,8 +1,9 @@
 #pragma once
 
-#include <Utilities\Math.h>
+#include <Utilities/Math.h>
 
-#include <UI\EditorUI.h>
+#include <UI/EditorUI.h>
+#include <UI/EditStruct.h>
 
 namespace pn {
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Application/ResourceDatabaseTypes.h>
+
+#include <Utilities/UtilityTypes.h>
+
+#include <cstdint>
+
+// The backend decides what a mesh buffer holds. Core code only fills in id and name and asks the
+// backend to create the rest from a cooked mesh.
+#if defined(PN_BACKEND_D3D11)
+#include <Graphics/DirectX.h>
+#endif
+
+namespace pn {
+
+struct cooked_mesh_view_t;
+struct cooked_submesh_t;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+#if !defined(PN_BACKEND_D3D11)
+// Headless builds have no device, only the sizes are kept
+struct mesh_buffer_t {
+	unsigned int			vertex_count;
+	unsigned int			index_count;
+	uint32_t				topology;	// D3D_PRIMITIVE_TOPOLOGY value, as stored in the cooked file
+
+	pn::rdb::resource_id_t	id;
+	pn::string				name;
+};
+#endif
+
+// -------- FUNCTIONS ------------
+
+// Implemented by the backend. Called on the device thread by the mesh loader.
+mesh_buffer_t			CreateMeshBuffer(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh);
+
+} // namespace pn
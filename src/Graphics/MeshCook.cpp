@@ -0,0 +1,210 @@
+#include <Graphics/MeshCook.h>
+
+#if !defined(PN_NO_ASSIMP)
+#include <assimp/Importer.hpp>
+#endif
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <IO/FileUtil.h>
+
+#include <System/Jobs.h>
+
+#include <Utilities/Logging.h>
+#include <Utilities/MemoryTracking.h>
+
+#include <algorithm>
+#include <filesystem>
+
+namespace pn {
+
+#pragma region Assimp Conversion
+
+static vec3f aiVector3DToVec3f(const aiVector3D& v) {
+	return vec3f(v.x, v.y, v.z);
+}
+
+static vec2f aiVector3DToVec2f(const aiVector3D& v) {
+	return vec2f(v.x, v.y);
+}
+
+static vec4f aiColor4DToVec4f(const aiColor4D& c) {
+	return vec4f(c.r, c.g, c.b, c.a);
+}
+
+static quaternion aiQuaternionToQuaternion(const aiQuaternion& q) {
+	return quaternion(q.x, q.y, q.z, q.w);
+}
+
+static transform_t aiMatrixToTransform(const aiMatrix4x4& aiMatrix) {
+	aiVector3D scale, translation;
+	aiQuaternion rotation;
+	aiMatrix.Decompose(scale, rotation, translation);
+
+	transform_t transform;
+	transform.position	= aiVector3DToVec3f(translation);
+	transform.rotation	= aiQuaternionToQuaternion(rotation);
+	transform.scale		= aiVector3DToVec3f(scale);
+	return transform;
+}
+
+void ConvertAIMesh(const aiMesh* mesh, cooked_submesh_source_t& result_mesh) {
+	LogDebug("Loading mesh {}", mesh->mName.C_Str());
+
+	result_mesh.name.assign(mesh->mName.data, mesh->mName.length);
+
+	const unsigned int VERTEX_COUNT = mesh->mNumVertices;
+	// converted element by element, the assimp types only happen to share the layout
+	auto convert = [VERTEX_COUNT](const auto* source, auto& destination, auto to_pn) {
+		Resize(destination, VERTEX_COUNT);
+		std::transform(source, source + VERTEX_COUNT, destination.begin(), to_pn);
+	};
+
+	convert(mesh->mVertices, result_mesh.vertices, aiVector3DToVec3f);
+
+	if (mesh->HasNormals()) {
+		convert(mesh->mNormals, result_mesh.normals, aiVector3DToVec3f);
+	}
+
+	if (mesh->HasTangentsAndBitangents()) {
+		convert(mesh->mTangents, result_mesh.tangents, aiVector3DToVec3f);
+		convert(mesh->mBitangents, result_mesh.bitangents, aiVector3DToVec3f);
+	}
+
+	if (mesh->GetNumColorChannels() >= 1) {
+		convert(mesh->mColors[0], result_mesh.colors, aiColor4DToVec4f);
+	}
+
+	if (mesh->GetNumUVChannels() >= 1) {
+		convert(mesh->mTextureCoords[0], result_mesh.uvs, aiVector3DToVec2f);
+	}
+	if (mesh->GetNumUVChannels() >= 2) {
+		convert(mesh->mTextureCoords[1], result_mesh.uv2s, aiVector3DToVec2f);
+	}
+
+	Reserve(result_mesh.indices, VERTEX_COUNT);
+	for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+		const aiFace& face = mesh->mFaces[i];
+		for (unsigned int j = 0; j < face.mNumIndices; ++j) {
+			pn::PushBack(result_mesh.indices, face.mIndices[j]);
+		}
+	}
+	result_mesh.topology = COOKED_TOPOLOGY_TRIANGLE_LIST;
+	LogDebug("Finished loading mesh {}", mesh->mName.C_Str());
+}
+
+// Depth first, so every parent is stored before its children
+static void FlattenAINode(const aiNode* node, const int32_t parent, cooked_mesh_source_t& source) {
+	const int32_t index = static_cast<int32_t>(Size(source.nodes));
+
+	cooked_node_t flat_node{};
+	SetNodeTransform(flat_node, aiMatrixToTransform(node->mTransformation));
+	flat_node.parent		= parent;
+	flat_node.first_mesh	= static_cast<uint32_t>(Size(source.node_meshes));
+	flat_node.mesh_count	= node->mNumMeshes;
+	PushBack(source.nodes, flat_node);
+	source.node_meshes.insert(source.node_meshes.end(), node->mMeshes, node->mMeshes + node->mNumMeshes);
+
+	for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+		FlattenAINode(node->mChildren[i], index, source);
+	}
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+unsigned int	MeshLoadDataToAssimp(const MeshLoadData& mesh_load_data) {
+	unsigned int assimp_post_process = aiProcess_CalcTangentSpace;
+	if (mesh_load_data.convert_left) assimp_post_process |= (aiProcess_MakeLeftHanded | aiProcess_FlipUVs | aiProcess_FlipWindingOrder);
+	if (mesh_load_data.triangulate) assimp_post_process |= aiProcess_Triangulate;
+
+	return assimp_post_process;
+}
+
+bool			ImportMeshSource(const bytes& file_data, const MeshLoadData& mesh_load_data, cooked_mesh_source_t& source) {
+#if defined(PN_NO_ASSIMP)
+	(void)file_data;
+	(void)mesh_load_data;
+	(void)source;
+	LogError("Assimp: Not available in this build, only cooked meshes can be loaded");
+	return false;
+#else
+	Assimp::Importer importer;
+	const auto* ai_scene = importer.ReadFileFromMemory(
+		file_data.data(), file_data.size(),
+		MeshLoadDataToAssimp(mesh_load_data),
+		nullptr
+	);
+	if (!ai_scene) {
+		LogError("Assimp: Couldn't read file: {}", importer.GetErrorString());
+		return false;
+	}
+
+	source = cooked_mesh_source_t{};
+	source.load_flags = MeshLoadDataToAssimp(mesh_load_data);
+	FlattenAINode(ai_scene->mRootNode, -1, source);
+
+	Resize(source.meshes, ai_scene->mNumMeshes);
+	jobs::ParallelFor(0, ai_scene->mNumMeshes, 1, [&](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			ConvertAIMesh(ai_scene->mMeshes[i], source.meshes[i]);
+		}
+	});
+	return true;
+#endif
+}
+
+bytes			CookMesh(const bytes& file_data, const MeshLoadData& mesh_load_data) {
+	memory_tag_scope tag(memory_tag_t::MESH);
+	cooked_mesh_source_t source;
+	if (!ImportMeshSource(file_data, mesh_load_data, source)) {
+		return {};
+	}
+	return WriteCookedMesh(source);
+}
+
+bool			CookMeshFile(const string& source_path, const string& cooked_path, const MeshLoadData& mesh_load_data) {
+	const auto file_data = ReadFile(source_path);
+	if (file_data.empty()) {
+		LogError("MeshCook: Couldn't load file {}", source_path);
+		return false;
+	}
+
+	const auto cooked_data = CookMesh(file_data, mesh_load_data);
+	if (cooked_data.empty()) {
+		return false;
+	}
+	return WriteCookedMeshFile(cooked_path, cooked_data);
+}
+
+bool			WriteCookedMeshFile(const string& cooked_path, const bytes& cooked_data) {
+	const string temp_path = cooked_path + ".tmp";
+	if (!WriteFile(temp_path, cooked_data.data(), Size(cooked_data))) {
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp_path, cooked_path, error);
+	if (error) {
+		LogError("MeshCook: Couldn't replace {}: {}", cooked_path, error.message());
+		std::filesystem::remove(temp_path, error);
+		return false;
+	}
+	return true;
+}
+
+bool			IsCookedMeshCurrent(const string& source_path, const string& cooked_path) {
+	std::error_code error;
+	const auto cooked_time = std::filesystem::last_write_time(cooked_path, error);
+	if (error) {
+		return false;
+	}
+
+	const auto source_time = std::filesystem::last_write_time(source_path, error);
+	return error || cooked_time >= source_time;
+}
+
+#pragma endregion
+
+} // namespace pn
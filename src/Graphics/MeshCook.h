@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Graphics/CookedMesh.h>
+
+#include <Utilities/UtilityTypes.h>
+
+struct aiMesh;
+
+namespace pn {
+
+// -------- CLASS DEFINITIONS ------------
+
+struct MeshLoadData {
+	bool triangulate;
+	bool convert_left;
+};
+
+// ----- CONSTANTS ---------
+
+constexpr MeshLoadData DEFAULT_MESH_LOAD_DATA{ true, true };
+
+// ---------- FUNCTIONS --------------------
+
+unsigned int	MeshLoadDataToAssimp(const MeshLoadData& mesh_load_data);
+
+// Copies the streams of one imported mesh, ImportMeshSource runs it for every mesh of the scene
+void			ConvertAIMesh(const aiMesh* mesh, cooked_submesh_source_t& result_mesh);
+
+// Imports a mesh file through Assimp and converts it to the cooked layout. Meshes are converted in
+// parallel on the job system. Returns false and logs if the file couldn't be imported.
+// Always fails in builds without Assimp (PN_NO_ASSIMP), which can only load cooked meshes.
+bool			ImportMeshSource(const bytes& file_data, const MeshLoadData& mesh_load_data, cooked_mesh_source_t& source);
+
+// Imports and cooks in one go, returns an empty buffer on failure
+bytes			CookMesh(const bytes& file_data, const MeshLoadData& mesh_load_data);
+
+// Cooks source_path into cooked_path. The file is written under a temporary name and renamed, so
+// a reader never sees a partial file.
+bool			CookMeshFile(const string& source_path, const string& cooked_path, const MeshLoadData& mesh_load_data);
+bool			WriteCookedMeshFile(const string& cooked_path, const bytes& cooked_data);
+
+// True if cooked_path exists and isn't older than source_path. A missing source counts as up to date
+// so cooked files can ship without the originals.
+bool			IsCookedMeshCurrent(const string& source_path, const string& cooked_path);
+
+} // namespace pn
@@ -1,191 +1,243 @@
-#include <Graphics\MeshLoadUtil.h>
+#include <Graphics/MeshLoadUtil.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
-#include <assimp\Importer.hpp>
-#include <assimp\scene.h>
-#include <assimp\postprocess.h>
+#include <Graphics/CookedMesh.h>
+#include <Graphics/MeshBuffer.h>
 
-#include <IO\FileUtil.h>
-#include <IO\PathUtil.h>
+#include <IO/AssetCache.h>
+#include <IO/FileUtil.h>
+#include <IO/MappedFile.h>
+#include <IO/PathUtil.h>
 
-#include <Application\ResourceDatabase.h>
+#include <Application/ResourceDatabase.h>
 
-#include <Utilities\Profile.h>
+#include <System/Jobs.h>
 
+#include <Utilities/Hash.h>
+#include <Utilities/MemoryTracking.h>
+#include <Utilities/Profile.h>
+
+#include <memory>
 #include <utility>
 
 namespace pn {
 
-// ----- VARIABLES ---------
+// ----- ASYNC LOADING ---------
 
-dx_device device;
+// One mesh file in flight. The import job only touches its own mesh_load_t, the table of loads
+// and everything after the import belong to the device thread.
+struct mesh_load_t {
+	std::string					filename;
+	MeshLoadData				mesh_load_data;
 
-// ------ FUNCTIONS -----------
+	// the view points into one of these
+	mapped_file_t				mapped_file;	// an up to date cooked file
+	pn::bytes					cooked_data;	// or the file cooked by this load
+	cooked_mesh_view_t			view;
 
-void			InitMeshLoadUtil(dx_device d) {
-	device = d;
-}
+	bool						failed		= false;	// written by the job, read once done reaches 0
+	jobs::counter_t				done;
 
-unsigned int	MeshLoadDataToAssimp(const MeshLoadData& mesh_load_data) {
-	unsigned int assimp_post_process = aiProcess_CalcTangentSpace;
-	if (mesh_load_data.convert_left) assimp_post_process |= (aiProcess_MakeLeftHanded | aiProcess_FlipUVs | aiProcess_FlipWindingOrder);
-	if (mesh_load_data.triangulate) assimp_post_process |= aiProcess_Triangulate;
+	mesh_load_status_t			status		= mesh_load_status_t::PENDING;
+	pn::rdb::resource_id_t		root_id		= rdb::NULL_RESOURCE_ID;
+	bool						released	= false;	// dropped as soon as it's finished
+};
 
-	return assimp_post_process;
-}
+static pn::map<mesh_load_handle_t, std::unique_ptr<mesh_load_t>>	mesh_loads;
+static mesh_load_handle_t											next_mesh_load_handle = 1;
 
-pn::mat4f AiMatrixToMat4f(const aiMatrix4x4& m) {
-	return mat4f(
-		m.a1, m.a2, m.a3, m.a4,
-		m.b1, m.b2, m.b3, m.b4,
-		m.c1, m.c2, m.c3, m.c4,
-		m.d1, m.d2, m.d3, m.d4
-	);
-}
+// The loads UpdateMeshLoads still has to finish, so it doesn't walk the finished ones every frame.
+// May hold handles WaitForMeshLoad already took care of.
+static pn::vector<mesh_load_handle_t>								pending_mesh_loads;
 
-vec3f aiVector3DToVec3f(const aiVector3D& v) {
-	return vec3f(v.x, v.y, v.z);
-}
+static bool UseCookedMesh(mesh_load_t& load, mapped_file_t&& cooked_file) {
+	load.mapped_file = cooked_file;
+	if (!IsMapped(load.mapped_file)) {
+		return false;
+	}
+	if (OpenCookedMesh(load.mapped_file.data, load.mapped_file.size, load.view)
+		&& load.view.header->load_flags == MeshLoadDataToAssimp(load.mesh_load_data)) {
+		return true;
+	}
 
-quaternion aiQuaternionToQuaternion(const aiQuaternion& q) {
-	return quaternion(q.x, q.y, q.z, q.w);
+	// stale version or different import flags, cook it again
+	UnmapFile(load.mapped_file);
+	load.view = cooked_mesh_view_t{};
+	return false;
 }
 
-pn::transform_t aiDataToTransform(const aiVector3D& scale, const aiQuaternion& quaternion, const aiVector3D& translation) {
-	transform_t transform;
-	transform.position	= aiVector3DToVec3f(translation);
-	transform.rotation	= aiQuaternionToQuaternion(quaternion);
-	transform.scale		= aiVector3DToVec3f(scale);
-	return transform;
-}
+// Worker side: an offline cooked file next to the source wins, then the asset cache, and only
+// then the source goes through Assimp
+static void ImportMeshFile(mesh_load_t& load) {
+	PN_PROFILE_SCOPE("Import mesh");
+	memory_tag_scope tag(memory_tag_t::MESH);
+	const auto cooked_path = CookedMeshPath(load.filename);
+	if (IsCookedMeshCurrent(load.filename, cooked_path) && UseCookedMesh(load, MapFile(cooked_path))) {
+		return;
+	}
 
-pn::transform_t aiMatrixToTransform(const aiMatrix4x4& aiMatrix) {
-	aiVector3D scale, translation;
-	aiQuaternion rotation;
-	aiMatrix.Decompose(scale, rotation, translation);
-	return aiDataToTransform(scale, rotation, translation);
-}
+	auto file_data = pn::ReadResource(load.filename);
+	if (file_data.empty()) {
+		LogError("MeshLoad: Couldn't load file {}", load.filename);
+		load.failed = true;
+		return;
+	}
 
-pn::mesh_t ConvertAIMeshToMesh(aiMesh* mesh, const aiScene* scene) {
-	LogDebug("Loading mesh {}", mesh->mName.C_Str());
-	
-	pn::mesh_t result_mesh;
+	const auto options_hash = HashCombine(MeshLoadDataToAssimp(load.mesh_load_data), COOKED_MESH_VERSION);
+	const auto cache_key = MakeAssetKey(COOKED_MESH_EXTENSION, Hash64(file_data), options_hash);
+	if (UseCookedMesh(load, MapCachedAsset(cache_key))) {
+		return;
+	}
 
-	result_mesh.name.resize(mesh->mName.length);
-	memcpy(result_mesh.name.data(), mesh->mName.data, mesh->mName.length);
+	{
+		PN_PROFILE_SCOPE("Cook mesh");
+		load.cooked_data = CookMesh(file_data, load.mesh_load_data);
+	}
+	if (load.cooked_data.empty() || !OpenCookedMesh(load.cooked_data.data(), Size(load.cooked_data), load.view)) {
+		load.failed = true;
+		return;
+	}
 
-	const unsigned int VERTEX_COUNT = mesh->mNumVertices;
-	Resize(result_mesh.vertices, VERTEX_COUNT);
-	std::memcpy(&(result_mesh.vertices[0]), mesh->mVertices, VERTEX_COUNT * sizeof(pn::vec3f));
+	StoreCachedAsset(cache_key, load.cooked_data);
+}
 
-	if (mesh->HasNormals()) {
-		Resize(result_mesh.normals, VERTEX_COUNT);
-		std::memcpy(&result_mesh.normals[0], mesh->mNormals, VERTEX_COUNT * sizeof(pn::vec3f));
+// Device thread side: create the buffers and register the hierarchy in node order. A node's
+// children hang off the last mesh it added, or an empty mesh if it has none.
+static void FinishMeshLoad(mesh_load_t& load) {
+	PN_PROFILE_SCOPE("Finish mesh load");
+	if (load.failed) {
+		load.status = mesh_load_status_t::FAILED;
+		UnmapFile(load.mapped_file);
+		pn::bytes().swap(load.cooked_data);
+		return;
 	}
 
-	if (mesh->HasTangentsAndBitangents()) {
-		Resize(result_mesh.tangents, VERTEX_COUNT);
-		Resize(result_mesh.bitangents, VERTEX_COUNT);
-		std::memcpy(&result_mesh.tangents[0], mesh->mTangents, VERTEX_COUNT * sizeof(pn::vec3f));
-		std::memcpy(&result_mesh.bitangents[0], mesh->mBitangents, VERTEX_COUNT * sizeof(pn::vec3f));
+	// whatever the driver keeps on the CPU side of the buffers
+	memory_tag_scope tag(memory_tag_t::RENDERING);
+
+	const auto meshes = GetMeshes(load.view);
+	const auto nodes = GetNodes(load.view);
+	pn::vector<pn::rdb::resource_id_t> node_ids(Size(nodes), rdb::NULL_RESOURCE_ID);
+	for (size_t n = 0; n < Size(nodes); ++n) {
+		const auto& node = nodes[n];
+		const auto transform = GetNodeTransform(node);
+		const auto parent_id = (node.parent < 0) ? rdb::NULL_RESOURCE_ID : node_ids[node.parent];
+
+		pn::rdb::resource_id_t mesh_id = rdb::NULL_RESOURCE_ID;
+		if (node.mesh_count == 0) {
+			pn::mesh_buffer_t empty_mesh{};
+			mesh_id = rdb::AddMeshResource(std::move(empty_mesh));
+			rdb::AddMeshTransform(mesh_id, transform);
+			rdb::AddMeshChild(parent_id, mesh_id);
+		}
+		for (auto mesh_index : GetNodeMeshes(load.view, node)) {
+			auto mesh_buffer = CreateMeshBuffer(load.view, meshes[mesh_index]);
+			mesh_id = rdb::AddMeshResource(std::move(mesh_buffer));
+			rdb::AddMeshTransform(mesh_id, transform);
+			rdb::AddMeshChild(parent_id, mesh_id);
+		}
+		node_ids[n] = mesh_id;
 	}
 
-	if (mesh->GetNumColorChannels() >= 1) {
-		Resize(result_mesh.colors, VERTEX_COUNT);
-		std::memcpy(&result_mesh.colors[0], mesh->mColors[0], VERTEX_COUNT * sizeof(pn::vec4f));
-	}
+	// publish right away so the caller can look the meshes up by name
+	rdb::CommitChanges();
 
-	if (mesh->GetNumUVChannels() >= 1) {
-		Resize(result_mesh.uvs, VERTEX_COUNT);
-		if (mesh->GetNumUVChannels() >= 2) {
-			Resize(result_mesh.uv2s, VERTEX_COUNT);
-		}
+	load.root_id = node_ids.empty() ? rdb::NULL_RESOURCE_ID : node_ids[0];
+	load.status = mesh_load_status_t::READY;
+
+	// the buffers have their own copy now
+	load.view = cooked_mesh_view_t{};
+	UnmapFile(load.mapped_file);
+	pn::bytes().swap(load.cooked_data);
+}
 
-		for (unsigned int i = 0; i < VERTEX_COUNT; ++i) {
-			std::memcpy(&result_mesh.uvs[i], &(mesh->mTextureCoords[0][i]), sizeof(pn::vec2f));
+mesh_load_handle_t LoadMeshAsync(const std::string& filename, const MeshLoadData& mesh_load_data) {
+	const auto handle = next_mesh_load_handle++;
+	auto load = std::make_unique<mesh_load_t>();
+	load->filename = filename;
+	load->mesh_load_data = mesh_load_data;
+
+	auto* load_ptr = load.get();
+	mesh_loads.emplace(handle, std::move(load));
+	PushBack(pending_mesh_loads, handle);
+	jobs::Run([load_ptr] { ImportMeshFile(*load_ptr); }, &load_ptr->done);
+	return handle;
+}
 
-			if (mesh->GetNumUVChannels() >= 2) {
-				std::memcpy(&result_mesh.uv2s[i], &(mesh->mTextureCoords[1][i]), sizeof(pn::vec2f));
+mesh_load_handle_t LoadMeshAsync(const std::string& filename) {
+	return LoadMeshAsync(filename, DEFAULT_MESH_LOAD_DATA);
+}
+
+void UpdateMeshLoads() {
+	for (size_t i = 0; i < Size(pending_mesh_loads);) {
+		const auto it = mesh_loads.find(pending_mesh_loads[i]);
+		if (it != mesh_loads.end()) {
+			auto& load = *it->second;
+			if (load.status == mesh_load_status_t::PENDING) {
+				if (!jobs::IsDone(load.done)) {
+					++i;
+					continue;
+				}
+				FinishMeshLoad(load);
+			}
+			if (load.released) {
+				mesh_loads.erase(it);
 			}
 		}
-	}
 
-	Reserve(result_mesh.indices, VERTEX_COUNT / 3);
-	for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-		aiFace face = mesh->mFaces[i];
-		for (unsigned int j = 0; j < face.mNumIndices; ++j) {
-			pn::PushBack(result_mesh.indices, face.mIndices[j]);
-		}
+		// finished or waited on, order doesn't matter
+		pending_mesh_loads[i] = pending_mesh_loads.back();
+		pending_mesh_loads.pop_back();
 	}
-	result_mesh.topology = D3D_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	LogDebug("Finished loading mesh {}", mesh->mName.C_Str());
-	return std::move(result_mesh);
 }
 
-pn::rdb::resource_id_t ProcessAINode(aiNode* node, const aiScene* scene, pn::rdb::resource_id_t parent_id) {
-	auto transform = aiMatrixToTransform(node->mTransformation);
+mesh_load_status_t GetMeshLoadStatus(const mesh_load_handle_t handle) {
+	const auto it = mesh_loads.find(handle);
+	if (it == mesh_loads.end() || it->second->released) {
+		return mesh_load_status_t::INVALID;
+	}
+	return it->second->status;
+}
 
-	pn::rdb::resource_id_t mesh_id = 0;
-	if (node->mNumMeshes == 0) {
-		pn::mesh_buffer_t empty_mesh{};
-		mesh_id = rdb::AddMeshResource(empty_mesh);
-		rdb::AddMeshTransform(mesh_id, transform);
-		rdb::AddMeshChild(parent_id, mesh_id);
+void ReleaseMeshLoad(const mesh_load_handle_t handle) {
+	const auto it = mesh_loads.find(handle);
+	if (it == mesh_loads.end()) {
+		LogError("MeshLoad: Unknown load handle {}", handle);
+		return;
 	}
-	else {
-		for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
-			auto* ai_mesh		= scene->mMeshes[node->mMeshes[i]];
-			
-			//StartProfile("aiMesh to Mesh");
-			auto mesh			= std::move(ConvertAIMeshToMesh(ai_mesh, scene));
-			//EndProfile();
-			
-			//StartProfile("Mesh to MeshBuffer");
-			auto mesh_buffer	= CreateMeshBuffer(mesh);
-			//EndProfile();
-
-			mesh_id				= rdb::AddMeshResource(mesh_buffer);
-			rdb::AddMeshTransform(mesh_id, transform);
-			rdb::AddMeshChild(parent_id, mesh_id);
-		}
+
+	// the import job still writes to a pending load, UpdateMeshLoads drops it once it's finished
+	if (it->second->status == mesh_load_status_t::PENDING) {
+		it->second->released = true;
+		return;
 	}
+	mesh_loads.erase(it);
+}
 
-	for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-		ProcessAINode(node->mChildren[i], scene, mesh_id);
+pn::rdb::resource_id_t WaitForMeshLoad(const mesh_load_handle_t handle) {
+	if (!pn::Contains(mesh_loads, handle)) {
+		LogError("MeshLoad: Unknown load handle {}", handle);
+		return rdb::NULL_RESOURCE_ID;
 	}
 
-	return mesh_id;
-}
+	auto& load = *mesh_loads.at(handle);
+	jobs::WaitForCounter(load.done);
+	if (load.status == mesh_load_status_t::PENDING) {
+		FinishMeshLoad(load);
+	}
 
-auto ConvertAISceneToMeshes(const aiScene* ai_scene) {
-	return ProcessAINode(ai_scene->mRootNode, ai_scene, 0);
+	const auto root_id = load.root_id;
+	mesh_loads.erase(handle);
+	return root_id;
 }
 
 pn::rdb::resource_id_t LoadMesh(const std::string& filename, const MeshLoadData& mesh_load_data) {
-	Assimp::Importer importer;
-	auto file_data = pn::ReadResource(filename);
-	if (file_data.empty()) {
-		LogError("MeshLoad: Couldn't load file {}", filename);
-		return 0;
-	}
-	const auto* ai_scene = importer.ReadFileFromMemory(
-		file_data.data(), file_data.size(),
-		MeshLoadDataToAssimp(mesh_load_data),
-		nullptr
-	);
-	if (!ai_scene) {
-		LogError("Assimp: Couldn't read file: {}", importer.GetErrorString());
-		return 0;
-	}
-	return ConvertAISceneToMeshes(ai_scene);
+	return WaitForMeshLoad(LoadMeshAsync(filename, mesh_load_data));
 }
 
 pn::rdb::resource_id_t LoadMesh(const std::string& filename) {
-	MeshLoadData default_load_data;
-	default_load_data.convert_left = true;
-	default_load_data.triangulate = true;
-	return LoadMesh(filename, default_load_data);
+	return WaitForMeshLoad(LoadMeshAsync(filename));
 }
 
 } //namespace pn
\ No newline at end of file
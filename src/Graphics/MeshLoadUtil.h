@@ -3,24 +3,47 @@
 #include <string>
 #include <vector>
 
-#include <Application\ResourceDatabaseTypes.h>
-#include <Graphics\DirectX.h>
-#include <Utilities\UtilityTypes.h>
+#include <Application/ResourceDatabaseTypes.h>
+#include <Graphics/MeshCook.h>
+#include <Utilities/UtilityTypes.h>
 
 namespace pn {
 
-// -------- CLASS DEFINITIONS ------------
+// ----- TYPEDEFS ----------
 
-struct MeshLoadData {
-	bool triangulate;
-	bool convert_left;
+using mesh_load_handle_t = unsigned int;
+
+enum class mesh_load_status_t {
+	INVALID,	// unknown or already released handle
+	PENDING,	// still importing on the job system or waiting for UpdateMeshLoads
+	READY,		// buffers created and registered with the resource database
+	FAILED
 };
 
 // ---------- FUNCTIONS --------------------
 
-void InitMeshLoadUtil(dx_device device);
-
 pn::rdb::resource_id_t	LoadMesh(const std::string& filename, const MeshLoadData& mesh_load_data);
 pn::rdb::resource_id_t	LoadMesh(const std::string& filename);
 
+// Reads, imports and converts the file on the job system. Only the buffer creation and the resource
+// database registration happen on the device thread, in UpdateMeshLoads or WaitForMeshLoad.
+// An up to date cooked file next to filename, or a cooked copy in the asset cache, is memory
+// mapped instead of importing. Otherwise the imported mesh is cooked into the asset cache.
+mesh_load_handle_t		LoadMeshAsync(const std::string& filename, const MeshLoadData& mesh_load_data);
+mesh_load_handle_t		LoadMeshAsync(const std::string& filename);
+
+// Finishes every load whose import is done. Call from the device thread, e.g. once per frame.
+void					UpdateMeshLoads();
+
+mesh_load_status_t		GetMeshLoadStatus(const mesh_load_handle_t handle);
+
+// Every handle has to be given back, either here or with WaitForMeshLoad. For loads that are only
+// polled: the meshes stay in the resource database, only the handle goes. A load still pending is
+// finished by UpdateMeshLoads and dropped then.
+void					ReleaseMeshLoad(const mesh_load_handle_t handle);
+
+// Runs jobs until the load is done, finishes it and releases the handle.
+// Returns the id of the root mesh, or 0 if the load failed.
+pn::rdb::resource_id_t	WaitForMeshLoad(const mesh_load_handle_t handle);
+
 } // namespace pn
\ No newline at end of file
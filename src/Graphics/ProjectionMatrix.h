@@ -1,7 +1,7 @@
 #pragma once
 
-#include <Utilities\Math.h>
-#include <Utilities\Logging.h>
+#include <Utilities/Math.h>
+#include <Utilities/Logging.h>
 
 namespace pn {
 
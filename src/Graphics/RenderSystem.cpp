@@ -1,5 +1,6 @@
-#include <Graphics\RenderSystem.h>
-#include <Application\Global.h>
+#include <Graphics/RenderSystem.h>
+#include <Application/Global.h>
+#include <Utilities/Memory.h>
 
 namespace pn {
 
@@ -79,8 +80,8 @@ void UpdateGlobalConstantCBuffer() {
 
 void UpdateCameraConstantCBuffer(const camera_t& camera) {
 	// Update camera buffer
-	camera_constants.data.view = Inverse(TransformToMatrix(camera.transform));
-	camera_constants.data.inv_view = TransformToMatrix(camera.transform);
+	camera_constants.data.view = WorldToLocalMatrix(camera.transform);
+	camera_constants.data.inv_view = LocalToWorldMatrix(camera.transform);
 	camera_constants.data.proj = camera.projection_matrix.GetMatrix();
 	camera_constants.data.inv_proj = Inverse(camera.projection_matrix.GetMatrix());
 	camera_constants.data.inv_proj_view = Inverse(camera_constants.data.view * camera_constants.data.proj);
@@ -91,8 +92,8 @@ void UpdateCameraConstantCBuffer(const camera_t& camera) {
 void UpdateModelConstantCBuffer(const transform_t& transform) {
 	model_constants.data.model = LocalToWorldMatrix(transform);
 	model_constants.data.model_view = model_constants.data.model * camera_constants.data.view;
-	model_constants.data.model_view_inverse_transpose = pn::Transpose(pn::Inverse(model_constants.data.model * camera_constants.data.view));
-	model_constants.data.mvp = model_constants.data.model * camera_constants.data.view * camera_constants.data.proj;
+	model_constants.data.model_view_inverse_transpose = pn::Transpose(pn::Inverse(model_constants.data.model_view));
+	model_constants.data.mvp = model_constants.data.model_view * camera_constants.data.proj;
 
 	UpdateBuffer(model_constants);
 }
@@ -126,9 +127,9 @@ void SetShaderProgram(shader_program_t& shader_program) {
 
 void SetStandardShaderProgram(shader_program_t& shader_program) {
 	SetShaderProgram(shader_program);
-	SetProgramConstant("global_constants", global_constants);
-	SetProgramConstant("camera_constants", camera_constants);
-	SetProgramConstant("model_constants", model_constants);
+	SetProgramConstant(GLOBAL_CONSTANTS_NAME, global_constants);
+	SetProgramConstant(CAMERA_CONSTANTS_NAME, camera_constants);
+	SetProgramConstant(MODEL_CONSTANTS_NAME, model_constants);
 }
 
 void ClearShaderProgram() {
@@ -140,72 +141,38 @@ void ClearShaderProgram() {
 
 void SetVertexBuffers(const mesh_buffer_t& mesh_buffer) {
 	const input_layout_data_t& layout = CURRENT_SHADER->input_layout_data;
-	const auto NUM_PARAMETERS = layout.desc.size();
-
-	pn::vector<ID3D11Buffer*> vertex_buffers;
-	Reserve(vertex_buffers, NUM_PARAMETERS);
-
-	pn::vector<unsigned int> strides;
-	Reserve(strides, NUM_PARAMETERS);
-
-	pn::vector<unsigned int> offsets;
-	Reserve(offsets, NUM_PARAMETERS);
+	const auto NUM_PARAMETERS = Size(layout.streams);
+
+	// called for every draw, so the arrays live on the scratch stack instead of the heap
+	auto& scratch = ScratchStack();
+	stack_allocator_scope scratch_scope(scratch);
+	auto* vertex_buffers	= scratch.AllocateArray<ID3D11Buffer*>(NUM_PARAMETERS);
+	auto* strides			= scratch.AllocateArray<unsigned int>(NUM_PARAMETERS);
+	auto* offsets			= scratch.AllocateArray<unsigned int>(NUM_PARAMETERS);
+	unsigned int count		= 0;
+
+	const auto bind = [&](ID3D11Buffer* buffer, const unsigned int stride) {
+		vertex_buffers[count]	= buffer;
+		strides[count]			= stride;
+		offsets[count]			= 0;
+		++count;
+	};
 
-	for (size_t i = 0; i < layout.desc.size(); ++i) {
-		const auto& el = layout.desc[i];
-		unsigned int index = layout.desc[i].SemanticIndex;
-		std::string type = el.SemanticName;
-		if (type == "POSITION") {
-			PushBack(vertex_buffers, mesh_buffer.vertices.Get());
-			PushBack(strides, sizeof(pn::vec3f));
-			PushBack(offsets, 0);
-		}
-		else if (type == "NORMAL") {
-			PushBack(vertex_buffers, mesh_buffer.normals.Get());
-			PushBack(strides, sizeof(pn::vec3f));
-			PushBack(offsets, 0);
-		}
-		else if (type == "TEXCOORD") {
-			if (index == 0) {
-				PushBack(vertex_buffers, mesh_buffer.uvs.Get());
-				PushBack(strides, sizeof(pn::vec2f));
-				PushBack(offsets, 0);
-			}
-			else if (index == 1) {
-				PushBack(vertex_buffers, mesh_buffer.uv2s.Get());
-				PushBack(strides, sizeof(pn::vec2f));
-				PushBack(offsets, 0);
-			}
-			else {
-				LogError("TEXCOORD with index {} not implemented", index);
-			}
-		}
-		else if (type == "TANGENT") {
-			if (index == 0) {
-				PushBack(vertex_buffers, mesh_buffer.tangents.Get());
-				PushBack(strides, sizeof(pn::vec3f));
-				PushBack(offsets, 0);
-			}
-			else if (index == 1) {
-				PushBack(vertex_buffers, mesh_buffer.bitangents.Get());
-				PushBack(strides, sizeof(pn::vec3f));
-				PushBack(offsets, 0);
-			}
-			else {
-				LogError("TANGENT with index {} not implemented", index);
-			}
-		}
-		else if (type == "COLOR") {
-			PushBack(vertex_buffers, mesh_buffer.colors.Get());
-			PushBack(strides, sizeof(pn::vec4f));
-			PushBack(offsets, 0);
-		}
-		else {
-			LogError("Unknown parameter type '{}' in MeshBuffer", type);
+	// the semantics were resolved to streams when the layout was created
+	for (const auto stream : layout.streams) {
+		switch (stream) {
+		case vertex_stream_t::VERTICES:		bind(mesh_buffer.vertices.Get(), sizeof(pn::vec3f));	break;
+		case vertex_stream_t::NORMALS:		bind(mesh_buffer.normals.Get(), sizeof(pn::vec3f));		break;
+		case vertex_stream_t::TANGENTS:		bind(mesh_buffer.tangents.Get(), sizeof(pn::vec3f));	break;
+		case vertex_stream_t::BITANGENTS:	bind(mesh_buffer.bitangents.Get(), sizeof(pn::vec3f));	break;
+		case vertex_stream_t::COLORS:		bind(mesh_buffer.colors.Get(), sizeof(pn::vec4f));		break;
+		case vertex_stream_t::UVS:			bind(mesh_buffer.uvs.Get(), sizeof(pn::vec2f));			break;
+		case vertex_stream_t::UV2S:			bind(mesh_buffer.uv2s.Get(), sizeof(pn::vec2f));		break;
+		case vertex_stream_t::UNKNOWN:		break;
 		}
 	}
 
-	_context->IASetVertexBuffers(0, vertex_buffers.size(), const_cast<const pn::vector<ID3D11Buffer*>&>(vertex_buffers).data(), strides.data(), offsets.data());
+	_context->IASetVertexBuffers(0, count, vertex_buffers, strides, offsets);
 	_context->IASetIndexBuffer(mesh_buffer.indices.Get(), DXGI_FORMAT_R32_UINT, 0);
 	_context->IASetPrimitiveTopology(mesh_buffer.topology);
 }
@@ -276,17 +243,17 @@ void ClearVertexBuffers() {
 	_context->IASetVertexBuffers(0, 0, nullptr, nullptr, nullptr);
 }
 
-void SetProgramConstant(const pn::string& buffer_name, const dx_buffer& buffer) {
+void SetProgramConstant(const pn::string_id_t buffer_name, const dx_buffer& buffer) {
 	assert(CURRENT_SHADER != nullptr);
 	SetProgramConstant(*CURRENT_SHADER, buffer_name, buffer);
 }
 
-void SetProgramResource(const pn::string& resource_name, dx_resource_view& resource_view) {
+void SetProgramResource(const pn::string_id_t resource_name, dx_resource_view& resource_view) {
 	assert(CURRENT_SHADER != nullptr);
 	SetProgramResource(*CURRENT_SHADER, resource_name, resource_view);
 }
 
-void SetProgramSampler(const pn::string& sampler_name, dx_sampler_state& sampler_state) {
+void SetProgramSampler(const pn::string_id_t sampler_name, dx_sampler_state& sampler_state) {
 	assert(CURRENT_SHADER != nullptr);
 	SetProgramSampler(*CURRENT_SHADER, sampler_name, sampler_state);
 }
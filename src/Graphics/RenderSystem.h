@@ -1,12 +1,19 @@
 #pragma once
 
-#include <Graphics\CBuffer.h>
-#include <Graphics\DirectX.h>
+#include <Graphics/CBuffer.h>
+#include <Graphics/DirectX.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
 namespace pn {
 
+// ---- CONSTANTS -----
+
+// cbuffer names the standard shaders share, hashed at compile time
+constexpr string_id_t GLOBAL_CONSTANTS_NAME	= "global_constants"_id;
+constexpr string_id_t CAMERA_CONSTANTS_NAME	= "camera_constants"_id;
+constexpr string_id_t MODEL_CONSTANTS_NAME	= "model_constants"_id;
+
 // ---- CLASS -----
 
 struct alignas(16) global_constants_t {
@@ -81,9 +88,9 @@ void SetVertexBuffers(const mesh_buffer_t& mesh_buffer);
 void SetVertexBuffersScreen();
 void ClearVertexBuffers();
 
-void SetProgramConstant(const pn::string& buffer_name, const dx_buffer& buffer);
-void SetProgramResource(const pn::string& resource_name, dx_resource_view& resource_view);
-void SetProgramSampler(const pn::string& sampler_name, dx_sampler_state& sampler_state);
+void SetProgramConstant(const pn::string_id_t buffer_name, const dx_buffer& buffer);
+void SetProgramResource(const pn::string_id_t resource_name, dx_resource_view& resource_view);
+void SetProgramSampler(const pn::string_id_t sampler_name, dx_sampler_state& sampler_state);
 
 void SetAlphaBlend(bool on, int num_render_targets = 1);
 void SetDepthTest(bool on);
@@ -1,20 +1,76 @@
-#include <Graphics\TextureLoadUtil.h>
+#include <Graphics/TextureLoadUtil.h>
 
-#include <IO\FileUtil.h>
+#include <IO/AssetCache.h>
+#include <IO/FileUtil.h>
 
+#include <Utilities/Hash.h>
+
+#include <filesystem>
 #include <memory>
 
-#include <DirectXTK\WICTextureLoader.h>
-#include <DirectXTK\DDSTextureLoader.h>
+#include <DirectXTK/WICTextureLoader.h>
+#include <DirectXTK/DDSTextureLoader.h>
+#include <DirectXTK/ScreenGrab.h>
 
 namespace pn {
 
 // ------ FUNCTIONS ---------
 
 
+// Bump when the decode options below change, old cache entries then stop matching
+constexpr uint64_t TEXTURE_CACHE_VERSION = 1;
+
+dx_resource_view CreateTextureFromDDS(const bytes& dds_data) {
+	dx_resource_view resource_view;
+	auto hr = DirectX::CreateDDSTextureFromMemoryEx(
+		_device.Get(), _context.Get(),
+		(const uint8_t*) (dds_data.data()), dds_data.size(), 0,
+		D3D11_USAGE::D3D11_USAGE_DEFAULT,
+		D3D11_BIND_SHADER_RESOURCE,
+		0, 0,
+		false,
+		nullptr, resource_view.GetAddressOf(),
+		nullptr
+		);
+
+	if (FAILED(hr)) {
+		LogError("Couldn't create texture: {}", ErrMsg(hr));
+	}
+
+	return resource_view;
+}
+
+// Stores the decoded top level as a DDS, the mips are generated again on load
+void CacheTexture(const asset_key_t& key, const dx_resource_view& resource_view) {
+	dx_resource resource;
+	resource_view->GetResource(resource.GetAddressOf());
+
+	// ScreenGrab only writes to files, the .tmp suffix gets cleaned up by the cache if we crash
+	const auto temp_path = CachedAssetPath(key) + ".tex.tmp";
+	const std::wstring wtemp_path(temp_path.begin(), temp_path.end());
+	auto hr = DirectX::SaveDDSTextureToFile(_context.Get(), resource.Get(), wtemp_path.c_str());
+	if (FAILED(hr)) {
+		LogError("Couldn't save texture to the asset cache: {}", ErrMsg(hr));
+		return;
+	}
+
+	StoreCachedAsset(key, ReadFile(temp_path));
+	std::error_code error;
+	std::filesystem::remove(temp_path, error);
+}
+
 dx_resource_view LoadTexture2D(const string& filepath) {
 	auto image_data = ReadResource(filepath);
-	
+
+	const auto cache_key = MakeAssetKey("dds", Hash64(image_data), TEXTURE_CACHE_VERSION);
+	bytes cached_data;
+	if (ReadCachedAsset(cache_key, cached_data)) {
+		auto cached_view = CreateTextureFromDDS(cached_data);
+		if (cached_view) {
+			return cached_view;
+		}
+	}
+
 	dx_resource_view resource_view;
 	auto hr = DirectX::CreateWICTextureFromMemoryEx(
 		_device.Get(), _context.Get(),
@@ -29,31 +85,18 @@ dx_resource_view LoadTexture2D(const string& filepath) {
 	
 	if (FAILED(hr)) {
 		LogError("Couldn't create texture: {}", ErrMsg(hr));
+		return resource_view;
 	}
 
+	if (IsAssetCacheEnabled()) {
+		CacheTexture(cache_key, resource_view);
+	}
 	return resource_view;
 }
 
 dx_resource_view LoadCubemap(const string& filepath) {
-	auto image_data = ReadResource(filepath);
-
-	dx_resource_view cubemap_view;
-	auto hr = DirectX::CreateDDSTextureFromMemoryEx(
-		_device.Get(), _context.Get(),
-		(const uint8_t*) (image_data.data()), image_data.size(), 0,
-		D3D11_USAGE::D3D11_USAGE_DEFAULT,
-		D3D11_BIND_SHADER_RESOURCE,
-		0, 0,
-		false,
-		nullptr, cubemap_view.GetAddressOf(), 
-		nullptr
-		);
-
-	if (FAILED(hr)) {
-		LogError("Couldn't create texture: {}", ErrMsg(hr));
-	}
-
-	return cubemap_view;
+	// already a DDS, nothing to cache
+	return CreateTextureFromDDS(ReadResource(filepath));
 }
 
 } // namespace pn
\ No newline at end of file
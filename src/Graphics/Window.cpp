@@ -1,6 +1,6 @@
-#include <Graphics\Window.h>
+#include <Graphics/Window.h>
 
-#include <Utilities\Logging.h>
+#include <Utilities/Logging.h>
 
 namespace {
 
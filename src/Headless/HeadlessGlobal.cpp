@@ -0,0 +1,45 @@
+#include <Application/Global.h>
+#include <IO/AssetCache.h>
+#include <IO/PathUtil.h>
+#include <Utilities/FrameArena.h>
+#include <Utilities/Logging.h>
+
+namespace pn {
+
+namespace app {
+
+// -------- VARIABLES -----------
+
+double FPS;
+double FIXED_DT;
+double dt;
+double running_time;
+
+bool exit;
+
+// ---------- FUNCTIONS ---------
+
+// There's no Json reader in headless builds, so partition.json is ignored and the defaults of
+// the windowed build are used: resources in ./resources, the asset cache in ./cache, and the
+// default frame arenas
+void LoadEngineConfiguration() {
+	pn::SetWorkingDirectory(".");
+	pn::SetResourceDirectoryName("resources");
+
+	const auto cache_path = pn::GetWorkingDirectory() + "cache";
+	LogInfo("Asset Cache Folder: {}", cache_path);
+	pn::InitAssetCache(cache_path);
+
+	pn::InitFrameArenas();
+}
+
+void Exit() {
+	exit = true;
+}
+bool ShouldExit() {
+	return exit;
+}
+
+}
+
+}
@@ -0,0 +1,24 @@
+#include <Graphics/MeshBuffer.h>
+#include <Graphics/CookedMesh.h>
+
+namespace pn {
+
+// ------ FUNCTIONS -----------
+
+mesh_buffer_t CreateMeshBuffer(const cooked_mesh_view_t& view, const cooked_submesh_t& mesh) {
+	mesh_buffer_t mesh_buffer{};
+
+	const auto vertices = GetStream<vec3f>(view, mesh, mesh_stream_t::VERTICES);
+	if (vertices.empty()) {
+		LogError("Mesh has no vertices");
+		return mesh_buffer;
+	}
+
+	mesh_buffer.name			= GetMeshName(view, mesh);
+	mesh_buffer.vertex_count	= static_cast<unsigned int>(vertices.size());
+	mesh_buffer.index_count		= static_cast<unsigned int>(GetStream<uint32_t>(view, mesh, mesh_stream_t::INDICES).size());
+	mesh_buffer.topology		= mesh.topology;
+	return mesh_buffer;
+}
+
+} // namespace pn
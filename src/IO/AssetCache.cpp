@@ -0,0 +1,241 @@
+#include <IO/AssetCache.h>
+
+#include <IO/FileUtil.h>
+
+#include <Utilities/Hash.h>
+#include <Utilities/Logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+
+namespace pn {
+
+namespace fs = std::filesystem;
+
+#pragma region Internal
+
+struct cache_entry_t {
+	uint64_t	size		= 0;
+	uint64_t	last_use	= 0;
+};
+
+struct asset_cache_t {
+	std::mutex					lock;
+	fs::path					directory;
+	uint64_t					max_size	= 0;
+	uint64_t					use_clock	= 0;
+	pn::map<string, cache_entry_t>	entries;	// by file name
+	asset_cache_stats_t			stats;
+	std::atomic<uint32_t>		temp_counter{ 0 };
+};
+
+static asset_cache_t* CACHE = nullptr;
+
+static string FileName(const asset_key_t& key) {
+	return fmt::format("{:016x}.{}", key.hash, key.kind);
+}
+
+// Drops the least recently used entries until the cache fits. Called with the lock held.
+static void Evict(asset_cache_t& cache) {
+	if (cache.stats.total_size <= cache.max_size) return;
+
+	pn::vector<std::pair<uint64_t, string>> by_age;
+	Reserve(by_age, Size(cache.entries));
+	for (const auto& entry : cache.entries) {
+		PushBack(by_age, std::make_pair(entry.second.last_use, entry.first));
+	}
+	std::sort(by_age.begin(), by_age.end());
+
+	for (const auto& victim : by_age) {
+		if (cache.stats.total_size <= cache.max_size) break;
+
+		std::error_code error;
+		fs::remove(cache.directory / victim.second, error);
+		if (error) {
+			// most likely still mapped by a load in flight, the next scan picks it up again
+			LogDebug("Asset cache: couldn't remove {}: {}", victim.second, error.message());
+		}
+
+		cache.stats.total_size -= cache.entries[victim.second].size;
+		cache.entries.erase(victim.second);
+		++cache.stats.evictions;
+	}
+	cache.stats.entry_count = Size(cache.entries);
+}
+
+// Looks the entry up and marks it as used. Returns the path, or an empty path on a miss.
+static fs::path UseEntry(const asset_key_t& key) {
+	const auto name = FileName(key);
+	fs::path path;
+	{
+		std::lock_guard<std::mutex> guard(CACHE->lock);
+		auto it = CACHE->entries.find(name);
+		if (it == CACHE->entries.end()) {
+			++CACHE->stats.misses;
+			return path;
+		}
+		it->second.last_use = ++CACHE->use_clock;
+		path = CACHE->directory / name;
+	}
+
+	// keeps the order across runs, a failure only costs recency
+	std::error_code error;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+	return path;
+}
+
+static void RecordRead(const asset_key_t& key, const bool found, const uint64_t size) {
+	std::lock_guard<std::mutex> guard(CACHE->lock);
+	if (found) {
+		++CACHE->stats.hits;
+		CACHE->stats.bytes_read += size;
+		return;
+	}
+
+	// the file went away behind our back
+	++CACHE->stats.misses;
+	auto it = CACHE->entries.find(FileName(key));
+	if (it != CACHE->entries.end()) {
+		CACHE->stats.total_size -= it->second.size;
+		CACHE->entries.erase(it);
+		CACHE->stats.entry_count = Size(CACHE->entries);
+	}
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+void				InitAssetCache(const string& directory, const uint64_t max_size) {
+	if (CACHE != nullptr) {
+		LogError("Asset cache already initialized");
+		return;
+	}
+
+	std::error_code error;
+	fs::create_directories(directory, error);
+	if (error) {
+		LogError("Asset cache: couldn't create {}: {}", directory, error.message());
+		return;
+	}
+
+	auto* cache = new asset_cache_t;
+	cache->directory = fs::path(directory);
+	cache->max_size = max_size;
+
+	// rebuild the index, oldest modification time first
+	pn::vector<std::pair<fs::file_time_type, std::pair<string, uint64_t>>> found;
+	for (const auto& entry : fs::directory_iterator(cache->directory, error)) {
+		if (!entry.is_regular_file(error)) continue;
+		const auto name = entry.path().filename().string();
+		if (entry.path().extension() == ".tmp") {
+			// left behind by a crash during a store
+			fs::remove(entry.path(), error);
+			continue;
+		}
+		PushBack(found, std::make_pair(entry.last_write_time(error), std::make_pair(name, static_cast<uint64_t>(entry.file_size(error)))));
+	}
+	std::sort(found.begin(), found.end());
+
+	for (const auto& file : found) {
+		cache->entries[file.second.first] = cache_entry_t{ file.second.second, ++cache->use_clock };
+		cache->stats.total_size += file.second.second;
+	}
+	cache->stats.entry_count = Size(cache->entries);
+	Evict(*cache);
+
+	CACHE = cache;
+	LogInfo("Asset cache: {} entries, {} bytes in {}", CACHE->stats.entry_count, CACHE->stats.total_size, directory);
+}
+
+void				ShutdownAssetCache() {
+	if (CACHE == nullptr) return;
+	LogAssetCacheStats();
+	delete CACHE;
+	CACHE = nullptr;
+}
+
+bool				IsAssetCacheEnabled() {
+	return CACHE != nullptr;
+}
+
+asset_key_t			MakeAssetKey(const string& kind, const uint64_t source_hash, const uint64_t options_hash) {
+	asset_key_t key;
+	key.kind = kind;
+	key.hash = HashCombine(HashCombine(Hash64(kind), source_hash), options_hash);
+	return key;
+}
+
+bool				ReadCachedAsset(const asset_key_t& key, bytes& data) {
+	if (CACHE == nullptr) return false;
+
+	const auto path = UseEntry(key);
+	if (path.empty()) return false;
+
+	data = ReadFile(path.string());
+	RecordRead(key, !data.empty(), Size(data));
+	return !data.empty();
+}
+
+mapped_file_t		MapCachedAsset(const asset_key_t& key) {
+	if (CACHE == nullptr) return {};
+
+	const auto path = UseEntry(key);
+	if (path.empty()) return {};
+
+	auto file = MapFile(path.string());
+	RecordRead(key, IsMapped(file), file.size);
+	return file;
+}
+
+void				StoreCachedAsset(const asset_key_t& key, const bytes& data) {
+	if (CACHE == nullptr || data.empty()) return;
+
+	const auto name = FileName(key);
+	const auto path = CACHE->directory / name;
+	const auto temp_path = CACHE->directory / fmt::format("{}.{}.tmp", name, CACHE->temp_counter.fetch_add(1));
+	if (!WriteFile(temp_path.string(), data.data(), Size(data))) {
+		return;
+	}
+
+	std::error_code error;
+	fs::rename(temp_path, path, error);
+	if (error) {
+		LogError("Asset cache: couldn't store {}: {}", name, error.message());
+		fs::remove(temp_path, error);
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(CACHE->lock);
+	auto& entry = CACHE->entries[name];
+	CACHE->stats.total_size += Size(data) - entry.size;
+	entry.size = Size(data);
+	entry.last_use = ++CACHE->use_clock;
+	++CACHE->stats.stores;
+	CACHE->stats.bytes_written += Size(data);
+	CACHE->stats.entry_count = Size(CACHE->entries);
+	Evict(*CACHE);
+}
+
+string				CachedAssetPath(const asset_key_t& key) {
+	if (CACHE == nullptr) return "";
+	return (CACHE->directory / FileName(key)).string();
+}
+
+asset_cache_stats_t	GetAssetCacheStats() {
+	if (CACHE == nullptr) return {};
+	std::lock_guard<std::mutex> guard(CACHE->lock);
+	return CACHE->stats;
+}
+
+void				LogAssetCacheStats() {
+	const auto stats = GetAssetCacheStats();
+	LogInfo("Asset cache: {} hits, {} misses, {} stores, {} evictions, {} bytes read, {} bytes written, {} entries using {} bytes",
+		stats.hits, stats.misses, stats.stores, stats.evictions, stats.bytes_read, stats.bytes_written, stats.entry_count, stats.total_size);
+}
+
+#pragma endregion
+
+} // namespace pn
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <IO/MappedFile.h>
+
+#include <Utilities/UtilityTypes.h>
+
+#include <cstdint>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr uint64_t DEFAULT_ASSET_CACHE_SIZE = 1024ull * 1024ull * 1024ull;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Identifies one derived asset. hash covers the source bytes and every import option that changes
+// the output, kind says what produced it and becomes the file extension.
+struct asset_key_t {
+	uint64_t	hash = 0;
+	string		kind;
+};
+
+struct asset_cache_stats_t {
+	uint64_t	hits			= 0;
+	uint64_t	misses			= 0;
+	uint64_t	stores			= 0;
+	uint64_t	evictions		= 0;
+	uint64_t	bytes_read		= 0;
+	uint64_t	bytes_written	= 0;
+	uint64_t	entry_count		= 0;
+	uint64_t	total_size		= 0;
+};
+
+// -------- FUNCTIONS ------------
+
+// Persistent cache of cooked assets under directory, trimmed to max_size bytes by evicting the
+// least recently used entries. Recency survives restarts through the file modification times.
+// Every function is safe to call from any thread, and does nothing until the cache is initialized.
+void				InitAssetCache(const string& directory, const uint64_t max_size = DEFAULT_ASSET_CACHE_SIZE);
+void				ShutdownAssetCache();
+bool				IsAssetCacheEnabled();
+
+// kind + source hash + options hash. Bump the kind's version string when the cooked layout changes.
+asset_key_t			MakeAssetKey(const string& kind, const uint64_t source_hash, const uint64_t options_hash = 0);
+
+// Both count a hit or a miss and mark the entry as just used
+bool				ReadCachedAsset(const asset_key_t& key, bytes& data);
+mapped_file_t		MapCachedAsset(const asset_key_t& key);
+
+void				StoreCachedAsset(const asset_key_t& key, const bytes& data);
+
+// Path the entry lives at, whether it exists or not
+string				CachedAssetPath(const asset_key_t& key);
+
+asset_cache_stats_t	GetAssetCacheStats();
+void				LogAssetCacheStats();
+
+} // namespace pn
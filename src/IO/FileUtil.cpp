@@ -1,8 +1,8 @@
-#include <IO\FileUtil.h>
+#include <IO/FileUtil.h>
 
 #include <fstream>
 
-#include <Utilities\Logging.h>
+#include <Utilities/Logging.h>
 
 namespace pn {
 
@@ -32,4 +32,19 @@ bytes ReadResource(const string& resource_path) {
 	return ReadFile(resource_path);
 }
 
+bool WriteFile(const string& filename, const char* data, const size_t size) {
+	std::ofstream output_file(filename, std::ios::binary | std::ios::trunc);
+	if (output_file.fail()) {
+		LogError("Couldn't open file {} for writing: {}", filename, strerror(errno));
+		return false;
+	}
+
+	output_file.write(data, size);
+	if (output_file.fail()) {
+		LogError("Couldn't write file {}: {}", filename, strerror(errno));
+		return false;
+	}
+	return true;
+}
+
 } // namespace pn
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/UtilityTypes.h>
 
 namespace pn {
 
 bytes ReadFile(const string& filename);
 bytes ReadResource(const string& resource_path);
 
+// Replaces the file. Returns false and logs if it couldn't be written.
+bool  WriteFile(const string& filename, const char* data, const size_t size);
+
 } // namespace pn
\ No newline at end of file
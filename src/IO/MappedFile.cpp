@@ -0,0 +1,109 @@
+#include <IO/MappedFile.h>
+
+#include <Utilities/Logging.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pn {
+
+#ifdef _WIN32
+
+mapped_file_t	MapFile(const string& filename) {
+	mapped_file_t result;
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		LogError("Couldn't open file {}: {}", filename, ErrMsg(GetLastError()));
+		return result;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		LogError("Couldn't map file {}: {}", filename, "File is empty");
+		CloseHandle(file);
+		return result;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		LogError("Couldn't map file {}: {}", filename, ErrMsg(GetLastError()));
+		CloseHandle(file);
+		return result;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		LogError("Couldn't map file {}: {}", filename, ErrMsg(GetLastError()));
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return result;
+	}
+
+	result.data				= static_cast<const char*>(view);
+	result.size				= static_cast<size_t>(size.QuadPart);
+	result.file_handle		= file;
+	result.mapping_handle	= mapping;
+	return result;
+}
+
+void			UnmapFile(mapped_file_t& file) {
+	if (file.data != nullptr) {
+		UnmapViewOfFile(file.data);
+		CloseHandle(file.mapping_handle);
+		CloseHandle(file.file_handle);
+	}
+	file = mapped_file_t{};
+}
+
+#else
+
+mapped_file_t	MapFile(const string& filename) {
+	mapped_file_t result;
+
+	const int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		LogError("Couldn't open file {}: {}", filename, strerror(errno));
+		return result;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+		LogError("Couldn't map file {}: {}", filename, "File is empty");
+		close(fd);
+		return result;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps its own reference to the file
+	close(fd);
+	if (view == MAP_FAILED) {
+		LogError("Couldn't map file {}: {}", filename, strerror(errno));
+		return result;
+	}
+
+	result.data = static_cast<const char*>(view);
+	result.size = static_cast<size_t>(file_stat.st_size);
+	return result;
+}
+
+void			UnmapFile(mapped_file_t& file) {
+	if (file.data != nullptr) {
+		munmap(const_cast<char*>(file.data), file.size);
+	}
+	file = mapped_file_t{};
+}
+
+#endif
+
+bool			IsMapped(const mapped_file_t& file) {
+	return file.data != nullptr;
+}
+
+} // namespace pn
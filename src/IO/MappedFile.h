@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Utilities/UtilityTypes.h>
+
+namespace pn {
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Read-only view of a whole file mapped into memory. The data is page aligned and stays valid
+// until UnmapFile.
+struct mapped_file_t {
+	const char*	data			= nullptr;
+	size_t		size			= 0;
+	void*		file_handle		= nullptr;	// only used on Windows
+	void*		mapping_handle	= nullptr;	// only used on Windows
+};
+
+// ------------------- FUNCTIONS --------------------
+
+mapped_file_t	MapFile(const string& filename);
+void			UnmapFile(mapped_file_t& file);
+
+bool			IsMapped(const mapped_file_t& file);
+
+} // namespace pn
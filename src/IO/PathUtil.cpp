@@ -1,4 +1,4 @@
-#include <IO\PathUtil.h>
+#include <IO/PathUtil.h>
 
 namespace pn {
 
@@ -7,10 +7,10 @@ namespace pn {
 static string working_dir;
 static string resource_dir;
 
-static string texture_dir = "texture\\";
-static string mesh_dir    = "mesh\\";
-static string cubemap_dir = "cubemap\\";
-static string shader_dir  = "shader\\";
+static string texture_dir = "texture/";
+static string mesh_dir    = "mesh/";
+static string cubemap_dir = "cubemap/";
+static string shader_dir  = "shader/";
 
 // --------- FUNCTIONS -----------------
 
@@ -46,7 +46,7 @@ string ResourceTypeToDirectory(const string& resource_name) {
 	if (file_extension == "jpg" || file_extension == "png") {
 		return texture_dir;
 	}
-	if (file_extension == "fbx") {
+	if (file_extension == "fbx" || file_extension == "pnmesh") {
 		return mesh_dir;
 	}
 	if (file_extension == "hlsl" || file_extension == "hlsli") {
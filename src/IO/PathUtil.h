@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/UtilityTypes.h>
 
 namespace pn {
 
@@ -1,12 +1,12 @@
-#include <Input\Input.h>
+#include <Input/Input.h>
 
-#include <Graphics\Window.h>
+#include <Graphics/Window.h>
 
 #include <cassert>
 
-#include <Utilities\Logging.h>
+#include <Utilities/Logging.h>
 
-#include <Application\Global.h>
+#include <Application/Global.h>
 
 namespace pn {
 
@@ -1,9 +1,9 @@
-#include <System\Flycam.h>
+#include <System/Flycam.h>
 
-#include <Component\transform_t.h>
+#include <Component/transform_t.h>
 
-#include <Input\Input.h>
-#include <Application\Global.h>
+#include <Input/Input.h>
+#include <Application/Global.h>
 
 namespace pn {
 
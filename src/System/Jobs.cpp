@@ -0,0 +1,320 @@
+#include <System/Jobs.h>
+
+#include <Utilities/Logging.h>
+#include <Utilities/Profile.h>
+
+#include <condition_variable>
+#include <memory>
+#include <thread>
+
+namespace pn::jobs {
+
+#pragma region Work Deque
+
+// Chase-Lev deque. The owning thread pushes and pops at the bottom, any other thread steals
+// from the top.
+class work_deque_t {
+public:
+	static constexpr int64_t CAPACITY = 4096;
+
+	bool	Push(job_t* job) {
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		if (b - t >= CAPACITY) {
+			return false;
+		}
+		buffer[b & MASK].store(job, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+
+	job_t*	Pop() {
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		job_t* job = buffer[b & MASK].load(std::memory_order_relaxed);
+		if (t == b) {
+			// last element, race the thieves for it
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				job = nullptr;
+			}
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	job_t*	Steal() {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return nullptr;
+		}
+
+		job_t* job = buffer[t & MASK].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return job;
+	}
+
+private:
+	static constexpr int64_t MASK = CAPACITY - 1;
+	static_assert((CAPACITY & MASK) == 0, "Deque capacity must be a power of two");
+
+	alignas(64) std::atomic<int64_t>	top{ 0 };
+	alignas(64) std::atomic<int64_t>	bottom{ 0 };
+	std::atomic<job_t*>					buffer[CAPACITY];
+};
+
+#pragma endregion
+
+#pragma region Job System
+
+struct job_system_t {
+	pn::vector<std::unique_ptr<work_deque_t>>	deques;		// deques[0] belongs to the Init thread
+	pn::vector<std::thread>						workers;
+
+	// jobs queued from threads that don't own a deque
+	std::mutex									external_lock;
+	pn::vector<job_t*>							external_jobs;
+	std::atomic<int>							external_count{ 0 };
+
+	std::atomic<int>							queued{ 0 };
+	std::atomic<int>							sleepers{ 0 };
+	std::mutex									sleep_lock;
+	std::condition_variable						wake;
+	std::atomic<bool>							running{ true };
+};
+
+static job_system_t*			SYSTEM = nullptr;
+static thread_local unsigned	THREAD_INDEX = 0;
+static thread_local bool		OWNS_DEQUE = false;
+
+static void Decrement(counter_t& counter);
+
+static void Execute(job_t* job) {
+	{
+		PN_PROFILE_SCOPE("Job");
+		job->invoke(job);
+	}
+	job->destroy(job);
+	auto* counter = job->counter;
+	delete job;
+	if (counter != nullptr) {
+		Decrement(*counter);
+	}
+}
+
+static void Decrement(counter_t& counter) {
+	counter.releasing.fetch_add(1, std::memory_order_seq_cst);
+	if (counter.value.fetch_sub(1, std::memory_order_seq_cst) != 1) {
+		counter.releasing.fetch_sub(1, std::memory_order_release);
+		return;
+	}
+
+	pn::vector<job_t*> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter.continuation_lock);
+		ready.swap(counter.continuations);
+	}
+	// last access to the counter, a waiter may destroy it from here on
+	counter.releasing.fetch_sub(1, std::memory_order_release);
+
+	for (auto* job : ready) {
+		Run(job);
+	}
+}
+
+static void NotifyQueued() {
+	SYSTEM->queued.fetch_add(1, std::memory_order_seq_cst);
+	if (SYSTEM->sleepers.load(std::memory_order_seq_cst) > 0) {
+		// pairs with the predicate check in WorkerLoop so the wake up can't be missed
+		{ std::lock_guard<std::mutex> lock(SYSTEM->sleep_lock); }
+		SYSTEM->wake.notify_one();
+	}
+}
+
+static job_t* FindJob() {
+	auto& system = *SYSTEM;
+	job_t* job = nullptr;
+
+	if (OWNS_DEQUE) {
+		job = system.deques[THREAD_INDEX]->Pop();
+	}
+
+	if (job == nullptr && system.external_count.load(std::memory_order_acquire) > 0) {
+		std::unique_lock<std::mutex> lock(system.external_lock, std::try_to_lock);
+		if (lock.owns_lock() && !system.external_jobs.empty()) {
+			job = Pop(system.external_jobs);
+			system.external_count.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (job == nullptr) {
+		const auto count = static_cast<unsigned>(Size(system.deques));
+		for (unsigned i = 1; i <= count && job == nullptr; ++i) {
+			const unsigned victim = (THREAD_INDEX + i) % count;
+			if (OWNS_DEQUE && victim == THREAD_INDEX) continue;
+			job = system.deques[victim]->Steal();
+		}
+	}
+
+	if (job != nullptr) {
+		system.queued.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+static void WorkerLoop(const unsigned index) {
+	THREAD_INDEX = index;
+	OWNS_DEQUE = true;
+	SetProfileThreadName(fmt::format("job worker {}", index).c_str());
+
+	auto& system = *SYSTEM;
+	constexpr int SPIN_COUNT = 64;
+	int idle = 0;
+	while (system.running.load(std::memory_order_acquire)) {
+		if (auto* job = FindJob()) {
+			Execute(job);
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < SPIN_COUNT) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(system.sleep_lock);
+		system.sleepers.fetch_add(1, std::memory_order_seq_cst);
+		system.wake.wait(lock, [&] {
+			return system.queued.load(std::memory_order_seq_cst) > 0 || !system.running.load(std::memory_order_acquire);
+		});
+		system.sleepers.fetch_sub(1, std::memory_order_relaxed);
+		idle = 0;
+	}
+
+	OWNS_DEQUE = false;
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+void			Init(unsigned int worker_count) {
+	if (SYSTEM != nullptr) {
+		LogError("Job system already initialized");
+		return;
+	}
+
+	if (worker_count == UINT_MAX) {
+		const unsigned hardware_threads = std::thread::hardware_concurrency();
+		worker_count = (hardware_threads > 1) ? hardware_threads - 1 : 0;
+	}
+
+	SYSTEM = new job_system_t;
+	for (unsigned i = 0; i <= worker_count; ++i) {
+		SYSTEM->deques.emplace_back(std::make_unique<work_deque_t>());
+	}
+
+	THREAD_INDEX = 0;
+	OWNS_DEQUE = true;
+	for (unsigned i = 1; i <= worker_count; ++i) {
+		SYSTEM->workers.emplace_back(WorkerLoop, i);
+	}
+
+	LogDebug("Job system started with {} worker threads", worker_count);
+}
+
+void			Shutdown() {
+	if (SYSTEM == nullptr) return;
+
+	{
+		std::lock_guard<std::mutex> lock(SYSTEM->sleep_lock);
+		SYSTEM->running.store(false, std::memory_order_release);
+	}
+	SYSTEM->wake.notify_all();
+	for (auto& worker : SYSTEM->workers) {
+		worker.join();
+	}
+
+	// finish whatever is still queued so no counter is left waiting
+	while (auto* job = FindJob()) {
+		Execute(job);
+	}
+
+	delete SYSTEM;
+	SYSTEM = nullptr;
+	THREAD_INDEX = 0;
+	OWNS_DEQUE = false;
+}
+
+bool			IsInitialized() {
+	return SYSTEM != nullptr;
+}
+
+unsigned int	ThreadCount() {
+	return (SYSTEM != nullptr) ? static_cast<unsigned>(Size(SYSTEM->deques)) : 1;
+}
+
+unsigned int	ThreadIndex() {
+	return THREAD_INDEX;
+}
+
+void			Run(job_t* job) {
+	if (SYSTEM == nullptr) {
+		Execute(job);
+		return;
+	}
+
+	if (OWNS_DEQUE) {
+		if (!SYSTEM->deques[THREAD_INDEX]->Push(job)) {
+			// deque is full, running it now still makes progress
+			Execute(job);
+			return;
+		}
+	} else {
+		std::lock_guard<std::mutex> lock(SYSTEM->external_lock);
+		PushBack(SYSTEM->external_jobs, job);
+		SYSTEM->external_count.fetch_add(1, std::memory_order_release);
+	}
+	NotifyQueued();
+}
+
+void			RunAfter(counter_t& dependency, job_t* job) {
+	{
+		std::lock_guard<std::mutex> lock(dependency.continuation_lock);
+		if (dependency.value.load(std::memory_order_acquire) > 0) {
+			PushBack(dependency.continuations, job);
+			return;
+		}
+	}
+	Run(job);
+}
+
+bool			IsDone(const counter_t& counter) {
+	return counter.value.load(std::memory_order_seq_cst) == 0 && counter.releasing.load(std::memory_order_seq_cst) == 0;
+}
+
+void			WaitForCounter(counter_t& counter) {
+	while (!IsDone(counter)) {
+		job_t* job = (SYSTEM != nullptr) ? FindJob() : nullptr;
+		if (job != nullptr) {
+			Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+#pragma endregion
+
+} // namespace pn::jobs
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Utilities/UtilityTypes.h>
+
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pn::jobs {
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// One unit of work. The closure lives inline, so jobs never allocate beyond the job itself.
+struct job_t {
+	static constexpr size_t STORAGE_SIZE = 64;
+
+	void	(*invoke)(job_t* job)	= nullptr;
+	void	(*destroy)(job_t* job)	= nullptr;
+	struct counter_t*				counter = nullptr;
+	alignas(16) unsigned char		storage[STORAGE_SIZE];
+};
+
+// Counts the outstanding jobs of a group. Jobs started with RunAfter are held here until the
+// count drops back to zero.
+struct counter_t {
+	std::atomic<int>		value{ 0 };
+	std::atomic<int>		releasing{ 0 };	// jobs still inside their decrement, see WaitForCounter
+	std::mutex				continuation_lock;
+	pn::vector<job_t*>		continuations;
+
+	counter_t() = default;
+	counter_t(const counter_t&) = delete;
+	counter_t& operator=(const counter_t&) = delete;
+};
+
+// -------- FUNCTIONS ------------
+
+// Starts worker_count threads, by default one per core minus the calling thread, which becomes
+// thread 0 and keeps its own deque. Before Init, or after Shutdown, jobs run immediately inline.
+void			Init(unsigned int worker_count = UINT_MAX);
+void			Shutdown();
+
+bool			IsInitialized();
+
+// Workers plus the thread that called Init
+unsigned int	ThreadCount();
+
+// Index of the calling thread, 0 for the Init thread and for threads the system doesn't own
+unsigned int	ThreadIndex();
+
+// Queues a job. Jobs pushed by a thread go to its own deque, idle threads steal from the others.
+void			Run(job_t* job);
+
+// Queues job once dependency reaches zero
+void			RunAfter(counter_t& dependency, job_t* job);
+
+// True once every job of the group has finished and released the counter
+bool			IsDone(const counter_t& counter);
+
+// Runs other jobs on this thread until counter reaches zero. Once it returns no job touches
+// the counter anymore, so it's safe to destroy.
+void			WaitForCounter(counter_t& counter);
+
+// --------- CLOSURE HELPERS -----------
+
+template<typename F>
+job_t*			MakeJob(F&& f, counter_t* counter = nullptr) {
+	using closure_t = std::decay_t<F>;
+	static_assert(sizeof(closure_t) <= job_t::STORAGE_SIZE, "Job closure too large, capture by reference or pointer");
+	static_assert(alignof(closure_t) <= 16, "Job closure over-aligned");
+
+	auto* job = new job_t;
+	new (job->storage) closure_t(std::forward<F>(f));
+	job->invoke = [](job_t* j) { (*reinterpret_cast<closure_t*>(j->storage))(); };
+	job->destroy = [](job_t* j) { reinterpret_cast<closure_t*>(j->storage)->~closure_t(); };
+	job->counter = counter;
+	if (counter != nullptr) {
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+template<typename F>
+void			Run(F&& f, counter_t* counter = nullptr) {
+	Run(MakeJob(std::forward<F>(f), counter));
+}
+
+template<typename F>
+void			RunAfter(counter_t& dependency, F&& f, counter_t* counter = nullptr) {
+	RunAfter(dependency, MakeJob(std::forward<F>(f), counter));
+}
+
+// Calls f(chunk_begin, chunk_end) over [begin, end) in chunks of at most grain_size and waits for
+// all of them. A grain_size of 0 splits the range into a few chunks per thread.
+template<typename F>
+void			ParallelFor(const size_t begin, const size_t end, const size_t grain_size, const F& f) {
+	if (end <= begin) return;
+	const size_t count = end - begin;
+	const size_t grain = (grain_size > 0) ? grain_size : std::max<size_t>(1, count / (4 * ThreadCount()));
+	if (count <= grain || ThreadCount() == 1) {
+		f(begin, end);
+		return;
+	}
+
+	counter_t counter;
+	const F* body = &f;
+	size_t chunk_begin = begin + grain;
+	for (; chunk_begin < end; chunk_begin += grain) {
+		const size_t chunk_end = std::min(end, chunk_begin + grain);
+		Run([body, chunk_begin, chunk_end] { (*body)(chunk_begin, chunk_end); }, &counter);
+	}
+	f(begin, begin + grain);
+	WaitForCounter(counter);
+}
+
+} // namespace pn::jobs
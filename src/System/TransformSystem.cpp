@@ -0,0 +1,281 @@
+#include <System/TransformSystem.h>
+#include <System/Jobs.h>
+
+#include <Utilities/Logging.h>
+
+#include <algorithm>
+
+namespace pn {
+
+#pragma region Internal
+
+// Depths while sorting. Known dead subtrees need their own value, so later walks stop at them.
+constexpr uint32_t UNVISITED	= UINT32_MAX;
+constexpr uint32_t DEAD_DEPTH	= UINT32_MAX - 1;
+
+static uint32_t IndexOf(const transform_hierarchy_t& h, const transform_id_t id) {
+	assert(IsValid(h, id));
+	return h.id_to_index[id];
+}
+
+template<typename T>
+static void Gather(pn::vector<T>& v, const pn::vector<uint32_t>& order) {
+	pn::vector<T> result;
+	Reserve(result, Size(order));
+	for (auto i : order) {
+		PushBack(result, v[i]);
+	}
+	v.swap(result);
+}
+
+// Drops destroyed nodes and their descendants, then restores breadth first order.
+// Within a level, nodes are ordered by their parent so siblings stay adjacent.
+static void SortHierarchy(transform_hierarchy_t& h) {
+	const uint32_t n = static_cast<uint32_t>(Size(h.ids));
+
+	// depth of every node, DEAD_DEPTH for destroyed subtrees
+	pn::vector<uint32_t> depths(n, UNVISITED);
+	pn::vector<uint32_t> chain;
+	uint32_t max_depth = 0;
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t cur = i;
+		while (depths[cur] == UNVISITED) {
+			if (h.ids[cur] == INVALID_TRANSFORM_ID) {
+				depths[cur] = DEAD_DEPTH;
+				break;
+			}
+			if (h.parents[cur] == INVALID_TRANSFORM_ID) {
+				depths[cur] = 0;
+				break;
+			}
+			PushBack(chain, cur);
+			cur = h.parents[cur];
+		}
+		while (!chain.empty()) {
+			const uint32_t child = Pop(chain);
+			const uint32_t parent_depth = depths[h.parents[child]];
+			depths[child] = (parent_depth == DEAD_DEPTH) ? DEAD_DEPTH : parent_depth + 1;
+		}
+		if (depths[i] != DEAD_DEPTH) {
+			max_depth = std::max(max_depth, depths[i]);
+		}
+	}
+
+	// bucket by level, release the ids of dead nodes
+	pn::vector<pn::vector<uint32_t>> levels(n > 0 ? max_depth + 1 : 0);
+	for (uint32_t i = 0; i < n; ++i) {
+		if (depths[i] == DEAD_DEPTH) {
+			if (h.ids[i] != INVALID_TRANSFORM_ID) {
+				h.id_to_index[h.ids[i]] = INVALID_TRANSFORM_ID;
+				PushBack(h.free_ids, h.ids[i]);
+			}
+			continue;
+		}
+		PushBack(levels[depths[i]], i);
+	}
+
+	pn::vector<uint32_t> order;
+	pn::vector<uint32_t> new_index(n, INVALID_TRANSFORM_ID);
+	Clear(h.level_starts);
+	for (auto& level : levels) {
+		if (level.empty()) break;
+		std::stable_sort(level.begin(), level.end(), [&](const uint32_t a, const uint32_t b) {
+			const uint32_t pa = h.parents[a] == INVALID_TRANSFORM_ID ? 0 : new_index[h.parents[a]];
+			const uint32_t pb = h.parents[b] == INVALID_TRANSFORM_ID ? 0 : new_index[h.parents[b]];
+			return pa < pb;
+		});
+		PushBack(h.level_starts, static_cast<uint32_t>(Size(order)));
+		for (auto i : level) {
+			new_index[i] = static_cast<uint32_t>(Size(order));
+			PushBack(order, i);
+		}
+	}
+	PushBack(h.level_starts, static_cast<uint32_t>(Size(order)));
+
+	Gather(h.positions, order);
+	Gather(h.rotations, order);
+	Gather(h.scales, order);
+	Gather(h.parents, order);
+	Gather(h.world_matrices, order);
+	Gather(h.local_dirty, order);
+	Gather(h.world_changed, order);
+	Gather(h.ids, order);
+
+	for (uint32_t i = 0; i < Size(order); ++i) {
+		auto& parent = h.parents[i];
+		if (parent != INVALID_TRANSFORM_ID) {
+			parent = new_index[parent];
+		}
+		h.id_to_index[h.ids[i]] = i;
+	}
+
+	h.needs_sort = false;
+}
+
+// Same as SRTMatrix, without the intermediate matrix products. Scaling by 2 / |q|^2 instead of
+// normalizing the quaternion first saves the square root.
+static mat4f BuildLocalMatrix(const vec3f& s, const quaternion& q, const vec3f& t) {
+	const float k = 2.0f / LengthSqr(q);
+	const float xx = q.x*q.x*k, yy = q.y*q.y*k, zz = q.z*q.z*k;
+	const float xy = q.x*q.y*k, xz = q.x*q.z*k, yz = q.y*q.z*k;
+	const float xw = q.x*q.w*k, yw = q.y*q.w*k, zw = q.z*q.w*k;
+
+	return mat4f(
+		s.x * (1 - (yy + zz)), s.x * (xy + zw), s.x * (xz - yw), 0.0f,
+		s.y * (xy - zw), s.y * (1 - (xx + zz)), s.y * (yz + xw), 0.0f,
+		s.z * (xz + yw), s.z * (yz - xw), s.z * (1 - (xx + yy)), 0.0f,
+		t.x, t.y, t.z, 1.0f
+	);
+}
+
+static void UpdateRange(transform_hierarchy_t& h, const uint32_t begin, const uint32_t end) {
+	for (uint32_t i = begin; i < end; ++i) {
+		const uint32_t parent = h.parents[i];
+		const bool changed = h.local_dirty[i] || (parent != INVALID_TRANSFORM_ID && h.world_changed[parent]);
+		h.world_changed[i] = changed;
+		if (!changed) continue;
+
+		const mat4f local = BuildLocalMatrix(h.scales[i], h.rotations[i], h.positions[i]);
+		h.world_matrices[i] = (parent != INVALID_TRANSFORM_ID) ? local * h.world_matrices[parent] : local;
+		h.local_dirty[i] = 0;
+	}
+}
+
+// Nodes of one level only read their parents, which live in an earlier level, so a level can be
+// split into independent chunks
+static void UpdateLevel(transform_hierarchy_t& h, const uint32_t begin, const uint32_t end) {
+	if (end - begin < PARALLEL_LEVEL_SIZE) {
+		UpdateRange(h, begin, end);
+		return;
+	}
+
+	jobs::ParallelFor(begin, end, PARALLEL_LEVEL_SIZE / 4, [&h](const size_t chunk_begin, const size_t chunk_end) {
+		UpdateRange(h, static_cast<uint32_t>(chunk_begin), static_cast<uint32_t>(chunk_end));
+	});
+}
+
+#pragma endregion
+
+#pragma region Hierarchy Functions
+
+transform_id_t		CreateTransform(transform_hierarchy_t& h, const transform_t& local, const transform_id_t parent) {
+	assert(parent == INVALID_TRANSFORM_ID || IsValid(h, parent));
+
+	transform_id_t id;
+	if (!h.free_ids.empty()) {
+		id = Pop(h.free_ids);
+	} else {
+		id = static_cast<transform_id_t>(Size(h.id_to_index));
+		PushBack(h.id_to_index, INVALID_TRANSFORM_ID);
+	}
+
+	const uint32_t index = static_cast<uint32_t>(Size(h.ids));
+	h.id_to_index[id] = index;
+	PushBack(h.positions, local.position);
+	PushBack(h.rotations, local.rotation);
+	PushBack(h.scales, local.scale);
+	PushBack(h.parents, parent == INVALID_TRANSFORM_ID ? INVALID_TRANSFORM_ID : IndexOf(h, parent));
+	PushBack(h.world_matrices, mat4f::Identity);
+	PushBack(h.local_dirty, uint8_t(1));
+	PushBack(h.world_changed, uint8_t(1));
+	PushBack(h.ids, id);
+
+	h.needs_sort = true;
+	return id;
+}
+
+void				DestroyTransform(transform_hierarchy_t& h, const transform_id_t id) {
+	const uint32_t index = IndexOf(h, id);
+	h.ids[index] = INVALID_TRANSFORM_ID;
+	h.id_to_index[id] = INVALID_TRANSFORM_ID;
+	PushBack(h.free_ids, id);
+
+	// the descendants go, and their ids are released, when the storage is next sorted, so
+	// destroying many nodes compacts only once
+	h.needs_sort = true;
+}
+
+bool				IsValid(const transform_hierarchy_t& h, const transform_id_t id) {
+	return id < Size(h.id_to_index) && h.id_to_index[id] != INVALID_TRANSFORM_ID;
+}
+
+size_t				Size(const transform_hierarchy_t& h) {
+	return Size(h.ids);
+}
+
+void				SetParent(transform_hierarchy_t& h, const transform_id_t id, const transform_id_t parent) {
+	const uint32_t index = IndexOf(h, id);
+	uint32_t parent_index = INVALID_TRANSFORM_ID;
+	if (parent != INVALID_TRANSFORM_ID) {
+		parent_index = IndexOf(h, parent);
+		for (uint32_t cur = parent_index; cur != INVALID_TRANSFORM_ID; cur = h.parents[cur]) {
+			if (cur == index) {
+				LogError("Can't parent transform {} to its own descendant {}", id, parent);
+				return;
+			}
+		}
+	}
+
+	h.parents[index] = parent_index;
+	h.local_dirty[index] = 1;
+	h.needs_sort = true;
+}
+
+transform_id_t		GetParent(const transform_hierarchy_t& h, const transform_id_t id) {
+	const uint32_t parent = h.parents[IndexOf(h, id)];
+	return (parent == INVALID_TRANSFORM_ID) ? INVALID_TRANSFORM_ID : h.ids[parent];
+}
+
+void				SetPosition(transform_hierarchy_t& h, const transform_id_t id, const vec3f& position) {
+	const uint32_t index = IndexOf(h, id);
+	h.positions[index] = position;
+	h.local_dirty[index] = 1;
+}
+
+void				SetRotation(transform_hierarchy_t& h, const transform_id_t id, const quaternion& rotation) {
+	const uint32_t index = IndexOf(h, id);
+	h.rotations[index] = rotation;
+	h.local_dirty[index] = 1;
+}
+
+void				SetScale(transform_hierarchy_t& h, const transform_id_t id, const vec3f& scale) {
+	const uint32_t index = IndexOf(h, id);
+	h.scales[index] = scale;
+	h.local_dirty[index] = 1;
+}
+
+transform_t			GetTransform(const transform_hierarchy_t& h, const transform_id_t id) {
+	const uint32_t index = IndexOf(h, id);
+	transform_t result;
+	result.position = h.positions[index];
+	result.rotation = h.rotations[index];
+	result.scale = h.scales[index];
+	result.world_matrix = h.world_matrices[index];
+	result.world_dirty = false;
+	return result;
+}
+
+void				SetTransform(transform_hierarchy_t& h, const transform_id_t id, const transform_t& local) {
+	const uint32_t index = IndexOf(h, id);
+	h.positions[index] = local.position;
+	h.rotations[index] = local.rotation;
+	h.scales[index] = local.scale;
+	h.local_dirty[index] = 1;
+}
+
+const mat4f&		GetWorldMatrix(const transform_hierarchy_t& h, const transform_id_t id) {
+	return h.world_matrices[IndexOf(h, id)];
+}
+
+void				UpdateTransforms(transform_hierarchy_t& h) {
+	if (h.needs_sort) {
+		SortHierarchy(h);
+	}
+	for (size_t level = 0; level + 1 < Size(h.level_starts); ++level) {
+		UpdateLevel(h, h.level_starts[level], h.level_starts[level + 1]);
+	}
+}
+
+#pragma endregion
+
+} // namespace pn
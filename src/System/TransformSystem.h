@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Component/transform_t.h>
+
+#include <Utilities/Math.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <cstdint>
+
+namespace pn {
+
+// ----- TYPEDEFS ----------
+
+// Stable handle to a node. Storage indices move whenever the hierarchy is re-sorted, handles don't.
+using transform_id_t = uint32_t;
+
+constexpr transform_id_t INVALID_TRANSFORM_ID = UINT32_MAX;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Flat scene graph. Nodes are kept in structure-of-arrays form, sorted breadth first so every
+// parent sits in an earlier level than its children, and link to their parent by index.
+// World matrices are rebuilt one level at a time by UpdateTransforms.
+struct transform_hierarchy_t {
+	// ---- per node, in storage order
+	pn::vector<pn::vec3f>		positions;
+	pn::vector<pn::quaternion>	rotations;
+	pn::vector<pn::vec3f>		scales;
+	pn::vector<uint32_t>		parents;		// storage index of the parent or INVALID_TRANSFORM_ID
+	pn::vector<pn::mat4f>		world_matrices;
+	pn::vector<uint8_t>			local_dirty;	// set by the mutators, cleared by UpdateTransforms
+	pn::vector<uint8_t>			world_changed;	// set by UpdateTransforms for nodes whose world matrix moved
+	pn::vector<transform_id_t>	ids;
+
+	// ---- per level, level d occupies [level_starts[d], level_starts[d + 1])
+	pn::vector<uint32_t>		level_starts;
+
+	// ---- per id
+	pn::vector<uint32_t>		id_to_index;
+	pn::vector<transform_id_t>	free_ids;
+
+	bool						needs_sort = false;
+};
+
+// -------- FUNCTIONS ------------
+
+// Adds a node with the given local transform. Its parent and cache fields are ignored, use the
+// parent argument instead.
+transform_id_t		CreateTransform(transform_hierarchy_t& h, const transform_t& local = transform_t{}, const transform_id_t parent = INVALID_TRANSFORM_ID);
+
+// Removes the node and all of its descendants. The node's id is released right away, the
+// descendants stay valid until the next UpdateTransforms drops them.
+void				DestroyTransform(transform_hierarchy_t& h, const transform_id_t id);
+
+bool				IsValid(const transform_hierarchy_t& h, const transform_id_t id);
+
+// Nodes in storage, destroyed ones included until the next UpdateTransforms
+size_t				Size(const transform_hierarchy_t& h);
+
+void				SetParent(transform_hierarchy_t& h, const transform_id_t id, const transform_id_t parent);
+transform_id_t		GetParent(const transform_hierarchy_t& h, const transform_id_t id);
+
+void				SetPosition(transform_hierarchy_t& h, const transform_id_t id, const vec3f& position);
+void				SetRotation(transform_hierarchy_t& h, const transform_id_t id, const quaternion& rotation);
+void				SetScale(transform_hierarchy_t& h, const transform_id_t id, const vec3f& scale);
+
+// transform_t view of a node: local position/rotation/scale plus its world matrix as of the last
+// UpdateTransforms. The returned value has no parent pointer, its matrices come from the hierarchy.
+transform_t			GetTransform(const transform_hierarchy_t& h, const transform_id_t id);
+
+// Writes back the local position/rotation/scale of a view
+void				SetTransform(transform_hierarchy_t& h, const transform_id_t id, const transform_t& local);
+
+// World matrix as of the last UpdateTransforms
+const mat4f&		GetWorldMatrix(const transform_hierarchy_t& h, const transform_id_t id);
+
+// Re-sorts the storage if nodes were added, removed or re-parented, then rebuilds the world
+// matrix of every node whose local transform, or any ancestor's, changed since the last update.
+// Levels with at least PARALLEL_LEVEL_SIZE nodes are split across the job system's threads.
+void				UpdateTransforms(transform_hierarchy_t& h);
+
+constexpr size_t	PARALLEL_LEVEL_SIZE = 4096;
+
+} // namespace pn
@@ -0,0 +1,20 @@
+#include <UI/EditStruct.h>
+
+namespace pn::gui {
+
+template<>
+void EditStruct(pn::transform_t& transform) {
+	if (!pn::gui::IsGUIOn()) return;
+	bool changed = DragFloat3("position", &transform.position.x, -INFINITY, INFINITY);
+	changed |= DragRotation("rotation", &transform.rotation,
+				 TransformDirection(transform, vec3f::UnitX),
+				 TransformDirection(transform, vec3f::UnitY),
+				 TransformDirection(transform, vec3f::UnitZ)
+	);
+	changed |= DragFloat3("scale", &transform.scale.x, -INFINITY, INFINITY);
+	if (changed) {
+		MarkDirty(transform);
+	}
+}
+
+}
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <UI\UIUtil.h>
-#include <imgui\imgui.h>
+#include <UI/UIUtil.h>
+#include <imgui/imgui.h>
+
+#include <Component/transform_t.h>
 
 namespace pn::gui {
 
@@ -17,4 +19,7 @@ void EditStruct(const pn::string& window_name, T& struct_t) {
 	ImGui::End();
 }
 
+template<>
+void EditStruct(pn::transform_t& transform);
+
 }
@@ -1,8 +1,13 @@
-#include <UI\EditorUI.h>
+#include <UI/EditorUI.h>
 
-#include <Application\Global.h>
+#include <Application/Global.h>
 
+#include <Utilities/FrameStats.h>
+#include <Utilities/MemoryTracking.h>
+#include <Utilities/ProfileCapture.h>
+#include <Utilities/SmallVector.h>
 
+#include <algorithm>
 
 namespace pn {
 
@@ -16,6 +21,8 @@ const float MAIN_MENU_HEIGHT = 20.0f;
 
 bool show_main_menu;
 bool show_command_line;
+bool show_memory;
+bool show_frame_stats;
 
 map<int, function_map> functions;
 struct AppConsole* command_line;
@@ -42,17 +49,17 @@ struct AppConsole {
 	~AppConsole() {
 		ClearLog();
 		for (int i = 0; i < History.Size; i++)
-			free(History[i]);
+			TrackedFree(History[i]);
 	}
 
 	// Portable helpers
 	static int   Stricmp(const char* str1, const char* str2) { int d; while ((d = toupper(*str2) - toupper(*str1)) == 0 && *str1) { str1++; str2++; } return d; }
 	static int   Strnicmp(const char* str1, const char* str2, int n) { int d = 0; while (n > 0 && (d = toupper(*str2) - toupper(*str1)) == 0 && *str1) { str1++; str2++; n--; } return d; }
-	static char* Strdup(const char *str) { size_t len = strlen(str) + 1; void* buff = malloc(len); return (char*) memcpy(buff, (const void*) str, len); }
+	static char* Strdup(const char *str) { size_t len = strlen(str) + 1; void* buff = TrackedAllocate(len, memory_tag_t::UI); return (char*) memcpy(buff, (const void*) str, len); }
 
 	void    ClearLog() {
 		for (int i = 0; i < Items.Size; i++)
-			free(Items[i]);
+			TrackedFree(Items[i]);
 		Items.clear();
 		ScrollToBottom = true;
 	}
@@ -125,7 +132,7 @@ struct AppConsole {
 		HistoryPos = -1;
 		for (int i = History.Size - 1; i >= 0; i--)
 			if (Stricmp(History[i], command_line) == 0) {
-				free(History[i]);
+				TrackedFree(History[i]);
 				History.erase(History.begin() + i);
 				break;
 			}
@@ -306,34 +313,53 @@ struct AppConsole {
 	}
 };
 
+// --------- COMMANDS --------
+
+// profile_capture <frames>: the next frames as a Chrome trace, see Utilities/ProfileCapture.h
+pn::string profile_capture(int frames) {
+	if (frames <= 0 || !StartProfileCapture(static_cast<uint32_t>(frames), DEFAULT_PROFILE_CAPTURE_PATH)) {
+		return "Couldn't start the capture, check log.";
+	}
+	return "Capturing " + std::to_string(frames) + " frames to " + DEFAULT_PROFILE_CAPTURE_PATH;
+}
+
+// frame_stats_csv: the window's frames, and a summary row per phase to compare builds with
+pn::string frame_stats_csv() {
+	if (!WriteFrameStatsCsv("frame_stats.csv") || !AppendFrameStatsSummaryCsv("frame_stats_summary.csv")) {
+		return "Couldn't write the frame stats, check log.";
+	}
+	return "Frame stats written to frame_stats.csv and frame_stats_summary.csv";
+}
+
 // --------- FUNCTIONS --------
 
 void InitEditorUI() {
 	show_main_menu = true;
 	show_command_line = false;
+	show_memory = false;
+	show_frame_stats = false;
 	command_line = new AppConsole;
+
+	REGISTER_COMMAND(profile_capture, pn::string, int);
+	REGISTER_COMMAND(frame_stats_csv, pn::string, void);
 }
 
 void ShutdownEditorUI() {
 	delete command_line;
 }
 
+// The average alone hides hitches, the 99th percentile frame shows them
 void DrawFPS() {
-	auto fps_text_size = ImGui::CalcTextSize("FPS: XXXXX.XXX");
+	auto fps_text_size = ImGui::CalcTextSize("FPS: XXXXX.XX  p99: XXXX.XX ms");
 	ImGui::SetCursorPosX(static_cast<float>(pn::app::window_desc.width) - fps_text_size.x);
-	
-	static float fps = 0.0f;
-	static float sec_per_frame = 0.0f;
-	static int num_frames = 0;
-	
-	sec_per_frame += pn::app::dt;
-	num_frames++;
-	if (sec_per_frame >= 0.2f) {
-		fps = 1 / (sec_per_frame / num_frames);
-		sec_per_frame = 0.0f;
-		num_frames = 0;
-	}
-	ImGui::Text("FPS: %.2f", fps);
+
+	const auto stats = GetFrameTimeStats(frame_phase_t::FRAME);
+	const float fps = (stats.avg_ms > 0.0f) ? 1000.0f / stats.avg_ms : 0.0f;
+	const bool hitching = stats.p99_ms > GetFrameHitchStats().threshold_ms;
+
+	if (hitching) ImGui::PushStyleColor(ImGuiCol_Text, ImColor(1.0f, 0.4f, 0.4f, 1.0f));
+	ImGui::Text("FPS: %.2f  p99: %.2f ms", fps, stats.p99_ms);
+	if (hitching) ImGui::PopStyleColor();
 }
 
 // --------- MAIN MENU ---------
@@ -363,6 +389,11 @@ void DrawMainMenu(const unsigned int screen_width) {
 
 				ImGui::EndMenu();
 			}
+			if (ImGui::BeginMenu("View")) {
+				ImGui::MenuItem("Memory", nullptr, &show_memory);
+				ImGui::MenuItem("Frame Stats", nullptr, &show_frame_stats);
+				ImGui::EndMenu();
+			}
 			DrawFPS();
 			ImGui::EndMenuBar();
 		}
@@ -372,6 +403,134 @@ void DrawMainMenu(const unsigned int screen_width) {
 	ImGui::PopStyleColor(1);
 }
 
+// --------- MEMORY -------------
+
+void SetMemoryWindow(bool value) {
+	show_memory = value;
+}
+
+void DrawMemoryWindow() {
+	if (!show_memory) return;
+
+	ImGui::SetNextWindowSize(ImVec2(640, 240), ImGuiSetCond_FirstUseEver);
+	if (!ImGui::Begin("Memory", &show_memory)) {
+		ImGui::End();
+		return;
+	}
+
+	const float KB = 1024.0f;
+	ImGui::Columns(6, "memory_tags");
+	for (const char* heading : { "Tag", "Current (KB)", "Peak (KB)", "Budget (KB)", "Live", "Last frame" }) {
+		ImGui::Text("%s", heading);
+		ImGui::NextColumn();
+	}
+	ImGui::Separator();
+
+	for (size_t i = 0; i < static_cast<size_t>(memory_tag_t::COUNT); ++i) {
+		const auto tag = static_cast<memory_tag_t>(i);
+		const auto stats = GetMemoryTagStats(tag);
+		const bool over = stats.budget > 0 && stats.current > stats.budget;
+
+		if (over) ImGui::PushStyleColor(ImGuiCol_Text, ImColor(1.0f, 0.4f, 0.4f, 1.0f));
+		ImGui::Text("%s", MemoryTagName(tag));		ImGui::NextColumn();
+		ImGui::Text("%.1f", stats.current / KB);	ImGui::NextColumn();
+		ImGui::Text("%.1f", stats.peak / KB);		ImGui::NextColumn();
+		if (stats.budget > 0)	ImGui::Text("%.1f", stats.budget / KB);
+		else					ImGui::Text("-");
+		ImGui::NextColumn();
+		ImGui::Text("%llu", static_cast<unsigned long long>(stats.live_allocations));
+		ImGui::NextColumn();
+		ImGui::Text("%llu (%.1f KB)", static_cast<unsigned long long>(stats.frame_allocations), stats.frame_bytes / KB);
+		ImGui::NextColumn();
+		if (over) ImGui::PopStyleColor();
+	}
+	ImGui::Columns(1);
+	ImGui::Separator();
+
+#if defined(PN_CONTAINER_STATS)
+	const auto vectors = GetSmallVectorStats();
+	const float spill_rate = (vectors.small_vectors > 0) ? 100.0f * vectors.small_vector_spills / vectors.small_vectors : 0.0f;
+	ImGui::Text("Small vectors: %llu of %llu spilled (%.1f%%), %llu fixed_vector overflows",
+		static_cast<unsigned long long>(vectors.small_vector_spills), static_cast<unsigned long long>(vectors.small_vectors),
+		spill_rate, static_cast<unsigned long long>(vectors.fixed_vector_overflows));
+	ImGui::Separator();
+#endif
+
+	if (ImGui::Button("Dump JSON")) {
+		WriteMemoryReport("memory_report.json");
+	}
+	ImGui::End();
+}
+
+// --------- FRAME STATS -------------
+
+void SetFrameStatsWindow(bool value) {
+	show_frame_stats = value;
+}
+
+void DrawFrameStatsWindow() {
+	if (!show_frame_stats) return;
+
+	ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiSetCond_FirstUseEver);
+	if (!ImGui::Begin("Frame Stats", &show_frame_stats)) {
+		ImGui::End();
+		return;
+	}
+
+	const auto frame	= GetFrameTimeStats(frame_phase_t::FRAME);
+	const auto hitches	= GetFrameHitchStats();
+	const float width	= ImGui::GetContentRegionAvailWidth();
+
+	// the last FRAME_STATS_WINDOW frames, scaled so the hitch threshold is always in view
+	static float times[FRAME_STATS_WINDOW];
+	const auto count = CopyFrameTimes(frame_phase_t::FRAME, times, FRAME_STATS_WINDOW);
+	char overlay[64];
+	snprintf(overlay, sizeof(overlay), "%.2f ms avg, %.2f ms max", frame.avg_ms, frame.max_ms);
+	ImGui::PlotLines("##frame_times", times, static_cast<int>(count), 0, overlay, 0.0f,
+		std::max(frame.max_ms, hitches.threshold_ms * 1.25f), ImVec2(width, 100.0f));
+
+	// one bucket per millisecond, the last takes everything past the threshold
+	const float BUCKET_MS = 1.0f;
+	static float buckets[64];
+	const auto bucket_count = std::min<size_t>(static_cast<size_t>(hitches.threshold_ms / BUCKET_MS) + 2, IM_ARRAYSIZE(buckets));
+	FrameTimeHistogram(frame_phase_t::FRAME, buckets, bucket_count, BUCKET_MS);
+	ImGui::PlotHistogram("##frame_histogram", buckets, static_cast<int>(bucket_count), 0, "frames per ms", 0.0f, FLT_MAX, ImVec2(width, 80.0f));
+
+	ImGui::Text("Hitches over %.1f ms: %u in the window, %llu of %llu frames", hitches.threshold_ms, hitches.window_hitches,
+		static_cast<unsigned long long>(hitches.hitches), static_cast<unsigned long long>(hitches.frames));
+	ImGui::Text("Spikes over %.0fx the average: %u in the window, %llu in all", FRAME_SPIKE_FACTOR, hitches.window_spikes,
+		static_cast<unsigned long long>(hitches.spikes));
+	ImGui::Separator();
+
+	ImGui::Columns(7, "frame_phases");
+	for (const char* heading : { "Phase (ms)", "Min", "Avg", "p50", "p95", "p99", "Max" }) {
+		ImGui::Text("%s", heading);
+		ImGui::NextColumn();
+	}
+	ImGui::Separator();
+
+	for (size_t i = 0; i < static_cast<size_t>(frame_phase_t::COUNT); ++i) {
+		const auto phase = static_cast<frame_phase_t>(i);
+		const auto stats = GetFrameTimeStats(phase);
+		ImGui::Text("%s", FramePhaseName(phase));	ImGui::NextColumn();
+		for (const float ms : { stats.min_ms, stats.avg_ms, stats.p50_ms, stats.p95_ms, stats.p99_ms, stats.max_ms }) {
+			ImGui::Text("%.3f", ms);
+			ImGui::NextColumn();
+		}
+	}
+	ImGui::Columns(1);
+	ImGui::Separator();
+
+	if (ImGui::Button("Dump CSV")) {
+		frame_stats_csv();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset")) {
+		ResetFrameStats();
+	}
+	ImGui::End();
+}
+
 // --------- COMMAND LINE -------
 
 
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <UI\UIUtil.h>
+#include <UI/UIUtil.h>
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/UtilityTypes.h>
 
 #include <functional>
 #include <type_traits>
@@ -54,6 +54,14 @@ void ShutdownEditorUI();
 void SetMainMenuVisible(bool value);
 void DrawMainMenu(const unsigned int screen_width);
 
+// Per tag memory use, see Utilities/MemoryTracking.h
+void SetMemoryWindow(bool value);
+void DrawMemoryWindow();
+
+// Frame time percentiles, graph and hitches, see Utilities/FrameStats.h
+void SetFrameStatsWindow(bool value);
+void DrawFrameStatsWindow();
+
 // --------- COMMAND LINE --------------
 
 void SetCommandLine(bool value);
@@ -1,8 +1,8 @@
-#include <UI\UIUtil.h>
+#include <UI/UIUtil.h>
 
-#include <Input\Input.h>
+#include <Input/Input.h>
 
-#include <imgui\imgui_internal.h>
+#include <imgui/imgui_internal.h>
 
 // -------- VARIABLES ---------
 
@@ -76,8 +76,8 @@ bool DragFloat4(const char* label, float* v, float min, float max, float speed_m
 	return ImGui::DragFloat4(label, v, GetDragSpeed() * speed_modifer, min, max, display_format, power);
 }
 
-void DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y, const vec3f z, float speed_modifier) {
-	VALIDATE_GUI_ON;
+bool DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y, const vec3f z, float speed_modifier) {
+	VALIDATE_GUI_ON false;
 
 	const float ROT_SCALE = 0.01f * speed_modifier;
 
@@ -100,9 +100,10 @@ void DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y
 		window->DC.ItemWidthStack.push_back(w_item_one);
 	window->DC.ItemWidth = window->DC.ItemWidthStack.back();
 
+	float xr = 0.0f, xy = 0.0f, xz = 0.0f;
 	{
 		PushID(0);
-		float xr = ImGui::DeltaDragFloat("##v", &euler.x);
+		xr = ImGui::DeltaDragFloat("##v", &euler.x);
 		if (xr != 0.0f)
 			*q *= AxisAngleToQuaternion(x, xr*ROT_SCALE);
 		SameLine(0, g.Style.ItemInnerSpacing.x);
@@ -112,7 +113,7 @@ void DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y
 
 	{
 		PushID(1);
-		float xy = ImGui::DeltaDragFloat("##v", &euler.y);
+		xy = ImGui::DeltaDragFloat("##v", &euler.y);
 		if (xy != 0.0f)
 			*q *= AxisAngleToQuaternion(y, xy*ROT_SCALE);
 		SameLine(0, g.Style.ItemInnerSpacing.x);
@@ -122,7 +123,7 @@ void DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y
 
 	{
 		PushID(2);
-		float xz = ImGui::DeltaDragFloat("##v", &euler.z);
+		xz = ImGui::DeltaDragFloat("##v", &euler.z);
 		if (xz != 0.0f)
 			*q *= AxisAngleToQuaternion(z, xz*ROT_SCALE);
 		SameLine(0, g.Style.ItemInnerSpacing.x);
@@ -134,6 +135,8 @@ void DragRotation(const char* label, quaternion* q, const vec3f x, const vec3f y
 
 	TextUnformatted(label, FindRenderedTextEnd(label));
 	EndGroup();
+
+	return (xr != 0.0f) || (xy != 0.0f) || (xz != 0.0f);
 }
 
 } // namespace gui
@@ -0,0 +1,813 @@
+#pragma once
+
+#include <Utilities/SIMD.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+// Slots probed at once. The portable group is a uint64_t, so it assumes a little endian target.
+#if defined(PN_SIMD_SSE41)
+constexpr size_t FLAT_MAP_GROUP_WIDTH	= 16;
+#else
+constexpr size_t FLAT_MAP_GROUP_WIDTH	= 8;
+#endif
+
+// One control byte per slot. Full slots hold the low 7 bits of their key's hash, so a probe
+// compares a whole group of slots against those bits before it touches any key.
+constexpr int8_t FLAT_MAP_EMPTY		= -128;
+constexpr int8_t FLAT_MAP_DELETED	= -2;
+constexpr int8_t FLAT_MAP_SENTINEL	= -1;	// after the last slot, ends iteration
+
+// What maps without a table point at, so lookups never have to check for one
+alignas(16) inline const int8_t FLAT_MAP_EMPTY_GROUP[16] = {
+	FLAT_MAP_SENTINEL,	FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,
+	FLAT_MAP_EMPTY,		FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,
+	FLAT_MAP_EMPTY,		FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,
+	FLAT_MAP_EMPTY,		FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY,	FLAT_MAP_EMPTY
+};
+
+// -------- FUNCTIONS ------------
+
+inline size_t			FlatMapTrailingZeros(const uint64_t value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return static_cast<size_t>(index);
+#else
+	return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+}
+
+inline size_t			FlatMapLeadingZeros(const uint64_t value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return static_cast<size_t>(63 - index);
+#else
+	return static_cast<size_t>(__builtin_clzll(value));
+#endif
+}
+
+// std::hash is the identity for integers, the probe needs every bit to reach the low ones
+inline size_t			MixFlatMapHash(uint64_t hash) {
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	return static_cast<size_t>(hash);
+}
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Hashes and key comparisons for flat_map. Strings are transparent, so a map keyed by string
+// can be searched with a string_view or a literal without building a string.
+template<typename K>
+struct flat_hash : std::hash<K> {};
+
+template<>
+struct flat_hash<std::string> {
+	using is_transparent = void;
+
+	size_t operator()(const std::string_view s) const noexcept {
+		return std::hash<std::string_view>{}(s);
+	}
+};
+
+template<typename K>
+struct flat_equal : std::equal_to<K> {};
+
+template<>
+struct flat_equal<std::string> : std::equal_to<> {};
+
+// Matching slots of a group, lowest first. SSE has a bit per slot, the portable group the top
+// bit of each slot's byte.
+struct flat_map_mask_t {
+#if defined(PN_SIMD_SSE41)
+	static constexpr size_t SHIFT = 0;
+#else
+	static constexpr size_t SHIFT = 3;
+#endif
+
+	uint64_t bits;
+
+	explicit operator bool() const	{ return bits != 0; }
+
+	size_t	Lowest() const			{ return FlatMapTrailingZeros(bits) >> SHIFT; }
+	void	ClearLowest()			{ bits &= bits - 1; }
+
+	// slots before the first and after the last match
+	size_t	TrailingZeros() const	{ return Lowest(); }
+	size_t	LeadingZeros() const	{ return (FlatMapLeadingZeros(bits) - (64 - (FLAT_MAP_GROUP_WIDTH << SHIFT))) >> SHIFT; }
+};
+
+// FLAT_MAP_GROUP_WIDTH control bytes, loaded from anywhere in the table
+struct flat_map_group_t {
+#if defined(PN_SIMD_SSE41)
+	__m128i ctrl;
+
+	explicit flat_map_group_t(const int8_t* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+	flat_map_mask_t	Match(const int8_t h2) const {
+		return { static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))) };
+	}
+
+	flat_map_mask_t	MatchEmpty() const {
+		return { static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(FLAT_MAP_EMPTY), ctrl))) };
+	}
+
+	flat_map_mask_t	MatchEmptyOrDeleted() const {
+		return { static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(FLAT_MAP_SENTINEL), ctrl))) };
+	}
+
+	size_t			CountLeadingEmptyOrDeleted() const {
+		return FlatMapTrailingZeros(MatchEmptyOrDeleted().bits + 1);
+	}
+#else
+	static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+	static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+	uint64_t ctrl;
+
+	explicit flat_map_group_t(const int8_t* p) {
+		memcpy(&ctrl, p, sizeof(ctrl));
+	}
+
+	// Can also flag a full slot right after a real match, which the key comparison rejects
+	flat_map_mask_t	Match(const int8_t h2) const {
+		const uint64_t x = ctrl ^ (LSBS * static_cast<uint8_t>(h2));
+		return { (x - LSBS) & ~x & MSBS };
+	}
+
+	flat_map_mask_t	MatchEmpty() const {
+		return { ctrl & ~(ctrl << 6) & MSBS };
+	}
+
+	flat_map_mask_t	MatchEmptyOrDeleted() const {
+		return { ctrl & ~(ctrl << 7) & MSBS };
+	}
+
+	size_t			CountLeadingEmptyOrDeleted() const {
+		constexpr uint64_t GAPS = 0x00FEFEFEFEFEFEFEULL;
+		return (FlatMapTrailingZeros(((~ctrl & (ctrl >> 7)) | GAPS) + 1) + 7) >> 3;
+	}
+#endif
+};
+
+// The pair<K, V> view lets the key be moved when the table grows, the map only ever hands out
+// the const one
+template<typename K, typename V>
+union flat_map_slot_t {
+	std::pair<const K, V>	value;
+	std::pair<K, V>			mutable_value;
+
+	flat_map_slot_t() {}
+	~flat_map_slot_t() {}
+};
+
+template<typename H, typename E, typename = void>
+struct flat_map_is_transparent : std::false_type {};
+
+template<typename H, typename E>
+struct flat_map_is_transparent<H, E, std::void_t<typename H::is_transparent, typename E::is_transparent>> : std::true_type {};
+
+// ----------- CLASS DEFINITION -------------
+
+// Open addressing hash map in the SwissTable style. Keys and values live in one flat array next
+// to a control byte per slot, so a lookup is a hash, a group compare of control bytes and
+// usually a single key comparison, with no node to chase. The table is kept under 7/8 full.
+//
+// Follows std::unordered_map closely, except that an insert can move every element, like
+// push_back on a vector, so pointers, references and iterators only last until the next one.
+// Erasing only invalidates the erased element, and is fine while iterating.
+template<typename K, typename V, typename Hash = flat_hash<K>, typename KeyEqual = flat_equal<K>,
+	typename Alloc = std::allocator<std::pair<const K, V>>>
+class flat_map {
+public:
+	using key_type			= K;
+	using mapped_type		= V;
+	using value_type		= std::pair<const K, V>;
+	using size_type			= size_t;
+	using difference_type	= ptrdiff_t;
+	using hasher			= Hash;
+	using key_equal			= KeyEqual;
+	using allocator_type	= Alloc;
+	using reference			= value_type&;
+	using const_reference	= const value_type&;
+
+private:
+	using slot_t			= flat_map_slot_t<K, V>;
+	using slot_allocator_t	= typename std::allocator_traits<Alloc>::template rebind_alloc<slot_t>;
+	using slot_traits_t		= std::allocator_traits<slot_allocator_t>;
+
+	template<typename Q, typename H>
+	using enable_if_transparent_t = std::enable_if_t<flat_map_is_transparent<H, KeyEqual>::value && !std::is_same_v<Q, K>, int>;
+
+	static constexpr size_t NOT_FOUND		= ~size_t(0);
+	static constexpr size_t MIN_CAPACITY	= FLAT_MAP_GROUP_WIDTH - 1;
+
+	template<bool IsConst>
+	class iterator_base {
+		friend class flat_map;
+		template<bool> friend class iterator_base;
+
+		int8_t*	ctrl;
+		slot_t*	slot;
+
+		iterator_base(int8_t* ctrl, slot_t* slot) : ctrl(ctrl), slot(slot) {}
+
+		void SkipEmpty() {
+			while (*ctrl < FLAT_MAP_SENTINEL) {
+				const size_t skip = flat_map_group_t(ctrl).CountLeadingEmptyOrDeleted();
+				ctrl += skip;
+				slot += skip;
+			}
+		}
+
+	public:
+		using iterator_category	= std::forward_iterator_tag;
+		using value_type		= typename flat_map::value_type;
+		using difference_type	= ptrdiff_t;
+		using pointer			= std::conditional_t<IsConst, const value_type*, value_type*>;
+		using reference			= std::conditional_t<IsConst, const value_type&, value_type&>;
+
+		iterator_base() : ctrl(nullptr), slot(nullptr) {}
+
+		template<bool C = IsConst, typename = std::enable_if_t<C>>
+		iterator_base(const iterator_base<false>& other) : ctrl(other.ctrl), slot(other.slot) {}
+
+		reference	operator*() const	{ return slot->value; }
+		pointer		operator->() const	{ return &slot->value; }
+
+		iterator_base& operator++() {
+			++ctrl;
+			++slot;
+			SkipEmpty();
+			return *this;
+		}
+		iterator_base operator++(int) {
+			auto previous = *this;
+			++*this;
+			return previous;
+		}
+
+		friend bool operator==(const iterator_base& a, const iterator_base& b) { return a.ctrl == b.ctrl; }
+		friend bool operator!=(const iterator_base& a, const iterator_base& b) { return a.ctrl != b.ctrl; }
+	};
+
+public:
+	using iterator			= iterator_base<false>;
+	using const_iterator	= iterator_base<true>;
+
+private:
+	int8_t*				ctrl;
+	slot_t*				slots;
+	size_t				slot_capacity;	// 2^n - 1, or 0 without a table
+	size_t				element_count;
+	size_t				growth_left;	// inserts into empty slots before the table has to grow
+
+	Hash				hash;
+	KeyEqual			equal;
+	slot_allocator_t	allocator;
+
+	// ---- sizing
+
+	static size_t CapacityToGrowth(const size_t capacity) {
+		return capacity - std::max<size_t>(capacity / 8, 1);
+	}
+
+	static size_t CapacityForSize(const size_t size) {
+		if (size == 0) return 0;
+		size_t capacity = MIN_CAPACITY;
+		while (CapacityToGrowth(capacity) < size) {
+			capacity = capacity * 2 + 1;
+		}
+		return capacity;
+	}
+
+	// the control bytes go after the slots, in the same allocation
+	static size_t AllocationSlots(const size_t capacity) {
+		return capacity + (capacity + FLAT_MAP_GROUP_WIDTH + sizeof(slot_t) - 1) / sizeof(slot_t);
+	}
+
+	static size_t H1(const size_t hash)	{ return hash >> 7; }
+	static int8_t H2(const size_t hash)	{ return static_cast<int8_t>(hash & 0x7F); }
+
+	template<typename Q>
+	size_t HashOf(const Q& key) const {
+		return MixFlatMapHash(static_cast<uint64_t>(hash(key)));
+	}
+
+	// The first FLAT_MAP_GROUP_WIDTH - 1 bytes are cloned after the sentinel, so a group can be
+	// loaded at any slot without wrapping
+	void SetCtrl(const size_t index, const int8_t h) {
+		ctrl[index] = h;
+		ctrl[((index - (FLAT_MAP_GROUP_WIDTH - 1)) & slot_capacity) + (FLAT_MAP_GROUP_WIDTH - 1)] = h;
+	}
+
+	void ResetCtrl() {
+		memset(ctrl, FLAT_MAP_EMPTY, slot_capacity + FLAT_MAP_GROUP_WIDTH);
+		ctrl[slot_capacity] = FLAT_MAP_SENTINEL;
+		growth_left = CapacityToGrowth(slot_capacity) - element_count;
+	}
+
+	void SetEmptyTable() {
+		ctrl = const_cast<int8_t*>(FLAT_MAP_EMPTY_GROUP);
+		slots = nullptr;
+		slot_capacity = 0;
+		element_count = 0;
+		growth_left = 0;
+	}
+
+	void DestroySlots() {
+		if (!std::is_trivially_destructible_v<value_type>) {
+			for (size_t i = 0; i < slot_capacity; ++i) {
+				if (ctrl[i] >= 0) std::destroy_at(&slots[i].value);
+			}
+		}
+	}
+
+	void Deallocate() {
+		if (slot_capacity > 0) {
+			slot_traits_t::deallocate(allocator, slots, AllocationSlots(slot_capacity));
+		}
+	}
+
+	void Resize(const size_t new_capacity) {
+		int8_t* old_ctrl = ctrl;
+		slot_t* old_slots = slots;
+		const size_t old_capacity = slot_capacity;
+
+		if (new_capacity == 0) {
+			assert(element_count == 0);
+			SetEmptyTable();
+		}
+		else {
+			slots = slot_traits_t::allocate(allocator, AllocationSlots(new_capacity));
+			ctrl = reinterpret_cast<int8_t*>(slots + new_capacity);
+			slot_capacity = new_capacity;
+			ResetCtrl();
+		}
+
+		for (size_t i = 0; i < old_capacity; ++i) {
+			if (old_ctrl[i] < 0) continue;
+			const size_t h = HashOf(old_slots[i].value.first);
+			const size_t index = FindFirstNonFull(h);
+			SetCtrl(index, H2(h));
+			new (&slots[index].mutable_value) std::pair<K, V>(std::move(old_slots[i].mutable_value));
+			std::destroy_at(&old_slots[i].mutable_value);
+		}
+
+		if (old_capacity > 0) {
+			slot_traits_t::deallocate(allocator, old_slots, AllocationSlots(old_capacity));
+		}
+	}
+
+	// Out of empty slots: mostly tombstones are cleaned up in a table of the same size, otherwise
+	// the table doubles
+	void GrowForInsert() {
+		if (slot_capacity > FLAT_MAP_GROUP_WIDTH && element_count * 32 <= slot_capacity * 25) {
+			Resize(slot_capacity);
+		}
+		else {
+			Resize(slot_capacity == 0 ? MIN_CAPACITY : slot_capacity * 2 + 1);
+		}
+	}
+
+	// ---- probing
+
+	template<typename Q>
+	size_t FindIndex(const Q& key, const size_t h) const {
+		const int8_t h2 = H2(h);
+		size_t pos = H1(h) & slot_capacity;
+		size_t step = 0;
+		while (true) {
+			const flat_map_group_t group(ctrl + pos);
+			for (auto match = group.Match(h2); match; match.ClearLowest()) {
+				const size_t index = (pos + match.Lowest()) & slot_capacity;
+				if (equal(slots[index].value.first, key)) return index;
+			}
+			if (group.MatchEmpty()) return NOT_FOUND;
+			step += FLAT_MAP_GROUP_WIDTH;
+			pos = (pos + step) & slot_capacity;
+			assert(step <= slot_capacity + FLAT_MAP_GROUP_WIDTH && "flat_map probed a full table");
+		}
+	}
+
+	size_t FindFirstNonFull(const size_t h) const {
+		size_t pos = H1(h) & slot_capacity;
+		size_t step = 0;
+		while (true) {
+			const auto match = flat_map_group_t(ctrl + pos).MatchEmptyOrDeleted();
+			if (match) return (pos + match.Lowest()) & slot_capacity;
+			step += FLAT_MAP_GROUP_WIDTH;
+			pos = (pos + step) & slot_capacity;
+			assert(step <= slot_capacity + FLAT_MAP_GROUP_WIDTH && "flat_map probed a full table");
+		}
+	}
+
+	// Slot for a key known not to be in the map
+	size_t PrepareInsert(const size_t h) {
+		size_t index = FindFirstNonFull(h);
+		if (growth_left == 0 && ctrl[index] != FLAT_MAP_DELETED) {
+			GrowForInsert();
+			index = FindFirstNonFull(h);
+		}
+		return index;
+	}
+
+	// Marks the slot full only once the value is built, so a throwing constructor leaves the map as it was
+	template<typename... Args>
+	void ConstructAt(const size_t index, const size_t h, Args&&... args) {
+		new (&slots[index].value) value_type(std::forward<Args>(args)...);
+		growth_left -= (ctrl[index] == FLAT_MAP_EMPTY) ? 1 : 0;
+		SetCtrl(index, H2(h));
+		++element_count;
+	}
+
+	void EraseAt(const size_t index) {
+		std::destroy_at(&slots[index].value);
+		--element_count;
+
+		// If no group covering the slot was ever full, no probe went past it and it can be empty again
+		const size_t before = (index - FLAT_MAP_GROUP_WIDTH) & slot_capacity;
+		const auto empty_after = flat_map_group_t(ctrl + index).MatchEmpty();
+		const auto empty_before = flat_map_group_t(ctrl + before).MatchEmpty();
+		const bool was_never_full = empty_before && empty_after &&
+			empty_after.TrailingZeros() + empty_before.LeadingZeros() < FLAT_MAP_GROUP_WIDTH;
+
+		SetCtrl(index, was_never_full ? FLAT_MAP_EMPTY : FLAT_MAP_DELETED);
+		growth_left += was_never_full ? 1 : 0;
+	}
+
+	iterator IteratorAt(const size_t index)				{ return iterator(ctrl + index, slots + index); }
+	const_iterator IteratorAt(const size_t index) const	{ return const_iterator(ctrl + index, slots + index); }
+
+	template<typename Q>
+	size_t FindIndex(const Q& key) const {
+		return FindIndex(key, HashOf(key));
+	}
+
+	template<typename Q, typename... Args>
+	std::pair<iterator, bool> TryEmplace(Q&& key, Args&&... args) {
+		const size_t h = HashOf(key);
+		size_t index = FindIndex(key, h);
+		if (index != NOT_FOUND) return { IteratorAt(index), false };
+
+		index = PrepareInsert(h);
+		ConstructAt(index, h, std::piecewise_construct,
+			std::forward_as_tuple(std::forward<Q>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { IteratorAt(index), true };
+	}
+
+	template<typename P>
+	std::pair<iterator, bool> InsertValue(P&& value) {
+		const size_t h = HashOf(value.first);
+		size_t index = FindIndex(value.first, h);
+		if (index != NOT_FOUND) return { IteratorAt(index), false };
+
+		index = PrepareInsert(h);
+		ConstructAt(index, h, std::forward<P>(value));
+		return { IteratorAt(index), true };
+	}
+
+	void CopyFrom(const flat_map& other) {
+		reserve(other.element_count);
+		for (size_t i = 0; i < other.slot_capacity; ++i) {
+			if (other.ctrl[i] < 0) continue;
+			const size_t h = HashOf(other.slots[i].value.first);
+			ConstructAt(FindFirstNonFull(h), h, other.slots[i].value);
+		}
+	}
+
+	void Steal(flat_map& other) {
+		ctrl			= other.ctrl;
+		slots			= other.slots;
+		slot_capacity	= other.slot_capacity;
+		element_count	= other.element_count;
+		growth_left		= other.growth_left;
+		other.SetEmptyTable();
+	}
+
+public:
+	flat_map() : flat_map(0) {}
+
+	explicit flat_map(const size_t bucket_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+		: hash(hash), equal(equal), allocator(alloc) {
+		SetEmptyTable();
+		if (bucket_count > 0) Resize(CapacityForSize(bucket_count));
+	}
+
+	explicit flat_map(const Alloc& alloc) : flat_map(0, Hash(), KeyEqual(), alloc) {}
+
+	flat_map(std::initializer_list<value_type> values, const size_t bucket_count = 0, const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc())
+		: flat_map(bucket_count, hash, equal, alloc) {
+		insert(values.begin(), values.end());
+	}
+
+	flat_map(const flat_map& other)
+		: hash(other.hash), equal(other.equal), allocator(slot_traits_t::select_on_container_copy_construction(other.allocator)) {
+		SetEmptyTable();
+		CopyFrom(other);
+	}
+
+	flat_map(flat_map&& other) noexcept
+		: hash(std::move(other.hash)), equal(std::move(other.equal)), allocator(std::move(other.allocator)) {
+		Steal(other);
+	}
+
+	~flat_map() {
+		DestroySlots();
+		Deallocate();
+	}
+
+	flat_map& operator=(const flat_map& other) {
+		if (this != &other) {
+			clear();
+			hash = other.hash;
+			equal = other.equal;
+			if constexpr (slot_traits_t::propagate_on_container_copy_assignment::value) {
+				if (allocator != other.allocator) {
+					Deallocate();
+					SetEmptyTable();
+				}
+				allocator = other.allocator;
+			}
+			CopyFrom(other);
+		}
+		return *this;
+	}
+
+	flat_map& operator=(flat_map&& other) noexcept(slot_traits_t::propagate_on_container_move_assignment::value ||
+		slot_traits_t::is_always_equal::value) {
+		if (this != &other) {
+			DestroySlots();
+			hash = std::move(other.hash);
+			equal = std::move(other.equal);
+			if (slot_traits_t::propagate_on_container_move_assignment::value || allocator == other.allocator) {
+				Deallocate();
+				if constexpr (slot_traits_t::propagate_on_container_move_assignment::value) {
+					allocator = std::move(other.allocator);
+				}
+				Steal(other);
+			}
+			else {
+				// another heap, the elements have to move one by one
+				element_count = 0;
+				if (slot_capacity > 0) ResetCtrl();
+				reserve(other.element_count);
+				for (auto& value : other) {
+					const size_t h = HashOf(value.first);
+					ConstructAt(FindFirstNonFull(h), h, std::move(reinterpret_cast<slot_t&>(value).mutable_value));
+				}
+				other.clear();
+			}
+		}
+		return *this;
+	}
+
+	// ---- iteration
+
+	iterator		begin() {
+		iterator it(ctrl, slots);
+		it.SkipEmpty();
+		return it;
+	}
+	const_iterator	begin() const {
+		const_iterator it(ctrl, slots);
+		it.SkipEmpty();
+		return it;
+	}
+	iterator		end()			{ return IteratorAt(slot_capacity); }
+	const_iterator	end() const		{ return IteratorAt(slot_capacity); }
+	const_iterator	cbegin() const	{ return begin(); }
+	const_iterator	cend() const	{ return end(); }
+
+	// ---- size
+
+	bool	empty() const			{ return element_count == 0; }
+	size_t	size() const			{ return element_count; }
+	size_t	capacity() const		{ return slot_capacity; }
+	size_t	bucket_count() const	{ return slot_capacity; }
+	float	load_factor() const		{ return slot_capacity > 0 ? static_cast<float>(element_count) / slot_capacity : 0.0f; }
+	float	max_load_factor() const	{ return 7.0f / 8.0f; }
+
+	allocator_type	get_allocator() const	{ return allocator_type(allocator); }
+	hasher			hash_function() const	{ return hash; }
+	key_equal		key_eq() const			{ return equal; }
+
+	// Room for n elements without growing
+	void reserve(const size_t n) {
+		if (n > element_count + growth_left) {
+			Resize(CapacityForSize(n));
+		}
+	}
+
+	// At least bucket_count slots, or the smallest table that fits. rehash(0) shrinks to fit.
+	void rehash(const size_t bucket_count) {
+		const size_t capacity = std::max(CapacityForSize(bucket_count), CapacityForSize(element_count));
+		if (capacity != slot_capacity) {
+			Resize(capacity);
+		}
+	}
+
+	// Keeps the table
+	void clear() {
+		if (slot_capacity == 0) return;
+		DestroySlots();
+		element_count = 0;
+		ResetCtrl();
+	}
+
+	void swap(flat_map& other) noexcept {
+		using std::swap;
+		swap(ctrl, other.ctrl);
+		swap(slots, other.slots);
+		swap(slot_capacity, other.slot_capacity);
+		swap(element_count, other.element_count);
+		swap(growth_left, other.growth_left);
+		swap(hash, other.hash);
+		swap(equal, other.equal);
+		swap(allocator, other.allocator);
+	}
+
+	// ---- lookup
+
+	iterator		find(const K& key) {
+		const size_t index = FindIndex(key);
+		return index != NOT_FOUND ? IteratorAt(index) : end();
+	}
+	const_iterator	find(const K& key) const {
+		const size_t index = FindIndex(key);
+		return index != NOT_FOUND ? IteratorAt(index) : end();
+	}
+
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	iterator		find(const Q& key) {
+		const size_t index = FindIndex(key);
+		return index != NOT_FOUND ? IteratorAt(index) : end();
+	}
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	const_iterator	find(const Q& key) const {
+		const size_t index = FindIndex(key);
+		return index != NOT_FOUND ? IteratorAt(index) : end();
+	}
+
+	bool			contains(const K& key) const {
+		return FindIndex(key) != NOT_FOUND;
+	}
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	bool			contains(const Q& key) const {
+		return FindIndex(key) != NOT_FOUND;
+	}
+
+	size_t			count(const K& key) const		{ return contains(key) ? 1 : 0; }
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	size_t			count(const Q& key) const		{ return contains(key) ? 1 : 0; }
+
+	V&				at(const K& key) {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) throw std::out_of_range("flat_map::at");
+		return slots[index].value.second;
+	}
+	const V&		at(const K& key) const {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) throw std::out_of_range("flat_map::at");
+		return slots[index].value.second;
+	}
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	V&				at(const Q& key) {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) throw std::out_of_range("flat_map::at");
+		return slots[index].value.second;
+	}
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	const V&		at(const Q& key) const {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) throw std::out_of_range("flat_map::at");
+		return slots[index].value.second;
+	}
+
+	V&				operator[](const K& key)	{ return TryEmplace(key).first->second; }
+	V&				operator[](K&& key)			{ return TryEmplace(std::move(key)).first->second; }
+
+	// ---- insertion
+
+	std::pair<iterator, bool> insert(const value_type& value)	{ return InsertValue(value); }
+	std::pair<iterator, bool> insert(value_type&& value)		{ return InsertValue(std::move(value)); }
+
+	template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+	std::pair<iterator, bool> insert(P&& value) {
+		return emplace(std::forward<P>(value));
+	}
+
+	template<typename It>
+	void insert(It first, const It last) {
+		for (; first != last; ++first) {
+			emplace(*first);
+		}
+	}
+
+	void insert(std::initializer_list<value_type> values) {
+		insert(values.begin(), values.end());
+	}
+
+	// The key has to be hashed before the slot is known, so the pair is built first and moved in
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		return InsertValue(std::pair<K, V>(std::forward<Args>(args)...));
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+		return TryEmplace(key, std::forward<Args>(args)...);
+	}
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return TryEmplace(std::move(key), std::forward<Args>(args)...);
+	}
+
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+		auto result = TryEmplace(key, std::forward<M>(value));
+		if (!result.second) result.first->second = std::forward<M>(value);
+		return result;
+	}
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(K&& key, M&& value) {
+		auto result = TryEmplace(std::move(key), std::forward<M>(value));
+		if (!result.second) result.first->second = std::forward<M>(value);
+		return result;
+	}
+
+	// ---- removal
+
+	size_t erase(const K& key) {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) return 0;
+		EraseAt(index);
+		return 1;
+	}
+	template<typename Q, typename H = Hash, enable_if_transparent_t<Q, H> = 0>
+	size_t erase(const Q& key) {
+		const size_t index = FindIndex(key);
+		if (index == NOT_FOUND) return 0;
+		EraseAt(index);
+		return 1;
+	}
+
+	// Returns the next element
+	iterator erase(const_iterator position) {
+		assert(position != end());
+		const size_t index = static_cast<size_t>(position.ctrl - ctrl);
+		EraseAt(index);
+		auto next = IteratorAt(index);
+		++next;
+		return next;
+	}
+	iterator erase(iterator position) {
+		return erase(const_iterator(position));
+	}
+};
+
+template<typename K, typename V, typename H, typename E, typename A>
+bool operator==(const flat_map<K, V, H, E, A>& a, const flat_map<K, V, H, E, A>& b) {
+	if (a.size() != b.size()) return false;
+	for (const auto& value : a) {
+		const auto it = b.find(value.first);
+		if (it == b.end() || !(it->second == value.second)) return false;
+	}
+	return true;
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+bool operator!=(const flat_map<K, V, H, E, A>& a, const flat_map<K, V, H, E, A>& b) {
+	return !(a == b);
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+void swap(flat_map<K, V, H, E, A>& a, flat_map<K, V, H, E, A>& b) noexcept {
+	a.swap(b);
+}
+
+} // namespace pn
@@ -0,0 +1,211 @@
+#include <Utilities/FrameArena.h>
+
+#include <System/Jobs.h>
+
+#include <Utilities/Logging.h>
+#include <Utilities/Memory.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+namespace pn {
+
+#pragma region Internal
+
+constexpr size_t FRAME_ARENA_ALIGNMENT = 64;
+
+struct frame_overflow_t {
+	void*	memory;
+	size_t	size;
+};
+
+// One thread's part of an arena, on its own cache line so bumping doesn't bounce between cores
+struct alignas(FRAME_ARENA_ALIGNMENT) thread_arena_t {
+	std::unique_ptr<virtual_arena>	arena;
+	char*							memory		= nullptr;
+	std::atomic<size_t>				offset{ 0 };
+	std::atomic<size_t>				committed{ 0 };	// copy of arena->Committed() for the fast path
+
+	// ---- committing and heap fallback, rare enough for a lock
+	std::mutex						lock;
+	pn::vector<frame_overflow_t>	overflows;
+	std::atomic<size_t>				overflow{ 0 };
+};
+
+struct frame_arena_t {
+	std::unique_ptr<thread_arena_t[]>	threads;
+	std::atomic<bool>					reported_overflow{ false };
+};
+
+struct frame_arenas_t {
+	size_t								size_per_thread	= 0;
+	unsigned							thread_count	= 0;
+	unsigned							arena_count		= 0;
+	unsigned							current			= 0;
+	std::unique_ptr<frame_arena_t[]>	arenas;
+	frame_arena_stats_t					stats;
+};
+
+static frame_arenas_t* ARENAS = nullptr;
+
+static void* OverflowAllocate(frame_arena_t& arena, thread_arena_t& thread, const size_t size, const size_t alignment) {
+	// untracked, the block is charged to FRAME below and global new would charge it again
+	void* memory = UntrackedAllocate(std::max<size_t>(size, 1), std::max(alignment, alignof(std::max_align_t)));
+	if (memory == nullptr) return nullptr;
+	{
+		std::lock_guard<std::mutex> guard(thread.lock);
+		PushBack(thread.overflows, frame_overflow_t{ memory, size });
+	}
+	thread.overflow.fetch_add(size, std::memory_order_relaxed);
+	TrackAllocation(memory_tag_t::FRAME, size);
+
+	if (!arena.reported_overflow.exchange(true, std::memory_order_relaxed)) {
+		LogInfo("Frame arena of thread {} is full ({} bytes), falling back to the heap for the rest of the frame",
+			jobs::ThreadIndex(), ARENAS->size_per_thread);
+	}
+	return memory;
+}
+
+static void ResetArena(frame_arena_t& arena) {
+	for (unsigned t = 0; t < ARENAS->thread_count; ++t) {
+		auto& thread = arena.threads[t];
+		thread.offset.store(0, std::memory_order_relaxed);
+		for (const auto& overflow : thread.overflows) {
+			UntrackedFree(overflow.memory);
+			TrackFree(memory_tag_t::FRAME, overflow.size);
+		}
+		thread.overflows.clear();
+		thread.overflow.store(0, std::memory_order_relaxed);
+		thread.arena->Decommit();
+		thread.committed.store(thread.arena->Committed(), std::memory_order_relaxed);
+	}
+	arena.reported_overflow.store(false, std::memory_order_relaxed);
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+void				InitFrameArenas(const size_t size_per_thread, const unsigned arena_count) {
+	if (ARENAS != nullptr) {
+		LogError("Frame arenas already initialized");
+		return;
+	}
+	if (arena_count < 1) {
+		LogError("Frame arenas need at least one arena");
+		return;
+	}
+
+	auto* arenas = new frame_arenas_t;
+	// rounded up so every thread's part starts aligned
+	arenas->size_per_thread	= (size_per_thread + FRAME_ARENA_ALIGNMENT - 1) / FRAME_ARENA_ALIGNMENT * FRAME_ARENA_ALIGNMENT;
+	arenas->thread_count	= jobs::ThreadCount();
+	arenas->arena_count		= arena_count;
+	arenas->arenas			= std::make_unique<frame_arena_t[]>(arena_count);
+	arenas->stats.capacity	= arenas->size_per_thread * arenas->thread_count;
+
+	for (unsigned a = 0; a < arena_count; ++a) {
+		auto& arena = arenas->arenas[a];
+		arena.threads = std::make_unique<thread_arena_t[]>(arenas->thread_count);
+		for (unsigned t = 0; t < arenas->thread_count; ++t) {
+			arena.threads[t].arena = std::make_unique<virtual_arena>(arenas->size_per_thread, DEFAULT_ARENA_WATERMARK, memory_tag_t::FRAME);
+			arena.threads[t].memory = arena.threads[t].arena->Base();
+		}
+	}
+
+	ARENAS = arenas;
+	LogDebug("Frame arenas: {} arenas reserving {} bytes for each of {} threads", arena_count, ARENAS->size_per_thread, ARENAS->thread_count);
+}
+
+void				ShutdownFrameArenas() {
+	if (ARENAS == nullptr) return;
+
+	LogFrameArenaStats();
+	for (unsigned a = 0; a < ARENAS->arena_count; ++a) {
+		ResetArena(ARENAS->arenas[a]);
+	}
+	delete ARENAS;
+	ARENAS = nullptr;
+}
+
+bool				IsFrameArenaInitialized() {
+	return ARENAS != nullptr;
+}
+
+void*				FrameAllocate(const size_t size, const size_t alignment) {
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	if (ARENAS == nullptr) return nullptr;
+
+	auto& arena = ARENAS->arenas[ARENAS->current];
+	// threads the job system doesn't own all share index 0, so the bump is a compare and swap
+	auto& thread = arena.threads[jobs::ThreadIndex() % ARENAS->thread_count];
+
+	const auto base = reinterpret_cast<uintptr_t>(thread.memory);
+	size_t offset = thread.offset.load(std::memory_order_relaxed);
+	size_t begin;
+	do {
+		begin = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+		if (begin + size > ARENAS->size_per_thread) {
+			return OverflowAllocate(arena, thread, size, alignment);
+		}
+	} while (!thread.offset.compare_exchange_weak(offset, begin + size, std::memory_order_relaxed));
+
+	if (begin + size > thread.committed.load(std::memory_order_acquire)) {
+		std::unique_lock<std::mutex> guard(thread.lock);
+		if (!thread.arena->EnsureCommitted(begin + size)) {
+			guard.unlock();
+			return OverflowAllocate(arena, thread, size, alignment);
+		}
+		thread.committed.store(thread.arena->Committed(), std::memory_order_release);
+	}
+	return thread.memory + begin;
+}
+
+void				AdvanceFrameArenas() {
+	if (ARENAS == nullptr) return;
+
+	auto& stats = ARENAS->stats;
+	const auto& arena = ARENAS->arenas[ARENAS->current];
+	stats.used				= 0;
+	stats.overflow			= 0;
+	stats.overflow_count	= 0;
+	stats.thread_peak		= 0;
+	stats.committed			= 0;
+	for (unsigned t = 0; t < ARENAS->thread_count; ++t) {
+		const auto& thread = arena.threads[t];
+		const size_t overflow = thread.overflow.load(std::memory_order_relaxed);
+		const size_t used = thread.offset.load(std::memory_order_relaxed) + overflow;
+		stats.used				+= used;
+		stats.overflow			+= overflow;
+		stats.overflow_count	+= Size(thread.overflows);
+		stats.thread_peak		= std::max(stats.thread_peak, used);
+	}
+	stats.peak_used = std::max(stats.peak_used, stats.used);
+	for (unsigned a = 0; a < ARENAS->arena_count; ++a) {
+		for (unsigned t = 0; t < ARENAS->thread_count; ++t) {
+			stats.committed += ARENAS->arenas[a].threads[t].arena->Committed();
+		}
+	}
+	++stats.frame;
+
+	ARENAS->current = (ARENAS->current + 1) % ARENAS->arena_count;
+	ResetArena(ARENAS->arenas[ARENAS->current]);
+}
+
+frame_arena_stats_t	GetFrameArenaStats() {
+	return (ARENAS != nullptr) ? ARENAS->stats : frame_arena_stats_t{};
+}
+
+void				LogFrameArenaStats() {
+	const auto stats = GetFrameArenaStats();
+	LogInfo("Frame arenas: {} frames, peak {} of {} bytes, {} bytes committed, last frame {} bytes with {} bytes in {} heap allocations, busiest thread {} bytes",
+		stats.frame, stats.peak_used, stats.capacity, stats.committed, stats.used, stats.overflow, stats.overflow_count, stats.thread_peak);
+}
+
+#pragma endregion
+
+} // namespace pn
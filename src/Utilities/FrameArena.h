@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr size_t	DEFAULT_FRAME_ARENA_SIZE	= 16 * 1024 * 1024;	// bytes reserved per thread per arena
+constexpr unsigned	DEFAULT_FRAME_ARENA_COUNT	= 2;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+struct frame_arena_stats_t {
+	uint64_t	frame				= 0;	// frames completed
+	size_t		capacity			= 0;	// bytes reserved per arena, all threads
+	size_t		committed			= 0;	// bytes committed in all arenas
+	size_t		used				= 0;	// last frame, overflow included
+	size_t		overflow			= 0;	// last frame, bytes that went to the heap
+	size_t		overflow_count		= 0;	// last frame
+	size_t		thread_peak			= 0;	// last frame, most used by a single thread
+	size_t		peak_used			= 0;	// highest used of any frame so far
+};
+
+// -------- FUNCTIONS ------------
+
+// Memory that lives for arena_count frames. Each frame allocates from the next of arena_count
+// rotating arenas, so what frame N writes can still be read in frames up to N + arena_count - 1,
+// by a render or upload stage running a frame behind. Each arena is split per job thread and
+// allocating is a bump of the calling thread's own offset. The parts are only reserved, pages
+// are committed as the offsets reach them and given back past DEFAULT_ARENA_WATERMARK when the
+// arena is reset, so size_per_thread can cover the worst frame. When a thread runs out the
+// allocation comes from the heap and is freed with the arena, and it shows up in the stats.
+// Call it after jobs::Init so every job thread gets its own part.
+void				InitFrameArenas(const size_t size_per_thread = DEFAULT_FRAME_ARENA_SIZE, const unsigned arena_count = DEFAULT_FRAME_ARENA_COUNT);
+void				ShutdownFrameArenas();
+bool				IsFrameArenaInitialized();
+
+// Safe from any thread. Returns nullptr only when the arenas aren't initialized or the heap
+// fallback is out of memory.
+void*				FrameAllocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+
+// Ends the frame and resets the oldest arena for the next one. Called by the main loop after
+// MainLoopEnd, when no job is allocating.
+void				AdvanceFrameArenas();
+
+frame_arena_stats_t	GetFrameArenaStats();
+void				LogFrameArenaStats();
+
+// --------- TYPED HELPERS -----------
+
+// Destructors never run, the memory is simply reused
+template<typename T, typename... Args>
+T*					FrameCreate(Args&&... args) {
+	static_assert(std::is_trivially_destructible<T>::value, "Frame arena objects are never destroyed");
+	void* memory = FrameAllocate(sizeof(T), alignof(T));
+	return (memory != nullptr) ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+}
+
+// Uninitialized
+template<typename T>
+T*					FrameAllocateArray(const size_t count) {
+	static_assert(std::is_trivially_destructible<T>::value, "Frame arena objects are never destroyed");
+	return static_cast<T*>(FrameAllocate(sizeof(T) * count, alignof(T)));
+}
+
+} // namespace pn
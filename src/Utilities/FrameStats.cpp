@@ -0,0 +1,250 @@
+#include <Utilities/FrameStats.h>
+
+#include <IO/FileUtil.h>
+
+#include <Utilities/Logging.h>
+
+#include <revision_data.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace pn {
+
+#pragma region Internal
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(frame_phase_t::COUNT);
+constexpr size_t FRAME_INDEX = static_cast<size_t>(frame_phase_t::FRAME);
+
+static const char* PHASE_NAMES[PHASE_COUNT] = {
+	"messages",
+	"fixed_update",
+	"update",
+	"cbuffers",
+	"render",
+	"present",
+	"frame",
+};
+
+// A ring of the last FRAME_STATS_WINDOW frames, next is where the next one goes
+struct frame_window_t {
+	float				times[PHASE_COUNT][FRAME_STATS_WINDOW]	= {};
+	bool				hitch[FRAME_STATS_WINDOW]				= {};
+	bool				spike[FRAME_STATS_WINDOW]				= {};
+	size_t				next	= 0;
+	size_t				count	= 0;
+	double				sum		= 0.0;	// of the frame times
+
+	float				pending[PHASE_COUNT] = {};
+	uint64_t			last_end = 0;
+	frame_hitch_stats_t	hitches;
+};
+
+static frame_window_t WINDOW;
+
+static size_t Oldest() {
+	return (WINDOW.next + FRAME_STATS_WINDOW - WINDOW.count) % FRAME_STATS_WINDOW;
+}
+
+// Nearest rank on sorted times
+static float Percentile(const float* sorted, const size_t count, const float percent) {
+	const auto rank = static_cast<size_t>(std::ceil(percent / 100.0f * count));
+	return sorted[std::min(std::max<size_t>(rank, 1), count) - 1];
+}
+
+static void WriteStatsRow(std::ostream& out, const frame_phase_t phase) {
+	const auto stats = GetFrameTimeStats(phase);
+	out << _HASH << ',' << _DATE << ',' << stats.samples << ',' << FramePhaseName(phase) << ','
+		<< stats.min_ms << ',' << stats.avg_ms << ',' << stats.p50_ms << ',' << stats.p95_ms << ','
+		<< stats.p99_ms << ',' << stats.max_ms << ',';
+	if (phase == frame_phase_t::FRAME) {
+		out << WINDOW.hitches.window_hitches << ',' << WINDOW.hitches.window_spikes;
+	}
+	else {
+		out << ',';
+	}
+	out << '\n';
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+frame_phase_scope::~frame_phase_scope() {
+	AddFramePhaseTime(phase, static_cast<float>(ProfileTicksToMilliseconds(ProfileTimestamp() - begin)));
+}
+
+const char*			FramePhaseName(const frame_phase_t phase) {
+	return (phase < frame_phase_t::COUNT) ? PHASE_NAMES[static_cast<size_t>(phase)] : "";
+}
+
+void				AddFramePhaseTime(const frame_phase_t phase, const float ms) {
+	if (phase >= frame_phase_t::FRAME) return;
+	WINDOW.pending[static_cast<size_t>(phase)] += ms;
+}
+
+void				EndFrameStats() {
+	const uint64_t now = ProfileTimestamp();
+	auto& window = WINDOW;
+	if (window.last_end == 0) {
+		window.last_end = now;
+		std::fill(std::begin(window.pending), std::end(window.pending), 0.0f);
+		return;
+	}
+
+	const uint64_t begin = window.last_end;
+	window.last_end = now;
+	EndFrameStats(static_cast<float>(ProfileTicksToMilliseconds(now - begin)));
+}
+
+void				EndFrameStats(const float frame_ms) {
+	auto& window = WINDOW;
+	window.pending[FRAME_INDEX] = frame_ms;
+
+	auto& hitches = window.hitches;
+	const bool hitch = frame_ms > hitches.threshold_ms;
+	const bool spike = window.count > 0 && frame_ms > FRAME_SPIKE_FACTOR * static_cast<float>(window.sum / window.count);
+
+	const size_t slot = window.next;
+	if (window.count == FRAME_STATS_WINDOW) {
+		window.sum				-= window.times[FRAME_INDEX][slot];
+		hitches.window_hitches	-= window.hitch[slot] ? 1 : 0;
+		hitches.window_spikes	-= window.spike[slot] ? 1 : 0;
+	}
+	else {
+		++window.count;
+	}
+
+	for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		window.times[phase][slot]	= window.pending[phase];
+		window.pending[phase]		= 0.0f;
+	}
+	window.hitch[slot]	= hitch;
+	window.spike[slot]	= spike;
+	window.sum			+= frame_ms;
+	window.next			= (slot + 1) % FRAME_STATS_WINDOW;
+
+	hitches.frames			+= 1;
+	hitches.hitches			+= hitch ? 1 : 0;
+	hitches.spikes			+= spike ? 1 : 0;
+	hitches.window_hitches	+= hitch ? 1 : 0;
+	hitches.window_spikes	+= spike ? 1 : 0;
+}
+
+frame_time_stats_t	GetFrameTimeStats(const frame_phase_t phase) {
+	frame_time_stats_t stats;
+	const size_t count = WINDOW.count;
+	if (phase >= frame_phase_t::COUNT || count == 0) return stats;
+
+	float sorted[FRAME_STATS_WINDOW];
+	CopyFrameTimes(phase, sorted, count);
+	std::sort(sorted, sorted + count);
+
+	double sum = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		sum += sorted[i];
+	}
+	stats.min_ms	= sorted[0];
+	stats.avg_ms	= static_cast<float>(sum / count);
+	stats.p50_ms	= Percentile(sorted, count, 50.0f);
+	stats.p95_ms	= Percentile(sorted, count, 95.0f);
+	stats.p99_ms	= Percentile(sorted, count, 99.0f);
+	stats.max_ms	= sorted[count - 1];
+	stats.samples	= static_cast<uint32_t>(count);
+	return stats;
+}
+
+frame_hitch_stats_t	GetFrameHitchStats() {
+	return WINDOW.hitches;
+}
+
+size_t				CopyFrameTimes(const frame_phase_t phase, float* times, const size_t count) {
+	if (phase >= frame_phase_t::COUNT) return 0;
+	const size_t copied = std::min(count, WINDOW.count);
+	const float* phase_times = WINDOW.times[static_cast<size_t>(phase)];
+	const size_t oldest = Oldest();
+	for (size_t i = 0; i < copied; ++i) {
+		times[i] = phase_times[(oldest + i) % FRAME_STATS_WINDOW];
+	}
+	return copied;
+}
+
+void				FrameTimeHistogram(const frame_phase_t phase, float* buckets, const size_t bucket_count, const float bucket_ms) {
+	std::fill(buckets, buckets + bucket_count, 0.0f);
+	if (phase >= frame_phase_t::COUNT || bucket_count == 0 || bucket_ms <= 0.0f) return;
+
+	const float* phase_times = WINDOW.times[static_cast<size_t>(phase)];
+	const size_t oldest = Oldest();
+	for (size_t i = 0; i < WINDOW.count; ++i) {
+		const auto bucket = static_cast<size_t>(phase_times[(oldest + i) % FRAME_STATS_WINDOW] / bucket_ms);
+		buckets[std::min(bucket, bucket_count - 1)] += 1.0f;
+	}
+}
+
+void				SetFrameHitchThreshold(const float ms) {
+	WINDOW.hitches.threshold_ms = ms;
+}
+
+void				ResetFrameStats() {
+	const float threshold	= WINDOW.hitches.threshold_ms;
+	const uint64_t last_end	= WINDOW.last_end;
+	WINDOW = frame_window_t();
+	WINDOW.hitches.threshold_ms	= threshold;
+	WINDOW.last_end				= last_end;
+}
+
+bool				WriteFrameStatsCsv(const std::string& path) {
+	fmt::MemoryWriter out;
+	out << "frame";
+	for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		out << ',' << PHASE_NAMES[phase] << "_ms";
+	}
+	out << '\n';
+
+	const uint64_t first_frame = WINDOW.hitches.frames - WINDOW.count;
+	const size_t oldest = Oldest();
+	for (size_t i = 0; i < WINDOW.count; ++i) {
+		out << (first_frame + i);
+		for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+			out.write(",{:.4f}", WINDOW.times[phase][(oldest + i) % FRAME_STATS_WINDOW]);
+		}
+		out << '\n';
+	}
+
+	if (!WriteFile(path, out.data(), out.size())) return false;
+	LogInfo("Frame stats of {} frames written to {}", WINDOW.count, path);
+	return true;
+}
+
+bool				AppendFrameStatsSummaryCsv(const std::string& path) {
+	const bool is_new = !std::ifstream(path).good();
+	std::ofstream out(path, std::ios::app);
+	if (!out) {
+		LogError("Couldn't open {} for the frame stats summary", path);
+		return false;
+	}
+
+	if (is_new) {
+		out << "revision,date,frames,phase,min_ms,avg_ms,p50_ms,p95_ms,p99_ms,max_ms,hitches,spikes\n";
+	}
+	for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		WriteStatsRow(out, static_cast<frame_phase_t>(phase));
+	}
+	LogInfo("Frame stats summary appended to {}", path);
+	return true;
+}
+
+void				LogFrameStats() {
+	for (size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		const auto stats = GetFrameTimeStats(static_cast<frame_phase_t>(phase));
+		LogInfo("Frame time '{}': avg {:.3f} ms, p50 {:.3f}, p95 {:.3f}, p99 {:.3f}, min {:.3f}, max {:.3f}",
+			PHASE_NAMES[phase], stats.avg_ms, stats.p50_ms, stats.p95_ms, stats.p99_ms, stats.min_ms, stats.max_ms);
+	}
+	const auto& hitches = WINDOW.hitches;
+	LogInfo("Frame hitches: {} of {} frames over {:.1f} ms, {} spikes", hitches.hitches, hitches.frames, hitches.threshold_ms, hitches.spikes);
+}
+
+#pragma endregion
+
+} // namespace pn
@@ -0,0 +1,106 @@
+#pragma once
+
+// CPU time of every main loop phase over the last FRAME_STATS_WINDOW frames, with percentiles
+// and hitch counts, for the editor's frame statistics window and for comparing builds by CSV.
+// Main loop thread only.
+
+#include <Utilities/Profile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr size_t	FRAME_STATS_WINDOW			= 600;	// 10 seconds at 60 frames a second
+constexpr float		DEFAULT_HITCH_THRESHOLD_MS	= 1000.0f / 30.0f;
+
+// A spike is a frame this many times longer than the window's average
+constexpr float		FRAME_SPIKE_FACTOR			= 2.0f;
+
+// ----- TYPEDEFS ----------
+
+// FRAME is the whole frame, end to end, whatever ran in it
+enum class frame_phase_t : uint8_t {
+	MESSAGES,
+	FIXED_UPDATE,
+	UPDATE,
+	CBUFFERS,
+	RENDER,
+	PRESENT,
+	FRAME,
+	COUNT
+};
+
+// ---------- STRUCT DEFINITIONS -------------
+
+struct frame_time_stats_t {
+	float		min_ms	= 0.0f;
+	float		avg_ms	= 0.0f;
+	float		p50_ms	= 0.0f;
+	float		p95_ms	= 0.0f;
+	float		p99_ms	= 0.0f;
+	float		max_ms	= 0.0f;
+	uint32_t	samples	= 0;
+};
+
+struct frame_hitch_stats_t {
+	uint64_t	frames			= 0;	// since the last reset
+	uint64_t	hitches			= 0;	// over the threshold
+	uint64_t	spikes			= 0;	// over FRAME_SPIKE_FACTOR times the average
+	uint32_t	window_hitches	= 0;
+	uint32_t	window_spikes	= 0;
+	float		threshold_ms	= DEFAULT_HITCH_THRESHOLD_MS;
+};
+
+// Charges the time it's alive to a phase of the current frame, phases that run more than once
+// a frame add up
+class frame_phase_scope {
+	frame_phase_t	phase;
+	uint64_t		begin;
+
+public:
+	explicit frame_phase_scope(const frame_phase_t phase) : phase(phase), begin(ProfileTimestamp()) {}
+	~frame_phase_scope();
+
+	frame_phase_scope(const frame_phase_scope&)				= delete;
+	frame_phase_scope& operator=(const frame_phase_scope&)	= delete;
+};
+
+// -------- FUNCTIONS ------------
+
+const char*			FramePhaseName(const frame_phase_t phase);
+
+void				AddFramePhaseTime(const frame_phase_t phase, const float ms);
+
+// Closes the frame, its length is the time since the last call. Called by the main loop at the
+// end of every frame, the first call only starts the clock.
+void				EndFrameStats();
+
+// Closes the frame with a length measured elsewhere, e.g. by a replay
+void				EndFrameStats(const float frame_ms);
+
+frame_time_stats_t	GetFrameTimeStats(const frame_phase_t phase);
+frame_hitch_stats_t	GetFrameHitchStats();
+
+// The window's times in milliseconds, oldest first. Returns how many were copied.
+size_t				CopyFrameTimes(const frame_phase_t phase, float* times, const size_t count);
+
+// Frames per bucket_ms wide bucket, the last bucket takes everything longer
+void				FrameTimeHistogram(const frame_phase_t phase, float* buckets, const size_t bucket_count, const float bucket_ms);
+
+void				SetFrameHitchThreshold(const float ms);
+void				ResetFrameStats();
+
+// One row per frame in the window, a column per phase
+bool				WriteFrameStatsCsv(const std::string& path);
+
+// One row per phase with the window's stats and the build's revision, appended so runs of
+// different builds end up side by side
+bool				AppendFrameStatsSummaryCsv(const std::string& path);
+
+void				LogFrameStats();
+
+} // namespace pn
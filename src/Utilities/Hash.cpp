@@ -0,0 +1,97 @@
+#include <Utilities/Hash.h>
+
+#include <cstring>
+
+namespace pn {
+
+#pragma region XXH64
+
+static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t RotateLeft(const uint64_t x, const int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t Read64(const unsigned char* p) {
+	uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t Read32(const unsigned char* p) {
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint64_t Round(uint64_t acc, const uint64_t input) {
+	acc += input * PRIME64_2;
+	acc = RotateLeft(acc, 31);
+	return acc * PRIME64_1;
+}
+
+static inline uint64_t MergeRound(uint64_t acc, const uint64_t val) {
+	acc ^= Round(0, val);
+	return acc * PRIME64_1 + PRIME64_4;
+}
+
+#pragma endregion
+
+uint64_t	Hash64(const void* data, const size_t size, const uint64_t seed) {
+	const auto* p = static_cast<const unsigned char*>(data);
+	const auto* const end = p + size;
+	uint64_t h;
+
+	if (size >= 32) {
+		const auto* const limit = end - 32;
+		uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+		uint64_t v2 = seed + PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - PRIME64_1;
+		do {
+			v1 = Round(v1, Read64(p));		p += 8;
+			v2 = Round(v2, Read64(p));		p += 8;
+			v3 = Round(v3, Read64(p));		p += 8;
+			v4 = Round(v4, Read64(p));		p += 8;
+		} while (p <= limit);
+
+		h = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+		h = MergeRound(h, v1);
+		h = MergeRound(h, v2);
+		h = MergeRound(h, v3);
+		h = MergeRound(h, v4);
+	} else {
+		h = seed + PRIME64_5;
+	}
+
+	h += static_cast<uint64_t>(size);
+
+	while (p + 8 <= end) {
+		h ^= Round(0, Read64(p));
+		h = RotateLeft(h, 27) * PRIME64_1 + PRIME64_4;
+		p += 8;
+	}
+	if (p + 4 <= end) {
+		h ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+		h = RotateLeft(h, 23) * PRIME64_2 + PRIME64_3;
+		p += 4;
+	}
+	while (p < end) {
+		h ^= (*p) * PRIME64_5;
+		h = RotateLeft(h, 11) * PRIME64_1;
+		++p;
+	}
+
+	h ^= h >> 33;
+	h *= PRIME64_2;
+	h ^= h >> 29;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+} // namespace pn
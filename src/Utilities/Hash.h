@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Utilities/UtilityTypes.h>
+
+#include <cstdint>
+
+namespace pn {
+
+// -------- FUNCTIONS ------------
+
+// XXH64 of the data. Stable across platforms and runs, so it's safe to persist.
+uint64_t	Hash64(const void* data, const size_t size, const uint64_t seed = 0);
+
+inline uint64_t	Hash64(const bytes& data, const uint64_t seed = 0) {
+	return Hash64(data.data(), data.size(), seed);
+}
+
+inline uint64_t	Hash64(const string& data, const uint64_t seed = 0) {
+	return Hash64(data.data(), data.size(), seed);
+}
+
+// Mixes value into seed, order dependent
+inline uint64_t	HashCombine(const uint64_t seed, const uint64_t value) {
+	return Hash64(&value, sizeof(value), seed);
+}
+
+} // namespace pn
@@ -0,0 +1,331 @@
+#include <Utilities/Heap.h>
+#include <Utilities/VirtualMemory.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace pn {
+
+#pragma region Internal
+
+// Blocks sit back to back in a region, each a header followed by its payload. The links to the
+// neighbouring free blocks of the same size class live in the payload while the block is free.
+struct tlsf_heap::block_t {
+	block_t*	prev_phys;	// the block just before this one in memory
+	size_t		size;		// of the payload, the low bits are BLOCK_FREE and BLOCK_PREV_FREE
+
+	block_t*	next_free;
+	block_t*	prev_free;
+};
+
+using block_t = tlsf_heap::block_t;
+
+constexpr size_t BLOCK_FREE			= 1;
+constexpr size_t BLOCK_PREV_FREE	= 2;
+constexpr size_t BLOCK_FLAGS		= BLOCK_FREE | BLOCK_PREV_FREE;
+
+constexpr size_t BLOCK_HEADER_SIZE	= offsetof(block_t, next_free);
+constexpr size_t MIN_BLOCK_SIZE		= sizeof(block_t) - BLOCK_HEADER_SIZE;	// room for the free links
+constexpr size_t SMALL_BLOCK_SIZE	= size_t(1) << HEAP_FL_INDEX_SHIFT;		// below it classes are linear
+constexpr size_t MAX_BLOCK_SIZE		= (size_t(1) << HEAP_FL_INDEX_MAX) - 1;
+
+static_assert(BLOCK_HEADER_SIZE == HEAP_ALIGNMENT, "block headers keep payloads aligned");
+static_assert(HEAP_FL_INDEX_COUNT <= 64, "first level bitmap is 64 bits");
+
+static int MostSignificantBit(const uint64_t value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return static_cast<int>(index);
+#else
+	return 63 - __builtin_clzll(value);
+#endif
+}
+
+static int LeastSignificantBit(const uint64_t value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+static size_t BlockSize(const block_t* block) {
+	return block->size & ~BLOCK_FLAGS;
+}
+
+static void SetBlockSize(block_t* block, const size_t size) {
+	block->size = size | (block->size & BLOCK_FLAGS);
+}
+
+static char* Payload(block_t* block) {
+	return reinterpret_cast<char*>(block) + BLOCK_HEADER_SIZE;
+}
+
+static block_t* BlockFromPayload(void* memory) {
+	return reinterpret_cast<block_t*>(static_cast<char*>(memory) - BLOCK_HEADER_SIZE);
+}
+
+static block_t* NextPhysical(block_t* block) {
+	return reinterpret_cast<block_t*>(Payload(block) + BlockSize(block));
+}
+
+static size_t AlignUp(const size_t value, const size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Size class of a block
+static void MappingInsert(const size_t size, int& fl, int& sl) {
+	if (size < SMALL_BLOCK_SIZE) {
+		fl = 0;
+		sl = static_cast<int>(size / (SMALL_BLOCK_SIZE / HEAP_SL_INDEX_COUNT));
+		return;
+	}
+	const int msb = MostSignificantBit(size);
+	sl = static_cast<int>(size >> (msb - HEAP_SL_INDEX_COUNT_LOG2)) ^ HEAP_SL_INDEX_COUNT;
+	fl = msb - (HEAP_FL_INDEX_SHIFT - 1);
+}
+
+// Rounds a request up to the next class boundary, so any block of the class found fits
+static size_t MappingSearchSize(const size_t size) {
+	if (size < SMALL_BLOCK_SIZE) return size;
+	return size + (size_t(1) << (MostSignificantBit(size) - HEAP_SL_INDEX_COUNT_LOG2)) - 1;
+}
+
+#pragma endregion
+
+#pragma region TLSF Heap
+
+tlsf_heap::tlsf_heap(const size_t reserve_size, const size_t region_size, const memory_tag_t tag)
+	: arena(std::make_unique<virtual_arena>(reserve_size, DEFAULT_ARENA_WATERMARK, UNTRACKED_MEMORY))	// blocks are tracked instead
+	, region_size(AlignUp(std::max(region_size, PageSize()), PageSize()))
+	, tag(tag) {}
+
+tlsf_heap::tlsf_heap(const memory_tag_t tag) : tag(tag) {}
+
+void tlsf_heap::AddRegion(void* memory, const size_t size) {
+	std::lock_guard<std::mutex> guard(lock);
+	AddRegionLocked(memory, size);
+}
+
+void tlsf_heap::AddRegionLocked(void* memory, const size_t size) {
+	const auto begin	= AlignUp(reinterpret_cast<uintptr_t>(memory), HEAP_ALIGNMENT);
+	const auto end		= (reinterpret_cast<uintptr_t>(memory) + size) & ~(uintptr_t(HEAP_ALIGNMENT) - 1);
+	if (end <= begin || end - begin < 2 * BLOCK_HEADER_SIZE + MIN_BLOCK_SIZE) {
+		LogError("Heap region of {} bytes is too small", size);
+		return;
+	}
+
+	// one free block spanning the region, and a used sentinel of just a header closing it
+	auto* block			= reinterpret_cast<block_t*>(begin);
+	block->prev_phys	= nullptr;
+	block->size			= std::min<size_t>(end - begin - 2 * BLOCK_HEADER_SIZE, MAX_BLOCK_SIZE & ~BLOCK_FLAGS) | BLOCK_FREE;
+
+	auto* sentinel		= NextPhysical(block);
+	sentinel->prev_phys	= block;
+	sentinel->size		= BLOCK_PREV_FREE;
+
+	InsertFree(block);
+	stats.capacity	+= end - begin;
+	stats.regions	+= 1;
+}
+
+void* tlsf_heap::Allocate(const size_t size, const size_t alignment) {
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	if (size > MAX_BLOCK_SIZE / 2) return nullptr;
+
+	const size_t adjusted	= std::max(AlignUp(std::max<size_t>(size, 1), HEAP_ALIGNMENT), MIN_BLOCK_SIZE);
+	const size_t align		= std::max(alignment, HEAP_ALIGNMENT);
+	// an over-aligned request needs room to split off a free block in front of it
+	const size_t search		= adjusted + ((align > HEAP_ALIGNMENT) ? align + sizeof(block_t) : 0);
+
+	std::lock_guard<std::mutex> guard(lock);
+	block_t* block = FindFree(search);
+	if (block == nullptr && Grow(search)) {
+		block = FindFree(search);
+	}
+	if (block == nullptr) return nullptr;
+	RemoveFree(block);
+
+	if (align > HEAP_ALIGNMENT) {
+		const auto payload = reinterpret_cast<uintptr_t>(Payload(block));
+		size_t gap = AlignUp(payload, align) - payload;
+		if (gap != 0 && gap < sizeof(block_t)) {
+			gap += align;
+		}
+		if (gap != 0) {
+			auto* aligned		= reinterpret_cast<block_t*>(payload + gap - BLOCK_HEADER_SIZE);
+			aligned->prev_phys	= block;
+			aligned->size		= (BlockSize(block) - gap) | BLOCK_FREE | BLOCK_PREV_FREE;
+			NextPhysical(aligned)->prev_phys = aligned;
+
+			SetBlockSize(block, gap - BLOCK_HEADER_SIZE);
+			InsertFree(block);
+			block = aligned;
+		}
+	}
+
+	// give back what's left if it can make a block of its own
+	if (BlockSize(block) >= adjusted + sizeof(block_t)) {
+		auto* rest		= reinterpret_cast<block_t*>(Payload(block) + adjusted);
+		rest->prev_phys	= block;
+		rest->size		= (BlockSize(block) - adjusted - BLOCK_HEADER_SIZE) | BLOCK_FREE;
+		SetBlockSize(block, adjusted);
+
+		auto* next		= NextPhysical(rest);
+		next->prev_phys	= rest;
+		next->size		|= BLOCK_PREV_FREE;
+		InsertFree(rest);
+	}
+
+	block->size &= ~BLOCK_FREE;
+	NextPhysical(block)->size &= ~BLOCK_PREV_FREE;
+
+	stats.used			+= BlockSize(block);
+	stats.peak_used		= std::max(stats.peak_used, stats.used);
+	stats.allocations	+= 1;
+	TrackAllocation(tag, BlockSize(block));
+	return Payload(block);
+}
+
+void tlsf_heap::Free(void* memory) {
+	if (memory == nullptr) return;
+
+	std::lock_guard<std::mutex> guard(lock);
+	block_t* block = BlockFromPayload(memory);
+	assert(!(block->size & BLOCK_FREE) && "heap block freed twice");
+	stats.used			-= BlockSize(block);
+	stats.allocations	-= 1;
+	TrackFree(tag, BlockSize(block));
+
+	block->size |= BLOCK_FREE;
+	if (block->size & BLOCK_PREV_FREE) {
+		block_t* prev = block->prev_phys;
+		RemoveFree(prev);
+		SetBlockSize(prev, BlockSize(prev) + BLOCK_HEADER_SIZE + BlockSize(block));
+		block = prev;
+	}
+
+	block_t* next = NextPhysical(block);
+	if (next->size & BLOCK_FREE) {
+		RemoveFree(next);
+		SetBlockSize(block, BlockSize(block) + BLOCK_HEADER_SIZE + BlockSize(next));
+		next = NextPhysical(block);
+	}
+	next->prev_phys	= block;
+	next->size		|= BLOCK_PREV_FREE;
+	InsertFree(block);
+}
+
+heap_stats_t tlsf_heap::GetStats() const {
+	std::lock_guard<std::mutex> guard(lock);
+	heap_stats_t result = stats;
+	result.free = 0;
+	for (int fl = 0; fl < HEAP_FL_INDEX_COUNT; ++fl) {
+		for (int sl = 0; sl < HEAP_SL_INDEX_COUNT; ++sl) {
+			for (const block_t* block = free_lists[fl][sl]; block != nullptr; block = block->next_free) {
+				result.free += BlockSize(block);
+			}
+		}
+	}
+	return result;
+}
+
+tlsf_heap::block_t* tlsf_heap::FindFree(const size_t size) {
+	int fl, sl;
+	MappingInsert(MappingSearchSize(size), fl, sl);
+	if (fl >= HEAP_FL_INDEX_COUNT) return nullptr;
+
+	uint32_t sl_map = sl_bitmap[fl] & (~0u << sl);
+	if (sl_map == 0) {
+		const uint64_t fl_map = (fl + 1 < 64) ? fl_bitmap & (~uint64_t(0) << (fl + 1)) : 0;
+		if (fl_map == 0) return nullptr;
+		fl		= LeastSignificantBit(fl_map);
+		sl_map	= sl_bitmap[fl];
+	}
+	sl = LeastSignificantBit(sl_map);
+	return free_lists[fl][sl];
+}
+
+void tlsf_heap::InsertFree(block_t* block) {
+	int fl, sl;
+	MappingInsert(BlockSize(block), fl, sl);
+	block->prev_free = nullptr;
+	block->next_free = free_lists[fl][sl];
+	if (block->next_free != nullptr) {
+		block->next_free->prev_free = block;
+	}
+	free_lists[fl][sl] = block;
+	fl_bitmap		|= uint64_t(1) << fl;
+	sl_bitmap[fl]	|= 1u << sl;
+}
+
+void tlsf_heap::RemoveFree(block_t* block) {
+	int fl, sl;
+	MappingInsert(BlockSize(block), fl, sl);
+	if (block->prev_free != nullptr) {
+		block->prev_free->next_free = block->next_free;
+	}
+	else {
+		free_lists[fl][sl] = block->next_free;
+	}
+	if (block->next_free != nullptr) {
+		block->next_free->prev_free = block->prev_free;
+	}
+
+	if (free_lists[fl][sl] == nullptr) {
+		sl_bitmap[fl] &= ~(1u << sl);
+		if (sl_bitmap[fl] == 0) {
+			fl_bitmap &= ~(uint64_t(1) << fl);
+		}
+	}
+}
+
+// Commits more of the arena. The new memory continues the last region: its sentinel becomes a
+// free block over the new pages, merged with the free block before it if there is one.
+bool tlsf_heap::Grow(const size_t size) {
+	if (arena == nullptr) return false;
+
+	const size_t needed = MappingSearchSize(size) + 2 * BLOCK_HEADER_SIZE;
+	size_t grow = AlignUp(std::max(needed, region_size), region_size);
+	grow = std::min(grow, arena->Reserved() - arena_used);
+	if (grow < needed || !arena->EnsureCommitted(arena_used + grow)) {
+		return false;
+	}
+
+	char* memory = arena->Base() + arena_used;
+	if (arena_used == 0) {
+		AddRegionLocked(memory, grow);
+	}
+	else {
+		auto* block = reinterpret_cast<block_t*>(memory - BLOCK_HEADER_SIZE);
+		block->size = (grow - BLOCK_HEADER_SIZE) | (block->size & BLOCK_PREV_FREE) | BLOCK_FREE;
+
+		auto* sentinel		= NextPhysical(block);
+		sentinel->prev_phys	= block;
+		sentinel->size		= BLOCK_PREV_FREE;
+
+		if (block->size & BLOCK_PREV_FREE) {
+			block_t* prev = block->prev_phys;
+			RemoveFree(prev);
+			SetBlockSize(prev, BlockSize(prev) + BLOCK_HEADER_SIZE + BlockSize(block));
+			block = prev;
+			sentinel->prev_phys = block;
+		}
+		InsertFree(block);
+		stats.capacity += grow;
+	}
+	arena_used += grow;
+	return true;
+}
+
+#pragma endregion
+
+} // namespace pn
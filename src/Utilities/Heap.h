@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Utilities/Memory.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr size_t DEFAULT_HEAP_REGION_SIZE	= 1024 * 1024;
+constexpr size_t HEAP_ALIGNMENT				= 16;	// of every block, larger alignments split a block
+
+constexpr int	HEAP_SL_INDEX_COUNT_LOG2	= 5;	// 32 second level lists per power of two
+constexpr int	HEAP_SL_INDEX_COUNT			= 1 << HEAP_SL_INDEX_COUNT_LOG2;
+constexpr int	HEAP_FL_INDEX_SHIFT			= HEAP_SL_INDEX_COUNT_LOG2 + 4;	// log2(HEAP_ALIGNMENT)
+constexpr int	HEAP_FL_INDEX_MAX			= 40;	// blocks up to 1 TB
+constexpr int	HEAP_FL_INDEX_COUNT			= HEAP_FL_INDEX_MAX - HEAP_FL_INDEX_SHIFT + 1;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+struct heap_stats_t {
+	size_t	used			= 0;	// bytes handed out, headers excluded
+	size_t	peak_used		= 0;
+	size_t	allocations		= 0;	// live
+	size_t	free			= 0;	// bytes in free blocks
+	size_t	capacity		= 0;	// bytes in all regions
+	size_t	regions			= 0;
+};
+
+// Two-level segregated fit allocator (Masmano et al.) over memory the engine owns. Free blocks
+// are kept in lists by size class, a power of two split in HEAP_SL_INDEX_COUNT steps, with a
+// bitmap per level, so Allocate and Free are a handful of bit scans and list operations whatever
+// the heap's state. A block is the best fit of its class, and freed blocks merge with their free
+// neighbours right away, which keeps fragmentation bounded. Thread-safe behind a mutex.
+class tlsf_heap {
+public:
+	struct block_t;
+
+	// Regions come from a virtual_arena reserving reserve_size bytes, committed region_size at a
+	// time whenever no free block fits
+	explicit tlsf_heap(const size_t reserve_size, const size_t region_size = DEFAULT_HEAP_REGION_SIZE,
+		const memory_tag_t tag = memory_tag_t::GENERAL);
+
+	// Only manages memory handed to AddRegion
+	explicit tlsf_heap(const memory_tag_t tag = memory_tag_t::GENERAL);
+
+	tlsf_heap(const tlsf_heap&)				= delete;
+	tlsf_heap(tlsf_heap&&)					= delete;
+	tlsf_heap& operator=(const tlsf_heap&)	= delete;
+	tlsf_heap& operator=(tlsf_heap&&)		= delete;
+
+	// memory has to outlive the heap
+	void			AddRegion(void* memory, const size_t size);
+
+	// nullptr when nothing fits and the heap can't grow
+	void*			Allocate(const size_t size, const size_t alignment = HEAP_ALIGNMENT);
+	void			Free(void* memory);
+
+	heap_stats_t	GetStats() const;
+
+private:
+	void			AddRegionLocked(void* memory, const size_t size);
+	block_t*		FindFree(const size_t size);
+	void			InsertFree(block_t* block);
+	void			RemoveFree(block_t* block);
+	bool			Grow(const size_t size);
+
+	mutable std::mutex				lock;
+	uint64_t						fl_bitmap = 0;
+	uint32_t						sl_bitmap[HEAP_FL_INDEX_COUNT] = {};
+	block_t*						free_lists[HEAP_FL_INDEX_COUNT][HEAP_SL_INDEX_COUNT] = {};
+
+	std::unique_ptr<virtual_arena>	arena;
+	size_t							arena_used	= 0;
+	size_t							region_size	= 0;
+	memory_tag_t					tag			= memory_tag_t::GENERAL;	// charged per block
+
+	heap_stats_t					stats;
+};
+
+// std allocator over a tlsf_heap. A default constructed one uses the global heap, so containers
+// only go to an engine heap when they're given one.
+template<typename T>
+class heap_allocator {
+public:
+	using value_type								= T;
+	using propagate_on_container_copy_assignment	= std::true_type;
+	using propagate_on_container_move_assignment	= std::true_type;
+	using propagate_on_container_swap				= std::true_type;
+
+	tlsf_heap* heap = nullptr;
+
+	heap_allocator() noexcept = default;
+	explicit heap_allocator(tlsf_heap* heap) noexcept : heap(heap) {}
+	template<typename U>
+	heap_allocator(const heap_allocator<U>& other) noexcept : heap(other.heap) {}
+
+	T* allocate(const size_t n) {
+		if (heap == nullptr) {
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+		}
+		void* memory = heap->Allocate(n * sizeof(T), alignof(T));
+		if (memory == nullptr) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(memory);
+	}
+
+	void deallocate(T* memory, const size_t) noexcept {
+		if (heap == nullptr) {
+			::operator delete(memory, std::align_val_t(alignof(T)));
+			return;
+		}
+		heap->Free(memory);
+	}
+
+	template<typename U>
+	bool operator==(const heap_allocator<U>& other) const noexcept { return heap == other.heap; }
+	template<typename U>
+	bool operator!=(const heap_allocator<U>& other) const noexcept { return heap != other.heap; }
+};
+
+// ----- TYPEDEFS ----------
+
+template<typename T>
+using heap_vector	= vector<T, heap_allocator<T>>;
+
+template<typename K, typename V>
+using heap_map		= map<K, V, heap_allocator<std::pair<const K, V>>>;
+
+using heap_string	= std::basic_string<char, std::char_traits<char>, heap_allocator<char>>;
+
+} // namespace pn
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <json11\json11.hpp>
-#include <Utilities\Logging.h>
+#include <json11/json11.hpp>
+#include <Utilities/Logging.h>
 
 namespace pn {
 
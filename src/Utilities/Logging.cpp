@@ -1,9 +1,11 @@
-#include <Utilities\Logging.h>
+#include <Utilities/Logging.h>
 
+#ifdef _WIN32
 #include <comdef.h> // _com_error
+#endif
 #include <iostream>
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/UtilityTypes.h>
 
 namespace pn {
 
@@ -13,6 +15,7 @@ log_ptr<spdlog::logger> console;
 
 // --------------- FUNCTIONS ----------
 
+#ifdef _WIN32
 std::string ErrMsg(const HRESULT hr) {
 	_com_error err(hr);
 	return std::string(err.ErrorMessage());
@@ -22,6 +25,7 @@ std::string ErrMsg(const DWORD error) {
 	auto hresult = HRESULT_FROM_WIN32(error);
 	return ErrMsg(hresult);
 }
+#endif
 
 void InitLogger() {
 	try {
@@ -48,21 +52,4 @@ void CloseLogger() {
 	spdlog::drop_all();
 }
 
-// from https://stackoverflow.com/questions/31050113/how-to-extract-the-source-filename-without-path-and-suffix-at-compile-time
-constexpr const char* str_end(const char *str) {
-	return *str ? str_end(str + 1) : str;
-}
-
-constexpr bool str_slant(const char *str) {
-	return *str == '\\' ? true : (*str ? str_slant(str + 1) : false);
-}
-
-constexpr const char* r_slant(const char* str) {
-	return *str == '\\' ? (str + 1) : r_slant(str - 1);
-}
-
-constexpr const char* file_name_from_path(const char* str) {
-	return str_slant(str) ? r_slant(str_end(str)) : str;
-}
-
 } // namespace pn
\ No newline at end of file
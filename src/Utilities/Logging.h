@@ -1,6 +1,6 @@
 #pragma once
 
-#include <spdlog\spdlog.h>
+#include <spdlog/spdlog.h>
 
 namespace pn {
 
@@ -15,26 +15,38 @@ extern log_ptr<spdlog::logger> console;
 
 // ---------------- FUNCTIONS --------------
 
-std::string ErrMsg(const HRESULT hr);
-std::string ErrMsg(const DWORD error);
+#ifdef _WIN32
+// Text of a COM/Win32 error code. The parameters are HRESULT and DWORD, spelled out so this
+// header doesn't need Windows.h
+std::string ErrMsg(const long hr);
+std::string ErrMsg(const unsigned long error);
+#endif
 
 void InitLogger();
 void CloseLogger();
 
-extern constexpr const char* file_name_from_path(const char* str);
+// Strips the directories from __FILE__, whichever separator the compiler used
+constexpr const char* file_name_from_path(const char* str) {
+	const char* file_name = str;
+	for (; *str; ++str) {
+		if (*str == '/' || *str == '\\') file_name = str + 1;
+	}
+	return file_name;
+}
 
+// Formats into a writer on the stack, so a message only touches the heap if it's very long
 template<typename ... Args>
-void __Log(const spdlog::level::level_enum level, const std::string& filename, const std::string& fn_name, const int line_number, const char* fmt, const Args& ... args) {
-	auto message = fmt::format(fmt, args...);
-	auto final_message = fmt::format("{3} ({0}:{1}:{2})", filename, fn_name, line_number, message);
-	console->log(level, final_message);
+void __Log(const spdlog::level::level_enum level, const char* filename, const char* fn_name, const int line_number, const char* fmt, const Args& ... args) {
+	if (!console->should_log(level)) return;
+	fmt::MemoryWriter message;
+	message.write(fmt, args...);
+	message.write(" ({}:{}:{})", filename, fn_name, line_number);
+	console->log(level, fmt::StringRef(message.data(), message.size()));
 }
 
 template<typename T, typename ... Args>
-const T& __LogValue(const spdlog::level::level_enum level, const std::string& filename, const std::string& fn_name, const int line_number, const char* fmt, const T& value, const Args& ... args) {
-	auto message = fmt::format(fmt, value, args...);
-	auto final_message = fmt::format("{3} ({0}:{1}:{2})", filename, fn_name, line_number, message);
-	console->log(level, final_message);
+const T& __LogValue(const spdlog::level::level_enum level, const char* filename, const char* fn_name, const int line_number, const char* fmt, const T& value, const Args& ... args) {
+	__Log(level, filename, fn_name, line_number, fmt, value, args...);
 	return value;
 }
 
@@ -1,9 +1,12 @@
-#include <Utilities\Math.h>
-#include <Utilities\Logging.h>
+#include <Utilities/Math.h>
+#include <Utilities/Logging.h>
+#include <Utilities/SIMD.h>
 
 #include <utility>
 
+#ifdef _WIN32
 #include <DirectXMath.h>
+#endif
 
 namespace pn {
 
@@ -52,8 +55,35 @@ const mat4f mat4f::One		= mat4f(1.0f, 1.0f, 1.0f, 1.0f,
 
 #pragma endregion
 
-#pragma region Matrix Functions
+#pragma region Scalar Matrix Kernels
+
+namespace scalar {
+
+mat4f Multiply(const mat4f& a, const mat4f& b) {
+	mat4f result;
+
+	result._00 = a._00*b._00 + a._01*b._10 + a._02*b._20 + a._03*b._30;
+	result._01 = a._00*b._01 + a._01*b._11 + a._02*b._21 + a._03*b._31;
+	result._02 = a._00*b._02 + a._01*b._12 + a._02*b._22 + a._03*b._32;
+	result._03 = a._00*b._03 + a._01*b._13 + a._02*b._23 + a._03*b._33;
+
+	result._10 = a._10*b._00 + a._11*b._10 + a._12*b._20 + a._13*b._30;
+	result._11 = a._10*b._01 + a._11*b._11 + a._12*b._21 + a._13*b._31;
+	result._12 = a._10*b._02 + a._11*b._12 + a._12*b._22 + a._13*b._32;
+	result._13 = a._10*b._03 + a._11*b._13 + a._12*b._23 + a._13*b._33;
 
+	result._20 = a._20*b._00 + a._21*b._10 + a._22*b._20 + a._23*b._30;
+	result._21 = a._20*b._01 + a._21*b._11 + a._22*b._21 + a._23*b._31;
+	result._22 = a._20*b._02 + a._21*b._12 + a._22*b._22 + a._23*b._32;
+	result._23 = a._20*b._03 + a._21*b._13 + a._22*b._23 + a._23*b._33;
+
+	result._30 = a._30*b._00 + a._31*b._10 + a._32*b._20 + a._33*b._30;
+	result._31 = a._30*b._01 + a._31*b._11 + a._32*b._21 + a._33*b._31;
+	result._32 = a._30*b._02 + a._31*b._12 + a._32*b._22 + a._33*b._32;
+	result._33 = a._30*b._03 + a._31*b._13 + a._32*b._23 + a._33*b._33;
+
+	return result;
+}
 mat4f Transpose(const mat4f& m) {
 	return mat4f(
 		m._00, m._10, m._20, m._30,
@@ -106,6 +136,215 @@ mat4f Inverse(const mat4f& in) {
 	return m;
 }
 
+} // namespace scalar
+
+#pragma endregion
+
+#pragma region SIMD Matrix Kernels
+
+#if defined(PN_SIMD_SSE41)
+
+namespace simd {
+
+#define PN_SHUFFLE_MASK(x, y, z, w)		((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define PN_SWIZZLE(v, x, y, z, w)		_mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), PN_SHUFFLE_MASK(x, y, z, w)))
+#define PN_SHUFFLE(a, b, x, y, z, w)	_mm_shuffle_ps(a, b, PN_SHUFFLE_MASK(x, y, z, w))
+
+PN_FORCEINLINE __m128 LoadRow(const mat4f& m, const int row) {
+	return _mm_load_ps(&m._00 + 4 * row);
+}
+PN_FORCEINLINE void StoreRow(mat4f& m, const int row, const __m128 v) {
+	_mm_store_ps(&m._00 + 4 * row, v);
+}
+
+PN_FORCEINLINE __m128 MulAdd(const __m128 a, const __m128 b, const __m128 c) {
+#if defined(__FMA__)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// row * m, where m is given as its four rows
+PN_FORCEINLINE __m128 RowTimesMatrix(const __m128 row, const __m128 m0, const __m128 m1, const __m128 m2, const __m128 m3) {
+	__m128 result = _mm_mul_ps(PN_SWIZZLE(row, 0, 0, 0, 0), m0);
+	result = MulAdd(PN_SWIZZLE(row, 1, 1, 1, 1), m1, result);
+	result = MulAdd(PN_SWIZZLE(row, 2, 2, 2, 2), m2, result);
+	result = MulAdd(PN_SWIZZLE(row, 3, 3, 3, 3), m3, result);
+	return result;
+}
+
+#if defined(PN_SIMD_AVX2)
+
+PN_FORCEINLINE __m256 MulAdd(const __m256 a, const __m256 b, const __m256 c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+	return _mm256_fmadd_ps(a, b, c);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// Two rows of a per 256-bit register; b's rows are broadcast to both lanes.
+// mat4f is only 16-byte aligned, so the 256-bit loads/stores are unaligned.
+mat4f Multiply(const mat4f& a, const mat4f& b) {
+	const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b._00));
+	const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b._10));
+	const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b._20));
+	const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b._30));
+
+	auto rows_times_b = [&](const __m256 rows) {
+		__m256 result = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, PN_SHUFFLE_MASK(0, 0, 0, 0)), b0);
+		result = MulAdd(_mm256_shuffle_ps(rows, rows, PN_SHUFFLE_MASK(1, 1, 1, 1)), b1, result);
+		result = MulAdd(_mm256_shuffle_ps(rows, rows, PN_SHUFFLE_MASK(2, 2, 2, 2)), b2, result);
+		result = MulAdd(_mm256_shuffle_ps(rows, rows, PN_SHUFFLE_MASK(3, 3, 3, 3)), b3, result);
+		return result;
+	};
+
+	mat4f result;
+	_mm256_storeu_ps(&result._00, rows_times_b(_mm256_loadu_ps(&a._00)));
+	_mm256_storeu_ps(&result._20, rows_times_b(_mm256_loadu_ps(&a._20)));
+	return result;
+}
+
+#else
+
+mat4f Multiply(const mat4f& a, const mat4f& b) {
+	const __m128 b0 = LoadRow(b, 0);
+	const __m128 b1 = LoadRow(b, 1);
+	const __m128 b2 = LoadRow(b, 2);
+	const __m128 b3 = LoadRow(b, 3);
+
+	mat4f result;
+	StoreRow(result, 0, RowTimesMatrix(LoadRow(a, 0), b0, b1, b2, b3));
+	StoreRow(result, 1, RowTimesMatrix(LoadRow(a, 1), b0, b1, b2, b3));
+	StoreRow(result, 2, RowTimesMatrix(LoadRow(a, 2), b0, b1, b2, b3));
+	StoreRow(result, 3, RowTimesMatrix(LoadRow(a, 3), b0, b1, b2, b3));
+	return result;
+}
+
+#endif
+
+mat4f Transpose(const mat4f& m) {
+	__m128 r0 = LoadRow(m, 0);
+	__m128 r1 = LoadRow(m, 1);
+	__m128 r2 = LoadRow(m, 2);
+	__m128 r3 = LoadRow(m, 3);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	mat4f result;
+	StoreRow(result, 0, r0);
+	StoreRow(result, 1, r1);
+	StoreRow(result, 2, r2);
+	StoreRow(result, 3, r3);
+	return result;
+}
+
+// 2x2 row major matrix helpers, each matrix packed in one register as (m00, m01, m10, m11)
+PN_FORCEINLINE __m128 Mat2Mul(const __m128 a, const __m128 b) {
+	return _mm_add_ps(
+		_mm_mul_ps(a, PN_SWIZZLE(b, 0, 3, 0, 3)),
+		_mm_mul_ps(PN_SWIZZLE(a, 1, 0, 3, 2), PN_SWIZZLE(b, 2, 1, 2, 1)));
+}
+// adj(a) * b
+PN_FORCEINLINE __m128 Mat2AdjMul(const __m128 a, const __m128 b) {
+	return _mm_sub_ps(
+		_mm_mul_ps(PN_SWIZZLE(a, 3, 3, 0, 0), b),
+		_mm_mul_ps(PN_SWIZZLE(a, 1, 1, 2, 2), PN_SWIZZLE(b, 2, 3, 0, 1)));
+}
+// a * adj(b)
+PN_FORCEINLINE __m128 Mat2MulAdj(const __m128 a, const __m128 b) {
+	return _mm_sub_ps(
+		_mm_mul_ps(a, PN_SWIZZLE(b, 3, 0, 3, 0)),
+		_mm_mul_ps(PN_SWIZZLE(a, 1, 0, 3, 2), PN_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// Block-wise inverse: M = | A B |, with A, B, C, D 2x2 sub matrices
+//                         | C D |
+mat4f Inverse(const mat4f& in) {
+	const __m128 r0 = LoadRow(in, 0);
+	const __m128 r1 = LoadRow(in, 1);
+	const __m128 r2 = LoadRow(in, 2);
+	const __m128 r3 = LoadRow(in, 3);
+
+	const __m128 A = _mm_movelh_ps(r0, r1);
+	const __m128 B = _mm_movehl_ps(r1, r0);
+	const __m128 C = _mm_movelh_ps(r2, r3);
+	const __m128 D = _mm_movehl_ps(r3, r2);
+
+	// (|A|, |B|, |C|, |D|)
+	const __m128 det_sub = _mm_sub_ps(
+		_mm_mul_ps(PN_SHUFFLE(r0, r2, 0, 2, 0, 2), PN_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+		_mm_mul_ps(PN_SHUFFLE(r0, r2, 1, 3, 1, 3), PN_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+	const __m128 det_A = PN_SWIZZLE(det_sub, 0, 0, 0, 0);
+	const __m128 det_B = PN_SWIZZLE(det_sub, 1, 1, 1, 1);
+	const __m128 det_C = PN_SWIZZLE(det_sub, 2, 2, 2, 2);
+	const __m128 det_D = PN_SWIZZLE(det_sub, 3, 3, 3, 3);
+
+	const __m128 D_C = Mat2AdjMul(D, C);
+	const __m128 A_B = Mat2AdjMul(A, B);
+
+	__m128 X = _mm_sub_ps(_mm_mul_ps(det_D, A), Mat2Mul(B, D_C));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(det_A, D), Mat2Mul(C, A_B));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(det_B, C), Mat2MulAdj(D, A_B));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(det_C, B), Mat2MulAdj(A, D_C));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 det_M = _mm_add_ps(_mm_mul_ps(det_A, det_D), _mm_mul_ps(det_B, det_C));
+	__m128 trace = _mm_mul_ps(A_B, PN_SWIZZLE(D_C, 0, 2, 1, 3));
+	trace = _mm_hadd_ps(trace, trace);
+	trace = _mm_hadd_ps(trace, trace);
+	det_M = _mm_sub_ps(det_M, trace);
+
+	// Should check for 0 determinant
+
+	const __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_M);
+	X = _mm_mul_ps(X, inv_det);
+	Y = _mm_mul_ps(Y, inv_det);
+	Z = _mm_mul_ps(Z, inv_det);
+	W = _mm_mul_ps(W, inv_det);
+
+	mat4f result;
+	StoreRow(result, 0, PN_SHUFFLE(X, Y, 3, 1, 3, 1));
+	StoreRow(result, 1, PN_SHUFFLE(X, Y, 2, 0, 2, 0));
+	StoreRow(result, 2, PN_SHUFFLE(Z, W, 3, 1, 3, 1));
+	StoreRow(result, 3, PN_SHUFFLE(Z, W, 2, 0, 2, 0));
+	return result;
+}
+
+#undef PN_SHUFFLE
+#undef PN_SWIZZLE
+#undef PN_SHUFFLE_MASK
+
+} // namespace simd
+
+#endif
+
+#pragma endregion
+
+#pragma region Matrix Functions
+
+mat4f Multiply(const mat4f& a, const mat4f& b) {
+#if defined(PN_SIMD_SSE41)
+	return simd::Multiply(a, b);
+#else
+	return scalar::Multiply(a, b);
+#endif
+}
+mat4f Transpose(const mat4f& m) {
+#if defined(PN_SIMD_SSE41)
+	return simd::Transpose(m);
+#else
+	return scalar::Transpose(m);
+#endif
+}
+mat4f Inverse(const mat4f& in) {
+#if defined(PN_SIMD_SSE41)
+	return simd::Inverse(in);
+#else
+	return scalar::Inverse(in);
+#endif
+}
+
 mat4f Translation(const vec3f& translation) {
 	return Translation(translation.x, translation.y, translation.z);
 }
@@ -364,6 +603,7 @@ bool IsEqual(const mat4f& v1, const mat4f& v2, const float eps) {
 		E(v1._32, v2._32, eps) &&
 		E(v1._33, v2._33, eps);
 }
+#ifdef _WIN32
 bool IsEqual(const mat4f& v1, const DirectX::XMMATRIX& v2, const float eps) {
 	return
 		E(v1._00, v2.r[0].m128_f32[0], eps) &&
@@ -383,6 +623,7 @@ bool IsEqual(const mat4f& v1, const DirectX::XMMATRIX& v2, const float eps) {
 		E(v1._32, v2.r[3].m128_f32[2], eps) &&
 		E(v1._33, v2.r[3].m128_f32[3], eps);
 }
+#endif
 #undef E
 
 #pragma endregion
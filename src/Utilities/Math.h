@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cmath>
 #include <functional>
 #include <cassert>
+#include <cstring>
 
+#ifdef _WIN32
+// only to check results against DirectXMath, which ships with the Windows SDK
 namespace DirectX {
 struct XMMATRIX;
 }
+#endif
 
 namespace pn {
 
@@ -176,7 +181,10 @@ struct quaternion {
 
 // ---------- MATRIX ---------------
 
-struct mat4f {
+struct mat4f		Multiply(const struct mat4f& a, const struct mat4f& b);
+
+// Rows are 16-byte aligned so the SIMD kernels in Math.cpp can load them directly
+struct alignas(16) mat4f {
 	float _00, _01, _02, _03;
 	float _10, _11, _12, _13;
 	float _20, _21, _22, _23;
@@ -232,25 +240,7 @@ struct mat4f {
 		return *this;
 	}
 	mat4f& operator*=(const mat4f& m) {
-		_00 = _00*m._00 + _01*m._10 + _02*m._20 + _03*m._30;
-		_01 = _00*m._01 + _01*m._11 + _02*m._21 + _03*m._31;
-		_02 = _00*m._02 + _01*m._12 + _02*m._22 + _03*m._32;
-		_03 = _00*m._03 + _01*m._13 + _02*m._23 + _03*m._33;
-
-		_10 = _10*m._00 + _11*m._10 + _12*m._20 + _13*m._30;
-		_11 = _10*m._01 + _11*m._11 + _12*m._21 + _13*m._31;
-		_12 = _10*m._02 + _11*m._12 + _12*m._22 + _13*m._32;
-		_13 = _10*m._03 + _11*m._13 + _12*m._23 + _13*m._33;
-
-		_20 = _20*m._00 + _21*m._10 + _22*m._20 + _23*m._30;
-		_21 = _20*m._01 + _21*m._11 + _22*m._21 + _23*m._31;
-		_22 = _20*m._02 + _21*m._12 + _22*m._22 + _23*m._32;
-		_23 = _20*m._03 + _21*m._13 + _22*m._23 + _23*m._33;
-
-		_30 = _30*m._00 + _31*m._10 + _32*m._20 + _33*m._30;
-		_31 = _30*m._01 + _31*m._11 + _32*m._21 + _33*m._31;
-		_32 = _30*m._02 + _31*m._12 + _32*m._22 + _33*m._32;
-		_33 = _30*m._03 + _31*m._13 + _32*m._23 + _33*m._33;
+		*this = Multiply(*this, m);
 		return *this;
 	}
 	mat4f& operator*=(const float c) {
@@ -285,29 +275,7 @@ struct mat4f {
 		);
 	}
 	mat4f operator*(const mat4f& m) const {
-		mat4f result;
-
-		result._00 = _00*m._00 + _01*m._10 + _02*m._20 + _03*m._30;
-		result._01 = _00*m._01 + _01*m._11 + _02*m._21 + _03*m._31;
-		result._02 = _00*m._02 + _01*m._12 + _02*m._22 + _03*m._32;
-		result._03 = _00*m._03 + _01*m._13 + _02*m._23 + _03*m._33;
-
-		result._10 = _10*m._00 + _11*m._10 + _12*m._20 + _13*m._30;
-		result._11 = _10*m._01 + _11*m._11 + _12*m._21 + _13*m._31;
-		result._12 = _10*m._02 + _11*m._12 + _12*m._22 + _13*m._32;
-		result._13 = _10*m._03 + _11*m._13 + _12*m._23 + _13*m._33;
-
-		result._20 = _20*m._00 + _21*m._10 + _22*m._20 + _23*m._30;
-		result._21 = _20*m._01 + _21*m._11 + _22*m._21 + _23*m._31;
-		result._22 = _20*m._02 + _21*m._12 + _22*m._22 + _23*m._32;
-		result._23 = _20*m._03 + _21*m._13 + _22*m._23 + _23*m._33;
-
-		result._30 = _30*m._00 + _31*m._10 + _32*m._20 + _33*m._30;
-		result._31 = _30*m._01 + _31*m._11 + _32*m._21 + _33*m._31;
-		result._32 = _30*m._02 + _31*m._12 + _32*m._22 + _33*m._32;
-		result._33 = _30*m._03 + _31*m._13 + _32*m._23 + _33*m._33;
-
-		return result;
+		return Multiply(*this, m);
 	}
 	mat4f operator*(const float c) const {
 		return mat4f(
@@ -369,9 +337,20 @@ inline float	Distance(const Vec& v1, const Vec& v2) { return sqrtf(DistanceSqr(v
 
 // --------- MATRIX FUNCTIONS -------------
 
+// Dispatch to the widest kernel enabled at compile time (see Utilities/SIMD.h)
+mat4f		Multiply(const mat4f& a, const mat4f& b);
 mat4f		Transpose(const mat4f& m);
 mat4f		Inverse(const mat4f& in);
 
+namespace scalar {
+
+// Reference implementations, used as the fallback path and to validate the SIMD kernels
+mat4f		Multiply(const mat4f& a, const mat4f& b);
+mat4f		Transpose(const mat4f& m);
+mat4f		Inverse(const mat4f& in);
+
+} // namespace scalar
+
 mat4f		Translation(const vec3f& translation);
 mat4f		Translation(const float xt, const float yt, const float zt);
 
@@ -482,10 +461,10 @@ inline vec4f	operator*(const vec4f& v, const mat4f& m) {
 
 // ------ ANGLE FUNCTIONS -------------
 
-inline constexpr float	Rad(const float angles) {
+inline float			Rad(const float angles) {
 	return angles * (PI / 180.0f);
 }
-inline constexpr float	Angle(const float rad) {
+inline float			Angle(const float rad) {
 	return rad * (180.0f / PI);
 }
 inline float			DeltaAngle(const float a1, const float a2) {
@@ -510,21 +489,27 @@ bool IsEqual(const vec3f& v1, const vec3f& v2, const float eps = EPSILON);
 bool IsEqual(const vec4f& v1, const vec4f& v2, const float eps = EPSILON);
 bool IsEqual(const quaternion& v1, const quaternion& v2, const float eps = EPSILON);
 bool IsEqual(const mat4f& v1, const mat4f& v2, const float eps = EPSILON);
+#ifdef _WIN32
 bool IsEqual(const mat4f& v1, const DirectX::XMMATRIX& v2, const float eps = EPSILON);
+#endif
 
 inline bool operator==(const vec2f& v1, const vec2f& v2) { return IsEqual(v1, v2); }
 inline bool operator==(const vec3f& v1, const vec3f& v2) { return IsEqual(v1, v2); }
 inline bool operator==(const vec4f& v1, const vec4f& v2) { return IsEqual(v1, v2); }
 inline bool operator==(const quaternion& v1, const quaternion& v2) { return IsEqual(v1, v2); }
 inline bool operator==(const mat4f& v1, const mat4f& v2) { return IsEqual(v1, v2); }
+#ifdef _WIN32
 inline bool operator==(const mat4f& v1, const DirectX::XMMATRIX& v2) { return IsEqual(v1, v2); }
+#endif
 
 inline bool operator!=(const vec2f& v1, const vec2f& v2) { return !IsEqual(v1, v2); }
 inline bool operator!=(const vec3f& v1, const vec3f& v2) { return !IsEqual(v1, v2); }
 inline bool operator!=(const vec4f& v1, const vec4f& v2) { return !IsEqual(v1, v2); }
 inline bool operator!=(const quaternion& v1, const quaternion& v2) { return !IsEqual(v1, v2); }
 inline bool operator!=(const mat4f& v1, const mat4f& v2) { return !IsEqual(v1, v2); }
+#ifdef _WIN32
 inline bool operator!=(const mat4f& v1, const DirectX::XMMATRIX& v2) { return !IsEqual(v1, v2); }
+#endif
 
 
 // -------- VECTOR FUNCTIONS -----------------
@@ -0,0 +1,303 @@
+#include <Utilities/MathBatch.h>
+#include <Utilities/SIMD.h>
+
+#include <cassert>
+
+namespace pn {
+
+#pragma region Lanes
+
+// Each lane type wraps one register worth of floats. The batch kernels are written once against
+// this interface and run with the widest lane available, then finish the tail with scalar_lane.
+
+struct scalar_lane {
+	using reg = float;
+	static constexpr size_t WIDTH = 1;
+
+	static PN_FORCEINLINE reg	Load(const float* p) { return *p; }
+	static PN_FORCEINLINE void	Store(float* p, const reg v) { *p = v; }
+	static PN_FORCEINLINE reg	Set(const float f) { return f; }
+	static PN_FORCEINLINE reg	Add(const reg a, const reg b) { return a + b; }
+	static PN_FORCEINLINE reg	Sub(const reg a, const reg b) { return a - b; }
+	static PN_FORCEINLINE reg	Mul(const reg a, const reg b) { return a * b; }
+	static PN_FORCEINLINE reg	MulAdd(const reg a, const reg b, const reg c) { return a * b + c; }
+	static PN_FORCEINLINE reg	Div(const reg a, const reg b) { return a / b; }
+	static PN_FORCEINLINE reg	Sqrt(const reg a) { return sqrtf(a); }
+};
+
+#if defined(PN_SIMD_SSE41)
+
+struct sse_lane {
+	using reg = __m128;
+	static constexpr size_t WIDTH = 4;
+
+	static PN_FORCEINLINE reg	Load(const float* p) { return _mm_loadu_ps(p); }
+	static PN_FORCEINLINE void	Store(float* p, const reg v) { _mm_storeu_ps(p, v); }
+	static PN_FORCEINLINE reg	Set(const float f) { return _mm_set1_ps(f); }
+	static PN_FORCEINLINE reg	Add(const reg a, const reg b) { return _mm_add_ps(a, b); }
+	static PN_FORCEINLINE reg	Sub(const reg a, const reg b) { return _mm_sub_ps(a, b); }
+	static PN_FORCEINLINE reg	Mul(const reg a, const reg b) { return _mm_mul_ps(a, b); }
+	static PN_FORCEINLINE reg	MulAdd(const reg a, const reg b, const reg c) {
+#if defined(__FMA__)
+		return _mm_fmadd_ps(a, b, c);
+#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+	}
+	static PN_FORCEINLINE reg	Div(const reg a, const reg b) { return _mm_div_ps(a, b); }
+	static PN_FORCEINLINE reg	Sqrt(const reg a) { return _mm_sqrt_ps(a); }
+};
+
+#endif
+
+#if defined(PN_SIMD_AVX2)
+
+struct avx_lane {
+	using reg = __m256;
+	static constexpr size_t WIDTH = 8;
+
+	static PN_FORCEINLINE reg	Load(const float* p) { return _mm256_loadu_ps(p); }
+	static PN_FORCEINLINE void	Store(float* p, const reg v) { _mm256_storeu_ps(p, v); }
+	static PN_FORCEINLINE reg	Set(const float f) { return _mm256_set1_ps(f); }
+	static PN_FORCEINLINE reg	Add(const reg a, const reg b) { return _mm256_add_ps(a, b); }
+	static PN_FORCEINLINE reg	Sub(const reg a, const reg b) { return _mm256_sub_ps(a, b); }
+	static PN_FORCEINLINE reg	Mul(const reg a, const reg b) { return _mm256_mul_ps(a, b); }
+	static PN_FORCEINLINE reg	MulAdd(const reg a, const reg b, const reg c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+		return _mm256_fmadd_ps(a, b, c);
+#else
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+	}
+	static PN_FORCEINLINE reg	Div(const reg a, const reg b) { return _mm256_div_ps(a, b); }
+	static PN_FORCEINLINE reg	Sqrt(const reg a) { return _mm256_sqrt_ps(a); }
+};
+
+using wide_lane = avx_lane;
+
+#elif defined(PN_SIMD_SSE41)
+
+using wide_lane = sse_lane;
+
+#else
+
+using wide_lane = scalar_lane;
+
+#endif
+
+#pragma endregion
+
+#pragma region Kernels
+
+// out_i = sum_j in_j * m._ji + (HAS_W ? in_w * m._3i : m._3i)
+template<typename L, bool HAS_W>
+struct transform_kernel {
+	// broadcast once up front, the output stores could otherwise alias the matrix
+	typename L::reg c[16];
+
+	explicit transform_kernel(const mat4f& m) {
+		const float* p = &m._00;
+		for (int i = 0; i < 16; ++i) {
+			c[i] = L::Set(p[i]);
+		}
+	}
+
+	template<size_t N>
+	PN_FORCEINLINE void operator()(const size_t i, const float* const (&in)[N], float* const (&out)[N]) const {
+		typename L::reg v[N];
+		for (size_t j = 0; j < N; ++j) {
+			v[j] = L::Load(in[j] + i);
+		}
+		for (size_t col = 0; col < N; ++col) {
+			auto r = c[12 + col];
+			if constexpr (HAS_W) {
+				r = L::Mul(v[3], r);
+			}
+			r = L::MulAdd(v[2], c[8 + col], r);
+			r = L::MulAdd(v[1], c[4 + col], r);
+			r = L::MulAdd(v[0], c[0 + col], r);
+			L::Store(out[col] + i, r);
+		}
+	}
+};
+
+template<typename L>
+struct normalize_kernel {
+	PN_FORCEINLINE void operator()(const size_t i, const float* const (&in)[3], float* const (&out)[3]) const {
+		const auto x = L::Load(in[0] + i);
+		const auto y = L::Load(in[1] + i);
+		const auto z = L::Load(in[2] + i);
+		const auto len = L::Sqrt(L::MulAdd(x, x, L::MulAdd(y, y, L::Mul(z, z))));
+		L::Store(out[0] + i, L::Div(x, len));
+		L::Store(out[1] + i, L::Div(y, len));
+		L::Store(out[2] + i, L::Div(z, len));
+	}
+};
+
+// Loads every input of a lane before storing, so outputs can alias inputs
+template<template<typename> class Kernel, size_t N, typename... Args>
+void RunBatch(const size_t n, const float* const (&in)[N], float* const (&out)[N], const Args&... args) {
+	const Kernel<wide_lane> wide{ args... };
+	const Kernel<scalar_lane> tail{ args... };
+
+	size_t i = 0;
+	for (; i + wide_lane::WIDTH <= n; i += wide_lane::WIDTH) {
+		wide(i, in, out);
+	}
+	for (; i < n; ++i) {
+		tail(i, in, out);
+	}
+}
+
+template<typename L> using point_kernel = transform_kernel<L, false>;
+template<typename L> using vec4_kernel = transform_kernel<L, true>;
+
+#pragma endregion
+
+#pragma region Layout Conversion
+
+void			ToSoA(span<const vec3f> aos, span<float> xs, span<float> ys, span<float> zs) {
+	assert(xs.size() == aos.size() && ys.size() == aos.size() && zs.size() == aos.size());
+	for (size_t i = 0; i < aos.size(); ++i) {
+		xs[i] = aos[i].x;
+		ys[i] = aos[i].y;
+		zs[i] = aos[i].z;
+	}
+}
+
+void			ToSoA(span<const vec4f> aos, span<float> xs, span<float> ys, span<float> zs, span<float> ws) {
+	assert(xs.size() == aos.size() && ys.size() == aos.size() && zs.size() == aos.size() && ws.size() == aos.size());
+	for (size_t i = 0; i < aos.size(); ++i) {
+		xs[i] = aos[i].x;
+		ys[i] = aos[i].y;
+		zs[i] = aos[i].z;
+		ws[i] = aos[i].w;
+	}
+}
+
+soa_vec3f		ToSoA(const pn::vector<vec3f>& aos) {
+	soa_vec3f result;
+	Resize(result, aos.size());
+	ToSoA(aos, result.x, result.y, result.z);
+	return result;
+}
+
+soa_vec4f		ToSoA(const pn::vector<vec4f>& aos) {
+	soa_vec4f result;
+	Resize(result, aos.size());
+	ToSoA(aos, result.x, result.y, result.z, result.w);
+	return result;
+}
+
+void			ToAoS(span<const float> xs, span<const float> ys, span<const float> zs, span<vec3f> aos) {
+	assert(xs.size() == aos.size() && ys.size() == aos.size() && zs.size() == aos.size());
+	for (size_t i = 0; i < aos.size(); ++i) {
+		aos[i] = vec3f(xs[i], ys[i], zs[i]);
+	}
+}
+
+void			ToAoS(span<const float> xs, span<const float> ys, span<const float> zs, span<const float> ws, span<vec4f> aos) {
+	assert(xs.size() == aos.size() && ys.size() == aos.size() && zs.size() == aos.size() && ws.size() == aos.size());
+	for (size_t i = 0; i < aos.size(); ++i) {
+		aos[i] = vec4f(xs[i], ys[i], zs[i], ws[i]);
+	}
+}
+
+pn::vector<vec3f>	ToAoS(const soa_vec3f& soa) {
+	pn::vector<vec3f> result(Size(soa));
+	ToAoS(soa.x, soa.y, soa.z, result);
+	return result;
+}
+
+pn::vector<vec4f>	ToAoS(const soa_vec4f& soa) {
+	pn::vector<vec4f> result(Size(soa));
+	ToAoS(soa.x, soa.y, soa.z, soa.w, result);
+	return result;
+}
+
+void			Resize(soa_vec3f& soa, const size_t n) {
+	soa.x.resize(n);
+	soa.y.resize(n);
+	soa.z.resize(n);
+}
+
+void			Resize(soa_vec4f& soa, const size_t n) {
+	soa.x.resize(n);
+	soa.y.resize(n);
+	soa.z.resize(n);
+	soa.w.resize(n);
+}
+
+#pragma endregion
+
+#pragma region Batch Transformations
+
+void			TransformPoints(const mat4f& m,
+								span<const float> xs, span<const float> ys, span<const float> zs,
+								span<float> out_xs, span<float> out_ys, span<float> out_zs) {
+	const size_t n = xs.size();
+	assert(ys.size() == n && zs.size() == n && out_xs.size() == n && out_ys.size() == n && out_zs.size() == n);
+	const float* const in[] = { xs.data(), ys.data(), zs.data() };
+	float* const out[] = { out_xs.data(), out_ys.data(), out_zs.data() };
+	RunBatch<point_kernel>(n, in, out, m);
+}
+
+void			TransformVectors(const mat4f& m,
+								 span<const float> xs, span<const float> ys, span<const float> zs,
+								 span<float> out_xs, span<float> out_ys, span<float> out_zs) {
+	// dropping the translation row leaves the same kernel as for points
+	mat4f linear = m;
+	linear._30 = linear._31 = linear._32 = 0.0f;
+	TransformPoints(linear, xs, ys, zs, out_xs, out_ys, out_zs);
+}
+
+void			Transform(const mat4f& m,
+						  span<const float> xs, span<const float> ys, span<const float> zs, span<const float> ws,
+						  span<float> out_xs, span<float> out_ys, span<float> out_zs, span<float> out_ws) {
+	const size_t n = xs.size();
+	assert(ys.size() == n && zs.size() == n && ws.size() == n);
+	assert(out_xs.size() == n && out_ys.size() == n && out_zs.size() == n && out_ws.size() == n);
+	const float* const in[] = { xs.data(), ys.data(), zs.data(), ws.data() };
+	float* const out[] = { out_xs.data(), out_ys.data(), out_zs.data(), out_ws.data() };
+	RunBatch<vec4_kernel>(n, in, out, m);
+}
+
+void			RotatePoints(const quaternion& q,
+							 span<const float> xs, span<const float> ys, span<const float> zs,
+							 span<float> out_xs, span<float> out_ys, span<float> out_zs) {
+	// one matrix build amortized over the batch instead of two quaternion products per point
+	TransformPoints(QuaternionToRotationMatrix(q), xs, ys, zs, out_xs, out_ys, out_zs);
+}
+
+void			NormalizeVectors(span<const float> xs, span<const float> ys, span<const float> zs,
+								 span<float> out_xs, span<float> out_ys, span<float> out_zs) {
+	const size_t n = xs.size();
+	assert(ys.size() == n && zs.size() == n && out_xs.size() == n && out_ys.size() == n && out_zs.size() == n);
+	const float* const in[] = { xs.data(), ys.data(), zs.data() };
+	float* const out[] = { out_xs.data(), out_ys.data(), out_zs.data() };
+	RunBatch<normalize_kernel>(n, in, out);
+}
+
+void			TransformPoints(const mat4f& m, soa_vec3f& points) {
+	TransformPoints(m, points.x, points.y, points.z, points.x, points.y, points.z);
+}
+
+void			TransformVectors(const mat4f& m, soa_vec3f& vectors) {
+	TransformVectors(m, vectors.x, vectors.y, vectors.z, vectors.x, vectors.y, vectors.z);
+}
+
+void			Transform(const mat4f& m, soa_vec4f& vectors) {
+	Transform(m, vectors.x, vectors.y, vectors.z, vectors.w, vectors.x, vectors.y, vectors.z, vectors.w);
+}
+
+void			RotatePoints(const quaternion& q, soa_vec3f& points) {
+	RotatePoints(q, points.x, points.y, points.z, points.x, points.y, points.z);
+}
+
+void			NormalizeVectors(soa_vec3f& vectors) {
+	NormalizeVectors(vectors.x, vectors.y, vectors.z, vectors.x, vectors.y, vectors.z);
+}
+
+#pragma endregion
+
+} // namespace pn
\ No newline at end of file
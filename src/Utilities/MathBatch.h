@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Utilities/Math.h>
+#include <Utilities/UtilityTypes.h>
+
+namespace pn {
+
+// ---------- STRUCTURE OF ARRAYS -------------
+
+struct soa_vec3f {
+	pn::vector<float> x;
+	pn::vector<float> y;
+	pn::vector<float> z;
+};
+
+struct soa_vec4f {
+	pn::vector<float> x;
+	pn::vector<float> y;
+	pn::vector<float> z;
+	pn::vector<float> w;
+};
+
+// ------- FUNCTIONS -------------
+
+// All batch functions take one span per component. Input and output spans must have the same
+// size, and an output may alias the matching input to work in place.
+
+// -------- LAYOUT CONVERSION --------------
+
+void			ToSoA(span<const vec3f> aos, span<float> xs, span<float> ys, span<float> zs);
+void			ToSoA(span<const vec4f> aos, span<float> xs, span<float> ys, span<float> zs, span<float> ws);
+soa_vec3f		ToSoA(const pn::vector<vec3f>& aos);
+soa_vec4f		ToSoA(const pn::vector<vec4f>& aos);
+
+void			ToAoS(span<const float> xs, span<const float> ys, span<const float> zs, span<vec3f> aos);
+void			ToAoS(span<const float> xs, span<const float> ys, span<const float> zs, span<const float> ws, span<vec4f> aos);
+pn::vector<vec3f>	ToAoS(const soa_vec3f& soa);
+pn::vector<vec4f>	ToAoS(const soa_vec4f& soa);
+
+void			Resize(soa_vec3f& soa, const size_t n);
+void			Resize(soa_vec4f& soa, const size_t n);
+
+inline size_t	Size(const soa_vec3f& soa) { return soa.x.size(); }
+inline size_t	Size(const soa_vec4f& soa) { return soa.x.size(); }
+
+// -------- BATCH TRANSFORMATIONS -----------
+
+// Same as vec4f(p, 1.0f) * m for every point, w is dropped without a perspective divide
+void			TransformPoints(const mat4f& m,
+								span<const float> xs, span<const float> ys, span<const float> zs,
+								span<float> out_xs, span<float> out_ys, span<float> out_zs);
+
+// Same as vec4f(v, 0.0f) * m for every vector
+void			TransformVectors(const mat4f& m,
+								 span<const float> xs, span<const float> ys, span<const float> zs,
+								 span<float> out_xs, span<float> out_ys, span<float> out_zs);
+
+// Same as v * m for every vec4f
+void			Transform(const mat4f& m,
+						  span<const float> xs, span<const float> ys, span<const float> zs, span<const float> ws,
+						  span<float> out_xs, span<float> out_ys, span<float> out_zs, span<float> out_ws);
+
+// Same as RotatePoint(v, q) for every point
+void			RotatePoints(const quaternion& q,
+							 span<const float> xs, span<const float> ys, span<const float> zs,
+							 span<float> out_xs, span<float> out_ys, span<float> out_zs);
+
+// Same as Normalize(v) for every vector
+void			NormalizeVectors(span<const float> xs, span<const float> ys, span<const float> zs,
+								 span<float> out_xs, span<float> out_ys, span<float> out_zs);
+
+void			TransformPoints(const mat4f& m, soa_vec3f& points);
+void			TransformVectors(const mat4f& m, soa_vec3f& vectors);
+void			Transform(const mat4f& m, soa_vec4f& vectors);
+void			RotatePoints(const quaternion& q, soa_vec3f& points);
+void			NormalizeVectors(soa_vec3f& vectors);
+
+} // namespace pn
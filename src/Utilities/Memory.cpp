@@ -0,0 +1,331 @@
+#include <Utilities/Memory.h>
+#include <Utilities/UtilityTypes.h>
+#include <Utilities/VirtualMemory.h>
+
+#include <algorithm>
+
+namespace pn {
+
+#pragma region Internal
+
+struct free_slot_t {
+	free_slot_t* next;
+};
+
+struct pool_storage::magazine_t {
+	std::atomic<uint64_t>	depot_next{ 0 };	// untagged, only meaningful while in the depot
+	free_slot_t*			slots = nullptr;
+	size_t					count = 0;
+};
+
+struct pool_storage::thread_cache_t {
+	std::mutex				lock;		// thread exit against pool destruction, never on the fast path
+	pool_storage*			pool;		// null once the pool is destroyed
+	magazine_t*				loaded;
+	magazine_t*				previous;
+	std::atomic<int64_t>	live_delta{ 0 };	// only written by the owning thread
+};
+
+// Depot links are a magazine pointer with a 16 bit tag in the unused top bits, bumped on every
+// push and pop so a magazine that left and came back doesn't fool a pop in progress
+static_assert(sizeof(void*) == 8, "pool depot tags need 64 bit pointers");
+
+constexpr uint64_t DEPOT_POINTER_MASK	= (uint64_t(1) << 48) - 1;
+constexpr int      DEPOT_TAG_SHIFT		= 48;
+
+static pool_storage::magazine_t* DepotPointer(const uint64_t link) {
+	return reinterpret_cast<pool_storage::magazine_t*>(link & DEPOT_POINTER_MASK);
+}
+
+static uint64_t DepotLink(const pool_storage::magazine_t* magazine, const uint64_t previous_link) {
+	const uint64_t tag = (previous_link >> DEPOT_TAG_SHIFT) + 1;
+	return (tag << DEPOT_TAG_SHIFT) | reinterpret_cast<uintptr_t>(magazine);
+}
+
+static void DepotPush(std::atomic<uint64_t>& depot, pool_storage::magazine_t* magazine) {
+	uint64_t head = depot.load(std::memory_order_relaxed);
+	do {
+		magazine->depot_next.store(head & DEPOT_POINTER_MASK, std::memory_order_relaxed);
+	} while (!depot.compare_exchange_weak(head, DepotLink(magazine, head), std::memory_order_release, std::memory_order_relaxed));
+}
+
+// Magazines are only freed with the pool, so reading depot_next of one another thread just
+// popped is safe, the tag makes the exchange fail
+static pool_storage::magazine_t* DepotPop(std::atomic<uint64_t>& depot) {
+	uint64_t head = depot.load(std::memory_order_acquire);
+	while (DepotPointer(head) != nullptr) {
+		const auto next = DepotPointer(DepotPointer(head)->depot_next.load(std::memory_order_relaxed));
+		if (depot.compare_exchange_weak(head, DepotLink(next, head), std::memory_order_acquire, std::memory_order_acquire)) {
+			return DepotPointer(head);
+		}
+	}
+	return nullptr;
+}
+
+static std::atomic<size_t> next_pool_id{ 0 };
+
+// Every slot has to be able to hold a free list link and keep the slot after it aligned
+static size_t PoolSlotSize(const size_t size, const size_t alignment) {
+	const size_t slot_size = std::max(size, sizeof(free_slot_t));
+	return (slot_size + alignment - 1) / alignment * alignment;
+}
+
+// The calling thread's caches, indexed by pool id. Ids aren't reused, so the entry of a
+// destroyed pool is never looked up again.
+struct thread_pool_caches_t {
+	std::vector<std::shared_ptr<pool_storage::thread_cache_t>> caches;
+
+	~thread_pool_caches_t() {
+		for (auto& cache : caches) {
+			if (!cache) continue;
+			std::lock_guard<std::mutex> guard(cache->lock);
+			if (cache->pool != nullptr) {
+				cache->pool->ReturnThreadCache(*cache);
+			}
+		}
+	}
+};
+
+static thread_local thread_pool_caches_t thread_pool_caches;
+
+#pragma endregion
+
+#pragma region Pool Storage
+
+pool_storage::pool_storage(const size_t slot_size, const size_t slot_alignment, const size_t chunk_size, const memory_tag_t tag)
+	: slot_size(PoolSlotSize(slot_size, std::max(slot_alignment, alignof(free_slot_t))))
+	, slot_alignment(std::max(slot_alignment, alignof(free_slot_t)))
+	, chunk_size(std::max<size_t>(chunk_size, 1))
+	, id(next_pool_id.fetch_add(1, std::memory_order_relaxed))
+	, tag(tag)
+	, chunk_cursor(this->chunk_size) {}
+
+pool_storage::~pool_storage() {
+	for (auto& cache : thread_caches) {
+		std::lock_guard<std::mutex> guard(cache->lock);
+		cache->pool = nullptr;
+	}
+	for (auto* magazine : magazines) {
+		magazine->~magazine_t();
+		UntrackedFree(magazine);
+	}
+	for (auto* chunk : chunks) {
+		UntrackedFree(chunk);
+	}
+	TrackMemory(tag, -static_cast<int64_t>(Size(chunks) * chunk_size * slot_size + Size(magazines) * sizeof(magazine_t)));
+}
+
+void* pool_storage::Allocate() {
+	auto& cache = GetThreadCache();
+	if (cache.loaded->count == 0) {
+		Reload(cache);
+	}
+
+	auto* slot = cache.loaded->slots;
+	cache.loaded->slots = slot->next;
+	--cache.loaded->count;
+	cache.live_delta.store(cache.live_delta.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	return slot;
+}
+
+void pool_storage::Release(void* slot) {
+	auto& cache = GetThreadCache();
+	if (cache.loaded->count == POOL_MAGAZINE_SIZE) {
+		Unload(cache);
+	}
+
+	auto* free_slot = static_cast<free_slot_t*>(slot);
+	free_slot->next = cache.loaded->slots;
+	cache.loaded->slots = free_slot;
+	++cache.loaded->count;
+	cache.live_delta.store(cache.live_delta.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+}
+
+bool pool_storage::Owns(const void* slot) const {
+	const auto* address = static_cast<const char*>(slot);
+	std::lock_guard<std::mutex> guard(lock);
+	for (const auto* chunk : chunks) {
+		if (address >= chunk && address < chunk + chunk_size * slot_size) {
+			return (address - chunk) % slot_size == 0;
+		}
+	}
+	return false;
+}
+
+pool_stats_t pool_storage::GetStats() const {
+	std::lock_guard<std::mutex> guard(lock);
+	int64_t live_now = live.load(std::memory_order_relaxed);
+	for (const auto& cache : thread_caches) {
+		live_now += cache->live_delta.load(std::memory_order_relaxed);
+	}
+
+	auto peak = peak_live.load(std::memory_order_relaxed);
+	while (live_now > peak && !peak_live.compare_exchange_weak(peak, live_now, std::memory_order_relaxed)) {}
+
+	pool_stats_t stats;
+	stats.live		= static_cast<size_t>(std::max<int64_t>(live_now, 0));
+	stats.peak_live	= static_cast<size_t>(std::max(live_now, peak));
+	stats.capacity	= Size(chunks) * chunk_size;
+	stats.chunks	= Size(chunks);
+	return stats;
+}
+
+void pool_storage::ReturnThreadCache(thread_cache_t& cache) {
+	FoldLiveCount(cache);
+	for (auto* magazine : { cache.loaded, cache.previous }) {
+		DepotPush(magazine->count > 0 ? filled_magazines : empty_magazines, magazine);
+	}
+	cache.loaded = cache.previous = nullptr;
+}
+
+pool_storage::thread_cache_t& pool_storage::GetThreadCache() {
+	auto& caches = thread_pool_caches.caches;
+	if (id < Size(caches) && caches[id]) {
+		return *caches[id];
+	}
+	return AddThreadCache();
+}
+
+pool_storage::thread_cache_t& pool_storage::AddThreadCache() {
+	auto cache = std::make_shared<thread_cache_t>();
+	cache->pool		= this;
+	cache->loaded	= NewMagazine();
+	cache->previous	= NewMagazine();
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		PushBack(thread_caches, cache);
+	}
+
+	auto& caches = thread_pool_caches.caches;
+	if (Size(caches) <= id) {
+		Resize(caches, id + 1);
+	}
+	caches[id] = cache;
+	return *cache;
+}
+
+// loaded is empty. Take previous if it has slots, then a magazine from the depot, and only
+// then carve new slots.
+void pool_storage::Reload(thread_cache_t& cache) {
+	FoldLiveCount(cache);
+	if (cache.previous->count > 0) {
+		std::swap(cache.loaded, cache.previous);
+		return;
+	}
+	if (auto* filled = DepotPop(filled_magazines)) {
+		DepotPush(empty_magazines, cache.previous);
+		cache.previous	= cache.loaded;
+		cache.loaded	= filled;
+		return;
+	}
+	Carve(*cache.loaded);
+}
+
+// loaded is full. Take previous if it's empty, otherwise previous goes to the depot.
+void pool_storage::Unload(thread_cache_t& cache) {
+	FoldLiveCount(cache);
+	if (cache.previous->count == 0) {
+		std::swap(cache.loaded, cache.previous);
+		return;
+	}
+	DepotPush(filled_magazines, cache.previous);
+	cache.previous = cache.loaded;
+
+	auto* empty = DepotPop(empty_magazines);
+	cache.loaded = (empty != nullptr) ? empty : NewMagazine();
+}
+
+void pool_storage::Carve(magazine_t& magazine) {
+	std::lock_guard<std::mutex> guard(lock);
+	if (chunk_cursor == chunk_size) {
+		// untracked, global new would charge the chunk to the calling thread's tag as well
+		PushBack(chunks, static_cast<char*>(UntrackedAllocate(chunk_size * slot_size, slot_alignment)));
+		TrackMemory(tag, chunk_size * slot_size);
+		chunk_cursor = 0;
+	}
+
+	const size_t count = std::min(POOL_MAGAZINE_SIZE - magazine.count, chunk_size - chunk_cursor);
+	char* chunk = chunks.back();
+	for (size_t i = 0; i < count; ++i) {
+		auto* slot = reinterpret_cast<free_slot_t*>(chunk + (chunk_cursor + i) * slot_size);
+		slot->next = magazine.slots;
+		magazine.slots = slot;
+	}
+	magazine.count += count;
+	chunk_cursor += count;
+}
+
+pool_storage::magazine_t* pool_storage::NewMagazine() {
+	auto* magazine = new (UntrackedAllocate(sizeof(magazine_t), alignof(magazine_t))) magazine_t();
+	TrackMemory(tag, sizeof(magazine_t));
+	std::lock_guard<std::mutex> guard(lock);
+	PushBack(magazines, magazine);
+	return magazine;
+}
+
+void pool_storage::FoldLiveCount(thread_cache_t& cache) {
+	const auto delta = cache.live_delta.exchange(0, std::memory_order_relaxed);
+	const auto live_now = live.fetch_add(delta, std::memory_order_relaxed) + delta;
+	auto peak = peak_live.load(std::memory_order_relaxed);
+	while (live_now > peak && !peak_live.compare_exchange_weak(peak, live_now, std::memory_order_relaxed)) {}
+}
+
+#pragma endregion
+
+#pragma region Virtual Arena
+
+static size_t RoundUpToPage(const size_t size) {
+	const size_t page = PageSize();
+	return (size + page - 1) / page * page;
+}
+
+virtual_arena::virtual_arena(const size_t reserve_size, const size_t watermark, const memory_tag_t tag)
+	: base(nullptr)
+	, reserved(RoundUpToPage(std::max<size_t>(reserve_size, 1)))
+	, committed(0)
+	, watermark(RoundUpToPage(watermark))
+	, peak_committed(0)
+	, tag(tag) {
+	base = static_cast<char*>(ReserveAddressSpace(reserved));
+	if (base == nullptr) {
+		reserved = 0;
+	}
+}
+
+virtual_arena::~virtual_arena() {
+	TrackMemory(tag, -static_cast<int64_t>(committed));
+	ReleaseAddressSpace(base, reserved);
+}
+
+bool virtual_arena::Grow(const size_t size) {
+	if (size > reserved) return false;
+
+	const size_t new_committed = std::min(reserved, RoundUpToPage(std::max(size, committed + VIRTUAL_ARENA_COMMIT_SIZE)));
+	if (!CommitPages(base + committed, new_committed - committed)) {
+		return false;
+	}
+	TrackMemory(tag, new_committed - committed);
+	committed = new_committed;
+	peak_committed = std::max(peak_committed, committed);
+	return true;
+}
+
+void virtual_arena::Decommit() {
+	if (committed <= watermark) return;
+	DecommitPages(base + watermark, committed - watermark);
+	TrackMemory(tag, -static_cast<int64_t>(committed - watermark));
+	committed = watermark;
+}
+
+#pragma endregion
+
+#pragma region Stack Allocator
+
+stack_allocator&	ScratchStack() {
+	static thread_local stack_allocator stack(SCRATCH_STACK_SIZE, DEFAULT_ARENA_WATERMARK, memory_tag_t::SCRATCH);
+	return stack;
+}
+
+#pragma endregion
+
+} // namespace pn
@@ -1,79 +1,181 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
-#include <type_traits>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Utilities/MemoryTracking.h>
 
 namespace pn {
 
-template<typename T>
-class pool_allocator {
-	struct alignas(sizeof(T)) free_memory_node {
-		free_memory_node* next;
-	};
-	free_memory_node*	head;
-	free_memory_node*	memory;
-	size_t				N;
+// ----- POOL ALLOCATOR ---------
 
-	T* Allocate() {
-		if (!HasFree()) return nullptr;
-		T* new_object = (T*) head;
-		head = head->next;
-		return new_object;
-	}
+constexpr size_t DEFAULT_POOL_CHUNK_SIZE	= 256;	// slots per chunk
+constexpr size_t POOL_MAGAZINE_SIZE			= 32;	// free slots per magazine
 
+struct pool_stats_t {
+	size_t	live;			// handed out and not released yet
+	size_t	peak_live;		// high-water mark of live
+	size_t	capacity;		// slots in all chunks, live or free
+	size_t	chunks;
+};
+
+// Untyped slots of a single size. Each thread allocates from and releases to its own two
+// magazines, small stacks of free slots, so the common case touches no shared state. Full and
+// empty magazines are swapped through a lock-free depot, which is also how slots released on
+// one thread get back to the others. Only adding a chunk takes a lock. Chunks are never given
+// back before the pool is destroyed.
+class pool_storage {
 public:
-	pool_allocator(size_t N) {
-		memory = new free_memory_node[N];
-		head = memory;
-		free_memory_node* current = head;
-		for (int i = 0; i < N - 1; ++i) {
-			current->next = current + 1;
-			current = current->next;
-		}
-		current->next = nullptr;
-	}
-	
-	~pool_allocator() {
-		delete memory;
-	}
+	struct magazine_t;
+	struct thread_cache_t;
 
-	bool HasFree() const {
-		return head != nullptr;
-	}
+	pool_storage(const size_t slot_size, const size_t slot_alignment, const size_t chunk_size,
+		const memory_tag_t tag = memory_tag_t::GENERAL);
+	~pool_storage();
+
+	pool_storage(const pool_storage&)				= delete;
+	pool_storage(pool_storage&&)					= delete;
+	pool_storage& operator=(const pool_storage&)	= delete;
+	pool_storage& operator=(pool_storage&&)			= delete;
+
+	void*			Allocate();
+	void			Release(void* slot);
+
+	// True if slot lies in one of the chunks. Locks, meant for asserts.
+	bool			Owns(const void* slot) const;
+
+	// live and peak_live count a thread's latest allocations once it next refills or returns
+	// a magazine, so while threads are busy they can be off by a magazine per thread
+	pool_stats_t	GetStats() const;
+
+	// Called at thread exit, returns the thread's magazines to the depot
+	void			ReturnThreadCache(thread_cache_t& cache);
+
+private:
+	thread_cache_t&	GetThreadCache();
+	thread_cache_t&	AddThreadCache();
+	void			Reload(thread_cache_t& cache);
+	void			Unload(thread_cache_t& cache);
+	void			Carve(magazine_t& magazine);
+	magazine_t*		NewMagazine();
+	void			FoldLiveCount(thread_cache_t& cache);
+
+	const size_t						slot_size;
+	const size_t						slot_alignment;
+	const size_t						chunk_size;
+	const size_t						id;			// index into each thread's caches
+	const memory_tag_t					tag;		// charged for whole chunks and magazines
+
+	// ---- depot, tagged magazine pointers
+	std::atomic<uint64_t>				filled_magazines{ 0 };
+	std::atomic<uint64_t>				empty_magazines{ 0 };
+
+	// ---- stats
+	std::atomic<int64_t>				live{ 0 };
+	mutable std::atomic<int64_t>		peak_live{ 0 };	// GetStats raises it too
+
+	// ---- growth, guarded by lock
+	mutable std::mutex					lock;
+	std::vector<char*>					chunks;
+	size_t								chunk_cursor;	// next uncarved slot of the last chunk
+	std::vector<magazine_t*>				magazines;
+	std::vector<std::shared_ptr<thread_cache_t>>	thread_caches;
+};
+
+// Object pool that grows a chunk at a time and never runs out. Objects can be released on any
+// thread, not just the one that created them.
+template<typename T>
+class pool_allocator {
+	pool_storage storage;
+
+public:
+	explicit pool_allocator(const size_t chunk_size = DEFAULT_POOL_CHUNK_SIZE, const memory_tag_t tag = memory_tag_t::GENERAL)
+		: storage(sizeof(T), alignof(T), chunk_size, tag) {}
 
 	template<typename... Args>
 	T* Create(Args&&... args) {
-		T* new_object_address = Allocate();
-		if (new_object_address == nullptr) return nullptr;
-		return new (new_object_address) T(std::forward<Args>(args)...);
+		return new (storage.Allocate()) T(std::forward<Args>(args)...);
 	}
 
 	void Release(T* obj) {
 		assert(obj != nullptr);
-		free_memory_node* new_head = (free_memory_node*) obj;
-		assert(0 <= (new_head - memory) && (new_head - memory) < N);
-		assert(((char*) new_head - (char*) memory) % sizeof(T) == 0);
-
+		assert(storage.Owns(obj));
 		obj->~T();
-		new_head->next = head;
-		head = new_head;
+		storage.Release(obj);
+	}
+
+	pool_stats_t GetStats() const {
+		return storage.GetStats();
+	}
+};
+
+// ----- VIRTUAL ARENA ---------
+
+constexpr size_t VIRTUAL_ARENA_COMMIT_SIZE	= 64 * 1024;	// commits grow by at least this much
+constexpr size_t DEFAULT_ARENA_WATERMARK	= 1024 * 1024;
+
+// A range of address space reserved up front and committed a page at a time as it's used, so
+// the size can be the worst case without costing memory, and pointers never move. Decommit
+// gives back everything past the watermark. Committed pages are charged to the arena's tag.
+class virtual_arena {
+	char*			base;
+	size_t			reserved;
+	size_t			committed;
+	size_t			watermark;
+	size_t			peak_committed;
+	memory_tag_t	tag;
+
+	bool	Grow(size_t size);
+
+public:
+	explicit virtual_arena(size_t reserve_size, size_t watermark = DEFAULT_ARENA_WATERMARK,
+		memory_tag_t tag = memory_tag_t::GENERAL);
+	~virtual_arena();
+
+	virtual_arena(const virtual_arena&)				= delete;
+	virtual_arena(virtual_arena&&)					= delete;
+	virtual_arena& operator=(const virtual_arena&)	= delete;
+	virtual_arena& operator=(virtual_arena&&)		= delete;
+
+	char*	Base() const { return base; }
+
+	// Makes the first size bytes usable. False past the reservation or when the OS is out of memory.
+	bool	EnsureCommitted(size_t size) {
+		return size <= committed || Grow(size);
 	}
+
+	void	Decommit();
+
+	size_t	Reserved() const		{ return reserved; }
+	size_t	Committed() const		{ return committed; }
+	size_t	PeakCommitted() const	{ return peak_committed; }
 };
 
+// ----- LINEAR ALLOCATOR ---------
+
+// Reserves N bytes and commits them as they're used, Release decommits down to the watermark
 class linear_allocator {
-	char*	memory;
-	char*	offset;
-	size_t	N;
+	virtual_arena	arena;
+	char*			memory;
+	char*			offset;
+	size_t			N;
 
 public:
-	linear_allocator(size_t N) : N(N) {
-		memory = new char[N];
+	explicit linear_allocator(size_t N, size_t watermark = DEFAULT_ARENA_WATERMARK, memory_tag_t tag = memory_tag_t::GENERAL)
+		: arena(N, watermark, tag), N(N) {
+		memory = arena.Base();
 		offset = memory;
 	}
-	~linear_allocator() {
-		delete memory;
-	}
 
 	linear_allocator(const linear_allocator&)				= delete;
 	linear_allocator(linear_allocator&&)					= delete;
@@ -84,27 +186,141 @@ public:
 		return offset < memory + N;
 	}
 
-	bool HasFree(unsigned int space_for) const {
+	bool HasFree(size_t space_for) const {
 		return (offset + space_for) <= (memory + N);
 	}
 
-	void* Allocate(unsigned int n) {
-		assert(HasFree(n));
-		void* allocation = offset;
-		offset += n;
-		return allocation;
+	// Returns nullptr when full. Asserts in debug builds, since a frame that runs out usually
+	// means the allocator is too small.
+	void* Allocate(size_t n, size_t alignment = 1) {
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+		const auto address = reinterpret_cast<uintptr_t>(offset);
+		char* aligned = offset + (((address + alignment - 1) & ~(uintptr_t(alignment) - 1)) - address);
+		if (aligned + n > memory + N || !arena.EnsureCommitted(aligned + n - memory)) {
+			assert(false && "linear_allocator is full");
+			return nullptr;
+		}
+		offset = aligned + n;
+		return aligned;
 	}
 
 	template<typename T, typename... Args>
 	T* Create(Args&&... args) {
-		auto* allocation = Allocate(sizeof(T));
-		return new (allocation) T(std::forward<Args>(args)...);
+		auto* allocation = Allocate(sizeof(T), alignof(T));
+		return (allocation != nullptr) ? new (allocation) T(std::forward<Args>(args)...) : nullptr;
 	}
 
 	void Release() {
 		offset = memory;
+		arena.Decommit();
+	}
+
+	size_t Committed() const {
+		return arena.Committed();
+	}
+};
+
+// ----- STACK ALLOCATOR ---------
+
+constexpr size_t	SCRATCH_STACK_SIZE		= 256 * 1024;
+constexpr uint8_t	STACK_ALLOCATOR_POISON	= 0xDD;
+
+// Linear allocator that frees in LIFO order. Take a marker, allocate temporaries, then free back
+// to the marker, or let a stack_allocator_scope do it. Debug builds fill freed memory with
+// STACK_ALLOCATOR_POISON so reads after the rollback stand out.
+class stack_allocator {
+	virtual_arena	arena;
+	char*			memory;
+	size_t			offset;
+	size_t			peak;
+	size_t			N;
+
+public:
+	using marker_t = size_t;
+
+	explicit stack_allocator(size_t N, size_t watermark = DEFAULT_ARENA_WATERMARK, memory_tag_t tag = memory_tag_t::GENERAL)
+		: arena(N, watermark, tag), offset(0), peak(0), N(N) {
+		memory = arena.Base();
+	}
+
+	stack_allocator(const stack_allocator&)				= delete;
+	stack_allocator(stack_allocator&&)					= delete;
+	stack_allocator& operator=(const stack_allocator&)	= delete;
+	stack_allocator& operator=(stack_allocator&&)		= delete;
+
+	bool HasFree(size_t space_for) const {
+		return offset + space_for <= N;
+	}
+
+	// Returns nullptr when full, asserts in debug builds
+	void* Allocate(size_t n, size_t alignment = alignof(std::max_align_t)) {
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+		const auto address = reinterpret_cast<uintptr_t>(memory);
+		const size_t begin = ((address + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - address;
+		if (begin + n > N || !arena.EnsureCommitted(begin + n)) {
+			assert(false && "stack_allocator is full");
+			return nullptr;
+		}
+		offset = begin + n;
+		peak = (offset > peak) ? offset : peak;
+		return memory + begin;
+	}
+
+	// Uninitialized, freeing to a marker never runs destructors
+	template<typename T>
+	T* AllocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "stack_allocator never runs destructors");
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	template<typename T, typename... Args>
+	T* Create(Args&&... args) {
+		static_assert(std::is_trivially_destructible<T>::value, "stack_allocator never runs destructors");
+		auto* allocation = Allocate(sizeof(T), alignof(T));
+		return (allocation != nullptr) ? new (allocation) T(std::forward<Args>(args)...) : nullptr;
+	}
+
+	marker_t GetMarker() const {
+		return offset;
+	}
+
+	void FreeToMarker(marker_t marker) {
+		assert(marker <= offset && "stack_allocator freed out of order");
+#ifndef NDEBUG
+		memset(memory + marker, STACK_ALLOCATOR_POISON, offset - marker);
+#endif
+		offset = marker;
 	}
 
+	// Also decommits down to the watermark, FreeToMarker never does
+	void Release() {
+		FreeToMarker(0);
+		arena.Decommit();
+	}
+
+	size_t Used() const			{ return offset; }
+	size_t Peak() const			{ return peak; }
+	size_t Capacity() const		{ return N; }
+	size_t Committed() const	{ return arena.Committed(); }
+};
+
+// Frees everything allocated from stack during its lifetime
+class stack_allocator_scope {
+	stack_allocator&			stack;
+	stack_allocator::marker_t	marker;
+
+public:
+	explicit stack_allocator_scope(stack_allocator& stack) : stack(stack), marker(stack.GetMarker()) {}
+	~stack_allocator_scope() {
+		stack.FreeToMarker(marker);
+	}
+
+	stack_allocator_scope(const stack_allocator_scope&)				= delete;
+	stack_allocator_scope& operator=(const stack_allocator_scope&)	= delete;
 };
 
+// The calling thread's stack for short-lived scratch work, SCRATCH_STACK_SIZE bytes. Always use
+// it through a stack_allocator_scope so whatever is called next finds it as it was.
+stack_allocator&	ScratchStack();
+
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include <Utilities/MemoryTracking.h>
+
+#include <IO/FileUtil.h>
+
+#include <Utilities/Logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace pn {
+
+#pragma region Internal
+
+constexpr size_t TAG_COUNT = static_cast<size_t>(memory_tag_t::COUNT);
+
+static const char* TAG_NAMES[TAG_COUNT] = {
+	"general",
+	"frame",
+	"scratch",
+	"resources",
+	"mesh",
+	"rendering",
+	"ui",
+};
+
+// Constant initialized, so global new can use them before any constructor has run
+struct alignas(64) tag_counters_t {
+	std::atomic<int64_t>	current{ 0 };
+	std::atomic<int64_t>	peak{ 0 };
+	std::atomic<int64_t>	live_allocations{ 0 };
+	std::atomic<uint64_t>	total_allocations{ 0 };
+	std::atomic<uint64_t>	frame_allocations{ 0 };
+	std::atomic<uint64_t>	frame_bytes{ 0 };
+	std::atomic<size_t>		budget{ 0 };
+
+	// ---- main loop only
+	uint64_t				last_frame_allocations	= 0;
+	uint64_t				last_frame_bytes		= 0;
+	bool					over_budget				= false;
+};
+
+static tag_counters_t TAGS[TAG_COUNT];
+
+static thread_local memory_tag_t THREAD_TAG = memory_tag_t::GENERAL;
+
+// In front of every TrackedAllocate and UntrackedAllocate block, and of every global new one with
+// TRACK_GLOBAL_HEAP
+struct alignas(alignof(std::max_align_t)) tracked_header_t {
+	size_t			size;
+	size_t			offset;	// from the start of the malloc block to the user memory
+	memory_tag_t	tag;
+};
+
+static bool IsTracked(const memory_tag_t tag) {
+	return tag < memory_tag_t::COUNT;
+}
+
+static void AddBytes(tag_counters_t& counters, const int64_t bytes) {
+	const int64_t current = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	int64_t peak = counters.peak.load(std::memory_order_relaxed);
+	while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+}
+
+static void* AllocateWithHeader(const size_t size, const size_t alignment, const memory_tag_t tag) {
+	// malloc is only max_align_t aligned, over-aligned blocks pad in front of the header
+	const size_t padding = alignment > alignof(std::max_align_t) ? alignment : 0;
+	char* block = static_cast<char*>(std::malloc(size + sizeof(tracked_header_t) + padding));
+	if (block == nullptr) return nullptr;
+
+	size_t offset = sizeof(tracked_header_t);
+	if (padding > 0) {
+		const auto address = reinterpret_cast<uintptr_t>(block) + sizeof(tracked_header_t);
+		offset += ((address + alignment - 1) & ~(uintptr_t(alignment) - 1)) - address;
+	}
+
+	auto* header	= reinterpret_cast<tracked_header_t*>(block + offset) - 1;
+	header->size	= size;
+	header->offset	= offset;
+	header->tag		= tag;
+	TrackAllocation(tag, size);
+	return block + offset;
+}
+
+static void FreeWithHeader(void* memory) {
+	if (memory == nullptr) return;
+	auto* header = static_cast<tracked_header_t*>(memory) - 1;
+	TrackFree(header->tag, header->size);
+	std::free(static_cast<char*>(memory) - header->offset);
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+memory_tag_scope::memory_tag_scope(const memory_tag_t tag) : previous(THREAD_TAG) {
+	THREAD_TAG = tag;
+}
+
+memory_tag_scope::~memory_tag_scope() {
+	THREAD_TAG = previous;
+}
+
+const char*			MemoryTagName(const memory_tag_t tag) {
+	return IsTracked(tag) ? TAG_NAMES[static_cast<size_t>(tag)] : "untracked";
+}
+
+bool				MemoryTagFromName(const std::string& name, memory_tag_t& tag) {
+	for (size_t i = 0; i < TAG_COUNT; ++i) {
+		if (name == TAG_NAMES[i]) {
+			tag = static_cast<memory_tag_t>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+memory_tag_t		CurrentMemoryTag() {
+	return THREAD_TAG;
+}
+
+void				TrackAllocation(const memory_tag_t tag, const size_t bytes) {
+	if (!IsTracked(tag)) return;
+	auto& counters = TAGS[static_cast<size_t>(tag)];
+	AddBytes(counters, static_cast<int64_t>(bytes));
+	counters.live_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.total_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.frame_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void				TrackFree(const memory_tag_t tag, const size_t bytes) {
+	if (!IsTracked(tag)) return;
+	auto& counters = TAGS[static_cast<size_t>(tag)];
+	counters.current.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+	counters.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void				TrackMemory(const memory_tag_t tag, const int64_t bytes) {
+	if (!IsTracked(tag)) return;
+	AddBytes(TAGS[static_cast<size_t>(tag)], bytes);
+}
+
+void*				TrackedAllocate(const size_t size, const memory_tag_t tag) {
+	return AllocateWithHeader(size, alignof(std::max_align_t), tag);
+}
+
+void				TrackedFree(void* memory) {
+	FreeWithHeader(memory);
+}
+
+void*				UntrackedAllocate(const size_t size, const size_t alignment) {
+	return AllocateWithHeader(size, alignment, UNTRACKED_MEMORY);
+}
+
+void				UntrackedFree(void* memory) {
+	FreeWithHeader(memory);
+}
+
+void				SetMemoryBudget(const memory_tag_t tag, const size_t bytes) {
+	if (!IsTracked(tag)) return;
+	TAGS[static_cast<size_t>(tag)].budget.store(bytes, std::memory_order_relaxed);
+}
+
+memory_tag_stats_t	GetMemoryTagStats(const memory_tag_t tag) {
+	memory_tag_stats_t stats;
+	if (!IsTracked(tag)) return stats;
+
+	const auto& counters = TAGS[static_cast<size_t>(tag)];
+	stats.current			= static_cast<size_t>(std::max<int64_t>(counters.current.load(std::memory_order_relaxed), 0));
+	stats.peak				= static_cast<size_t>(counters.peak.load(std::memory_order_relaxed));
+	stats.budget			= counters.budget.load(std::memory_order_relaxed);
+	stats.live_allocations	= static_cast<uint64_t>(std::max<int64_t>(counters.live_allocations.load(std::memory_order_relaxed), 0));
+	stats.total_allocations	= counters.total_allocations.load(std::memory_order_relaxed);
+	stats.frame_allocations	= counters.last_frame_allocations;
+	stats.frame_bytes		= counters.last_frame_bytes;
+	return stats;
+}
+
+void				EndMemoryFrame() {
+	for (size_t i = 0; i < TAG_COUNT; ++i) {
+		auto& counters = TAGS[i];
+		counters.last_frame_allocations	= counters.frame_allocations.exchange(0, std::memory_order_relaxed);
+		counters.last_frame_bytes		= counters.frame_bytes.exchange(0, std::memory_order_relaxed);
+
+		const size_t budget		= counters.budget.load(std::memory_order_relaxed);
+		const int64_t current	= counters.current.load(std::memory_order_relaxed);
+		const bool over			= budget > 0 && current > static_cast<int64_t>(budget);
+		if (over && !counters.over_budget) {
+			LogError("Memory tag '{}' is over its budget: {} of {} bytes", TAG_NAMES[i], current, budget);
+		}
+		counters.over_budget = over;
+	}
+}
+
+std::string			MemoryReportJson() {
+	std::string json = "{\n\t\"tags\": [\n";
+	for (size_t i = 0; i < TAG_COUNT; ++i) {
+		const auto stats = GetMemoryTagStats(static_cast<memory_tag_t>(i));
+		json += fmt::format("\t\t{{ \"name\": \"{}\", \"current\": {}, \"peak\": {}, \"budget\": {}, \"live_allocations\": {}, "
+			"\"total_allocations\": {}, \"frame_allocations\": {}, \"frame_bytes\": {} }}{}\n",
+			TAG_NAMES[i], stats.current, stats.peak, stats.budget, stats.live_allocations,
+			stats.total_allocations, stats.frame_allocations, stats.frame_bytes, (i + 1 < TAG_COUNT) ? "," : "");
+	}
+	json += "\t]\n}\n";
+	return json;
+}
+
+bool				WriteMemoryReport(const std::string& path) {
+	const auto json = MemoryReportJson();
+	if (!WriteFile(path, json.data(), json.size())) {
+		LogError("Couldn't write memory report to {}", path);
+		return false;
+	}
+	LogInfo("Memory report written to {}", path);
+	return true;
+}
+
+void				LogMemoryReport() {
+	for (size_t i = 0; i < TAG_COUNT; ++i) {
+		const auto stats = GetMemoryTagStats(static_cast<memory_tag_t>(i));
+		LogInfo("Memory '{}': {} bytes, peak {}, {} live allocations, {} last frame",
+			TAG_NAMES[i], stats.current, stats.peak, stats.live_allocations, stats.frame_allocations);
+	}
+}
+
+#pragma endregion
+
+} // namespace pn
+
+#pragma region Global Heap
+
+#if defined(PN_TRACK_GLOBAL_HEAP)
+
+// Every global new and delete is charged to the calling thread's memory tag. Replacement
+// functions, so this translation unit has to be linked in, which any use of the tracking does.
+
+void* operator new(size_t size) {
+	void* memory = pn::AllocateWithHeader(size, alignof(std::max_align_t), pn::CurrentMemoryTag());
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size) {
+	return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return pn::AllocateWithHeader(size, alignof(std::max_align_t), pn::CurrentMemoryTag());
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return pn::AllocateWithHeader(size, alignof(std::max_align_t), pn::CurrentMemoryTag());
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	void* memory = pn::AllocateWithHeader(size, static_cast<size_t>(alignment), pn::CurrentMemoryTag());
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept								{ pn::FreeWithHeader(memory); }
+void operator delete[](void* memory) noexcept							{ pn::FreeWithHeader(memory); }
+void operator delete(void* memory, size_t) noexcept						{ pn::FreeWithHeader(memory); }
+void operator delete[](void* memory, size_t) noexcept					{ pn::FreeWithHeader(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept		{ pn::FreeWithHeader(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept	{ pn::FreeWithHeader(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept			{ pn::FreeWithHeader(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept			{ pn::FreeWithHeader(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept	{ pn::FreeWithHeader(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept	{ pn::FreeWithHeader(memory); }
+
+#endif
+
+#pragma endregion
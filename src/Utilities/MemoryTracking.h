@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pn {
+
+// ----- TYPEDEFS ----------
+
+// Who memory is charged to. The engine allocators take a tag when they're made, global new and
+// delete use the calling thread's memory_tag_scope when built with TRACK_GLOBAL_HEAP.
+enum class memory_tag_t : uint8_t {
+	GENERAL,
+	FRAME,
+	SCRATCH,
+	RESOURCES,
+	MESH,
+	RENDERING,
+	UI,
+	COUNT
+};
+
+// For memory another allocator already accounts for, e.g. the arena under a heap
+constexpr memory_tag_t UNTRACKED_MEMORY = memory_tag_t::COUNT;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+struct memory_tag_stats_t {
+	size_t		current				= 0;	// bytes
+	size_t		peak				= 0;
+	size_t		budget				= 0;	// 0 for none
+	uint64_t	live_allocations	= 0;
+	uint64_t	total_allocations	= 0;
+	uint64_t	frame_allocations	= 0;	// last frame
+	uint64_t	frame_bytes			= 0;	// allocated last frame
+};
+
+// Charges the calling thread's allocations to tag while it's alive, scopes nest
+class memory_tag_scope {
+	memory_tag_t	previous;
+
+public:
+	explicit memory_tag_scope(const memory_tag_t tag);
+	~memory_tag_scope();
+
+	memory_tag_scope(const memory_tag_scope&)				= delete;
+	memory_tag_scope& operator=(const memory_tag_scope&)	= delete;
+};
+
+// -------- FUNCTIONS ------------
+
+const char*			MemoryTagName(const memory_tag_t tag);
+bool				MemoryTagFromName(const std::string& name, memory_tag_t& tag);
+
+memory_tag_t		CurrentMemoryTag();
+
+// One allocation of bytes, counted in the frame's churn
+void				TrackAllocation(const memory_tag_t tag, const size_t bytes);
+void				TrackFree(const memory_tag_t tag, const size_t bytes);
+
+// Bytes reserved in bulk, like the pages an arena commits. Not counted as allocations.
+void				TrackMemory(const memory_tag_t tag, const int64_t bytes);
+
+// malloc and free that charge the tag, for C-style code such as ImGui and the console
+void*				TrackedAllocate(const size_t size, const memory_tag_t tag);
+void				TrackedFree(void* memory);
+
+// Heap memory nothing charges, not even global new with TRACK_GLOBAL_HEAP. For allocators that
+// charge their tag for it themselves, like the chunks of a pool.
+void*				UntrackedAllocate(const size_t size, const size_t alignment);
+void				UntrackedFree(void* memory);
+
+// Logs once each time a tag goes over, checked at the end of every frame
+void				SetMemoryBudget(const memory_tag_t tag, const size_t bytes);
+
+memory_tag_stats_t	GetMemoryTagStats(const memory_tag_t tag);
+
+// Closes the frame's allocation counts and checks budgets. Called by the main loop.
+void				EndMemoryFrame();
+
+std::string			MemoryReportJson();
+bool				WriteMemoryReport(const std::string& path);
+void				LogMemoryReport();
+
+} // namespace pn
@@ -1,38 +1,321 @@
+#include <Utilities/Profile.h>
 
-#include <time.h>
+#include <Utilities/Logging.h>
+#include <Utilities/ProfileCapture.h>
 
-#include <Utilities\Logging.h>
-#include <Utilities\Profile.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
 
-#include <chrono>
-
-// There are other clocks, but this is usually the one you want.
-// It corresponds to CLOCK_MONOTONIC at the syscall level.
 using Clock = std::chrono::steady_clock;
-using std::chrono::time_point;
-using std::chrono::duration_cast;
-using std::chrono::milliseconds;
-using namespace std::literals::chrono_literals;
 
 namespace pn {
 
-struct profile_data {
-	string				name;
-	time_point<Clock>	start_time;
+#pragma region Internal
+
+constexpr uint64_t	RING_MASK			= PROFILE_RING_SIZE - 1;
+constexpr size_t	THREAD_NAME_SIZE	= 32;
+
+static_assert((PROFILE_RING_SIZE & RING_MASK) == 0, "The profile ring size has to be a power of two");
+
+// A single producer, single consumer ring. The owning thread writes events at head, the main
+// loop reads them up to head and moves tail.
+struct profile_thread_t {
+	alignas(64) std::atomic<uint64_t>	head{ 0 };
+	uint32_t							depth = 0;			// owner only
+	alignas(64) std::atomic<uint64_t>	tail{ 0 };
+	std::atomic<uint64_t>				dropped{ 0 };
+	std::atomic<bool>					in_use{ false };	// a thread exiting hands its ring to the next new one
+	char								name[THREAD_NAME_SIZE] = {};
+	profile_event_t						events[PROFILE_RING_SIZE];
+};
+
+// Frees the ring's slot when the thread exits, the events left in it are still drained
+struct profile_thread_handle_t {
+	profile_thread_t*	thread = nullptr;
+	bool				registered = false;
+
+	~profile_thread_handle_t() {
+		if (thread != nullptr) thread->in_use.store(false, std::memory_order_release);
+	}
+};
+
+struct clock_base_t {
+	uint64_t			ticks;
+	Clock::time_point	time;
 };
 
-pn::vector<profile_data> profiling_stack{};
+static std::atomic<profile_thread_t*>	THREADS[PROFILE_MAX_THREADS];
+static std::atomic<uint32_t>			THREAD_COUNT{ 0 };
+static std::mutex						REGISTRY_LOCK;
+static std::atomic<bool>				ENABLED{ true };
+
+static thread_local profile_thread_handle_t THREAD;
+
+static const clock_base_t				CLOCK_BASE{ ProfileTimestamp(), Clock::now() };
+static std::atomic<double>				NS_PER_TICK{ 0.0 };
+
+// ---- main loop only
+static profile_frame_t					FRAME;
+static uint64_t							FRAME_INDEX = 0;
+static uint64_t							FRAME_BEGIN = CLOCK_BASE.ticks;
+
+static double MeasureNanosecondsPerTick(const Clock::time_point now, const uint64_t ticks) {
+	const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - CLOCK_BASE.time).count());
+	return ns / static_cast<double>(ticks - CLOCK_BASE.ticks);
+}
+
+static double CalibrateClock() {
+#if defined(PN_PROFILE_RDTSC)
+	// At least a millisecond of baseline, usually long past by the first conversion
+	Clock::time_point now = Clock::now();
+	while (now - CLOCK_BASE.time < std::chrono::milliseconds(1)) {
+		std::this_thread::yield();
+		now = Clock::now();
+	}
+	const double ns_per_tick = MeasureNanosecondsPerTick(now, ProfileTimestamp());
+#else
+	const double ns_per_tick = 1.0;
+#endif
+	NS_PER_TICK.store(ns_per_tick, std::memory_order_relaxed);
+	return ns_per_tick;
+}
+
+static profile_thread_t* RegisterThread() {
+	std::lock_guard<std::mutex> lock(REGISTRY_LOCK);
+	THREAD.registered = true;
+
+	const uint32_t count = THREAD_COUNT.load(std::memory_order_relaxed);
+	uint32_t index = 0;
+	for (; index < count; ++index) {
+		bool in_use = false;
+		if (THREADS[index].load(std::memory_order_relaxed)->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) break;
+	}
+
+	if (index == count) {
+		if (count == PROFILE_MAX_THREADS) {
+			LogError("Profiler is out of thread slots, this thread won't be profiled");
+			return nullptr;
+		}
+		auto* thread = new profile_thread_t;
+		thread->in_use.store(true, std::memory_order_relaxed);
+		THREADS[index].store(thread, std::memory_order_release);
+		THREAD_COUNT.store(count + 1, std::memory_order_release);
+	}
+
+	auto* thread = THREADS[index].load(std::memory_order_relaxed);
+	thread->depth = 0;
+	std::snprintf(thread->name, THREAD_NAME_SIZE, "thread %u", index);
+	THREAD.thread = thread;
+	return thread;
+}
+
+static profile_thread_t* CurrentThread() {
+	if (THREAD.thread != nullptr || THREAD.registered) return THREAD.thread;
+	return RegisterThread();
+}
+
+static uint32_t AddNode(const profile_location_t* location, const uint32_t thread, const uint32_t parent, const uint32_t previous) {
+	auto& nodes = FRAME.nodes;
+	const auto index = static_cast<uint32_t>(Size(nodes));
+	profile_node_t node;
+	node.location	= location;
+	node.thread		= thread;
+	node.parent		= parent;
+	PushBack(nodes, node);
+
+	// children stay in the order they first ran
+	if (previous != NO_PROFILE_NODE)	nodes[previous].next_sibling = index;
+	else if (parent != NO_PROFILE_NODE)	nodes[parent].first_child = index;
+	return index;
+}
+
+static uint32_t FindOrAddChild(const uint32_t parent, const profile_location_t* location) {
+	const auto& nodes = FRAME.nodes;
+	uint32_t last = NO_PROFILE_NODE;
+	for (uint32_t child = nodes[parent].first_child; child != NO_PROFILE_NODE; child = nodes[child].next_sibling) {
+		if (nodes[child].location == location) return child;
+		last = child;
+	}
+	return AddNode(location, nodes[parent].thread, parent, last);
+}
+
+// Events come in the order their scopes closed. In the order they opened, an event's parent is
+// the last one seen at the depth above it.
+static void BuildThreadTree(const uint32_t thread, const size_t first_event) {
+	auto& events = FRAME.events;
+	std::sort(events.begin() + first_event, events.end(), [](const profile_event_t& a, const profile_event_t& b) {
+		return (a.begin != b.begin) ? a.begin < b.begin : a.depth < b.depth;
+	});
+
+	const uint32_t root = AddNode(nullptr, thread, NO_PROFILE_NODE, NO_PROFILE_NODE);
+	uint32_t stack[PROFILE_MAX_DEPTH];
+	uint32_t stack_size = 0;
+	for (size_t i = first_event; i < Size(events); ++i) {
+		const auto& event = events[i];
+		// the parents of scopes that outlived the last frame were drained back then
+		const uint32_t depth	= std::min(event.depth, stack_size);
+		const uint32_t parent	= (depth == 0) ? root : stack[depth - 1];
+		const uint32_t node		= FindOrAddChild(parent, event.location);
+
+		auto& data = FRAME.nodes[node];
+		data.calls		+= 1;
+		data.total_ns	+= static_cast<uint64_t>(ProfileTicksToNanoseconds(event.end - event.begin));
+
+		if (depth < PROFILE_MAX_DEPTH) {
+			stack[depth]	= node;
+			stack_size		= depth + 1;
+		}
+	}
+}
+
+// Children totals are known once every event is in, the self time is what's left
+static void FinishNodes() {
+	auto& nodes = FRAME.nodes;
+	for (auto& node : nodes) {
+		uint64_t children = 0;
+		for (uint32_t child = node.first_child; child != NO_PROFILE_NODE; child = nodes[child].next_sibling) {
+			children += nodes[child].total_ns;
+		}
+		if (node.location == nullptr) {
+			node.total_ns = children;
+		}
+		node.self_ns = (node.total_ns > children) ? node.total_ns - children : 0;
+	}
+}
 
-void StartProfile(const string& name) {
-	profile_data data = { name, Clock::now() };
-	pn::PushBack(profiling_stack, data);
+static void LogNode(const uint32_t index, const int indent) {
+	const auto& nodes	= FRAME.nodes;
+	const auto& node	= nodes[index];
+	if (node.location == nullptr) {
+		LogInfo("[ PROFILE ] {}", ProfileThreadName(node.thread));
+	}
+	else {
+		LogInfo("[ PROFILE ] {}{} took {:.3f} ms ({} calls, {:.3f} ms self)", string(indent * 2, ' '), node.location->name,
+			node.total_ns / 1e6, node.calls, node.self_ns / 1e6);
+	}
+	for (uint32_t child = node.first_child; child != NO_PROFILE_NODE; child = nodes[child].next_sibling) {
+		LogNode(child, indent + 1);
+	}
 }
-void EndProfile() {
-	time_point<Clock> now	= Clock::now();
-	auto	current_profile	= pn::Pop(profiling_stack);
-	auto	diff			= duration_cast<milliseconds>(now - current_profile.start_time);
-	auto	ms				= diff.count();
-	Log("[ PROFILE ] {} took {} ms", current_profile.name, ms);
+
+#pragma endregion
+
+#pragma region Functions
+
+double					ProfileTicksToNanoseconds(const uint64_t ticks) {
+	double ns_per_tick = NS_PER_TICK.load(std::memory_order_relaxed);
+	if (ns_per_tick == 0.0) ns_per_tick = CalibrateClock();
+	return static_cast<double>(ticks) * ns_per_tick;
+}
+
+double					ProfileTicksToMilliseconds(const uint64_t ticks) {
+	return ProfileTicksToNanoseconds(ticks) / 1e6;
+}
+
+void					SetProfilerEnabled(const bool enabled) {
+	ENABLED.store(enabled, std::memory_order_relaxed);
+}
+
+bool					IsProfilerEnabled() {
+	return ENABLED.load(std::memory_order_relaxed);
+}
+
+void					SetProfileThreadName(const char* name) {
+	auto* thread = CurrentThread();
+	if (thread == nullptr) return;
+	std::lock_guard<std::mutex> lock(REGISTRY_LOCK);
+	std::snprintf(thread->name, THREAD_NAME_SIZE, "%s", name);
+}
+
+const char*				ProfileThreadName(const uint32_t thread) {
+	if (thread >= THREAD_COUNT.load(std::memory_order_acquire)) return "";
+	return THREADS[thread].load(std::memory_order_relaxed)->name;
+}
+
+uint32_t				ProfileThreadCount() {
+	return THREAD_COUNT.load(std::memory_order_acquire);
 }
 
-} // namespace pn
\ No newline at end of file
+bool					BeginProfileScope() {
+	if (!ENABLED.load(std::memory_order_relaxed)) return false;
+	auto* thread = CurrentThread();
+	if (thread == nullptr) return false;
+	++thread->depth;
+	return true;
+}
+
+void					EndProfileScope(const profile_location_t* location, const uint64_t begin, const uint64_t end) {
+	auto* thread = THREAD.thread;
+	const uint32_t depth = --thread->depth;
+
+	const uint64_t head = thread->head.load(std::memory_order_relaxed);
+	if (head - thread->tail.load(std::memory_order_acquire) >= PROFILE_RING_SIZE) {
+		thread->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	thread->events[head & RING_MASK] = { location, begin, end, depth, 0 };
+	thread->head.store(head + 1, std::memory_order_release);
+}
+
+void					EndProfileFrame() {
+	const uint64_t now = ProfileTimestamp();
+#if defined(PN_PROFILE_RDTSC)
+	// a longer baseline is a more precise one, a tenth of a second is plenty to start with
+	const auto time = Clock::now();
+	if (time - CLOCK_BASE.time > std::chrono::milliseconds(100)) {
+		NS_PER_TICK.store(MeasureNanosecondsPerTick(time, now), std::memory_order_relaxed);
+	}
+#endif
+
+	FRAME.index				= FRAME_INDEX++;
+	FRAME.begin				= FRAME_BEGIN;
+	FRAME.end				= now;
+	FRAME.event_count		= 0;
+	FRAME.dropped_events	= 0;
+	FRAME.nodes.clear();
+	FRAME.events.clear();
+	FRAME_BEGIN = now;
+
+	const uint32_t count = THREAD_COUNT.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < count; ++i) {
+		auto& thread = *THREADS[i].load(std::memory_order_relaxed);
+		const uint64_t head = thread.head.load(std::memory_order_acquire);
+		const uint64_t tail = thread.tail.load(std::memory_order_relaxed);
+
+		const size_t first_event = Size(FRAME.events);
+		for (uint64_t event = tail; event != head; ++event) {
+			PushBack(FRAME.events, thread.events[event & RING_MASK]);
+			FRAME.events.back().thread = i;
+		}
+		thread.tail.store(head, std::memory_order_release);
+
+		FRAME.event_count		+= head - tail;
+		FRAME.dropped_events	+= thread.dropped.exchange(0, std::memory_order_relaxed);
+		if (head != tail) {
+			BuildThreadTree(i, first_event);
+		}
+	}
+	FinishNodes();
+	CaptureProfileFrame(FRAME);
+}
+
+const profile_frame_t&	GetProfileFrame() {
+	return FRAME;
+}
+
+void					LogProfileFrame() {
+	const auto& nodes = FRAME.nodes;
+	for (uint32_t i = 0; i < Size(nodes); ++i) {
+		if (nodes[i].parent == NO_PROFILE_NODE) LogNode(i, 0);
+	}
+	if (FRAME.dropped_events > 0) {
+		LogInfo("[ PROFILE ] {} events dropped, the rings were full", FRAME.dropped_events);
+	}
+}
+
+#pragma endregion
+
+} // namespace pn
@@ -1,11 +1,147 @@
 #pragma once
 
+// Hierarchical CPU profiler. PN_PROFILE_SCOPE("name") times the rest of the enclosing block:
+// two timestamps and one event written to the calling thread's ring, no locks and no allocation.
+// The main loop drains every thread's ring in EndProfileFrame and folds the events into an
+// aggregate tree per thread, readable with GetProfileFrame until the next frame ends.
+//
+// Build with PROFILING=OFF (PN_NO_PROFILE) to compile the scopes out altogether.
 
-#include <Utilities\UtilityTypes.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <chrono>
+#include <cstdint>
+
+#if !defined(PN_NO_PROFILE) && (defined(_M_X64) || defined(__x86_64__))
+#define PN_PROFILE_RDTSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
 
 namespace pn {
 
-void StartProfile(const string& name);
-void EndProfile();
+// ----- CONSTANTS ---------
+
+// Events a thread can hold between two EndProfileFrame calls, more are dropped and counted
+constexpr size_t	PROFILE_RING_SIZE		= 1 << 14;
+constexpr uint32_t	PROFILE_MAX_DEPTH		= 64;
+constexpr uint32_t	PROFILE_MAX_THREADS		= 64;
+constexpr uint32_t	NO_PROFILE_NODE			= UINT32_MAX;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Where a scope is, one static record per PN_PROFILE_SCOPE
+struct profile_location_t {
+	const char*	name;
+	const char*	file;
+	const char*	function;
+	uint32_t	line;
+};
+
+// One closed scope, in timestamp ticks. The thread is filled in when the frame drains it.
+struct profile_event_t {
+	const profile_location_t*	location;
+	uint64_t					begin;
+	uint64_t					end;
+	uint32_t					depth;
+	uint32_t					thread;
+};
+
+// Every call of a location under the same parent in one frame. The roots are one per thread,
+// with no location.
+struct profile_node_t {
+	const profile_location_t*	location		= nullptr;
+	uint32_t					thread			= 0;
+	uint32_t					parent			= NO_PROFILE_NODE;
+	uint32_t					first_child		= NO_PROFILE_NODE;
+	uint32_t					next_sibling	= NO_PROFILE_NODE;
+	uint32_t					calls			= 0;
+	uint64_t					total_ns		= 0;
+	uint64_t					self_ns			= 0;
+};
 
+struct profile_frame_t {
+	uint64_t				index			= 0;
+	uint64_t				begin			= 0;	// ticks
+	uint64_t				end				= 0;
+	uint64_t				event_count		= 0;
+	uint64_t				dropped_events	= 0;
+	vector<profile_node_t>	nodes;
+	vector<profile_event_t>	events;	// by thread, then in the order they opened
+};
+
+// -------- FUNCTIONS ------------
+
+// rdtsc on x64, steady_clock nanoseconds elsewhere
+inline uint64_t			ProfileTimestamp() {
+#if defined(PN_PROFILE_RDTSC)
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
 }
+
+// Calibrated against steady_clock, and refined every frame as the baseline gets longer
+double					ProfileTicksToNanoseconds(const uint64_t ticks);
+double					ProfileTicksToMilliseconds(const uint64_t ticks);
+
+// Scopes opened while disabled record nothing, scopes already open still close
+void					SetProfilerEnabled(const bool enabled);
+bool					IsProfilerEnabled();
+
+// Shown for the calling thread's root node, threads are "thread <n>" until named
+void					SetProfileThreadName(const char* name);
+const char*				ProfileThreadName(const uint32_t thread);
+uint32_t				ProfileThreadCount();
+
+// What PN_PROFILE_SCOPE expands to. BeginProfileScope returns false if nothing is recorded.
+bool					BeginProfileScope();
+void					EndProfileScope(const profile_location_t* location, const uint64_t begin, const uint64_t end);
+
+// Drains the thread rings into the frame's tree. Called by the main loop at the end of every frame.
+// Scopes still open at that point are counted in the frame they close in.
+void					EndProfileFrame();
+
+// The last frame EndProfileFrame closed
+const profile_frame_t&	GetProfileFrame();
+
+// The frame's tree with milliseconds, the way StartProfile/EndProfile used to print it
+void					LogProfileFrame();
+
+// A value over time, e.g. bytes in use. Only kept while a capture is running, see
+// Utilities/ProfileCapture.h. The name and series have to outlive the capture.
+void					ProfileCounter(const char* name, const double value, const char* series = "value");
+
+// ----------- CLASS DEFINITION -------------
+
+class profile_scope {
+	const profile_location_t*	location;
+	uint64_t					begin;
+
+public:
+	explicit profile_scope(const profile_location_t* location) : location(BeginProfileScope() ? location : nullptr), begin(ProfileTimestamp()) {}
+	~profile_scope() {
+		if (location != nullptr) EndProfileScope(location, begin, ProfileTimestamp());
+	}
+
+	profile_scope(const profile_scope&)				= delete;
+	profile_scope& operator=(const profile_scope&)	= delete;
+};
+
+} // namespace pn
+
+#define PN_PROFILE_CONCAT_IMPL(a, b) a##b
+#define PN_PROFILE_CONCAT(a, b) PN_PROFILE_CONCAT_IMPL(a, b)
+
+#if !defined(PN_NO_PROFILE)
+#define PN_PROFILE_SCOPE(name)																						\
+	static const pn::profile_location_t PN_PROFILE_CONCAT(pn_profile_location_, __LINE__) = { name, __FILE__, __func__, __LINE__ };	\
+	pn::profile_scope PN_PROFILE_CONCAT(pn_profile_scope_, __LINE__)(&PN_PROFILE_CONCAT(pn_profile_location_, __LINE__))
+#else
+#define PN_PROFILE_SCOPE(name) do {} while (false)
+#endif
+
+#define PN_PROFILE_FUNCTION() PN_PROFILE_SCOPE(__func__)
@@ -0,0 +1,224 @@
+#include <Utilities/ProfileCapture.h>
+
+#include <IO/FileUtil.h>
+
+#include <Utilities/Logging.h>
+#include <Utilities/MemoryTracking.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace pn {
+
+#pragma region Internal
+
+// Every thread's scopes share the one process in the trace, the frame markers get a track of their own
+constexpr int		TRACE_PID			= 1;
+constexpr uint32_t	FRAME_MARKER_TID	= PROFILE_MAX_THREADS;
+
+struct capture_frame_t {
+	uint64_t	index;
+	uint64_t	begin;
+	uint64_t	end;
+};
+
+struct capture_counter_t {
+	const char*	name;
+	const char*	series;
+	uint64_t	time;
+	double		value;
+};
+
+enum class capture_state_t {
+	IDLE,
+	STARTING,	// waiting for the current frame to end
+	RUNNING
+};
+
+struct profile_capture_t {
+	std::atomic<capture_state_t>	state{ capture_state_t::IDLE };
+	uint32_t						frames_left	= 0;
+	std::string						path;
+	uint64_t						begin		= 0;
+	vector<profile_event_t>			events;
+	vector<capture_frame_t>			frames;
+
+	std::mutex						counter_lock;
+	vector<capture_counter_t>		counters;
+};
+
+static profile_capture_t CAPTURE;
+
+// Trace times are microseconds from the start of the capture. Scopes open when it started
+// come out negative, which both viewers take.
+static double TraceTime(const uint64_t ticks) {
+	const auto offset = static_cast<int64_t>(ticks - CAPTURE.begin);
+	const double ns = (offset < 0) ? -ProfileTicksToNanoseconds(static_cast<uint64_t>(-offset)) : ProfileTicksToNanoseconds(static_cast<uint64_t>(offset));
+	return ns / 1000.0;
+}
+
+static void WriteJsonString(fmt::MemoryWriter& out, const char* text) {
+	out << '"';
+	for (const char* c = text; *c != '\0'; ++c) {
+		switch (*c) {
+		case '"':	out << "\\\"";	break;
+		case '\\':	out << "\\\\";	break;
+		case '\n':	out << "\\n";	break;
+		case '\t':	out << "\\t";	break;
+		default:
+			if (static_cast<unsigned char>(*c) < 0x20)	out.write("\\u{:04x}", static_cast<unsigned>(*c));
+			else										out << *c;
+		}
+	}
+	out << '"';
+}
+
+static void WriteMetadata(fmt::MemoryWriter& out, const char* name, const uint32_t tid, const char* value) {
+	out.write("{{\"name\":\"{}\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":", name, TRACE_PID, tid);
+	WriteJsonString(out, value);
+	out << "}},\n";
+}
+
+static void WriteScope(fmt::MemoryWriter& out, const profile_event_t& event) {
+	out << "{\"name\":";
+	WriteJsonString(out, event.location->name);
+	out.write(",\"cat\":\"scope\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{},\"args\":{{\"file\":",
+		TraceTime(event.begin), ProfileTicksToNanoseconds(event.end - event.begin) / 1000.0, TRACE_PID, event.thread);
+	WriteJsonString(out, event.location->file);
+	out.write(",\"line\":{}}}}},\n", event.location->line);
+}
+
+static void WriteFrame(fmt::MemoryWriter& out, const capture_frame_t& frame) {
+	out.write("{{\"name\":\"Frame {}\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}}},\n",
+		frame.index, TraceTime(frame.begin), ProfileTicksToNanoseconds(frame.end - frame.begin) / 1000.0, TRACE_PID, FRAME_MARKER_TID);
+}
+
+// Counters recorded together under one name are one event, one series each
+static size_t WriteCounter(fmt::MemoryWriter& out, const vector<capture_counter_t>& counters, size_t i) {
+	const auto& first = counters[i];
+	out << "{\"name\":";
+	WriteJsonString(out, first.name);
+	out.write(",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":{},\"args\":{{", TraceTime(first.time), TRACE_PID);
+	for (size_t series = i; i < Size(counters) && counters[i].name == first.name && counters[i].time == first.time; ++i) {
+		if (i != series) out << ',';
+		WriteJsonString(out, counters[i].series);
+		out.write(":{}", std::isfinite(counters[i].value) ? counters[i].value : 0.0);
+	}
+	out << "}},\n";
+	return i;
+}
+
+static void ClearCapture() {
+	vector<profile_event_t>().swap(CAPTURE.events);
+	vector<capture_frame_t>().swap(CAPTURE.frames);
+	std::lock_guard<std::mutex> lock(CAPTURE.counter_lock);
+	vector<capture_counter_t>().swap(CAPTURE.counters);
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+bool		StartProfileCapture(const uint32_t frame_count, const std::string& path) {
+	if (frame_count == 0) {
+		LogError("A profile capture needs at least one frame");
+		return false;
+	}
+	if (IsProfileCaptureRunning()) {
+		LogError("A profile capture is already running, writing to {}", CAPTURE.path);
+		return false;
+	}
+
+	ClearCapture();
+	CAPTURE.frames_left	= frame_count;
+	CAPTURE.path		= path;
+	CAPTURE.state.store(capture_state_t::STARTING, std::memory_order_release);
+	LogInfo("Capturing the next {} frames to {}", frame_count, path);
+	return true;
+}
+
+bool		IsProfileCaptureRunning() {
+	return CAPTURE.state.load(std::memory_order_acquire) != capture_state_t::IDLE;
+}
+
+bool		FinishProfileCapture() {
+	if (!IsProfileCaptureRunning()) return false;
+	CAPTURE.state.store(capture_state_t::IDLE, std::memory_order_release);
+
+	const auto json = ProfileCaptureJson();
+	const bool written = WriteFile(CAPTURE.path, json.data(), json.size());
+	if (written) {
+		LogInfo("Profile capture of {} frames written to {}", Size(CAPTURE.frames), CAPTURE.path);
+	}
+	ClearCapture();
+	return written;
+}
+
+void		CaptureProfileFrame(const profile_frame_t& frame) {
+	switch (CAPTURE.state.load(std::memory_order_acquire)) {
+	case capture_state_t::IDLE:
+		return;
+	case capture_state_t::STARTING:
+		// whole frames only, the capture starts where this one ended
+		CAPTURE.begin = frame.end;
+		CAPTURE.state.store(capture_state_t::RUNNING, std::memory_order_release);
+		return;
+	case capture_state_t::RUNNING:
+		break;
+	}
+
+	CAPTURE.events.insert(CAPTURE.events.end(), frame.events.begin(), frame.events.end());
+	PushBack(CAPTURE.frames, capture_frame_t{ frame.index, frame.begin, frame.end });
+
+	ProfileCounter("Profile events", static_cast<double>(frame.event_count), "recorded");
+	ProfileCounter("Profile events", static_cast<double>(frame.dropped_events), "dropped");
+	for (size_t i = 0; i < static_cast<size_t>(memory_tag_t::COUNT); ++i) {
+		const auto tag = static_cast<memory_tag_t>(i);
+		ProfileCounter("Memory (KB)", GetMemoryTagStats(tag).current / 1024.0, MemoryTagName(tag));
+	}
+
+	if (--CAPTURE.frames_left == 0) {
+		FinishProfileCapture();
+	}
+}
+
+void		ProfileCounter(const char* name, const double value, const char* series) {
+	if (CAPTURE.state.load(std::memory_order_acquire) != capture_state_t::RUNNING) return;
+	const uint64_t now = ProfileTimestamp();
+	std::lock_guard<std::mutex> lock(CAPTURE.counter_lock);
+	PushBack(CAPTURE.counters, capture_counter_t{ name, series, now, value });
+}
+
+std::string	ProfileCaptureJson() {
+	fmt::MemoryWriter out;
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	WriteMetadata(out, "process_name", 0, "Partition");
+	WriteMetadata(out, "thread_name", FRAME_MARKER_TID, "Frames");
+	for (uint32_t thread = 0; thread < ProfileThreadCount(); ++thread) {
+		WriteMetadata(out, "thread_name", thread, ProfileThreadName(thread));
+	}
+
+	for (const auto& frame : CAPTURE.frames) {
+		WriteFrame(out, frame);
+	}
+	for (const auto& event : CAPTURE.events) {
+		WriteScope(out, event);
+	}
+	{
+		std::lock_guard<std::mutex> lock(CAPTURE.counter_lock);
+		for (size_t i = 0; i < Size(CAPTURE.counters);) {
+			i = WriteCounter(out, CAPTURE.counters, i);
+		}
+	}
+
+	// the trailing comma after the last event isn't valid JSON, a last metadata event takes it
+	out.write("{{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"sort_index\":0}}}}\n]}}\n", TRACE_PID);
+	return out.str();
+}
+
+#pragma endregion
+
+} // namespace pn
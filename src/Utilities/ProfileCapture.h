@@ -0,0 +1,37 @@
+#pragma once
+
+// Records whole frames of profiler output, scopes on every thread along with frame markers and
+// counters, and writes them as Chrome trace event JSON. The file opens as is in
+// chrome://tracing and ui.perfetto.dev.
+//
+// Start one with StartProfileCapture, the "profile_capture" command, or
+// "profile_capture": { "frames": 300, "path": "profile_capture.json" } in partition.json.
+
+#include <Utilities/Profile.h>
+
+#include <string>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr uint32_t	DEFAULT_PROFILE_CAPTURE_FRAMES	= 120;
+constexpr char		DEFAULT_PROFILE_CAPTURE_PATH[]	= "profile_capture.json";
+
+// -------- FUNCTIONS ------------
+
+// Captures the frame_count frames after the current one, then writes the trace to path
+bool		StartProfileCapture(const uint32_t frame_count, const std::string& path);
+bool		IsProfileCaptureRunning();
+
+// Writes the frames captured so far and stops, e.g. when the program exits mid capture.
+// Returns false if there was no capture or the file couldn't be written.
+bool		FinishProfileCapture();
+
+// Adds a frame to the running capture. Called by EndProfileFrame.
+void		CaptureProfileFrame(const profile_frame_t& frame);
+
+// The trace of the frames captured so far
+std::string	ProfileCaptureJson();
+
+} // namespace pn
@@ -0,0 +1,34 @@
+#pragma once
+
+// Compile-time selection of the vector instruction set used by the math kernels.
+// The build sets PN_SIMD_AVX2 / PN_SIMD_SSE41 (see SIMD_ARCH in CMakeLists.txt), otherwise
+// it's picked from the compiler's target flags. Define PN_NO_SIMD to force the scalar path.
+
+#if !defined(PN_NO_SIMD)
+
+#if !defined(PN_SIMD_AVX2) && defined(__AVX2__)
+#define PN_SIMD_AVX2
+#endif
+
+#if !defined(PN_SIMD_SSE41) && (defined(PN_SIMD_AVX2) || defined(__AVX__) || defined(__SSE4_1__))
+#define PN_SIMD_SSE41
+#endif
+
+#else
+
+#undef PN_SIMD_AVX2
+#undef PN_SIMD_SSE41
+
+#endif
+
+#if defined(PN_SIMD_AVX2) || (defined(PN_SIMD_SSE41) && defined(__FMA__))
+#include <immintrin.h>
+#elif defined(PN_SIMD_SSE41)
+#include <smmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#define PN_FORCEINLINE __forceinline
+#else
+#define PN_FORCEINLINE inline __attribute__((always_inline))
+#endif
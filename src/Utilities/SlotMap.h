@@ -0,0 +1,142 @@
+#pragma once
+
+#include <Utilities/UtilityTypes.h>
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace pn {
+
+// ----- TYPEDEFS ----------
+
+// Low 32 bits are the slot index, high 32 bits its generation. A live generation is always odd,
+// so a handle of 0 is never valid and can be used as a null value.
+using slot_handle_t = uint64_t;
+
+constexpr slot_handle_t NULL_SLOT_HANDLE = 0;
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// Values are packed densely so iteration is a plain array walk. Handles stay valid until their
+// value is removed, after which the slot's generation is bumped and the old handle is rejected
+// instead of aliasing whatever reuses the slot. Pointers and references into the map are only
+// good until the next insert or remove.
+template<typename T>
+struct slot_map_t {
+	// ---- dense, in no particular order
+	pn::vector<T>			values;
+	pn::vector<uint32_t>	value_slots;	// slot owning values[i]
+
+	// ---- per slot
+	pn::vector<uint32_t>	slot_values;	// index into values, only meaningful while the slot is live
+	pn::vector<uint32_t>	generations;	// odd while the slot is live
+	pn::vector<uint32_t>	free_slots;
+};
+
+// -------- FUNCTIONS ------------
+
+inline uint32_t			SlotIndex(const slot_handle_t handle) {
+	return static_cast<uint32_t>(handle);
+}
+
+inline uint32_t			SlotGeneration(const slot_handle_t handle) {
+	return static_cast<uint32_t>(handle >> 32);
+}
+
+inline slot_handle_t	MakeSlotHandle(const uint32_t index, const uint32_t generation) {
+	return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+template<typename T>
+bool					IsValid(const slot_map_t<T>& m, const slot_handle_t handle) {
+	const uint32_t index = SlotIndex(handle);
+	return index < Size(m.generations) && m.generations[index] == SlotGeneration(handle) && (m.generations[index] & 1) != 0;
+}
+
+template<typename T>
+size_t					Size(const slot_map_t<T>& m) {
+	return Size(m.values);
+}
+
+template<typename T>
+slot_handle_t			Insert(slot_map_t<T>& m, T value) {
+	uint32_t index;
+	if (!m.free_slots.empty()) {
+		index = Pop(m.free_slots);
+	} else {
+		index = static_cast<uint32_t>(Size(m.generations));
+		PushBack(m.generations, uint32_t(0));
+		PushBack(m.slot_values, uint32_t(0));
+	}
+
+	// even -> odd marks the slot live. Live generations are never 0, even after wrapping.
+	++m.generations[index];
+	m.slot_values[index] = static_cast<uint32_t>(Size(m.values));
+	PushBack(m.values, std::move(value));
+	PushBack(m.value_slots, index);
+	return MakeSlotHandle(index, m.generations[index]);
+}
+
+// Returns false if the handle is stale
+template<typename T>
+bool					Remove(slot_map_t<T>& m, const slot_handle_t handle) {
+	if (!IsValid(m, handle)) return false;
+
+	const uint32_t index = SlotIndex(handle);
+	const uint32_t value_index = m.slot_values[index];
+	const uint32_t last = static_cast<uint32_t>(Size(m.values)) - 1;
+	if (value_index != last) {
+		m.values[value_index] = std::move(m.values[last]);
+		m.value_slots[value_index] = m.value_slots[last];
+		m.slot_values[m.value_slots[value_index]] = value_index;
+	}
+	m.values.pop_back();
+	m.value_slots.pop_back();
+
+	++m.generations[index];
+	PushBack(m.free_slots, index);
+	return true;
+}
+
+// nullptr if the handle is stale
+template<typename T>
+T*						Find(slot_map_t<T>& m, const slot_handle_t handle) {
+	return IsValid(m, handle) ? &m.values[m.slot_values[SlotIndex(handle)]] : nullptr;
+}
+
+template<typename T>
+const T*				Find(const slot_map_t<T>& m, const slot_handle_t handle) {
+	return IsValid(m, handle) ? &m.values[m.slot_values[SlotIndex(handle)]] : nullptr;
+}
+
+template<typename T>
+T&						Get(slot_map_t<T>& m, const slot_handle_t handle) {
+	assert(IsValid(m, handle));
+	return m.values[m.slot_values[SlotIndex(handle)]];
+}
+
+template<typename T>
+const T&				Get(const slot_map_t<T>& m, const slot_handle_t handle) {
+	assert(IsValid(m, handle));
+	return m.values[m.slot_values[SlotIndex(handle)]];
+}
+
+// Handle of the value at a dense index, for walking values alongside their handles
+template<typename T>
+slot_handle_t			HandleAt(const slot_map_t<T>& m, const size_t value_index) {
+	const uint32_t index = m.value_slots[value_index];
+	return MakeSlotHandle(index, m.generations[index]);
+}
+
+template<typename T>
+void					Clear(slot_map_t<T>& m) {
+	for (const auto index : m.value_slots) {
+		++m.generations[index];
+		PushBack(m.free_slots, index);
+	}
+	Clear(m.values);
+	Clear(m.value_slots);
+}
+
+} // namespace pn
@@ -0,0 +1,53 @@
+#include <Utilities/SmallVector.h>
+
+#include <Utilities/Logging.h>
+
+#include <atomic>
+
+namespace pn {
+
+#pragma region Internal
+
+static std::atomic<uint64_t> SMALL_VECTORS{ 0 };
+static std::atomic<uint64_t> SMALL_VECTOR_SPILLS{ 0 };
+static std::atomic<uint64_t> FIXED_VECTOR_OVERFLOWS{ 0 };
+
+#pragma endregion
+
+#pragma region Functions
+
+small_vector_stats_t	GetSmallVectorStats() {
+	small_vector_stats_t stats;
+	stats.small_vectors				= SMALL_VECTORS.load(std::memory_order_relaxed);
+	stats.small_vector_spills		= SMALL_VECTOR_SPILLS.load(std::memory_order_relaxed);
+	stats.fixed_vector_overflows	= FIXED_VECTOR_OVERFLOWS.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void					ResetSmallVectorStats() {
+	SMALL_VECTORS.store(0, std::memory_order_relaxed);
+	SMALL_VECTOR_SPILLS.store(0, std::memory_order_relaxed);
+	FIXED_VECTOR_OVERFLOWS.store(0, std::memory_order_relaxed);
+}
+
+void					LogSmallVectorStats() {
+#if defined(PN_CONTAINER_STATS)
+	const auto stats = GetSmallVectorStats();
+	const double rate = (stats.small_vectors > 0) ? 100.0 * stats.small_vector_spills / stats.small_vectors : 0.0;
+	LogInfo("Small vectors: {} of {} spilled to the heap ({:.1f}%), {} fixed_vector overflows",
+		stats.small_vector_spills, stats.small_vectors, rate, stats.fixed_vector_overflows);
+#endif
+}
+
+void					CountSmallVector(const bool spilled) {
+	SMALL_VECTORS.fetch_add(1, std::memory_order_relaxed);
+	if (spilled) SMALL_VECTOR_SPILLS.fetch_add(1, std::memory_order_relaxed);
+}
+
+void					CountFixedVectorOverflow() {
+	FIXED_VECTOR_OVERFLOWS.fetch_add(1, std::memory_order_relaxed);
+}
+
+#pragma endregion
+
+} // namespace pn
@@ -0,0 +1,592 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Debug builds count how often small vectors outgrow their inline storage, so N can be tuned.
+// Define PN_CONTAINER_STATS to count in release builds too.
+#if !defined(NDEBUG) && !defined(PN_CONTAINER_STATS)
+#define PN_CONTAINER_STATS
+#endif
+
+namespace pn {
+
+// ---------- STRUCT DEFINITIONS -------------
+
+struct small_vector_stats_t {
+	uint64_t	small_vectors			= 0;	// small_vector lifetimes that held any elements
+	uint64_t	small_vector_spills		= 0;	// of those, the ones that ended up on the heap
+	uint64_t	fixed_vector_overflows	= 0;	// elements dropped by a full fixed_vector
+};
+
+// -------- FUNCTIONS ------------
+
+// All zero without PN_CONTAINER_STATS
+small_vector_stats_t	GetSmallVectorStats();
+void					ResetSmallVectorStats();
+void					LogSmallVectorStats();
+
+void					CountSmallVector(const bool spilled);
+void					CountFixedVectorOverflow();
+
+// ----------- CLASS DEFINITION -------------
+
+// A vector whose first N elements live inside it, so short lists don't touch the heap. Past N
+// the elements move to memory from Alloc, and stay there until the vector is destroyed.
+// Moving a vector that's still inline moves its elements one by one.
+template<typename T, size_t N, typename Alloc = std::allocator<T>>
+class small_vector {
+	static_assert(N > 0, "use pn::vector without inline storage");
+
+	using traits_t = std::allocator_traits<Alloc>;
+
+public:
+	using value_type		= T;
+	using size_type			= size_t;
+	using difference_type	= ptrdiff_t;
+	using reference			= T&;
+	using const_reference	= const T&;
+	using pointer			= T*;
+	using const_pointer		= const T*;
+	using iterator			= T*;
+	using const_iterator	= const T*;
+	using allocator_type	= Alloc;
+
+	static constexpr size_t INLINE_CAPACITY = N;
+
+private:
+	T*		ptr;
+	size_t	length;
+	size_t	capacity_;
+	Alloc	allocator;
+	alignas(T) unsigned char inline_storage[N * sizeof(T)];
+
+	T* InlineData() { return reinterpret_cast<T*>(inline_storage); }
+
+	size_t NextCapacity(const size_t n) const {
+		return std::max(n, capacity_ * 2);
+	}
+
+	// Elements move over after the new storage is in place, so an argument that refers into
+	// the vector stays valid while the new element is built from it
+	template<typename... Args>
+	T& GrowAndEmplaceBack(Args&&... args) {
+		const size_t new_capacity = NextCapacity(length + 1);
+		T* memory = traits_t::allocate(allocator, new_capacity);
+		new (memory + length) T(std::forward<Args>(args)...);
+		std::uninitialized_move(ptr, ptr + length, memory);
+		Release();
+		ptr = memory;
+		capacity_ = new_capacity;
+		return ptr[length++];
+	}
+
+	// Destroys the elements and frees the heap storage, length is left as it was
+	void Release() {
+		std::destroy(ptr, ptr + length);
+		if (!IsInline()) traits_t::deallocate(allocator, ptr, capacity_);
+	}
+
+	void MoveFrom(small_vector& other) {
+		if (!other.IsInline() && (traits_t::propagate_on_container_move_assignment::value || allocator == other.allocator)) {
+			ptr = other.ptr;
+			capacity_ = other.capacity_;
+			length = other.length;
+		}
+		else {
+			reserve(other.length);
+			std::uninitialized_move(other.ptr, other.ptr + other.length, ptr);
+			length = other.length;
+			std::destroy(other.ptr, other.ptr + other.length);
+			if (!other.IsInline()) traits_t::deallocate(other.allocator, other.ptr, other.capacity_);
+		}
+		other.ptr = other.InlineData();
+		other.capacity_ = N;
+		other.length = 0;
+	}
+
+public:
+	small_vector() : ptr(InlineData()), length(0), capacity_(N) {}
+	explicit small_vector(const Alloc& alloc) : ptr(InlineData()), length(0), capacity_(N), allocator(alloc) {}
+
+	explicit small_vector(const size_t n) : small_vector() {
+		resize(n);
+	}
+	small_vector(const size_t n, const T& value) : small_vector() {
+		resize(n, value);
+	}
+	small_vector(std::initializer_list<T> values) : small_vector() {
+		assign(values.begin(), values.end());
+	}
+	template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+	small_vector(It first, It last) : small_vector() {
+		assign(first, last);
+	}
+
+	small_vector(const small_vector& other)
+		: ptr(InlineData()), length(0), capacity_(N), allocator(traits_t::select_on_container_copy_construction(other.allocator)) {
+		assign(other.begin(), other.end());
+	}
+	small_vector(small_vector&& other) noexcept
+		: ptr(InlineData()), length(0), capacity_(N), allocator(other.allocator) {
+		MoveFrom(other);
+	}
+
+	~small_vector() {
+#if defined(PN_CONTAINER_STATS)
+		if (length > 0 || !IsInline()) CountSmallVector(!IsInline());
+#endif
+		Release();
+	}
+
+	small_vector& operator=(const small_vector& other) {
+		if (this != &other) assign(other.begin(), other.end());
+		return *this;
+	}
+	small_vector& operator=(small_vector&& other) noexcept {
+		if (this != &other) {
+			Release();
+			ptr = InlineData();
+			capacity_ = N;
+			length = 0;
+			if constexpr (traits_t::propagate_on_container_move_assignment::value) {
+				allocator = other.allocator;
+			}
+			MoveFrom(other);
+		}
+		return *this;
+	}
+	small_vector& operator=(std::initializer_list<T> values) {
+		assign(values.begin(), values.end());
+		return *this;
+	}
+
+	template<typename It>
+	void assign(It first, It last) {
+		clear();
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>) {
+			reserve(static_cast<size_t>(std::distance(first, last)));
+		}
+		for (; first != last; ++first) {
+			emplace_back(*first);
+		}
+	}
+
+	// ---- access
+
+	T*			data()				{ return ptr; }
+	const T*	data() const		{ return ptr; }
+	size_t		size() const		{ return length; }
+	size_t		capacity() const	{ return capacity_; }
+	bool		empty() const		{ return length == 0; }
+	bool		IsInline() const	{ return ptr == reinterpret_cast<const T*>(inline_storage); }
+	Alloc		get_allocator() const	{ return allocator; }
+
+	T*			begin()				{ return ptr; }
+	T*			end()				{ return ptr + length; }
+	const T*	begin() const		{ return ptr; }
+	const T*	end() const			{ return ptr + length; }
+	const T*	cbegin() const		{ return ptr; }
+	const T*	cend() const		{ return ptr + length; }
+
+	T& operator[](const size_t i) {
+		assert(i < length);
+		return ptr[i];
+	}
+	const T& operator[](const size_t i) const {
+		assert(i < length);
+		return ptr[i];
+	}
+
+	T&			front()				{ assert(length > 0); return ptr[0]; }
+	const T&	front() const		{ assert(length > 0); return ptr[0]; }
+	T&			back()				{ assert(length > 0); return ptr[length - 1]; }
+	const T&	back() const		{ assert(length > 0); return ptr[length - 1]; }
+
+	// ---- size
+
+	void reserve(const size_t n) {
+		if (n <= capacity_) return;
+		T* memory = traits_t::allocate(allocator, n);
+		std::uninitialized_move(ptr, ptr + length, memory);
+		Release();
+		ptr = memory;
+		capacity_ = n;
+	}
+
+	void resize(const size_t n) {
+		if (n > length) {
+			if (n > capacity_) {
+				reserve(NextCapacity(n));
+			}
+			std::uninitialized_value_construct(ptr + length, ptr + n);
+		}
+		else {
+			std::destroy(ptr + n, ptr + length);
+		}
+		length = n;
+	}
+	void resize(const size_t n, const T& value) {
+		if (n > length) {
+			if (n > capacity_) {
+				const T copy = value;	// value may be an element
+				reserve(NextCapacity(n));
+				std::uninitialized_fill(ptr + length, ptr + n, copy);
+			}
+			else {
+				std::uninitialized_fill(ptr + length, ptr + n, value);
+			}
+		}
+		else {
+			std::destroy(ptr + n, ptr + length);
+		}
+		length = n;
+	}
+
+	// Keeps the storage
+	void clear() {
+		std::destroy(ptr, ptr + length);
+		length = 0;
+	}
+
+	// ---- modifiers
+
+	template<typename... Args>
+	T& emplace_back(Args&&... args) {
+		if (length == capacity_) return GrowAndEmplaceBack(std::forward<Args>(args)...);
+		new (ptr + length) T(std::forward<Args>(args)...);
+		return ptr[length++];
+	}
+
+	void push_back(const T& value)	{ emplace_back(value); }
+	void push_back(T&& value)		{ emplace_back(std::move(value)); }
+
+	void pop_back() {
+		assert(length > 0);
+		std::destroy_at(ptr + --length);
+	}
+
+	T* insert(const T* position, T value) {
+		const size_t index = static_cast<size_t>(position - ptr);
+		assert(index <= length);
+		emplace_back(std::move(value));
+		std::rotate(ptr + index, ptr + length - 1, ptr + length);
+		return ptr + index;
+	}
+
+	T* erase(const T* first, const T* last) {
+		T* const begin_erase = ptr + (first - ptr);
+		T* const end_erase = ptr + (last - ptr);
+		assert(begin_erase <= end_erase && end_erase <= ptr + length);
+		T* const new_end = std::move(end_erase, ptr + length, begin_erase);
+		std::destroy(new_end, ptr + length);
+		length = static_cast<size_t>(new_end - ptr);
+		return begin_erase;
+	}
+	T* erase(const T* position) {
+		return erase(position, position + 1);
+	}
+
+	bool operator==(const small_vector& rhs) const {
+		return std::equal(begin(), end(), rhs.begin(), rhs.end());
+	}
+	bool operator!=(const small_vector& rhs) const {
+		return !operator==(rhs);
+	}
+};
+
+// A vector that never allocates: up to N elements live inside it. Adding to a full one asserts
+// and, in release builds, drops the element.
+template<typename T, size_t N>
+class fixed_vector {
+	static_assert(N > 0, "fixed_vector needs room for an element");
+
+public:
+	using value_type		= T;
+	using size_type			= size_t;
+	using difference_type	= ptrdiff_t;
+	using reference			= T&;
+	using const_reference	= const T&;
+	using pointer			= T*;
+	using const_pointer		= const T*;
+	using iterator			= T*;
+	using const_iterator	= const T*;
+
+	static constexpr size_t CAPACITY = N;
+
+private:
+	size_t	length;
+	alignas(T) unsigned char storage[N * sizeof(T)];
+
+	bool Overflows(const size_t n) {
+		if (n <= N) return false;
+#if defined(PN_CONTAINER_STATS)
+		CountFixedVectorOverflow();
+#endif
+		assert(false && "fixed_vector is full");
+		return true;
+	}
+
+public:
+	fixed_vector() : length(0) {}
+	explicit fixed_vector(const size_t n) : length(0) {
+		resize(n);
+	}
+	fixed_vector(const size_t n, const T& value) : length(0) {
+		resize(n, value);
+	}
+	fixed_vector(std::initializer_list<T> values) : length(0) {
+		for (const auto& value : values) push_back(value);
+	}
+
+	fixed_vector(const fixed_vector& other) : length(0) {
+		std::uninitialized_copy(other.begin(), other.end(), data());
+		length = other.length;
+	}
+	fixed_vector(fixed_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : length(0) {
+		std::uninitialized_move(other.begin(), other.end(), data());
+		length = other.length;
+		other.clear();
+	}
+
+	~fixed_vector() {
+		clear();
+	}
+
+	fixed_vector& operator=(const fixed_vector& other) {
+		if (this != &other) {
+			clear();
+			std::uninitialized_copy(other.begin(), other.end(), data());
+			length = other.length;
+		}
+		return *this;
+	}
+	fixed_vector& operator=(fixed_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+		if (this != &other) {
+			clear();
+			std::uninitialized_move(other.begin(), other.end(), data());
+			length = other.length;
+			other.clear();
+		}
+		return *this;
+	}
+
+	// ---- access
+
+	T*			data()				{ return reinterpret_cast<T*>(storage); }
+	const T*	data() const		{ return reinterpret_cast<const T*>(storage); }
+	size_t		size() const		{ return length; }
+	size_t		capacity() const	{ return N; }
+	bool		empty() const		{ return length == 0; }
+	bool		full() const		{ return length == N; }
+
+	T*			begin()				{ return data(); }
+	T*			end()				{ return data() + length; }
+	const T*	begin() const		{ return data(); }
+	const T*	end() const			{ return data() + length; }
+	const T*	cbegin() const		{ return data(); }
+	const T*	cend() const		{ return data() + length; }
+
+	T& operator[](const size_t i) {
+		assert(i < length);
+		return data()[i];
+	}
+	const T& operator[](const size_t i) const {
+		assert(i < length);
+		return data()[i];
+	}
+
+	T&			front()				{ assert(length > 0); return data()[0]; }
+	const T&	front() const		{ assert(length > 0); return data()[0]; }
+	T&			back()				{ assert(length > 0); return data()[length - 1]; }
+	const T&	back() const		{ assert(length > 0); return data()[length - 1]; }
+
+	// ---- size
+
+	// Only checks, there's nothing to reserve
+	void reserve(const size_t n) {
+		Overflows(n);
+	}
+
+	void resize(const size_t n) {
+		const size_t target = Overflows(n) ? N : n;
+		if (target > length)	std::uninitialized_value_construct(data() + length, data() + target);
+		else					std::destroy(data() + target, data() + length);
+		length = target;
+	}
+	void resize(const size_t n, const T& value) {
+		const size_t target = Overflows(n) ? N : n;
+		if (target > length)	std::uninitialized_fill(data() + length, data() + target, value);
+		else					std::destroy(data() + target, data() + length);
+		length = target;
+	}
+
+	void clear() {
+		std::destroy(data(), data() + length);
+		length = 0;
+	}
+
+	// ---- modifiers
+
+	// nullptr when full
+	template<typename... Args>
+	T* emplace_back(Args&&... args) {
+		if (Overflows(length + 1)) return nullptr;
+		T* element = new (data() + length) T(std::forward<Args>(args)...);
+		++length;
+		return element;
+	}
+
+	void push_back(const T& value)	{ emplace_back(value); }
+	void push_back(T&& value)		{ emplace_back(std::move(value)); }
+
+	void pop_back() {
+		assert(length > 0);
+		std::destroy_at(data() + --length);
+	}
+
+	T* insert(const T* position, T value) {
+		const size_t index = static_cast<size_t>(position - data());
+		assert(index <= length);
+		if (emplace_back(std::move(value)) == nullptr) return end();
+		std::rotate(data() + index, data() + length - 1, data() + length);
+		return data() + index;
+	}
+
+	T* erase(const T* first, const T* last) {
+		T* const begin_erase = data() + (first - data());
+		T* const end_erase = data() + (last - data());
+		assert(begin_erase <= end_erase && end_erase <= end());
+		T* const new_end = std::move(end_erase, end(), begin_erase);
+		std::destroy(new_end, end());
+		length = static_cast<size_t>(new_end - data());
+		return begin_erase;
+	}
+	T* erase(const T* position) {
+		return erase(position, position + 1);
+	}
+
+	bool operator==(const fixed_vector& rhs) const {
+		return std::equal(begin(), end(), rhs.begin(), rhs.end());
+	}
+	bool operator!=(const fixed_vector& rhs) const {
+		return !operator==(rhs);
+	}
+};
+
+// -------- CONTAINER FUNCTIONS ------------
+
+// The vector helpers of UtilityTypes.h, for the inline vectors
+
+template<typename T, size_t N, typename A, typename U>
+void	PushBack(small_vector<T, N, A>& vec, const U& value) {
+	vec.push_back(value);
+}
+
+template<typename T, size_t N, typename A, typename U, typename... Us>
+void	PushBack(small_vector<T, N, A>& vec, const U& value, const Us&... args) {
+	vec.push_back(value);
+	PushBack(vec, args...);
+}
+
+template<typename T, size_t N, typename U>
+void	PushBack(fixed_vector<T, N>& vec, const U& value) {
+	vec.push_back(value);
+}
+
+template<typename T, size_t N, typename U, typename... Us>
+void	PushBack(fixed_vector<T, N>& vec, const U& value, const Us&... args) {
+	vec.push_back(value);
+	PushBack(vec, args...);
+}
+
+template<typename T, size_t N, typename A, typename... Args>
+void	EmplaceBack(small_vector<T, N, A>& vec, Args&&... args) {
+	vec.emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename T, size_t N, typename... Args>
+void	EmplaceBack(fixed_vector<T, N>& vec, Args&&... args) {
+	vec.emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename T, size_t N, typename A>
+T		Pop(small_vector<T, N, A>& vec) {
+	assert(vec.size() > 0);
+	T back = std::move(vec.back());
+	vec.pop_back();
+	return back;
+}
+
+template<typename T, size_t N>
+T		Pop(fixed_vector<T, N>& vec) {
+	assert(vec.size() > 0);
+	T back = std::move(vec.back());
+	vec.pop_back();
+	return back;
+}
+
+template<typename T, size_t N, typename A, typename SizeType>
+void	Reserve(small_vector<T, N, A>& vec, const SizeType s) {
+	vec.reserve(s);
+}
+
+template<typename T, size_t N, typename SizeType>
+void	Reserve(fixed_vector<T, N>& vec, const SizeType s) {
+	vec.reserve(s);
+}
+
+template<typename T, size_t N, typename A, typename SizeType>
+void	Resize(small_vector<T, N, A>& vec, const SizeType s) {
+	vec.resize(s);
+}
+
+template<typename T, size_t N, typename SizeType>
+void	Resize(fixed_vector<T, N>& vec, const SizeType s) {
+	vec.resize(s);
+}
+
+template<typename T, size_t N, typename A>
+T&		Get(small_vector<T, N, A>& v, size_t i) {
+	return v[i];
+}
+
+template<typename T, size_t N, typename A>
+const T& Get(const small_vector<T, N, A>& v, size_t i) {
+	return v[i];
+}
+
+template<typename T, size_t N>
+T&		Get(fixed_vector<T, N>& v, size_t i) {
+	return v[i];
+}
+
+template<typename T, size_t N>
+const T& Get(const fixed_vector<T, N>& v, size_t i) {
+	return v[i];
+}
+
+template<typename T, size_t N, typename A>
+void	Erase(small_vector<T, N, A>& v, const T& el) {
+	auto it = std::find(v.begin(), v.end(), el);
+	if (it != v.end()) {
+		v.erase(it);
+	}
+}
+
+template<typename T, size_t N>
+void	Erase(fixed_vector<T, N>& v, const T& el) {
+	auto it = std::find(v.begin(), v.end(), el);
+	if (it != v.end()) {
+		v.erase(it);
+	}
+}
+
+} // namespace pn
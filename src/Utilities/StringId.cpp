@@ -0,0 +1,65 @@
+#include <Utilities/StringId.h>
+
+#include <Utilities/Logging.h>
+
+#include <cassert>
+#include <shared_mutex>
+
+namespace pn {
+
+#pragma region Internal
+
+static std::shared_mutex& InternLock() {
+	static std::shared_mutex lock;
+	return lock;
+}
+
+static map<uint64_t, string>& InternTable() {
+	static map<uint64_t, string> table;
+	return table;
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+string_id_t				InternString(const string& s) {
+	const string_id_t id(s);
+	auto& table = InternTable();
+	{
+		std::shared_lock<std::shared_mutex> guard(InternLock());
+		const auto it = table.find(id.Hash());
+		if (it != table.end() && it->second == s) {
+			return id;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> guard(InternLock());
+	const auto inserted = table.emplace(id.Hash(), s);
+	if (!inserted.second && inserted.first->second != s) {
+		LogError("String id collision: '{}' and '{}' both hash to {:016x}", inserted.first->second, s, id.Hash());
+		assert(false && "string id collision");
+	}
+	return id;
+}
+
+string					StringIdName(const string_id_t id) {
+	{
+		std::shared_lock<std::shared_mutex> guard(InternLock());
+		const auto& table = InternTable();
+		const auto it = table.find(id.Hash());
+		if (it != table.end()) {
+			return it->second;
+		}
+	}
+	return fmt::format("#{:016x}", id.Hash());
+}
+
+size_t					InternedStringCount() {
+	std::shared_lock<std::shared_mutex> guard(InternLock());
+	return Size(InternTable());
+}
+
+#pragma endregion
+
+} // namespace pn
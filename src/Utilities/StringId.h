@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Utilities/UtilityTypes.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace pn {
+
+// ----- CONSTANTS ---------
+
+constexpr uint64_t STRING_ID_OFFSET_BASIS	= 0xCBF29CE484222325ULL;	// 64-bit FNV-1a
+constexpr uint64_t STRING_ID_PRIME			= 0x100000001B3ULL;
+
+// -------- FUNCTIONS ------------
+
+// FNV-1a, simple enough to run at compile time. Not Hash64, which isn't constexpr.
+constexpr uint64_t	HashStringId(const char* s, const size_t length) {
+	uint64_t hash = STRING_ID_OFFSET_BASIS;
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ static_cast<uint8_t>(s[i])) * STRING_ID_PRIME;
+	}
+	return hash;
+}
+
+constexpr uint64_t	HashStringId(const char* s) {
+	uint64_t hash = STRING_ID_OFFSET_BASIS;
+	for (; *s != '\0'; ++s) {
+		hash = (hash ^ static_cast<uint8_t>(*s)) * STRING_ID_PRIME;
+	}
+	return hash;
+}
+
+// ---------- STRUCT DEFINITIONS -------------
+
+// A name reduced to its 64-bit hash, so comparing names is comparing integers. Literals hash at
+// compile time when used in a constant expression, e.g. constexpr string_id_t ID = "name"_id.
+// Nothing is allocated: the interning table below only remembers the strings behind ids for
+// logging and checks interned names for collisions.
+class string_id_t {
+	uint64_t hash;
+
+public:
+	constexpr string_id_t() : hash(0) {}
+	constexpr string_id_t(const char* s) : hash(HashStringId(s)) {}
+	string_id_t(const string& s) : hash(HashStringId(s.data(), s.size())) {}
+	constexpr explicit string_id_t(const uint64_t hash) : hash(hash) {}
+
+	constexpr uint64_t	Hash() const	{ return hash; }
+	constexpr bool		IsNull() const	{ return hash == 0; }
+
+	constexpr bool operator==(const string_id_t other) const	{ return hash == other.hash; }
+	constexpr bool operator!=(const string_id_t other) const	{ return hash != other.hash; }
+	constexpr bool operator<(const string_id_t other) const		{ return hash < other.hash; }
+};
+
+constexpr string_id_t	operator""_id(const char* s, const size_t length) {
+	return string_id_t(HashStringId(s, length));
+}
+
+// Remembers the string behind the id. Logs and asserts if another interned string has the same
+// hash. Locks, so intern names when they're created, not when they're looked up.
+string_id_t				InternString(const string& s);
+
+// The interned string, or the hash in hex for ids that were never interned
+string					StringIdName(const string_id_t id);
+
+size_t					InternedStringCount();
+
+} // namespace pn
+
+namespace std {
+
+template<>
+struct hash<pn::string_id_t> {
+	size_t operator()(const pn::string_id_t id) const noexcept {
+		return static_cast<size_t>(id.Hash());
+	}
+};
+
+} // namespace std
@@ -3,12 +3,16 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
 #include <sstream>
+#include <type_traits>
 
 #include <string.h>
 
-#include <Utilities\Memory.h>
-#include <Utilities\Logging.h>
+#include <Utilities/FlatMap.h>
+#include <Utilities/Memory.h>
+#include <Utilities/Logging.h>
+#include <Utilities/SmallVector.h>
 
 namespace pn {
 
@@ -17,17 +21,52 @@ namespace pn {
 using string	= std::string;
 using wstring	= std::wstring;
 
-template<typename T>
-using vector	= std::vector<T>;
+// The allocator parameters default to the global heap, see Heap.h for engine heaps
+template<typename T, typename Alloc = std::allocator<T>>
+using vector	= std::vector<T, Alloc>;
 
-template<typename K, typename V>
-using map		= std::unordered_map<K, V>;
+// Open addressing, see FlatMap.h. Inserting can move the other elements.
+template<typename K, typename V, typename Alloc = std::allocator<std::pair<const K, V>>>
+using map		= flat_map<K, V, flat_hash<K>, flat_equal<K>, Alloc>;
 
 using bytes		= vector<char>;
 
+// Command lines and file names split into a handful of pieces
+using split_t	= small_vector<string, 8>;
+
 // ------------ STRUCT/CLASS DEFINITIONS --------
 
+// Non-owning view over contiguous elements, e.g. one stream of a structure-of-arrays
+template<typename T>
+class span {
+	T*		ptr;
+	size_t	count;
+
+public:
+	using value_type = std::remove_const_t<T>;
+
+	span()							noexcept : ptr(nullptr), count(0) {}
+	span(T* ptr, size_t count)		noexcept : ptr(ptr), count(count) {}
+	span(vector<value_type>& v)		noexcept : ptr(v.data()), count(v.size()) {}
+
+	template<typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+	span(const vector<value_type>& v)	noexcept : ptr(v.data()), count(v.size()) {}
+
+	template<typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+	span(const span<value_type>& s)		noexcept : ptr(s.data()), count(s.size()) {}
+
+	T*		data()	const { return ptr; }
+	size_t	size()	const { return count; }
+	bool	empty()	const { return count == 0; }
 
+	T*		begin()	const { return ptr; }
+	T*		end()	const { return ptr + count; }
+
+	T& operator[](size_t i) const {
+		assert(i < count);
+		return ptr[i];
+	}
+};
 
 // ------------ FUNCTIONS -------------
 
@@ -45,12 +84,15 @@ void	Clear(Container& container) {
 
 // ------- STRING FUNCTIONS ----------
 
-inline vector<string>	Split(const string& s, char delim) {
-	std::stringstream ss(s);
-	vector<string> elements;
-	string element;
-	while (std::getline(ss, element, delim)) {
-		elements.emplace_back(element);
+// Like reading s with std::getline, an empty last piece is dropped
+inline split_t			Split(const string& s, char delim) {
+	split_t elements;
+	size_t start = 0;
+	while (start < s.size()) {
+		size_t end = s.find(delim, start);
+		if (end == string::npos) end = s.size();
+		elements.emplace_back(s, start, end - start);
+		start = end + 1;
 	}
 	return elements;
 }
@@ -65,77 +107,78 @@ inline const char*		CString(const string& s) {
 
 // ------- VECTOR FUNCTIONS -----------
 
-template<typename T, typename U>
-void	PushBack(vector<T>& vec, const U& value) {
+template<typename T, typename A, typename U>
+void	PushBack(vector<T, A>& vec, const U& value) {
 	vec.push_back(value);
 }
 
-template<typename T, typename U, typename... Us>
-void	PushBack(vector<T>& vec, const U& value, const Us&... args) {
+template<typename T, typename A, typename U, typename... Us>
+void	PushBack(vector<T, A>& vec, const U& value, const Us&... args) {
 	vec.push_back(value);
 	PushBack(vec, args...);
 }
 
-template<typename T, typename... Args>
-void	EmplaceBack(vector<T>& vec, Args&&... args) {
+template<typename T, typename A, typename... Args>
+void	EmplaceBack(vector<T, A>& vec, Args&&... args) {
 	vec.emplace_back(std::forward<Args>(args)...);
 }
 
-template<typename T>
-T		Pop(vector<T>& vec) {
+template<typename T, typename A>
+T		Pop(vector<T, A>& vec) {
 	assert(Size(vec) > 0);
 	T back = vec.back();
 	vec.pop_back();
 	return back;
 }
 
-template<typename T, typename SizeType>
-void	Reserve(vector<T>& vec, const SizeType s) {
+template<typename T, typename A, typename SizeType>
+void	Reserve(vector<T, A>& vec, const SizeType s) {
 	vec.reserve(s);
 }
 
-template<typename T, typename SizeType>
-void	Resize(vector<T>& vec, const SizeType s) {
+template<typename T, typename A, typename SizeType>
+void	Resize(vector<T, A>& vec, const SizeType s) {
 	vec.resize(s);
 }
 
-template<typename T>
-auto	Get(const vector<T>& v, size_t i) -> decltype(v[i]) {
+template<typename T, typename A>
+auto	Get(const vector<T, A>& v, size_t i) -> decltype(v[i]) {
 	return v[i];
 }
 
-template<typename T>
-auto	Get(vector<T>& v, size_t i) -> decltype(v[i]) {
+template<typename T, typename A>
+auto	Get(vector<T, A>& v, size_t i) -> decltype(v[i]) {
 	return v[i];
 }
 
-template<typename T>
-auto	Erase(vector<T>& v, const T& el) {
-	LogError("Vector erase not implemented yet");
-	assert(false);
+template<typename T, typename A>
+void	Erase(vector<T, A>& v, const T& el) {
+	auto it = std::find(v.begin(), v.end(), el);
+	if (it != v.end()) {
+		v.erase(it);
+	}
 }
 
 // -------- MAP FUNCTIONS ------------
 
-template<typename K, typename V>
-bool	Contains(const map<K,V>& m, const K& key) {
-	return m.find(key) != m.end();
+template<typename K, typename V, typename A>
+bool	Contains(const map<K, V, A>& m, const K& key) {
+	return m.contains(key);
 }
 
-template<typename K, typename V>
-void	Insert(map<K,V>& m, const K key, const V& value) {
+template<typename K, typename V, typename A>
+void	Insert(map<K, V, A>& m, const K key, const V& value) {
 	if (Contains(m, key)) return;
 	m.insert(std::make_pair(key, value));
 }
 
-template<typename K, typename V>
-void	Remove(map<K, V>& m, const K& key) {
-	if (!Contains(m, key)) return;
+template<typename K, typename V, typename A>
+void	Remove(map<K, V, A>& m, const K& key) {
 	m.erase(key);
 }
 
-template<typename K, typename V>
-auto	Get(const map<K,V>& m, const K& key) {
+template<typename K, typename V, typename A>
+auto	Get(const map<K, V, A>& m, const K& key) {
 	return m.at(key);	
 }
 
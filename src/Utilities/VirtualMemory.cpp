@@ -0,0 +1,92 @@
+#include <Utilities/VirtualMemory.h>
+
+#include <Utilities/Logging.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace pn {
+
+#ifdef _WIN32
+
+size_t	PageSize() {
+	static const size_t page_size = [] {
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return static_cast<size_t>(info.dwPageSize);
+	}();
+	return page_size;
+}
+
+void*	ReserveAddressSpace(const size_t size) {
+	void* base = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+	if (base == nullptr) {
+		LogError("Couldn't reserve {} bytes of address space: {}", size, ErrMsg(GetLastError()));
+	}
+	return base;
+}
+
+void	ReleaseAddressSpace(void* base, const size_t size) {
+	if (base != nullptr) {
+		VirtualFree(base, 0, MEM_RELEASE);
+	}
+}
+
+bool	CommitPages(void* address, const size_t size) {
+	if (VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+		LogError("Couldn't commit {} bytes: {}", size, ErrMsg(GetLastError()));
+		return false;
+	}
+	return true;
+}
+
+void	DecommitPages(void* address, const size_t size) {
+	VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+#else
+
+size_t	PageSize() {
+	static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	return page_size;
+}
+
+void*	ReserveAddressSpace(const size_t size) {
+	void* base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (base == MAP_FAILED) {
+		LogError("Couldn't reserve {} bytes of address space: {}", size, strerror(errno));
+		return nullptr;
+	}
+	return base;
+}
+
+void	ReleaseAddressSpace(void* base, const size_t size) {
+	if (base != nullptr) {
+		munmap(base, size);
+	}
+}
+
+bool	CommitPages(void* address, const size_t size) {
+	if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0) {
+		LogError("Couldn't commit {} bytes: {}", size, strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+// MADV_DONTNEED drops the pages right away, the next commit hands out zeroed ones
+void	DecommitPages(void* address, const size_t size) {
+	madvise(address, size, MADV_DONTNEED);
+	mprotect(address, size, PROT_NONE);
+}
+
+#endif
+
+} // namespace pn
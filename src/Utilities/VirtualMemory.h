@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace pn {
+
+// -------- FUNCTIONS ------------
+
+// Thin layer over VirtualAlloc / mmap. Reserved address space costs no memory until a range of
+// it is committed, and decommitted ranges give their pages back to the OS while the addresses
+// stay reserved. Sizes and addresses passed to Commit and Decommit are multiples of PageSize.
+size_t	PageSize();
+
+// Returns nullptr on failure
+void*	ReserveAddressSpace(const size_t size);
+void	ReleaseAddressSpace(void* base, const size_t size);
+
+bool	CommitPages(void* address, const size_t size);
+void	DecommitPages(void* address, const size_t size);
+
+} // namespace pn
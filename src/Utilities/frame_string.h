@@ -1,97 +1,239 @@
 #pragma once
 
-#include <Utilities\Memory.h>
+#include <Utilities/FrameArena.h>
+#include <Utilities/Logging.h>
+#include <Utilities/Memory.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace pn {
 
+// ----- CONSTANTS ---------
+
+constexpr size_t FRAME_STRING_INLINE_SIZE = 32;	// bytes kept in the string itself, terminator included
+
 // ----------- CLASS DEFINITION -------------
 
+// String builder for text that only has to live until the end of the frame, like labels, log
+// lines and UI text. Short strings stay in an inline buffer, longer ones grow geometrically in the
+// frame arenas, or in the linear_allocator given to SetFrameAllocator, and are never freed
+// individually. Appending and Format write in place, and the text is always null terminated.
 template<typename T>
-struct basic_frame_string {
+class basic_frame_string {
+public:
+	static constexpr size_t INLINE_CAPACITY = FRAME_STRING_INLINE_SIZE / sizeof(T) - 1;
+
+	using traits_t	= std::char_traits<T>;
+	using view_t	= std::basic_string_view<T>;
+
+private:
 	static linear_allocator*	frame_alloc;
-	T*							data;
-	size_t						length;
 
-	basic_frame_string() : data(nullptr), length(0) {}
-	basic_frame_string(const basic_frame_string& f) : length(f.length) {
-		data = _allocate(length);
-		memcpy(data, f.data, sizeof(T)*length);
+	T*		ptr;
+	size_t	length;
+	size_t	capacity;	// characters, the terminator not included
+	T		inline_buffer[INLINE_CAPACITY + 1];
+
+	// Lets fmt write straight into the string, growing it as it goes. fmt writes as much as it
+	// asked for, so once the allocator runs out the text goes on in a heap spill buffer and is
+	// cut to fit at the end, like Append does.
+	class format_buffer_t : public fmt::Buffer<T> {
+		basic_frame_string&		target;
+		std::basic_string<T>	spill;
+		bool					spilled = false;
+
+	protected:
+		void grow(std::size_t size) override {
+			if (!spilled) {
+				target.length = this->size_;
+				target.Reserve(size);
+				if (size <= target.capacity) {
+					this->ptr_		= target.ptr;
+					this->capacity_	= target.capacity;
+					return;
+				}
+				spill.assign(target.ptr, this->size_);
+				spilled = true;
+			}
+			spill.resize(std::max(size, spill.size() * 2));
+			this->ptr_		= &spill[0];
+			this->capacity_	= spill.size();
+		}
+
+	public:
+		explicit format_buffer_t(basic_frame_string& target) : fmt::Buffer<T>(target.ptr, target.capacity), target(target) {
+			this->size_ = target.length;
+		}
+
+		// Length of the text in the string
+		size_t Finish() {
+			if (!spilled) return this->size_;
+			const size_t count = std::min(this->size_, target.capacity);
+			traits_t::copy(target.ptr, spill.data(), count);
+			return count;
+		}
+	};
+
+	class format_writer_t : public fmt::BasicWriter<T> {
+	public:
+		explicit format_writer_t(fmt::Buffer<T>& buffer) : fmt::BasicWriter<T>(buffer) {}
+	};
+
+	void SetInline() {
+		ptr = inline_buffer;
+		capacity = INLINE_CAPACITY;
 	}
-	basic_frame_string(basic_frame_string&& f) : length(f.length), data(f.data) {
-		f.data = nullptr;
-		f.length = 0;
+
+public:
+	basic_frame_string() : length(0) {
+		SetInline();
+		ptr[0] = T(0);
 	}
-	basic_frame_string(T* data, size_t length) : data(data), length(length) {}
-	basic_frame_string(const char* str) : length(strlen(str)) {
-		data = _allocate(length);
-		memcpy(data, str, sizeof(T)*length);
+	basic_frame_string(const T* str, const size_t n) : basic_frame_string() {
+		Append(str, n);
 	}
+	basic_frame_string(const T* str) : basic_frame_string(str, traits_t::length(str)) {}
+	basic_frame_string(const view_t str) : basic_frame_string(str.data(), str.size()) {}
+	basic_frame_string(const std::basic_string<T>& str) : basic_frame_string(str.data(), str.size()) {}
 
-	T& operator[](size_t index) {
-		return data[index];
+	basic_frame_string(const basic_frame_string& f) : basic_frame_string(f.ptr, f.length) {}
+
+	// Arena memory just changes hands, inline text is copied
+	basic_frame_string(basic_frame_string&& f) noexcept : length(f.length) {
+		if (f.IsInline()) {
+			SetInline();
+			traits_t::copy(ptr, f.ptr, length + 1);
+		}
+		else {
+			ptr = f.ptr;
+			capacity = f.capacity;
+		}
+		f.SetInline();
+		f.length = 0;
+		f.ptr[0] = T(0);
 	}
-	T operator[](size_t index) const {
-		return data[index];
+
+	basic_frame_string& operator=(const basic_frame_string& rhs) {
+		if (this != &rhs) {
+			Clear();
+			Append(rhs.ptr, rhs.length);
+		}
+		return *this;
+	}
+	basic_frame_string& operator=(basic_frame_string&& rhs) noexcept {
+		if (this != &rhs) {
+			this->~basic_frame_string();
+			new (this) basic_frame_string(std::move(rhs));
+		}
+		return *this;
 	}
 
-	bool operator==(const basic_frame_string& rhs) const {
-		if (length != rhs.length) return false;
-		if (length == 0) return true;
+	// ---- access
 
-		auto cmp_result = memcmp(data, rhs.data, length);
-		return cmp_result == 0;
+	const T*	data() const		{ return ptr; }
+	T*			data()				{ return ptr; }
+	const T*	c_str() const		{ return ptr; }
+	size_t		size() const		{ return length; }
+	bool		empty() const		{ return length == 0; }
+	bool		IsInline() const	{ return ptr == inline_buffer; }
+	size_t		Capacity() const	{ return capacity; }
+
+	const T*	begin() const		{ return ptr; }
+	const T*	end() const			{ return ptr + length; }
+
+	T& operator[](size_t index) {
+		assert(index < length);
+		return ptr[index];
 	}
-	bool operator!=(const basic_frame_string& rhs) const {
-		return !operator==(rhs);
+	T operator[](size_t index) const {
+		assert(index < length);
+		return ptr[index];
 	}
 
-	bool operator==(const std::basic_string<T>& rhs) const {
-		if (length != rhs.length()) return false;
-		if (length == 0) return true;
+	view_t		View() const		{ return view_t(ptr, length); }
+	operator	view_t() const		{ return View(); }
 
-		auto cmp_result = memcmp(data, rhs.data(), length);
-		return cmp_result == 0;
-	}
-	bool operator!=(const std::basic_string<T>& rhs) const {
-		return !operator==(rhs);
+	// ---- building
+
+	void Reserve(const size_t n) {
+		if (n <= capacity) return;
+		const size_t new_capacity = std::max(n, capacity * 2);
+		T* new_ptr = _allocate(new_capacity + 1);
+		if (new_ptr == nullptr) {
+			LogError("Frame string couldn't grow to {} characters", new_capacity);
+			return;
+		}
+		traits_t::copy(new_ptr, ptr, length);
+		new_ptr[length] = T(0);
+		ptr = new_ptr;
+		capacity = new_capacity;
 	}
 
-	bool operator==(const T* str) const {
-		auto cmp_result = memcmp(data, str, length);
-		return cmp_result == 0;
+	basic_frame_string& Append(const T* str, const size_t n) {
+		Reserve(length + n);
+		const size_t count = std::min(n, capacity - length);	// only short if the allocator ran out
+		traits_t::copy(ptr + length, str, count);
+		length += count;
+		ptr[length] = T(0);
+		return *this;
 	}
-	bool operator!=(const T* str) const {
-		return !operator==(str);
+	basic_frame_string& Append(const view_t str) {
+		return Append(str.data(), str.size());
 	}
-
-	basic_frame_string operator+(const basic_frame_string& rhs) const {
-		auto new_length = length + rhs.length;
-		auto new_data = _allocate(new_length);
-		memcpy(new_data, data, length);
-		memcpy(new_data + length, rhs.data, rhs.length);
-		return std::move(basic_frame_string(new_data, new_length));
+	basic_frame_string& Append(const T c) {
+		return Append(&c, 1);
 	}
-	basic_frame_string operator+(const T* rhs) const {
-		auto rhs_len = strlen(rhs);
-		auto new_length = length + rhs_len;
-		auto new_data = _allocate(new_length);
-		memcpy(new_data, data, length);
-		memcpy(new_data + length, rhs, rhs_len);
-		return std::move(basic_frame_string(new_data, new_length));
+
+	basic_frame_string& operator+=(const view_t rhs)	{ return Append(rhs); }
+	basic_frame_string& operator+=(const T* rhs)		{ return Append(view_t(rhs)); }
+	basic_frame_string& operator+=(const T rhs)			{ return Append(rhs); }
+
+	// Appends the arguments formatted with the fmt syntax, "{}" and so on
+	template<typename... Args>
+	basic_frame_string& Format(const T* format, const Args&... args) {
+		format_buffer_t buffer(*this);
+		format_writer_t writer(buffer);
+		writer.write(format, args...);
+		length = buffer.Finish();
+		ptr[length] = T(0);
+		return *this;
 	}
-	basic_frame_string operator+(const std::basic_string<T>& rhs) const {
-		return std::move(operator+(rhs.data()));
+
+	// Keeps the memory
+	void Clear() {
+		length = 0;
+		ptr[0] = T(0);
 	}
 
+	// ---- comparison
+
+	bool operator==(const view_t rhs) const					{ return View() == rhs; }
+	bool operator!=(const view_t rhs) const					{ return View() != rhs; }
+	bool operator==(const basic_frame_string& rhs) const	{ return View() == rhs.View(); }
+	bool operator!=(const basic_frame_string& rhs) const	{ return View() != rhs.View(); }
+	bool operator==(const std::basic_string<T>& rhs) const	{ return View() == view_t(rhs); }
+	bool operator!=(const std::basic_string<T>& rhs) const	{ return View() != view_t(rhs); }
+	bool operator==(const T* rhs) const						{ return View() == view_t(rhs); }
+	bool operator!=(const T* rhs) const						{ return View() != view_t(rhs); }
+
+	// ---- allocation
+
+	// Without an allocator of their own, frame strings live in the frame arenas
 	static void SetFrameAllocator(linear_allocator* fa) {
 		frame_alloc = fa;
 	}
 
-	T* _allocate(size_t n) const {
-		assert(frame_alloc != nullptr);
-		return (T*) frame_alloc->Allocate(n);
+	static T* _allocate(size_t n) {
+		if (frame_alloc == nullptr) {
+			assert(IsFrameArenaInitialized());
+			return FrameAllocateArray<T>(n);
+		}
+		return static_cast<T*>(frame_alloc->Allocate(n * sizeof(T), alignof(T)));
 	}
-
 };
 
 template<typename T>
@@ -99,40 +241,81 @@ linear_allocator* basic_frame_string<T>::frame_alloc = nullptr;
 
 // -------- TYPEDEFS -------------
 
-using frame_string = basic_frame_string<char>;
+using frame_string	= basic_frame_string<char>;
+using frame_wstring	= basic_frame_string<wchar_t>;
 
 // ------- FUNCTIONS --------------
 
+// A new frame string of the arguments formatted with the fmt syntax
+template<typename T, typename... Args>
+basic_frame_string<T> FrameFormat(const T* format, const Args&... args) {
+	basic_frame_string<T> result;
+	result.Format(format, args...);
+	return result;
+}
+
 template<typename T>
 bool operator==(const std::basic_string<T>& lhs, const basic_frame_string<T>& rhs) {
-	return rhs.operator==(lhs);
+	return rhs == lhs;
 }
 template<typename T>
 bool operator!=(const std::basic_string<T>& lhs, const basic_frame_string<T>& rhs) {
-	return rhs.operator!=(lhs);
+	return rhs != lhs;
 }
 
 template<typename T>
 bool operator==(const T* lhs, const basic_frame_string<T>& rhs) {
-	return rhs.operator==(lhs);
+	return rhs == lhs;
 }
 template<typename T>
 bool operator!=(const T* lhs, const basic_frame_string<T>& rhs) {
-	return rhs.operator!=(lhs);
+	return rhs != lhs;
 }
 
+// A temporary on the left is appended to in place, so chains only copy once
+template<typename T>
+basic_frame_string<T> operator+(basic_frame_string<T>&& lhs, const std::basic_string_view<T> rhs) {
+	lhs.Append(rhs);
+	return std::move(lhs);
+}
+template<typename T>
+basic_frame_string<T> operator+(basic_frame_string<T>&& lhs, const basic_frame_string<T>& rhs) {
+	lhs.Append(rhs.View());
+	return std::move(lhs);
+}
+template<typename T>
+basic_frame_string<T> operator+(basic_frame_string<T>&& lhs, const std::basic_string<T>& rhs) {
+	lhs.Append(rhs.data(), rhs.size());
+	return std::move(lhs);
+}
+template<typename T>
+basic_frame_string<T> operator+(basic_frame_string<T>&& lhs, const T* rhs) {
+	lhs.Append(std::basic_string_view<T>(rhs));
+	return std::move(lhs);
+}
+
+template<typename T>
+basic_frame_string<T> operator+(const basic_frame_string<T>& lhs, const basic_frame_string<T>& rhs) {
+	basic_frame_string<T> result;
+	result.Reserve(lhs.size() + rhs.size());
+	result.Append(lhs.View()).Append(rhs.View());
+	return result;
+}
+template<typename T>
+basic_frame_string<T> operator+(const basic_frame_string<T>& lhs, const T* rhs) {
+	return basic_frame_string<T>(lhs) + rhs;
+}
+template<typename T>
+basic_frame_string<T> operator+(const basic_frame_string<T>& lhs, const std::basic_string<T>& rhs) {
+	return basic_frame_string<T>(lhs) + rhs;
+}
 template<typename T>
 basic_frame_string<T> operator+(const T* lhs, const basic_frame_string<T>& rhs) {
-	auto lhs_len = strlen(lhs);
-	auto new_length = rhs.length + lhs_len;
-	auto new_data = rhs._allocate(new_length);
-	memcpy(new_data, lhs, lhs_len);
-	memcpy(new_data + lhs_len, rhs.data, rhs.length);
-	return std::move(basic_frame_string<T>(new_data, new_length));
+	return basic_frame_string<T>(lhs) + rhs;
 }
 template<typename T>
 basic_frame_string<T> operator+(const std::basic_string<T>& lhs, const basic_frame_string<T>& rhs) {
-	return std::move(lhs.data() + rhs);
+	return basic_frame_string<T>(lhs) + rhs;
 }
 
-} // namespace pn
\ No newline at end of file
+} // namespace pn
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
+#include <Utilities/Logging.h>
 
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
+	pn::InitLogger();
 	return RUN_ALL_TESTS();
 }
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <Application/ResourceDatabase.h>
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace pn;
+
+namespace ApplicationUnitTest {
+	mesh_buffer_t NamedMesh(const string& name) {
+		mesh_buffer_t mesh{};
+		mesh.name = name;
+		return mesh;
+	}
+
+	TEST(ResourceDatabaseTest, CommitPublishesChanges) {
+		const auto parent = rdb::AddMeshResource(NamedMesh("rdb_parent"));
+		const auto child = rdb::AddMeshResource(NamedMesh("rdb_child"));
+		transform_t transform;
+		transform.position = vec3f(1.0f, 2.0f, 3.0f);
+		rdb::AddMeshTransform(child, transform);
+		rdb::AddMeshChild(parent, child);
+
+		// staged until the commit
+		EXPECT_FALSE(rdb::IsValidMesh(parent));
+		EXPECT_EQ(rdb::NULL_RESOURCE_ID, rdb::FindMeshResourceId("rdb_parent"));
+
+		rdb::CommitChanges();
+		ASSERT_TRUE(rdb::IsValidMesh(parent));
+		EXPECT_EQ(parent, rdb::FindMeshResourceId("rdb_parent"));
+		EXPECT_EQ(child, rdb::GetMeshResource("rdb_child").id);
+		EXPECT_FLOAT_EQ(2.0f, rdb::GetMeshTransform(child).position.y);
+		ASSERT_EQ(1u, rdb::GetMeshChildren(parent).size());
+		EXPECT_EQ(child, rdb::GetMeshChildren(parent)[0]);
+		EXPECT_EQ(nullptr, rdb::FindMeshResource("rdb_missing"));
+
+		rdb::RemoveMeshResource(child);
+		rdb::CommitChanges();
+		EXPECT_FALSE(rdb::IsValidMesh(child));
+		EXPECT_EQ(nullptr, rdb::FindMeshResource(child));
+		EXPECT_EQ(rdb::NULL_RESOURCE_ID, rdb::FindMeshResourceId("rdb_child"));
+
+		rdb::RemoveMeshResource(parent);
+		rdb::CommitChanges();
+	}
+
+	TEST(ResourceDatabaseTest, StaleIdAfterSlotReuse) {
+		const auto first = rdb::AddMeshResource(NamedMesh("rdb_reused"));
+		rdb::CommitChanges();
+		rdb::RemoveMeshResource(first);
+		rdb::CommitChanges();
+
+		// earlier tests may have left free slots ahead of this one
+		pn::vector<rdb::mesh_resource_id_t> added;
+		rdb::mesh_resource_id_t second = rdb::NULL_RESOURCE_ID;
+		while (second == rdb::NULL_RESOURCE_ID && Size(added) < 64) {
+			const auto id = rdb::AddMeshResource(NamedMesh("rdb_reused"));
+			PushBack(added, id);
+			if (SlotIndex(id) == SlotIndex(first)) second = id;
+		}
+		rdb::CommitChanges();
+
+		ASSERT_NE(rdb::NULL_RESOURCE_ID, second);
+		EXPECT_NE(first, second);
+		EXPECT_FALSE(rdb::IsValidMesh(first));
+		EXPECT_EQ(nullptr, rdb::FindMeshResource(first));
+		EXPECT_TRUE(rdb::IsValidMesh(second));
+
+		for (const auto id : added) {
+			rdb::RemoveMeshResource(id);
+		}
+		rdb::CommitChanges();
+	}
+
+	TEST(ResourceDatabaseTest, SharedNameKeepsOldest) {
+		const auto first = rdb::AddMeshResource(NamedMesh("rdb_shared"));
+		rdb::CommitChanges();
+		const auto second = rdb::AddMeshResource(NamedMesh("rdb_shared"));
+		rdb::CommitChanges();
+		EXPECT_EQ(first, rdb::FindMeshResourceId("rdb_shared"));
+
+		rdb::RemoveMeshResource(first);
+		rdb::CommitChanges();
+		EXPECT_EQ(second, rdb::FindMeshResourceId("rdb_shared"));
+
+		rdb::RemoveMeshResource(second);
+		rdb::CommitChanges();
+	}
+
+	// Loader threads add, edit and remove meshes while a reader walks the ids it has seen and the
+	// main thread commits as fast as it can
+	TEST(ResourceDatabaseTest, ConcurrentStress) {
+		constexpr int WRITERS = 4;
+		constexpr int MESHES_PER_WRITER = 2000;
+
+		struct written_t {
+			rdb::mesh_resource_id_t	id;
+			string					name;
+			bool					removed;
+		};
+		std::mutex written_lock;
+		pn::vector<written_t> written;
+		std::atomic<int> writers_done{ 0 };
+		std::atomic<int> bad_reads{ 0 };
+		std::atomic<int> good_reads{ 0 };
+
+		pn::vector<std::thread> threads;
+		for (int w = 0; w < WRITERS; ++w) {
+			threads.emplace_back([&, w] {
+				auto parent = rdb::NULL_RESOURCE_ID;
+				for (int i = 0; i < MESHES_PER_WRITER; ++i) {
+					const auto name = "rdb_stress_" + std::to_string(w) + "_" + std::to_string(i);
+					const auto id = rdb::AddMeshResource(NamedMesh(name));
+					transform_t transform;
+					transform.position = vec3f(static_cast<float>(w), static_cast<float>(i), 0.0f);
+					rdb::AddMeshTransform(id, transform);
+					if (parent != rdb::NULL_RESOURCE_ID) {
+						rdb::AddMeshChild(parent, id);
+					}
+
+					const bool removed = (i % 4 == 3);
+					if (removed) {
+						rdb::RemoveMeshResource(id);
+					} else {
+						parent = id;
+					}
+					std::lock_guard<std::mutex> lock(written_lock);
+					PushBack(written, written_t{ id, name, removed });
+				}
+				writers_done.fetch_add(1);
+			});
+		}
+
+		threads.emplace_back([&] {
+			std::mt19937 rng(7);
+			while (writers_done.load() < WRITERS) {
+				written_t sample;
+				{
+					std::lock_guard<std::mutex> lock(written_lock);
+					if (written.empty()) continue;
+					sample = written[rng() % Size(written)];
+				}
+
+				rdb::read_scope_t scope;
+				if (const auto* mesh = rdb::FindMeshResource(sample.id)) {
+					const bool ok = mesh->id == sample.id && mesh->name == sample.name
+						&& rdb::FindMeshResourceId(sample.name) == sample.id;
+					(ok ? good_reads : bad_reads).fetch_add(1);
+				}
+			}
+		});
+
+		while (writers_done.load() < WRITERS) {
+			rdb::CommitChanges();
+			std::this_thread::yield();
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		rdb::CommitChanges();
+
+		EXPECT_EQ(0, bad_reads.load());
+		ASSERT_EQ(size_t(WRITERS * MESHES_PER_WRITER), Size(written));
+
+		pn::map<rdb::mesh_resource_id_t, int> seen;
+		for (const auto& w : written) {
+			EXPECT_EQ(0, seen[w.id]++) << "id handed out twice";
+			EXPECT_EQ(!w.removed, rdb::IsValidMesh(w.id)) << w.name;
+			if (!w.removed) {
+				EXPECT_EQ(w.id, rdb::FindMeshResourceId(w.name));
+				EXPECT_EQ(w.name, rdb::GetMeshResource(w.id).name);
+			}
+		}
+
+		// slots freed by the removals are recycled with a new generation
+		for (const auto& w : written) {
+			if (!w.removed) rdb::RemoveMeshResource(w.id);
+		}
+		rdb::CommitChanges();
+		const auto recycled = rdb::AddMeshResource(NamedMesh("rdb_stress_recycled"));
+		rdb::CommitChanges();
+		EXPECT_EQ(0, seen.count(recycled));
+		EXPECT_TRUE(rdb::IsValidMesh(recycled));
+		rdb::RemoveMeshResource(recycled);
+		rdb::CommitChanges();
+	}
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <Component/transform_t.h>
+
+using namespace pn;
+
+namespace ComponentUnitTest {
+	// Reference: rebuild the whole chain without touching the cache
+	mat4f UncachedLocalToWorld(const transform_t& t) {
+		auto m = TransformToMatrix(t);
+		for (auto* p = t.parent; p != nullptr; p = p->parent) {
+			m *= TransformToMatrix(*p);
+		}
+		return m;
+	}
+
+	TEST(TransformTest, RootMatrixTest) {
+		transform_t t;
+		ASSERT_TRUE(LocalToWorldMatrix(t) == mat4f::Identity);
+
+		SetPosition(t, vec3f(1.0f, 2.0f, 3.0f));
+		ASSERT_TRUE(LocalToWorldMatrix(t) == Translation(vec3f(1.0f, 2.0f, 3.0f)));
+		ASSERT_TRUE(TransformPoint(t, vec3f::Zero) == vec3f(1.0f, 2.0f, 3.0f));
+		ASSERT_TRUE(InverseTransformPoint(t, vec3f(1.0f, 2.0f, 3.0f)) == vec3f::Zero);
+	}
+
+	TEST(TransformTest, CachedMatrixTest) {
+		transform_t t;
+		SetScale(t, vec3f(2.0f, 2.0f, 2.0f));
+		const auto* first = &LocalToWorldMatrix(t);
+		ASSERT_FALSE(t.world_dirty);
+
+		// repeated queries come straight from the cache
+		ASSERT_EQ(first, &LocalToWorldMatrix(t));
+		ASSERT_FALSE(t.local_dirty);
+
+		TranslateWorld(t, vec3f(1.0f, 0.0f, 0.0f));
+		ASSERT_TRUE(t.local_dirty);
+		ASSERT_TRUE(t.world_dirty);
+		ASSERT_TRUE(LocalToWorldMatrix(t) == UncachedLocalToWorld(t));
+	}
+
+	TEST(TransformTest, DirtyPropagationTest) {
+		transform_t root, child, grandchild;
+		SetParent(child, &root);
+		SetParent(grandchild, &child);
+		ASSERT_EQ(1u, root.children.size());
+		ASSERT_EQ(&child, grandchild.parent);
+
+		SetPosition(root, vec3f(0.0f, 5.0f, 0.0f));
+		SetRotation(child, AxisAngleToQuaternion(vec3f::UnitY, Rad(90.0f)));
+		SetPosition(child, vec3f(1.0f, 0.0f, 0.0f));
+		SetPosition(grandchild, vec3f(0.0f, 0.0f, 1.0f));
+		ASSERT_TRUE(LocalToWorldMatrix(grandchild) == UncachedLocalToWorld(grandchild));
+		ASSERT_FALSE(root.world_dirty || child.world_dirty || grandchild.world_dirty);
+
+		// moving the root invalidates everything below it
+		RotateWorld(root, vec3f::UnitZ, Rad(45.0f));
+		ASSERT_TRUE(child.world_dirty);
+		ASSERT_TRUE(grandchild.world_dirty);
+		ASSERT_FALSE(child.local_dirty);
+		ASSERT_TRUE(LocalToWorldMatrix(grandchild) == UncachedLocalToWorld(grandchild));
+		ASSERT_TRUE(WorldToLocalMatrix(grandchild) == Inverse(UncachedLocalToWorld(grandchild)));
+
+		// moving a leaf leaves its ancestors cached
+		TranslateLocal(grandchild, vec3f(0.0f, 1.0f, 0.0f));
+		ASSERT_FALSE(root.world_dirty || child.world_dirty);
+		ASSERT_TRUE(LocalToWorldMatrix(grandchild) == UncachedLocalToWorld(grandchild));
+	}
+
+	TEST(TransformTest, PartialQueryTest) {
+		transform_t root, child;
+		SetParent(child, &root);
+		LocalToWorldMatrix(child);
+
+		// only the root gets rebuilt, the child must stay dirty through a second change
+		TranslateWorld(root, vec3f(1.0f, 0.0f, 0.0f));
+		LocalToWorldMatrix(root);
+		TranslateWorld(root, vec3f(1.0f, 0.0f, 0.0f));
+		ASSERT_TRUE(child.world_dirty);
+		ASSERT_TRUE(LocalToWorldMatrix(child) == Translation(vec3f(2.0f, 0.0f, 0.0f)));
+	}
+
+	TEST(TransformTest, ReparentTest) {
+		transform_t a, b, child;
+		SetPosition(a, vec3f(1.0f, 0.0f, 0.0f));
+		SetPosition(b, vec3f(0.0f, 1.0f, 0.0f));
+		SetParent(child, &a);
+		ASSERT_TRUE(TransformPoint(child, vec3f::Zero) == vec3f(1.0f, 0.0f, 0.0f));
+
+		SetParent(child, &b);
+		ASSERT_TRUE(a.children.empty());
+		ASSERT_EQ(1u, b.children.size());
+		ASSERT_TRUE(TransformPoint(child, vec3f::Zero) == vec3f(0.0f, 1.0f, 0.0f));
+
+		SetParent(child, nullptr);
+		ASSERT_TRUE(b.children.empty());
+		ASSERT_TRUE(TransformPoint(child, vec3f::Zero) == vec3f::Zero);
+	}
+
+	TEST(TransformTest, MarkDirtyTest) {
+		transform_t t;
+		LocalToWorldMatrix(t);
+
+		// direct writes need an explicit MarkDirty
+		t.position = vec3f(0.0f, 0.0f, 4.0f);
+		MarkDirty(t);
+		ASSERT_TRUE(TransformPoint(t, vec3f::Zero) == vec3f(0.0f, 0.0f, 4.0f));
+	}
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <Graphics/CookedMesh.h>
+#include <Graphics/MeshCook.h>
+#include <IO/FileUtil.h>
+#include <IO/MappedFile.h>
+
+#include <cstring>
+#include <filesystem>
+
+using namespace pn;
+
+namespace GraphicsUnitTest {
+	const string MESH_DIR = string(PN_TEST_RESOURCE_DIR) + "mesh/";
+
+	template<typename T>
+	void ExpectSameStream(const pn::vector<T>& expected, const pn::span<const T>& actual) {
+		ASSERT_EQ(Size(expected), actual.size());
+		if (!expected.empty()) {
+			EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), Size(expected) * sizeof(T)));
+		}
+	}
+
+	void ExpectSameMesh(const cooked_mesh_source_t& source, const cooked_mesh_view_t& view) {
+		EXPECT_EQ(source.load_flags, view.header->load_flags);
+
+		const auto meshes = GetMeshes(view);
+		ASSERT_EQ(Size(source.meshes), meshes.size());
+		for (size_t i = 0; i < meshes.size(); ++i) {
+			const auto& expected = source.meshes[i];
+			const auto& mesh = meshes[i];
+			EXPECT_EQ(expected.name, GetMeshName(view, mesh));
+			EXPECT_EQ(expected.topology, mesh.topology);
+			ExpectSameStream(expected.vertices, GetStream<vec3f>(view, mesh, mesh_stream_t::VERTICES));
+			ExpectSameStream(expected.normals, GetStream<vec3f>(view, mesh, mesh_stream_t::NORMALS));
+			ExpectSameStream(expected.tangents, GetStream<vec3f>(view, mesh, mesh_stream_t::TANGENTS));
+			ExpectSameStream(expected.bitangents, GetStream<vec3f>(view, mesh, mesh_stream_t::BITANGENTS));
+			ExpectSameStream(expected.colors, GetStream<vec4f>(view, mesh, mesh_stream_t::COLORS));
+			ExpectSameStream(expected.uvs, GetStream<vec2f>(view, mesh, mesh_stream_t::UVS));
+			ExpectSameStream(expected.uv2s, GetStream<vec2f>(view, mesh, mesh_stream_t::UV2S));
+			ExpectSameStream(expected.indices, GetStream<uint32_t>(view, mesh, mesh_stream_t::INDICES));
+		}
+
+		const auto nodes = GetNodes(view);
+		ASSERT_EQ(Size(source.nodes), nodes.size());
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			EXPECT_EQ(0, std::memcmp(&source.nodes[i], &nodes[i], sizeof(cooked_node_t)));
+			const auto node_meshes = GetNodeMeshes(view, nodes[i]);
+			for (size_t m = 0; m < node_meshes.size(); ++m) {
+				EXPECT_EQ(source.node_meshes[source.nodes[i].first_mesh + m], node_meshes[m]);
+			}
+		}
+	}
+
+	// Root with no meshes, one child with a full mesh and one with positions only
+	cooked_mesh_source_t MakeSource() {
+		cooked_mesh_source_t source;
+		source.load_flags = 0x1234;
+
+		cooked_submesh_source_t full;
+		full.name = "full";
+		for (int i = 0; i < 5; ++i) {
+			const float f = static_cast<float>(i);
+			PushBack(full.vertices, vec3f(f, f + 1.0f, f + 2.0f));
+			PushBack(full.normals, vec3f(0.0f, 1.0f, f));
+			PushBack(full.tangents, vec3f(1.0f, 0.0f, f));
+			PushBack(full.bitangents, vec3f(0.0f, 0.0f, f));
+			PushBack(full.colors, vec4f(f, f, f, 1.0f));
+			PushBack(full.uvs, vec2f(f, -f));
+			PushBack(full.uv2s, vec2f(-f, f));
+		}
+		full.indices = { 0, 1, 2, 2, 3, 4 };
+		PushBack(source.meshes, std::move(full));
+
+		cooked_submesh_source_t positions_only;
+		positions_only.name = "positions_only";
+		positions_only.vertices = { vec3f(1.0f, 2.0f, 3.0f), vec3f(4.0f, 5.0f, 6.0f), vec3f(7.0f, 8.0f, 9.0f) };
+		PushBack(source.meshes, std::move(positions_only));
+
+		transform_t t;
+		t.position = vec3f(1.0f, 2.0f, 3.0f);
+		t.rotation = EulerToQuaternion(vec3f(0.1f, 0.2f, 0.3f));
+		t.scale = vec3f(2.0f, 2.0f, 2.0f);
+
+		cooked_node_t root{};
+		SetNodeTransform(root, transform_t{});
+		root.parent = -1;
+		PushBack(source.nodes, root);
+
+		cooked_node_t child{};
+		SetNodeTransform(child, t);
+		child.parent = 0;
+		child.first_mesh = 0;
+		child.mesh_count = 2;
+		PushBack(source.nodes, child);
+		source.node_meshes = { 0, 1 };
+
+		return source;
+	}
+
+	TEST(MeshCookTest, RoundTrip) {
+		const auto source = MakeSource();
+		const auto file = WriteCookedMesh(source);
+
+		cooked_mesh_view_t view;
+		ASSERT_TRUE(OpenCookedMesh(file.data(), Size(file), view));
+		ExpectSameMesh(source, view);
+
+		const auto meshes = GetMeshes(view);
+		for (const auto& mesh : meshes) {
+			for (const auto& stream : mesh.streams) {
+				EXPECT_EQ(0u, stream.offset % COOKED_MESH_ALIGNMENT);
+			}
+		}
+		EXPECT_EQ(0u, meshes[1].streams[static_cast<size_t>(mesh_stream_t::NORMALS)].count);
+
+		const auto child = GetNodeTransform(GetNodes(view)[1]);
+		EXPECT_FLOAT_EQ(source.nodes[1].rotation[3], child.rotation.w);
+		EXPECT_FLOAT_EQ(2.0f, child.scale.y);
+	}
+
+	TEST(MeshCookTest, EmptyMesh) {
+		const auto file = WriteCookedMesh(cooked_mesh_source_t{});
+		cooked_mesh_view_t view;
+		ASSERT_TRUE(OpenCookedMesh(file.data(), Size(file), view));
+		EXPECT_TRUE(GetMeshes(view).empty());
+		EXPECT_TRUE(GetNodes(view).empty());
+	}
+
+	TEST(MeshCookTest, RejectsBadFiles) {
+		const auto file = WriteCookedMesh(MakeSource());
+		cooked_mesh_view_t view;
+
+		auto bad_magic = file;
+		bad_magic[0] ^= 0xff;
+		EXPECT_FALSE(OpenCookedMesh(bad_magic.data(), Size(bad_magic), view));
+
+		auto truncated = file;
+		Resize(truncated, Size(file) - 4);
+		EXPECT_FALSE(OpenCookedMesh(truncated.data(), Size(truncated), view));
+
+		auto bad_stream = file;
+		auto* header = reinterpret_cast<cooked_mesh_header_t*>(bad_stream.data());
+		auto* table = reinterpret_cast<cooked_submesh_t*>(bad_stream.data() + header->mesh_table_offset);
+		table[0].streams[0].count = 0x7fffffff;
+		EXPECT_FALSE(OpenCookedMesh(bad_stream.data(), Size(bad_stream), view));
+
+		// a stale element size would make GetStream read past the stream
+		auto bad_element_size = file;
+		header = reinterpret_cast<cooked_mesh_header_t*>(bad_element_size.data());
+		table = reinterpret_cast<cooked_submesh_t*>(bad_element_size.data() + header->mesh_table_offset);
+		table[0].streams[static_cast<size_t>(mesh_stream_t::NORMALS)].element_size = 1;
+		EXPECT_FALSE(OpenCookedMesh(bad_element_size.data(), Size(bad_element_size), view));
+
+		auto bad_parent = file;
+		header = reinterpret_cast<cooked_mesh_header_t*>(bad_parent.data());
+		reinterpret_cast<cooked_node_t*>(bad_parent.data() + header->node_table_offset)[1].parent = 1;
+		EXPECT_FALSE(OpenCookedMesh(bad_parent.data(), Size(bad_parent), view));
+
+		EXPECT_EQ(nullptr, view.header);
+	}
+
+	TEST(MeshCookTest, CookedMeshPath) {
+		EXPECT_EQ("mesh/dragon.pnmesh", CookedMeshPath("mesh/dragon.fbx"));
+		EXPECT_EQ("C:\\res.v2\\mesh\\cube.pnmesh", CookedMeshPath("C:\\res.v2\\mesh\\cube.fbx"));
+		EXPECT_EQ("my.dir/cube.pnmesh", CookedMeshPath("my.dir/cube"));
+	}
+
+#if !defined(PN_NO_ASSIMP)
+	// Every mesh shipped in resources/mesh goes through Assimp, the cooker and a memory mapped read
+	TEST(MeshCookTest, ResourceRoundTrip) {
+		const auto temp_path = (std::filesystem::temp_directory_path() / "meshcooktest.pnmesh").string();
+
+		int cooked_files = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(MESH_DIR)) {
+			if (entry.path().extension() != ".fbx") continue;
+			SCOPED_TRACE(entry.path().string());
+
+			cooked_mesh_source_t source;
+			ASSERT_TRUE(ImportMeshSource(ReadFile(entry.path().string()), DEFAULT_MESH_LOAD_DATA, source));
+			ASSERT_FALSE(source.meshes.empty());
+			ASSERT_TRUE(WriteCookedMeshFile(temp_path, WriteCookedMesh(source)));
+
+			auto mapped = MapFile(temp_path);
+			ASSERT_TRUE(IsMapped(mapped));
+			cooked_mesh_view_t view;
+			EXPECT_TRUE(OpenCookedMesh(mapped.data, mapped.size, view));
+			if (view.header != nullptr) {
+				ExpectSameMesh(source, view);
+			}
+			UnmapFile(mapped);
+			++cooked_files;
+		}
+		std::filesystem::remove(temp_path);
+		EXPECT_GT(cooked_files, 0);
+	}
+#endif
+
+	TEST(MeshCookTest, CookedFileIsCurrent) {
+		const auto dir = std::filesystem::temp_directory_path();
+		const auto source_path = (dir / "meshcooktest_source.fbx").string();
+		const auto cooked_path = CookedMeshPath(source_path);
+		std::filesystem::remove(cooked_path);
+
+		ASSERT_TRUE(WriteFile(source_path, "x", 1));
+		EXPECT_FALSE(IsCookedMeshCurrent(source_path, cooked_path));
+
+		ASSERT_TRUE(WriteCookedMeshFile(cooked_path, WriteCookedMesh(MakeSource())));
+		EXPECT_TRUE(IsCookedMeshCurrent(source_path, cooked_path));
+
+		std::filesystem::last_write_time(source_path, std::filesystem::last_write_time(cooked_path) + std::chrono::hours(1));
+		EXPECT_FALSE(IsCookedMeshCurrent(source_path, cooked_path));
+
+		std::filesystem::remove(source_path);
+		EXPECT_TRUE(IsCookedMeshCurrent(source_path, cooked_path));
+		std::filesystem::remove(cooked_path);
+	}
+}
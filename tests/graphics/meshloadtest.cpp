@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <Application/ResourceDatabase.h>
+#include <Graphics/MeshCook.h>
+#include <Graphics/MeshLoadUtil.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace pn;
+
+namespace GraphicsUnitTest {
+// the D3D11 backend needs a device to create the buffers
+#if !defined(PN_BACKEND_D3D11)
+	// A cooked triangle with nothing next to it, so loading it never needs Assimp
+	string WriteCookedTriangle(const string& name, const string& file_name) {
+		cooked_mesh_source_t source;
+		cooked_submesh_source_t triangle;
+		triangle.name = name;
+		triangle.vertices = { vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, 0.0f, 0.0f), vec3f(0.0f, 1.0f, 0.0f) };
+		triangle.indices = { 0, 1, 2 };
+		PushBack(source.meshes, std::move(triangle));
+
+		cooked_node_t root{};
+		SetNodeTransform(root, transform_t{});
+		root.parent = -1;
+		root.first_mesh = 0;
+		root.mesh_count = 1;
+		PushBack(source.nodes, root);
+		source.node_meshes = { 0 };
+		source.load_flags = MeshLoadDataToAssimp(DEFAULT_MESH_LOAD_DATA);
+
+		const auto source_path = (std::filesystem::temp_directory_path() / file_name).string();
+		EXPECT_TRUE(WriteCookedMeshFile(CookedMeshPath(source_path), WriteCookedMesh(source)));
+		return source_path;
+	}
+
+	// A cooked file without its source goes straight from the memory mapped file to the resource
+	// database, with no Assimp involved
+	TEST(MeshLoadTest, LoadCookedMeshHeadless) {
+		const auto source_path = WriteCookedTriangle("headless_triangle", "meshloadtest.fbx");
+		const auto root_id = LoadMesh(source_path);
+		std::filesystem::remove(CookedMeshPath(source_path));
+		ASSERT_TRUE(rdb::IsValidMesh(root_id));
+
+		const auto& mesh = rdb::GetMeshResource(root_id);
+		EXPECT_EQ("headless_triangle", mesh.name);
+		EXPECT_EQ(3u, mesh.vertex_count);
+		EXPECT_EQ(3u, mesh.index_count);
+		EXPECT_EQ(COOKED_TOPOLOGY_TRIANGLE_LIST, mesh.topology);
+		EXPECT_EQ(root_id, rdb::FindMeshResourceId("headless_triangle"));
+	}
+
+	// Loads that are only polled give their handle back with ReleaseMeshLoad
+	TEST(MeshLoadTest, PollAndRelease) {
+		const auto source_path = WriteCookedTriangle("polled_triangle", "meshloadtest_polled.fbx");
+
+		const auto handle = LoadMeshAsync(source_path);
+		for (int i = 0; i < 10000 && GetMeshLoadStatus(handle) == mesh_load_status_t::PENDING; ++i) {
+			UpdateMeshLoads();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		ASSERT_EQ(mesh_load_status_t::READY, GetMeshLoadStatus(handle));
+		ReleaseMeshLoad(handle);
+		EXPECT_EQ(mesh_load_status_t::INVALID, GetMeshLoadStatus(handle));
+		EXPECT_NE(rdb::NULL_RESOURCE_ID, rdb::FindMeshResourceId("polled_triangle"));
+
+		// released before it's done, the handle is gone right away and the load still finishes
+		const auto early_path = WriteCookedTriangle("early_triangle", "meshloadtest_early.fbx");
+		const auto early = LoadMeshAsync(early_path);
+		ReleaseMeshLoad(early);
+		EXPECT_EQ(mesh_load_status_t::INVALID, GetMeshLoadStatus(early));
+		for (int i = 0; i < 10000 && rdb::FindMeshResourceId("early_triangle") == rdb::NULL_RESOURCE_ID; ++i) {
+			UpdateMeshLoads();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		EXPECT_NE(rdb::NULL_RESOURCE_ID, rdb::FindMeshResourceId("early_triangle"));
+
+		std::filesystem::remove(CookedMeshPath(source_path));
+		std::filesystem::remove(CookedMeshPath(early_path));
+	}
+#endif
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <IO/AssetCache.h>
+#include <IO/FileUtil.h>
+
+#include <filesystem>
+#include <thread>
+
+using namespace pn;
+
+namespace IOUnitTest {
+	class AssetCacheTest : public ::testing::Test {
+	protected:
+		void SetUp() override {
+			directory = (std::filesystem::temp_directory_path() / "pn_asset_cache_test").string();
+			std::filesystem::remove_all(directory);
+		}
+
+		void TearDown() override {
+			ShutdownAssetCache();
+			std::filesystem::remove_all(directory);
+		}
+
+		string directory;
+	};
+
+	bytes Blob(const size_t size, const char fill) {
+		return bytes(size, fill);
+	}
+
+	TEST_F(AssetCacheTest, DisabledByDefault) {
+		bytes data;
+		EXPECT_FALSE(IsAssetCacheEnabled());
+		EXPECT_FALSE(ReadCachedAsset(MakeAssetKey("mesh", 1), data));
+		StoreCachedAsset(MakeAssetKey("mesh", 1), Blob(10, 'a'));
+		EXPECT_EQ(0u, GetAssetCacheStats().stores);
+	}
+
+	TEST_F(AssetCacheTest, StoreAndRead) {
+		InitAssetCache(directory);
+		const auto key = MakeAssetKey("mesh", 42, 7);
+
+		bytes data;
+		EXPECT_FALSE(ReadCachedAsset(key, data));
+		StoreCachedAsset(key, Blob(100, 'x'));
+		ASSERT_TRUE(ReadCachedAsset(key, data));
+		EXPECT_EQ(Blob(100, 'x'), data);
+
+		auto mapped = MapCachedAsset(key);
+		ASSERT_TRUE(IsMapped(mapped));
+		EXPECT_EQ(100u, mapped.size);
+		UnmapFile(mapped);
+
+		const auto stats = GetAssetCacheStats();
+		EXPECT_EQ(2u, stats.hits);
+		EXPECT_EQ(1u, stats.misses);
+		EXPECT_EQ(1u, stats.stores);
+		EXPECT_EQ(200u, stats.bytes_read);
+		EXPECT_EQ(100u, stats.bytes_written);
+		EXPECT_EQ(1u, stats.entry_count);
+		EXPECT_EQ(100u, stats.total_size);
+	}
+
+	TEST_F(AssetCacheTest, KeysDependOnEverything) {
+		const auto key = MakeAssetKey("mesh", 1, 2);
+		EXPECT_EQ(key.hash, MakeAssetKey("mesh", 1, 2).hash);
+		EXPECT_NE(key.hash, MakeAssetKey("mesh", 1, 3).hash);
+		EXPECT_NE(key.hash, MakeAssetKey("mesh", 2, 2).hash);
+		EXPECT_NE(key.hash, MakeAssetKey("texture", 1, 2).hash);
+	}
+
+	TEST_F(AssetCacheTest, EvictsLeastRecentlyUsed) {
+		InitAssetCache(directory, 250);
+		const auto a = MakeAssetKey("blob", 1);
+		const auto b = MakeAssetKey("blob", 2);
+		const auto c = MakeAssetKey("blob", 3);
+
+		StoreCachedAsset(a, Blob(100, 'a'));
+		StoreCachedAsset(b, Blob(100, 'b'));
+
+		// a becomes the most recent, so b goes first
+		bytes data;
+		ASSERT_TRUE(ReadCachedAsset(a, data));
+		StoreCachedAsset(c, Blob(100, 'c'));
+
+		EXPECT_TRUE(ReadCachedAsset(a, data));
+		EXPECT_FALSE(ReadCachedAsset(b, data));
+		EXPECT_TRUE(ReadCachedAsset(c, data));
+		EXPECT_FALSE(std::filesystem::exists(CachedAssetPath(b)));
+
+		const auto stats = GetAssetCacheStats();
+		EXPECT_EQ(1u, stats.evictions);
+		EXPECT_EQ(200u, stats.total_size);
+	}
+
+	TEST_F(AssetCacheTest, Overwrite) {
+		InitAssetCache(directory);
+		const auto key = MakeAssetKey("blob", 1);
+		StoreCachedAsset(key, Blob(100, 'a'));
+		StoreCachedAsset(key, Blob(30, 'b'));
+
+		bytes data;
+		ASSERT_TRUE(ReadCachedAsset(key, data));
+		EXPECT_EQ(Blob(30, 'b'), data);
+		EXPECT_EQ(30u, GetAssetCacheStats().total_size);
+		EXPECT_EQ(1u, GetAssetCacheStats().entry_count);
+	}
+
+	TEST_F(AssetCacheTest, PersistsAcrossRuns) {
+		const auto a = MakeAssetKey("blob", 1);
+		const auto b = MakeAssetKey("blob", 2);
+		const auto c = MakeAssetKey("blob", 3);
+
+		InitAssetCache(directory);
+		StoreCachedAsset(a, Blob(100, 'a'));
+		StoreCachedAsset(b, Blob(100, 'b'));
+		// recency comes back from the modification times, give them room to differ
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		bytes data;
+		ASSERT_TRUE(ReadCachedAsset(a, data));
+		ShutdownAssetCache();
+
+		// a stray temporary from an interrupted store is cleaned up
+		WriteFile(directory + "/junk.blob.0.tmp", "x", 1);
+
+		InitAssetCache(directory, 250);
+		EXPECT_EQ(2u, GetAssetCacheStats().entry_count);
+		EXPECT_FALSE(std::filesystem::exists(directory + "/junk.blob.0.tmp"));
+
+		StoreCachedAsset(c, Blob(100, 'c'));
+		EXPECT_TRUE(ReadCachedAsset(a, data));
+		EXPECT_EQ(Blob(100, 'a'), data);
+		EXPECT_FALSE(ReadCachedAsset(b, data));
+	}
+
+	TEST_F(AssetCacheTest, ConcurrentUse) {
+		InitAssetCache(directory, 64 * 100);
+		pn::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([t] {
+				bytes data;
+				for (int i = 0; i < 50; ++i) {
+					const auto key = MakeAssetKey("blob", (t * 50 + i) % 80);
+					if (!ReadCachedAsset(key, data)) {
+						StoreCachedAsset(key, Blob(100, static_cast<char>(i)));
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		const auto stats = GetAssetCacheStats();
+		EXPECT_EQ(200u, stats.hits + stats.misses);
+		EXPECT_LE(stats.total_size, 64u * 100u);
+		EXPECT_EQ(stats.entry_count * 100u, stats.total_size);
+	}
+}
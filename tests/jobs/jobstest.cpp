@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <System/Jobs.h>
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+using namespace pn;
+
+namespace JobsUnitTest {
+	class JobsTest : public ::testing::Test {
+	protected:
+		void SetUp() override { jobs::Init(3); }
+		void TearDown() override { jobs::Shutdown(); }
+	};
+
+	TEST(JobsInlineTest, RunWithoutInitTest) {
+		ASSERT_FALSE(jobs::IsInitialized());
+		ASSERT_EQ(1u, jobs::ThreadCount());
+
+		int value = 0;
+		jobs::counter_t counter;
+		jobs::Run([&] { value = 1; }, &counter);
+		ASSERT_EQ(1, value);
+		ASSERT_EQ(0, counter.value.load());
+
+		pn::vector<int> data(100, 1);
+		int sum = 0;
+		jobs::ParallelFor(0, data.size(), 0, [&](size_t b, size_t e) {
+			for (size_t i = b; i < e; ++i) sum += data[i];
+		});
+		ASSERT_EQ(100, sum);
+	}
+
+	TEST_F(JobsTest, InitTest) {
+		ASSERT_TRUE(jobs::IsInitialized());
+		ASSERT_EQ(4u, jobs::ThreadCount());
+		ASSERT_EQ(0u, jobs::ThreadIndex());
+	}
+
+	TEST_F(JobsTest, CounterTest) {
+		std::atomic<int> done{ 0 };
+		jobs::counter_t counter;
+		for (int i = 0; i < 10000; ++i) {
+			jobs::Run([&] { done.fetch_add(1); }, &counter);
+		}
+		jobs::WaitForCounter(counter);
+		ASSERT_EQ(10000, done.load());
+		ASSERT_EQ(0, counter.value.load());
+	}
+
+	TEST_F(JobsTest, ParallelForTest) {
+		pn::vector<uint64_t> data(1 << 20);
+		std::iota(data.begin(), data.end(), 0);
+
+		std::atomic<uint64_t> sum{ 0 };
+		pn::vector<std::atomic<int>> touched(data.size());
+		jobs::ParallelFor(0, data.size(), 1000, [&](size_t b, size_t e) {
+			uint64_t local = 0;
+			for (size_t i = b; i < e; ++i) {
+				local += data[i];
+				touched[i].fetch_add(1);
+			}
+			sum.fetch_add(local);
+		});
+
+		const uint64_t n = data.size();
+		ASSERT_EQ(n * (n - 1) / 2, sum.load());
+		for (auto& t : touched) {
+			ASSERT_EQ(1, t.load());
+		}
+	}
+
+	TEST_F(JobsTest, NestedParallelForTest) {
+		// jobs that wait on their own children must keep the pool busy instead of deadlocking
+		std::atomic<int> total{ 0 };
+		jobs::ParallelFor(0, 64, 1, [&](size_t, size_t) {
+			jobs::ParallelFor(0, 256, 8, [&](size_t b, size_t e) {
+				total.fetch_add(static_cast<int>(e - b));
+			});
+		});
+		ASSERT_EQ(64 * 256, total.load());
+	}
+
+	TEST_F(JobsTest, DependencyTest) {
+		pn::vector<int> order;
+		std::mutex order_lock;
+		auto record = [&](int stage) {
+			std::lock_guard<std::mutex> lock(order_lock);
+			PushBack(order, stage);
+		};
+
+		jobs::counter_t first, second, third;
+		for (int i = 0; i < 8; ++i) {
+			jobs::Run([&] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); record(1); }, &first);
+		}
+		for (int i = 0; i < 8; ++i) {
+			jobs::RunAfter(first, [&] { record(2); }, &second);
+		}
+		jobs::RunAfter(second, [&] { record(3); }, &third);
+		jobs::WaitForCounter(third);
+
+		ASSERT_EQ(17u, order.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			ASSERT_EQ(i < 8 ? 1 : i < 16 ? 2 : 3, order[i]);
+		}
+	}
+
+	TEST_F(JobsTest, RunAfterCompletedTest) {
+		jobs::counter_t done;
+		jobs::counter_t counter;
+		bool ran = false;
+		jobs::RunAfter(done, [&] { ran = true; }, &counter);
+		jobs::WaitForCounter(counter);
+		ASSERT_TRUE(ran);
+	}
+
+	TEST_F(JobsTest, WorkStealingTest) {
+		// everything is pushed to the main thread's deque, other threads only get work by stealing
+		std::atomic<int> threads_seen{ 0 };
+		pn::vector<std::atomic<int>> per_thread(jobs::ThreadCount());
+		jobs::counter_t counter;
+		for (int i = 0; i < 256; ++i) {
+			jobs::Run([&] {
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+				if (per_thread[jobs::ThreadIndex()].fetch_add(1) == 0) threads_seen.fetch_add(1);
+			}, &counter);
+		}
+		jobs::WaitForCounter(counter);
+		int total = 0;
+		for (auto& count : per_thread) total += count.load();
+		ASSERT_EQ(256, total);
+		ASSERT_GE(threads_seen.load(), 1);
+	}
+
+	TEST_F(JobsTest, ExternalThreadTest) {
+		std::atomic<int> done{ 0 };
+		jobs::counter_t counter;
+		std::thread producer([&] {
+			for (int i = 0; i < 1000; ++i) {
+				jobs::Run([&] { done.fetch_add(1); }, &counter);
+			}
+			jobs::WaitForCounter(counter);
+		});
+		producer.join();
+		ASSERT_EQ(1000, done.load());
+	}
+}
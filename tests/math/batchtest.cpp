@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <Utilities/MathBatch.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace MathUnitTest {
+	// sizes straddle the 4 and 8 wide kernels so the scalar tail is exercised too
+	const size_t BATCH_SIZES[] = { 0, 1, 3, 4, 7, 8, 9, 17, 1000 };
+
+	pn::vector<vec3f> RandomVec3s(std::mt19937& rng, const size_t n) {
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+		pn::vector<vec3f> result(n);
+		for (auto& v : result) {
+			v = vec3f(dist(rng), dist(rng), dist(rng));
+		}
+		return result;
+	}
+
+	pn::vector<vec4f> RandomVec4s(std::mt19937& rng, const size_t n) {
+		std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+		pn::vector<vec4f> result(n);
+		for (auto& v : result) {
+			v = vec4f(dist(rng), dist(rng), dist(rng), dist(rng));
+		}
+		return result;
+	}
+
+	mat4f RandomTransform(std::mt19937& rng) {
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> scale_dist(0.1f, 4.0f);
+		return SRTMatrix(
+			vec3f(scale_dist(rng), scale_dist(rng), scale_dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng))
+		);
+	}
+
+	// Compare per component relative to the vector's magnitude
+	template<typename Vec>
+	bool IsClose(const Vec& v1, const Vec& v2, const float rel_eps = 1e-5f) {
+		const float eps = rel_eps * Max(1.0f, Max(Length(v1), Length(v2)));
+		const float* p1 = &v1.x;
+		const float* p2 = &v2.x;
+		for (size_t i = 0; i < sizeof(Vec) / sizeof(float); ++i) {
+			if (abs(p1[i] - p2[i]) > eps) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	TEST(MathBatchTest, LayoutRoundTripTest) {
+		std::mt19937 rng(5);
+		for (auto n : BATCH_SIZES) {
+			auto points = RandomVec3s(rng, n);
+			auto soa = ToSoA(points);
+			ASSERT_EQ(n, Size(soa));
+			for (size_t i = 0; i < n; ++i) {
+				ASSERT_EQ(points[i].x, soa.x[i]);
+				ASSERT_EQ(points[i].y, soa.y[i]);
+				ASSERT_EQ(points[i].z, soa.z[i]);
+			}
+			ASSERT_TRUE(ToAoS(soa) == points);
+
+			auto vectors = RandomVec4s(rng, n);
+			ASSERT_TRUE(ToAoS(ToSoA(vectors)) == vectors);
+		}
+	}
+
+	TEST(MathBatchTest, TransformPointsTest) {
+		std::mt19937 rng(11);
+		for (auto n : BATCH_SIZES) {
+			auto m = RandomTransform(rng);
+			auto points = RandomVec3s(rng, n);
+
+			soa_vec3f soa = ToSoA(points);
+			TransformPoints(m, soa);
+			auto result = ToAoS(soa);
+
+			for (size_t i = 0; i < n; ++i) {
+				auto expected = (vec4f(points[i], 1.0f) * m).xyz();
+				ASSERT_TRUE(IsClose(expected, result[i]));
+			}
+		}
+	}
+
+	TEST(MathBatchTest, TransformVectorsTest) {
+		std::mt19937 rng(13);
+		for (auto n : BATCH_SIZES) {
+			auto m = RandomTransform(rng);
+			auto vectors = RandomVec3s(rng, n);
+
+			soa_vec3f soa = ToSoA(vectors);
+			TransformVectors(m, soa);
+			auto result = ToAoS(soa);
+
+			for (size_t i = 0; i < n; ++i) {
+				auto expected = (vec4f(vectors[i], 0.0f) * m).xyz();
+				ASSERT_TRUE(IsClose(expected, result[i]));
+			}
+		}
+	}
+
+	TEST(MathBatchTest, TransformVec4Test) {
+		std::mt19937 rng(17);
+		for (auto n : BATCH_SIZES) {
+			auto m = RandomTransform(rng);
+			auto vectors = RandomVec4s(rng, n);
+
+			soa_vec4f soa = ToSoA(vectors);
+			Transform(m, soa);
+			auto result = ToAoS(soa);
+
+			for (size_t i = 0; i < n; ++i) {
+				ASSERT_TRUE(IsClose(vectors[i] * m, result[i]));
+			}
+		}
+	}
+
+	TEST(MathBatchTest, SeparateOutputTest) {
+		std::mt19937 rng(19);
+		auto m = RandomTransform(rng);
+		auto in = ToSoA(RandomVec3s(rng, 37));
+		const auto original = in;
+
+		soa_vec3f out;
+		Resize(out, Size(in));
+		TransformPoints(m, in.x, in.y, in.z, out.x, out.y, out.z);
+
+		// inputs are untouched and the in place version gives the same answer
+		ASSERT_TRUE(in.x == original.x && in.y == original.y && in.z == original.z);
+		TransformPoints(m, in);
+		ASSERT_TRUE(in.x == out.x && in.y == out.y && in.z == out.z);
+	}
+
+	TEST(MathBatchTest, RotatePointsTest) {
+		std::mt19937 rng(23);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		for (auto n : BATCH_SIZES) {
+			quaternion q(dist(rng), dist(rng), dist(rng), dist(rng));
+			auto points = RandomVec3s(rng, n);
+
+			soa_vec3f soa = ToSoA(points);
+			RotatePoints(q, soa);
+			auto result = ToAoS(soa);
+
+			for (size_t i = 0; i < n; ++i) {
+				ASSERT_TRUE(IsClose(RotatePoint(points[i], q), result[i], 1e-4f));
+			}
+		}
+	}
+
+	TEST(MathBatchTest, NormalizeVectorsTest) {
+		std::mt19937 rng(29);
+		for (auto n : BATCH_SIZES) {
+			auto vectors = RandomVec3s(rng, n);
+
+			soa_vec3f soa = ToSoA(vectors);
+			NormalizeVectors(soa);
+			auto result = ToAoS(soa);
+
+			for (size_t i = 0; i < n; ++i) {
+				ASSERT_TRUE(IsClose(Normalize(vectors[i]), result[i]));
+				ASSERT_NEAR(1.0f, Length(result[i]), 1e-5f);
+			}
+		}
+	}
+}
@@ -22,7 +22,7 @@ namespace MathUnitTest {
 
 		{
 			float x = 6.0f;
-			ASSERT_FLOAT_EQ(0.19825099f, SmoothStep(edge0, edge1, x), EPS);
+			ASSERT_NEAR(0.19825099f, SmoothStep(edge0, edge1, x), EPS);
 		}
 	}
 
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <Utilities/Math.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace MathUnitTest {
+	mat4f RandomMatrix(std::mt19937& rng) {
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		mat4f m;
+		float* p = &m._00;
+		for (int i = 0; i < 16; ++i) {
+			p[i] = dist(rng);
+		}
+		return m;
+	}
+
+	mat4f RandomSRT(std::mt19937& rng) {
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> scale_dist(0.1f, 4.0f);
+		return SRTMatrix(
+			vec3f(scale_dist(rng), scale_dist(rng), scale_dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng)),
+			vec3f(dist(rng), dist(rng), dist(rng))
+		);
+	}
+
+	// Compare relative to the largest element, the kernels reorder the multiply-adds
+	bool IsClose(const mat4f& m1, const mat4f& m2, const float rel_eps = 1e-5f) {
+		const float* p1 = &m1._00;
+		float max_value = 1.0f;
+		for (int i = 0; i < 16; ++i) {
+			max_value = Max(max_value, abs(p1[i]));
+		}
+		return IsEqual(m1, m2, rel_eps * max_value);
+	}
+
+	TEST(Mat4fSIMDTest, AlignmentTest) {
+		ASSERT_EQ(static_cast<size_t>(16), alignof(mat4f));
+		ASSERT_EQ(static_cast<size_t>(64), sizeof(mat4f));
+
+		mat4f m[3];
+		for (auto& el : m) {
+			ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(&el) % 16);
+		}
+	}
+
+	TEST(Mat4fSIMDTest, MultiplyMatchesScalarTest) {
+		std::mt19937 rng(1234);
+		for (int i = 0; i < 1000; ++i) {
+			auto a = RandomMatrix(rng);
+			auto b = RandomMatrix(rng);
+			ASSERT_TRUE(IsClose(Multiply(a, b), scalar::Multiply(a, b)));
+			ASSERT_TRUE(IsClose(a * b, scalar::Multiply(a, b)));
+		}
+	}
+
+	TEST(Mat4fSIMDTest, MultiplyAssignTest) {
+		std::mt19937 rng(42);
+		for (int i = 0; i < 100; ++i) {
+			auto a = RandomMatrix(rng);
+			auto b = RandomMatrix(rng);
+			auto expected = scalar::Multiply(a, b);
+
+			auto c = a;
+			c *= b;
+			ASSERT_TRUE(IsClose(c, expected));
+
+			// aliasing the right-hand side must still use the original values
+			auto d = a;
+			d *= d;
+			ASSERT_TRUE(IsClose(d, scalar::Multiply(a, a)));
+		}
+	}
+
+	TEST(Mat4fSIMDTest, TransposeMatchesScalarTest) {
+		std::mt19937 rng(7);
+		for (int i = 0; i < 100; ++i) {
+			auto m = RandomMatrix(rng);
+			ASSERT_TRUE(Transpose(m) == scalar::Transpose(m));
+			ASSERT_TRUE(Transpose(Transpose(m)) == m);
+		}
+	}
+
+	TEST(Mat4fSIMDTest, InverseMatchesScalarTest) {
+		std::mt19937 rng(99);
+		for (int i = 0; i < 1000; ++i) {
+			auto m = RandomSRT(rng);
+			auto inv = Inverse(m);
+			ASSERT_TRUE(IsClose(inv, scalar::Inverse(m), 1e-4f));
+			ASSERT_TRUE(IsClose(m * inv, mat4f::Identity, 1e-4f));
+		}
+
+		mat4f m(1.0f, 2.0f, 3.0f, -4.0f,
+				5.0f, 6.0f, 7.0f, 8.0f,
+				9.0f, 10.0f, -11.0f, 12.0f,
+				13.0f, -14.0f, 15.0f, 16.0f);
+		ASSERT_TRUE(IsClose(Inverse(m), scalar::Inverse(m)));
+	}
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#ifdef _WIN32
 #include <DirectXMath.h>
+#endif
 #include <Utilities/Math.h>
 
 #include <string>
@@ -183,6 +185,8 @@ namespace MathUnitTest {
 	#endif*/
 	}
 
+#ifdef _WIN32
+	// checked against DirectXMath, which only ships with the Windows SDK
 	TEST(Mat4fTest, PerspectiveFovTest) {
 		mat4f m = PerspectiveFov(Rad(60.0f), 1.3f, 0.01f, 1000.0f);
 		auto m2 = DirectX::XMMatrixPerspectiveFovLH(Rad(60.0f), 1.3f, 0.01f, 1000.0f);
@@ -227,6 +231,7 @@ namespace MathUnitTest {
 			ASSERT_TRUE(m == m2);
 		}
 	}
+#endif
 
 	TEST(Mat4fTest, ToCoordinateSystemTest) {
 		vec3f p(1.0f, -3.0f, 5.0f);
@@ -259,6 +264,7 @@ namespace MathUnitTest {
 
 	} */
 
+#ifdef _WIN32
 	TEST(Mat4fTest, SRTMatrixTest) {
 		auto test = [](const vec3f& s, const vec3f& r, const vec3f& t) {
 			auto m = SRTMatrix(s, r, t);
@@ -277,4 +283,5 @@ namespace MathUnitTest {
 		}
 
 	}
+#endif
 }
\ No newline at end of file
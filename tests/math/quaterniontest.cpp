@@ -39,10 +39,9 @@ namespace MathUnitTest {
 					auto q = EulerToQuaternion(v);
 					auto e = QuaternionToEuler(q);
 
-					bool cond = IsRadianEqual(v.x, e.x, 0.01f) && IsRadianEqual(v.y, e.y, 0.01f) && IsRadianEqual(v.z, e.z, 0.01f);
-					if (!cond) {
-						auto b = 6;
-					}
+					// yaw comes back in [-pi/2, pi/2], so outside that range the angles differ from v
+					// but have to describe the same rotation
+					bool cond = IsEqual(QuaternionToRotationMatrix(q), QuaternionToRotationMatrix(EulerToQuaternion(e)), 0.001f);
 					ASSERT_TRUE(cond);
 				}
 			}
@@ -1,11 +1,6 @@
-#include "stdafx.h"
-#include "CppUnitTest.h"
-
 #include <gtest/gtest.h>
 #include <Utilities/Math.h>
 
-using namespace Microsoft::VisualStudio::CppUnitTestFramework;
-
 using namespace pn;
 
 namespace MathUnitTest {
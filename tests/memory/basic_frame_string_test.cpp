@@ -2,63 +2,66 @@
 #include <Utilities/UtilityTypes.h>
 #include <Utilities/frame_string.h>
 
+#include <cstring>
+#include <string_view>
 
 using pn::linear_allocator;
 using pn::frame_string;
+using pn::frame_wstring;
 
 namespace MemoryUnitTest {
 	TEST(BasicFrameStringTest, ConstructorTest) {
-		linear_allocator a(5);
+		linear_allocator a(1024);
 		frame_string::SetFrameAllocator(&a);
 
 		{
 			// default constructor
 			frame_string s;
-			ASSERT_TRUE(s.data == nullptr);
-			ASSERT_TRUE(s.length == 0);
-			ASSERT_TRUE(a.HasFree());
-			ASSERT_TRUE(a.HasFree(5));
+			ASSERT_EQ(0u, s.size());
+			ASSERT_TRUE(s.empty());
+			ASSERT_TRUE(s.IsInline());
+			ASSERT_STREQ("", s.c_str());
 
-			// const char* constructor
+			// const char* constructor, short enough to stay inline
 			frame_string s2("Hello");
-			ASSERT_TRUE(s2.data != nullptr);
-			ASSERT_TRUE(s2.length == 5);
-			ASSERT_FALSE(a.HasFree());
+			ASSERT_EQ(5u, s2.size());
+			ASSERT_TRUE(s2.IsInline());
+			ASSERT_TRUE(a.HasFree(1024));
 			ASSERT_EQ('H', s2[0]);
-			ASSERT_EQ('e', s2[1]);
-			ASSERT_EQ('l', s2[2]);
-			ASSERT_EQ('l', s2[3]);
 			ASSERT_EQ('o', s2[4]);
+			ASSERT_EQ('\0', s2.data()[5]);
 
 			// move constructor
 			frame_string s3(std::move(s2));
-			ASSERT_TRUE(s2.data == nullptr);
-			ASSERT_TRUE(s2.length == 0);
-
-			ASSERT_TRUE(s3.data != nullptr);
-			ASSERT_TRUE(s3.length == 5);
-			ASSERT_FALSE(a.HasFree());
-			ASSERT_EQ('H', s3[0]);
-			ASSERT_EQ('e', s3[1]);
-			ASSERT_EQ('l', s3[2]);
-			ASSERT_EQ('l', s3[3]);
-			ASSERT_EQ('o', s3[4]);
+			ASSERT_EQ(0u, s2.size());
+			ASSERT_STREQ("", s2.c_str());
+			ASSERT_EQ(5u, s3.size());
+			ASSERT_TRUE(s3.IsInline());
+			ASSERT_STREQ("Hello", s3.c_str());
 		}
 
-		a.Release();
-
 		{
-			frame_string s("ba");
-			ASSERT_TRUE(a.HasFree(3));
+			// past the inline buffer, into the allocator
+			const std::string text(frame_string::INLINE_CAPACITY + 1, 'x');
+			frame_string s(text);
+			ASSERT_FALSE(s.IsInline());
+			ASSERT_FALSE(a.HasFree(1024));
+			ASSERT_EQ(text, s.c_str());
+
+			// moving hands the arena memory over
+			const char* memory = s.data();
+			frame_string s2(std::move(s));
+			ASSERT_EQ(memory, s2.data());
+			ASSERT_TRUE(s.IsInline());
 
 			// copy constructor
-			frame_string s2(s);
-			ASSERT_TRUE(a.HasFree(1));
-			ASSERT_TRUE(s[0] == s2[0]);
-			ASSERT_TRUE(s[1] == s2[1]);
+			frame_string s3(s2);
+			ASSERT_NE(s2.data(), s3.data());
+			ASSERT_TRUE(s2 == s3);
 		}
 
-		
+		a.Release();
+		frame_string::SetFrameAllocator(nullptr);
 	}
 
 	TEST(BasicFrameStringTest, EqualityTest) {
@@ -79,6 +82,14 @@ namespace MemoryUnitTest {
 
 		std::string stds("this is a string.");
 		ASSERT_TRUE(stds == s3);
+		ASSERT_TRUE("this is a string." == s3);
+
+		// a shorter or longer string is never equal, whatever its prefix
+		ASSERT_FALSE(s3 == "this");
+		ASSERT_FALSE(s3 == "this is a string..");
+		ASSERT_TRUE(s3 == std::string_view("this is a string."));
+
+		frame_string::SetFrameAllocator(nullptr);
 	}
 
 	TEST(BasicFrameStringTest, EmptyStringTest) {
@@ -90,43 +101,136 @@ namespace MemoryUnitTest {
 
 		ASSERT_TRUE(s == s2);
 		ASSERT_TRUE(s == "");
-		ASSERT_TRUE(0 == s.length);
-		ASSERT_TRUE(0 == s2.length);
+		ASSERT_EQ(0u, s.size());
+		ASSERT_EQ(0u, s2.size());
+		ASSERT_TRUE(s.View().empty());
+
+		frame_string::SetFrameAllocator(nullptr);
 	}
 
 	TEST(BasicFrameStringTest, ConcatenationTest) {
-		linear_allocator a(20);
+		linear_allocator a(1024);
 		frame_string::SetFrameAllocator(&a);
 
 		{
 			frame_string s("thisa");
 			frame_string s2("THISA");
 			auto b = s + s2;
-
 			ASSERT_TRUE(b == "thisaTHISA");
-			ASSERT_FALSE(a.HasFree());
+			ASSERT_TRUE(s == "thisa");
 		}
 
-		a.Release();
-
 		{
 			frame_string s("thisa");
 			auto b = "THISA" + s;
-
 			ASSERT_TRUE(b == "THISAthisa");
-			ASSERT_TRUE(a.HasFree(5));
 		}
 
-		a.Release();
-
 		{
 			frame_string s("thisa");
 			pn::string s2("THISA");
 			auto b = s + s2;
-
 			ASSERT_TRUE(b == "thisaTHISA");
-			ASSERT_TRUE(a.HasFree(5));
 		}
 
+		// nothing short of the inline buffer touches the allocator
+		ASSERT_TRUE(a.HasFree(1024));
+
+		a.Release();
+		frame_string::SetFrameAllocator(nullptr);
+	}
+
+	TEST(BasicFrameStringTest, AppendTest) {
+		linear_allocator a(4096);
+		frame_string::SetFrameAllocator(&a);
+
+		frame_string s;
+		std::string expected;
+		for (int i = 0; i < 100; ++i) {
+			s += "ab";
+			s += 'c';
+			expected += "abc";
+			ASSERT_EQ(expected.size(), s.size());
+			ASSERT_GE(s.Capacity(), s.size());
+			ASSERT_EQ('\0', s.data()[s.size()]);
+		}
+		ASSERT_TRUE(s == expected);
+		ASSERT_FALSE(s.IsInline());
+
+		// growth is geometric, a few reallocations at most
+		ASSERT_TRUE(a.HasFree(4096 - 4 * expected.size()));
+
+		// clearing keeps the memory
+		const auto capacity = s.Capacity();
+		s.Clear();
+		ASSERT_TRUE(s.empty());
+		ASSERT_EQ(capacity, s.Capacity());
+
+		a.Release();
+		frame_string::SetFrameAllocator(nullptr);
+	}
+
+	TEST(BasicFrameStringTest, FormatTest) {
+		linear_allocator a(4096);
+		frame_string::SetFrameAllocator(&a);
+
+		frame_string s("mesh ");
+		s.Format("{} of {}: {:.2f}", 3, "sphere", 0.5f);
+		ASSERT_STREQ("mesh 3 of sphere: 0.50", s.c_str());
+		ASSERT_TRUE(s.IsInline());
+
+		// growing in the middle of formatting
+		s.Format(" {}", std::string(200, 'z'));
+		ASSERT_EQ(22u + 201u, s.size());
+		ASSERT_EQ('z', s[s.size() - 1]);
+		ASSERT_EQ('\0', s.data()[s.size()]);
+
+		auto label = pn::FrameFormat("[{}]", 42);
+		ASSERT_TRUE(label == "[42]");
+
+		a.Release();
+		frame_string::SetFrameAllocator(nullptr);
+	}
+
+	// Debug builds assert when the allocator runs out
+#ifdef NDEBUG
+	TEST(BasicFrameStringTest, FormatOutOfMemoryTest) {
+		linear_allocator a(256);
+		frame_string::SetFrameAllocator(&a);
+
+		// the first argument fits in the allocator, the second doesn't and is cut off
+		frame_string s;
+		s.Format("{}{}", std::string(100, 'a'), std::string(1000, 'b'));
+		ASSERT_LE(s.size(), s.Capacity());
+		ASSERT_EQ('\0', s.data()[s.size()]);
+		ASSERT_EQ(std::string(100, 'a'), std::string(s.data(), 100));
+
+		// nothing left at all, only the inline buffer
+		frame_string s2;
+		s2.Format("{}", std::string(1000, 'c'));
+		ASSERT_TRUE(s2.IsInline());
+		ASSERT_EQ(std::string(frame_string::INLINE_CAPACITY, 'c'), s2.c_str());
+
+		a.Release();
+		frame_string::SetFrameAllocator(nullptr);
+	}
+#endif
+
+	TEST(BasicFrameStringTest, WideStringTest) {
+		linear_allocator a(4096);
+		frame_wstring::SetFrameAllocator(&a);
+
+		frame_wstring s(L"wide");
+		ASSERT_EQ(4u, s.size());
+		ASSERT_TRUE(s == L"wide");
+		ASSERT_FALSE(s == L"wid");
+
+		auto b = s + L" string that's too long to stay inline";
+		ASSERT_FALSE(b.IsInline());
+		ASSERT_TRUE(b == std::wstring(L"wide string that's too long to stay inline"));
+		ASSERT_EQ(L'\0', b.data()[b.size()]);
+
+		a.Release();
+		frame_wstring::SetFrameAllocator(nullptr);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <System/Jobs.h>
+#include <Utilities/FrameArena.h>
+#include <Utilities/frame_string.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace pn;
+
+namespace MemoryUnitTest {
+	class FrameArenaTest : public ::testing::Test {
+	protected:
+		void TearDown() override {
+			ShutdownFrameArenas();
+			jobs::Shutdown();
+		}
+	};
+
+	struct vertex_t {
+		float x, y, z;
+	};
+
+	TEST_F(FrameArenaTest, NotInitializedTest) {
+		ASSERT_FALSE(IsFrameArenaInitialized());
+		ASSERT_EQ(nullptr, FrameAllocate(16));
+		AdvanceFrameArenas();
+		ASSERT_EQ(0u, GetFrameArenaStats().frame);
+	}
+
+	TEST_F(FrameArenaTest, AlignmentTest) {
+		InitFrameArenas(4096);
+		FrameAllocate(1, 1);
+		for (const size_t alignment : { 2, 4, 8, 16, 32, 64, 128 }) {
+			auto* memory = FrameAllocate(3, alignment);
+			ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(memory) % alignment);
+		}
+
+		auto* vertices = FrameAllocateArray<vertex_t>(10);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(vertices) % alignof(vertex_t));
+		auto* v = FrameCreate<vertex_t>(vertex_t{ 1.0f, 2.0f, 3.0f });
+		ASSERT_EQ(2.0f, v->y);
+	}
+
+	// What one frame writes survives the next one, then its arena comes around again
+	TEST_F(FrameArenaTest, RotationTest) {
+		InitFrameArenas(1024, 2);
+		auto* first = static_cast<char*>(FrameAllocate(16));
+		strcpy(first, "frame zero");
+		AdvanceFrameArenas();
+
+		auto* second = static_cast<char*>(FrameAllocate(16));
+		ASSERT_NE(first, second);
+		ASSERT_STREQ("frame zero", first);
+		AdvanceFrameArenas();
+
+		ASSERT_EQ(first, FrameAllocate(16));
+		ASSERT_EQ(2u, GetFrameArenaStats().frame);
+	}
+
+	TEST_F(FrameArenaTest, OverflowTest) {
+		InitFrameArenas(256, 2);
+		FrameAllocate(200);
+		auto* big = static_cast<char*>(FrameAllocate(1000));
+		ASSERT_NE(nullptr, big);
+		memset(big, 1, 1000);
+		AdvanceFrameArenas();
+
+		auto stats = GetFrameArenaStats();
+		ASSERT_EQ(1000u, stats.overflow);
+		ASSERT_EQ(1u, stats.overflow_count);
+		ASSERT_EQ(1200u, stats.used);
+
+		FrameAllocate(10);
+		AdvanceFrameArenas();
+		stats = GetFrameArenaStats();
+		ASSERT_EQ(0u, stats.overflow);
+		ASSERT_EQ(10u, stats.used);
+		ASSERT_EQ(1200u, stats.peak_used);
+	}
+
+	TEST_F(FrameArenaTest, JobThreadsTest) {
+		jobs::Init(3);
+		InitFrameArenas(64 * 1024);
+		ASSERT_EQ(4 * 64 * 1024u, GetFrameArenaStats().capacity);
+
+		constexpr size_t COUNT = 4096;
+		int* values[COUNT];
+		jobs::ParallelFor(0, COUNT, 16, [&](const size_t begin, const size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				values[i] = FrameCreate<int>(static_cast<int>(i));
+			}
+		});
+		for (size_t i = 0; i < COUNT; ++i) {
+			ASSERT_EQ(static_cast<int>(i), *values[i]);
+		}
+
+		AdvanceFrameArenas();
+		const auto stats = GetFrameArenaStats();
+		ASSERT_EQ(COUNT * sizeof(int), stats.used);
+		ASSERT_EQ(0u, stats.overflow);
+	}
+
+	TEST_F(FrameArenaTest, FrameStringTest) {
+		InitFrameArenas();
+		frame_string::SetFrameAllocator(nullptr);
+		frame_string name("mesh_");
+		auto label = name + "sphere";
+		ASSERT_TRUE(label == "mesh_sphere");
+	}
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <Utilities/Heap.h>
+
+#include <cstring>
+#include <random>
+
+using namespace pn;
+
+namespace MemoryUnitTest {
+	TEST(HeapTest, AllocateAndFreeTest) {
+		tlsf_heap heap(64 * 1024 * 1024);
+		ASSERT_EQ(0u, heap.GetStats().capacity);
+
+		auto* a = static_cast<char*>(heap.Allocate(100));
+		auto* b = static_cast<char*>(heap.Allocate(1));
+		auto* c = static_cast<char*>(heap.Allocate(5000));
+		ASSERT_NE(nullptr, a);
+		ASSERT_NE(nullptr, b);
+		ASSERT_NE(nullptr, c);
+		memset(a, 1, 100);
+		memset(b, 2, 1);
+		memset(c, 3, 5000);
+		ASSERT_EQ(1, a[99]);
+		ASSERT_EQ(3, c[0]);
+
+		auto stats = heap.GetStats();
+		ASSERT_EQ(3u, stats.allocations);
+		ASSERT_EQ(112u + 16u + 5008u, stats.used);
+		ASSERT_EQ(DEFAULT_HEAP_REGION_SIZE, stats.capacity);
+
+		heap.Free(b);
+		heap.Free(a);
+		heap.Free(c);
+		stats = heap.GetStats();
+		ASSERT_EQ(0u, stats.allocations);
+		ASSERT_EQ(0u, stats.used);
+		ASSERT_EQ(5136u, stats.peak_used);
+		// everything merged back into one block, less its header and the sentinel
+		ASSERT_EQ(stats.capacity - 2 * HEAP_ALIGNMENT, stats.free);
+	}
+
+	TEST(HeapTest, AlignmentTest) {
+		tlsf_heap heap(64 * 1024 * 1024);
+		heap.Allocate(8);
+		for (const size_t alignment : { 16, 32, 64, 256, 4096 }) {
+			auto* memory = heap.Allocate(24, alignment);
+			ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(memory) % alignment);
+		}
+	}
+
+	TEST(HeapTest, GrowTest) {
+		tlsf_heap heap(64 * 1024 * 1024, 1024 * 1024);
+		auto* small = heap.Allocate(512 * 1024);
+		auto* big = heap.Allocate(5 * 1024 * 1024);
+		ASSERT_NE(nullptr, small);
+		ASSERT_NE(nullptr, big);
+		memset(big, 7, 5 * 1024 * 1024);
+		ASSERT_EQ(1u, heap.GetStats().regions);
+
+		heap.Free(small);
+		heap.Free(big);
+		const auto stats = heap.GetStats();
+		// the arena grows in place, so it's still one block
+		ASSERT_EQ(stats.capacity - 2 * HEAP_ALIGNMENT, stats.free);
+
+		ASSERT_EQ(nullptr, heap.Allocate(128 * 1024 * 1024));
+	}
+
+	TEST(HeapTest, ExternalRegionTest) {
+		alignas(16) static char region[4096];
+		tlsf_heap heap;
+		ASSERT_EQ(nullptr, heap.Allocate(16));
+
+		heap.AddRegion(region, sizeof(region));
+		auto* a = heap.Allocate(2000);
+		ASSERT_TRUE(a >= region && a < region + sizeof(region));
+		ASSERT_EQ(nullptr, heap.Allocate(3000));
+		heap.Free(a);
+		ASSERT_NE(nullptr, heap.Allocate(3000));
+	}
+
+	// Random sizes and alignments, freed in random order, contents checked before every free
+	TEST(HeapTest, RandomTest) {
+		tlsf_heap heap(256 * 1024 * 1024, 256 * 1024);
+		std::mt19937 random(42);
+		struct allocation_t { unsigned char* memory; size_t size; unsigned char fill; };
+		pn::vector<allocation_t> live;
+
+		for (int i = 0; i < 20000; ++i) {
+			if (live.empty() || random() % 3 != 0) {
+				const size_t size = (random() % 8 == 0) ? random() % 100000 : random() % 300;
+				const size_t alignment = size_t(1) << (random() % 8);
+				auto* memory = static_cast<unsigned char*>(heap.Allocate(size, alignment));
+				ASSERT_NE(nullptr, memory);
+				ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(memory) % alignment);
+				const auto fill = static_cast<unsigned char>(i);
+				memset(memory, fill, size);
+				PushBack(live, allocation_t{ memory, size, fill });
+			}
+			else {
+				const size_t index = random() % live.size();
+				const auto allocation = live[index];
+				for (size_t b = 0; b < allocation.size; ++b) {
+					ASSERT_EQ(allocation.fill, allocation.memory[b]);
+				}
+				heap.Free(allocation.memory);
+				live[index] = live.back();
+				live.pop_back();
+			}
+		}
+		for (const auto& allocation : live) {
+			heap.Free(allocation.memory);
+		}
+
+		const auto stats = heap.GetStats();
+		ASSERT_EQ(0u, stats.allocations);
+		ASSERT_EQ(stats.capacity - 2 * HEAP_ALIGNMENT, stats.free);
+	}
+
+	TEST(HeapTest, ContainerTest) {
+		tlsf_heap heap(64 * 1024 * 1024);
+		{
+			heap_vector<int> numbers{ heap_allocator<int>(&heap) };
+			for (int i = 0; i < 1000; ++i) {
+				PushBack(numbers, i);
+			}
+			ASSERT_EQ(999, Pop(numbers));
+
+			heap_map<int, heap_string> names{ heap_allocator<std::pair<const int, heap_string>>(&heap) };
+			names.emplace(1, heap_string("a name long enough to not fit in the string itself", heap_allocator<char>(&heap)));
+			ASSERT_TRUE(Contains(names, 1));
+
+			ASSERT_GE(heap.GetStats().used, 1000 * sizeof(int));
+		}
+		ASSERT_EQ(0u, heap.GetStats().allocations);
+
+		// default constructed, on the global heap
+		heap_vector<int> global;
+		PushBack(global, 1);
+		ASSERT_EQ(1u, Size(global));
+	}
+}
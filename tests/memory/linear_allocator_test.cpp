@@ -36,4 +36,16 @@ namespace MemoryUnitTest {
 		ASSERT_TRUE(a.HasFree());
 		ASSERT_TRUE(a.HasFree(16));
 	}
+
+	TEST(LinearAllocatorTest, AlignmentTest) {
+		linear_allocator a(64);
+
+		a.Allocate(1);
+		auto* d = a.Create<double>(2.5);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(d) % alignof(double));
+		ASSERT_EQ(2.5, *d);
+
+		auto* b = a.Allocate(4, 16);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 16);
+	}
 }
\ No newline at end of file
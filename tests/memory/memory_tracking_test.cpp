@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <Utilities/Heap.h>
+#include <Utilities/Memory.h>
+#include <Utilities/MemoryTracking.h>
+
+#include <cstring>
+
+using namespace pn;
+
+// The counters are global, so each test works with the difference it makes
+namespace MemoryUnitTest {
+	TEST(MemoryTrackingTest, TagNameTest) {
+		for (size_t i = 0; i < static_cast<size_t>(memory_tag_t::COUNT); ++i) {
+			const auto tag = static_cast<memory_tag_t>(i);
+			memory_tag_t parsed;
+			ASSERT_TRUE(MemoryTagFromName(MemoryTagName(tag), parsed));
+			ASSERT_EQ(tag, parsed);
+		}
+		memory_tag_t parsed;
+		ASSERT_FALSE(MemoryTagFromName("nothing", parsed));
+		ASSERT_STREQ("untracked", MemoryTagName(UNTRACKED_MEMORY));
+	}
+
+	TEST(MemoryTrackingTest, ScopeTest) {
+		ASSERT_EQ(memory_tag_t::GENERAL, CurrentMemoryTag());
+		{
+			memory_tag_scope mesh(memory_tag_t::MESH);
+			ASSERT_EQ(memory_tag_t::MESH, CurrentMemoryTag());
+			{
+				memory_tag_scope ui(memory_tag_t::UI);
+				ASSERT_EQ(memory_tag_t::UI, CurrentMemoryTag());
+			}
+			ASSERT_EQ(memory_tag_t::MESH, CurrentMemoryTag());
+		}
+		ASSERT_EQ(memory_tag_t::GENERAL, CurrentMemoryTag());
+	}
+
+	TEST(MemoryTrackingTest, TrackedAllocateTest) {
+		const auto before = GetMemoryTagStats(memory_tag_t::UI);
+
+		auto* memory = static_cast<char*>(TrackedAllocate(1000, memory_tag_t::UI));
+		ASSERT_NE(nullptr, memory);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(memory) % alignof(std::max_align_t));
+		memset(memory, 1, 1000);
+
+		auto stats = GetMemoryTagStats(memory_tag_t::UI);
+		ASSERT_EQ(before.current + 1000, stats.current);
+		ASSERT_EQ(before.live_allocations + 1, stats.live_allocations);
+		ASSERT_EQ(before.total_allocations + 1, stats.total_allocations);
+		ASSERT_GE(stats.peak, stats.current);
+
+		TrackedFree(memory);
+		stats = GetMemoryTagStats(memory_tag_t::UI);
+		ASSERT_EQ(before.current, stats.current);
+		ASSERT_EQ(before.live_allocations, stats.live_allocations);
+		ASSERT_EQ(before.total_allocations + 1, stats.total_allocations);
+
+		TrackedFree(nullptr);
+	}
+
+	TEST(MemoryTrackingTest, HeapTagTest) {
+		const auto before = GetMemoryTagStats(memory_tag_t::RENDERING);
+		{
+			tlsf_heap heap(64 * 1024 * 1024, DEFAULT_HEAP_REGION_SIZE, memory_tag_t::RENDERING);
+			void* a = heap.Allocate(100);
+			void* b = heap.Allocate(5000);
+
+			// charged per block, the arena under the heap isn't counted
+			auto stats = GetMemoryTagStats(memory_tag_t::RENDERING);
+			ASSERT_EQ(before.current + heap.GetStats().used, stats.current);
+			ASSERT_EQ(before.live_allocations + 2, stats.live_allocations);
+
+			heap.Free(a);
+			heap.Free(b);
+		}
+		ASSERT_EQ(before.current, GetMemoryTagStats(memory_tag_t::RENDERING).current);
+	}
+
+	TEST(MemoryTrackingTest, ArenaTagTest) {
+		const auto before = GetMemoryTagStats(memory_tag_t::RESOURCES);
+		{
+			linear_allocator allocator(16 * 1024 * 1024, 0, memory_tag_t::RESOURCES);
+			ASSERT_NE(nullptr, allocator.Allocate(200 * 1024));
+
+			// committed pages count, not allocations
+			auto stats = GetMemoryTagStats(memory_tag_t::RESOURCES);
+			ASSERT_EQ(before.current + allocator.Committed(), stats.current);
+			ASSERT_EQ(before.live_allocations, stats.live_allocations);
+
+			allocator.Release();
+			ASSERT_EQ(before.current, GetMemoryTagStats(memory_tag_t::RESOURCES).current);
+
+			ASSERT_NE(nullptr, allocator.Allocate(100));
+		}
+		ASSERT_EQ(before.current, GetMemoryTagStats(memory_tag_t::RESOURCES).current);
+	}
+
+	TEST(MemoryTrackingTest, PoolTagTest) {
+		struct slot_t { char bytes[64]; };
+		constexpr size_t CHUNK_SIZE = 1024;
+		constexpr size_t CHUNK_BYTES = CHUNK_SIZE * sizeof(slot_t);
+
+		const auto mesh_before = GetMemoryTagStats(memory_tag_t::MESH);
+		const auto ui_before = GetMemoryTagStats(memory_tag_t::UI);
+		{
+			// with TRACK_GLOBAL_HEAP the pool's own bookkeeping goes to UI, the chunk mustn't
+			memory_tag_scope ui(memory_tag_t::UI);
+			pool_allocator<slot_t> pool(CHUNK_SIZE, memory_tag_t::MESH);
+			auto* slot = pool.Create();
+			ASSERT_EQ(1u, pool.GetStats().chunks);
+
+			// the chunk and a few magazines, once
+			const auto mesh = GetMemoryTagStats(memory_tag_t::MESH);
+			ASSERT_GE(mesh.current, mesh_before.current + CHUNK_BYTES);
+			ASSERT_LT(mesh.current, mesh_before.current + CHUNK_BYTES + 1024);
+			ASSERT_LT(GetMemoryTagStats(memory_tag_t::UI).current, ui_before.current + CHUNK_BYTES);
+
+			pool.Release(slot);
+		}
+		ASSERT_EQ(mesh_before.current, GetMemoryTagStats(memory_tag_t::MESH).current);
+	}
+
+	TEST(MemoryTrackingTest, FrameCountTest) {
+		// closes whatever earlier tests allocated, then an empty frame
+		EndMemoryFrame();
+		EndMemoryFrame();
+		ASSERT_EQ(0u, GetMemoryTagStats(memory_tag_t::UI).frame_allocations);
+
+		TrackAllocation(memory_tag_t::UI, 64);
+		TrackAllocation(memory_tag_t::UI, 32);
+		TrackFree(memory_tag_t::UI, 64);
+		TrackMemory(memory_tag_t::UI, 4096);	// bulk memory isn't an allocation
+
+		// the frame's counts only show once it's closed
+		ASSERT_EQ(0u, GetMemoryTagStats(memory_tag_t::UI).frame_allocations);
+		EndMemoryFrame();
+		auto stats = GetMemoryTagStats(memory_tag_t::UI);
+		ASSERT_EQ(2u, stats.frame_allocations);
+		ASSERT_EQ(96u, stats.frame_bytes);
+
+		EndMemoryFrame();
+		stats = GetMemoryTagStats(memory_tag_t::UI);
+		ASSERT_EQ(0u, stats.frame_allocations);
+		ASSERT_EQ(0u, stats.frame_bytes);
+
+		TrackFree(memory_tag_t::UI, 32);
+		TrackMemory(memory_tag_t::UI, -4096);
+	}
+
+	TEST(MemoryTrackingTest, BudgetTest) {
+		const auto current = GetMemoryTagStats(memory_tag_t::MESH).current;
+		SetMemoryBudget(memory_tag_t::MESH, current + 1024);
+		ASSERT_EQ(current + 1024, GetMemoryTagStats(memory_tag_t::MESH).budget);
+
+		TrackMemory(memory_tag_t::MESH, 2048);
+		EndMemoryFrame();	// logs the tag going over
+		ASSERT_GT(GetMemoryTagStats(memory_tag_t::MESH).current, GetMemoryTagStats(memory_tag_t::MESH).budget);
+		TrackMemory(memory_tag_t::MESH, -2048);
+		EndMemoryFrame();
+
+		SetMemoryBudget(memory_tag_t::MESH, 0);
+		ASSERT_EQ(0u, GetMemoryTagStats(memory_tag_t::MESH).budget);
+	}
+
+	TEST(MemoryTrackingTest, UntrackedTest) {
+		TrackAllocation(UNTRACKED_MEMORY, 100);
+		TrackMemory(UNTRACKED_MEMORY, 100);
+		SetMemoryBudget(UNTRACKED_MEMORY, 100);
+		const auto stats = GetMemoryTagStats(UNTRACKED_MEMORY);
+		ASSERT_EQ(0u, stats.current);
+		ASSERT_EQ(0u, stats.budget);
+	}
+
+	TEST(MemoryTrackingTest, ReportTest) {
+		const auto json = MemoryReportJson();
+		for (size_t i = 0; i < static_cast<size_t>(memory_tag_t::COUNT); ++i) {
+			const auto name = string("\"") + MemoryTagName(static_cast<memory_tag_t>(i)) + "\"";
+			ASSERT_NE(string::npos, json.find(name));
+		}
+		ASSERT_NE(string::npos, json.find("\"peak\""));
+		ASSERT_EQ('{', json.front());
+	}
+}
@@ -1,32 +1,41 @@
 #include <gtest/gtest.h>
 #include <Utilities/Memory.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 using pn::pool_allocator;
 
 namespace MemoryUnitTest
-{		
+{
 	struct blob {
 		int i; int j; int k; double d; float f;
 		blob() {}
 		blob(int i, int j, int k, double d, float f) : i(i), j(j), k(k), d(d), f(f) {
-				
+
 		}
 	};
-		
+
+	struct alignas(64) wide_blob {
+		char bytes[64];
+	};
+
 	TEST(PoolAllocatorTest, ConstructorTest) {
 		{
 			pool_allocator<char> a(5);
-			ASSERT_TRUE(a.HasFree());
+			ASSERT_EQ(0u, a.GetStats().live);
+			ASSERT_EQ(0u, a.GetStats().chunks);
 		}
 
 		{
 			pool_allocator<int> a(50);
-			ASSERT_TRUE(a.HasFree());
+			ASSERT_EQ(0u, a.GetStats().capacity);
 		}
 
 		{
 			pool_allocator<blob> a(1024);
-			ASSERT_TRUE(a.HasFree());
+			ASSERT_EQ(0u, a.GetStats().peak_live);
 		}
 	}
 
@@ -35,22 +44,116 @@ namespace MemoryUnitTest
 
 		blob* b = a.Create();
 		ASSERT_TRUE(b != nullptr);
-		ASSERT_TRUE(a.HasFree());
+		ASSERT_EQ(1u, a.GetStats().chunks);
 
 		blob* c = a.Create(1, 2, 3, 10.4, 15.4f);
 		ASSERT_TRUE(c != nullptr);
-		ASSERT_FALSE(a.HasFree());
 		ASSERT_EQ(1, c->i);
 		ASSERT_EQ(2, c->j);
 		ASSERT_EQ(3, c->k);
 		ASSERT_EQ(10.4, c->d);
 		ASSERT_EQ(15.4f, c->f);
 
+		// the first chunk is used up, the pool grows instead of failing
 		blob* d = a.Create();
-		ASSERT_TRUE(d == nullptr);
-		ASSERT_FALSE(a.HasFree());
+		ASSERT_TRUE(d != nullptr);
+		ASSERT_EQ(2u, a.GetStats().chunks);
+		ASSERT_EQ(4u, a.GetStats().capacity);
 
 		a.Release(c);
-		ASSERT_TRUE(a.HasFree());
+		blob* e = a.Create();
+		ASSERT_EQ(c, e);
+
+		a.Release(b);
+		a.Release(d);
+		a.Release(e);
+	}
+
+	TEST(PoolAllocatorTest, AlignmentTest) {
+		pool_allocator<wide_blob> a(3);
+		for (int i = 0; i < 10; ++i) {
+			auto* w = a.Create();
+			ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(w) % alignof(wide_blob));
+		}
+	}
+
+	TEST(PoolAllocatorTest, StatsTest) {
+		pool_allocator<int> a(16);
+		std::vector<int*> objects;
+		for (int i = 0; i < 100; ++i) {
+			objects.push_back(a.Create(i));
+		}
+		ASSERT_EQ(100u, a.GetStats().live);
+		for (int i = 0; i < 60; ++i) {
+			a.Release(objects.back());
+			objects.pop_back();
+		}
+
+		const auto stats = a.GetStats();
+		ASSERT_EQ(40u, stats.live);
+		ASSERT_EQ(100u, stats.peak_live);
+		ASSERT_EQ(stats.chunks * 16, stats.capacity);
+		ASSERT_GE(stats.capacity, 100u);
+	}
+
+	// Objects made on one thread and released on another go back through the depot, and the
+	// pool only grows as far as the peak number of live objects needs
+	TEST(PoolAllocatorTest, CrossThreadReleaseTest) {
+		constexpr int COUNT = 1000;
+		constexpr int ROUNDS = 20;
+		pool_allocator<blob> a(64);
+
+		for (int round = 0; round < ROUNDS; ++round) {
+			std::vector<blob*> objects;
+			for (int i = 0; i < COUNT; ++i) {
+				objects.push_back(a.Create(i, round, 0, 0.0, 0.0f));
+			}
+			ASSERT_EQ(static_cast<size_t>(COUNT), a.GetStats().live);
+			std::thread releaser([&]() {
+				for (auto* object : objects) {
+					a.Release(object);
+				}
+			});
+			releaser.join();
+		}
+
+		const auto stats = a.GetStats();
+		ASSERT_EQ(0u, stats.live);
+		ASSERT_EQ(static_cast<size_t>(COUNT), stats.peak_live);
+		// every slot released on the other thread came back, so there's at most slack of a few magazines
+		ASSERT_LT(stats.capacity, static_cast<size_t>(2 * COUNT));
+	}
+
+	TEST(PoolAllocatorTest, ConcurrentChurnTest) {
+		constexpr int THREADS = 4;
+		constexpr int ITERATIONS = 20000;
+		pool_allocator<blob> a(32);
+		std::atomic<bool> corrupted{ false };
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREADS; ++t) {
+			threads.emplace_back([&, t]() {
+				std::vector<blob*> objects;
+				for (int i = 0; i < ITERATIONS; ++i) {
+					objects.push_back(a.Create(t, i, 0, 0.0, 0.0f));
+					if (objects.size() > 50) {
+						for (auto* object : objects) {
+							if (object->i != t) corrupted = true;
+							a.Release(object);
+						}
+						objects.clear();
+					}
+				}
+				for (auto* object : objects) {
+					a.Release(object);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		ASSERT_FALSE(corrupted);
+		ASSERT_EQ(0u, a.GetStats().live);
 	}
-}
\ No newline at end of file
+}
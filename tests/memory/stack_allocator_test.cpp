@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <Utilities/Memory.h>
+
+#include <thread>
+
+using pn::stack_allocator;
+using pn::stack_allocator_scope;
+
+namespace MemoryUnitTest {
+	TEST(StackAllocatorTest, MarkerTest) {
+		stack_allocator a(256);
+
+		a.Allocate(16);
+		const auto marker = a.GetMarker();
+		ASSERT_EQ(16u, marker);
+
+		a.Allocate(64);
+		a.Allocate(64);
+		ASSERT_EQ(144u, a.Used());
+
+		a.FreeToMarker(marker);
+		ASSERT_EQ(16u, a.Used());
+		ASSERT_EQ(144u, a.Peak());
+
+		a.Release();
+		ASSERT_EQ(0u, a.Used());
+		ASSERT_TRUE(a.HasFree(256));
+	}
+
+	TEST(StackAllocatorTest, ScopeTest) {
+		stack_allocator a(256);
+		a.Allocate(8, 1);
+		{
+			stack_allocator_scope outer(a);
+			a.Allocate(32, 1);
+			{
+				stack_allocator_scope inner(a);
+				a.Allocate(100, 1);
+				ASSERT_EQ(8u + 32u + 100u, a.Used());
+			}
+			ASSERT_EQ(8u + 32u, a.Used());
+		}
+		ASSERT_EQ(8u, a.Used());
+	}
+
+	TEST(StackAllocatorTest, AlignedArrayTest) {
+		stack_allocator a(1024);
+		a.Allocate(1, 1);
+
+		auto* doubles = a.AllocateArray<double>(10);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(doubles) % alignof(double));
+		auto* wide = a.Allocate(8, 64);
+		ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(wide) % 64);
+
+		auto* i = a.Create<int>(7);
+		ASSERT_EQ(7, *i);
+	}
+
+#ifndef NDEBUG
+	TEST(StackAllocatorTest, PoisonTest) {
+		stack_allocator a(64);
+		auto* bytes = a.AllocateArray<unsigned char>(16);
+		memset(bytes, 0, 16);
+		a.Release();
+		for (int i = 0; i < 16; ++i) {
+			ASSERT_EQ(pn::STACK_ALLOCATOR_POISON, bytes[i]);
+		}
+	}
+#endif
+
+	TEST(StackAllocatorTest, ScratchStackTest) {
+		auto& scratch = pn::ScratchStack();
+		ASSERT_EQ(pn::SCRATCH_STACK_SIZE, scratch.Capacity());
+		ASSERT_EQ(&scratch, &pn::ScratchStack());
+
+		stack_allocator* other = nullptr;
+		std::thread([&]() { other = &pn::ScratchStack(); }).join();
+		ASSERT_NE(&scratch, other);
+	}
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <Utilities/Memory.h>
+#include <Utilities/VirtualMemory.h>
+
+#include <cstring>
+
+using pn::virtual_arena;
+
+namespace MemoryUnitTest {
+	TEST(VirtualArenaTest, ReserveTest) {
+		// far more than the test machine is expected to have free, only reserved
+		virtual_arena a(size_t(64) * 1024 * 1024 * 1024);
+		ASSERT_NE(nullptr, a.Base());
+		ASSERT_EQ(0u, a.Committed());
+		ASSERT_EQ(0u, a.Reserved() % pn::PageSize());
+	}
+
+	TEST(VirtualArenaTest, CommitTest) {
+		virtual_arena a(16 * 1024 * 1024, 0);
+		char* base = a.Base();
+
+		ASSERT_TRUE(a.EnsureCommitted(100));
+		ASSERT_GE(a.Committed(), 100u);
+		ASSERT_EQ(0u, a.Committed() % pn::PageSize());
+		memset(base, 1, a.Committed());
+
+		ASSERT_TRUE(a.EnsureCommitted(3 * 1024 * 1024));
+		ASSERT_EQ(base, a.Base());
+		memset(base, 2, 3 * 1024 * 1024);
+		ASSERT_EQ(2, base[3 * 1024 * 1024 - 1]);
+
+		ASSERT_FALSE(a.EnsureCommitted(a.Reserved() + 1));
+		ASSERT_TRUE(a.EnsureCommitted(a.Reserved()));
+	}
+
+	TEST(VirtualArenaTest, DecommitTest) {
+		virtual_arena a(16 * 1024 * 1024, 1024 * 1024);
+		ASSERT_TRUE(a.EnsureCommitted(8 * 1024 * 1024));
+		a.Decommit();
+		ASSERT_EQ(1024u * 1024u, a.Committed());
+		ASSERT_EQ(8u * 1024u * 1024u, a.PeakCommitted());
+
+		// back under the watermark nothing is given back
+		a.Decommit();
+		ASSERT_EQ(1024u * 1024u, a.Committed());
+
+		ASSERT_TRUE(a.EnsureCommitted(2 * 1024 * 1024));
+		a.Base()[2 * 1024 * 1024 - 1] = 5;
+		ASSERT_EQ(5, a.Base()[2 * 1024 * 1024 - 1]);
+	}
+
+	TEST(VirtualArenaTest, LinearAllocatorCommitTest) {
+		pn::linear_allocator a(256 * 1024 * 1024, 0);
+		ASSERT_EQ(0u, a.Committed());
+
+		a.Allocate(10);
+		const auto small = a.Committed();
+		ASSERT_LT(small, 1024u * 1024u);
+
+		a.Allocate(4 * 1024 * 1024);
+		ASSERT_GE(a.Committed(), 4u * 1024u * 1024u);
+
+		a.Release();
+		ASSERT_EQ(0u, a.Committed());
+	}
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <System/TransformSystem.h>
+#include <System/Jobs.h>
+
+#include <random>
+
+using namespace pn;
+
+namespace SystemUnitTest {
+	transform_t RandomLocal(std::mt19937& rng) {
+		std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> scale_dist(0.5f, 1.5f);
+		transform_t t;
+		t.position = vec3f(dist(rng), dist(rng), dist(rng));
+		t.rotation = EulerToQuaternion(vec3f(dist(rng), dist(rng), dist(rng)));
+		t.scale = vec3f(scale_dist(rng), scale_dist(rng), scale_dist(rng));
+		return t;
+	}
+
+	// Reference: the same chain built out of transform_t parent pointers
+	mat4f ExpectedWorld(const transform_hierarchy_t& h, transform_id_t id) {
+		mat4f m = mat4f::Identity;
+		for (; id != INVALID_TRANSFORM_ID; id = GetParent(h, id)) {
+			m *= TransformToMatrix(GetTransform(h, id));
+		}
+		return m;
+	}
+
+	bool IsClose(const mat4f& m1, const mat4f& m2) {
+		return IsEqual(m1, m2, 1e-3f);
+	}
+
+	void CheckOrder(const transform_hierarchy_t& h) {
+		for (size_t i = 0; i < Size(h); ++i) {
+			ASSERT_TRUE(h.parents[i] == INVALID_TRANSFORM_ID || h.parents[i] < i);
+		}
+	}
+
+	TEST(TransformSystemTest, ChainTest) {
+		transform_hierarchy_t h;
+		transform_t local;
+		local.position = vec3f(1.0f, 0.0f, 0.0f);
+
+		// created leaf first so the storage starts out of order
+		auto c = CreateTransform(h, local);
+		auto b = CreateTransform(h, local);
+		auto a = CreateTransform(h, local);
+		SetParent(h, c, b);
+		SetParent(h, b, a);
+		UpdateTransforms(h);
+		CheckOrder(h);
+
+		ASSERT_TRUE(GetWorldMatrix(h, a) == Translation(1.0f, 0.0f, 0.0f));
+		ASSERT_TRUE(GetWorldMatrix(h, b) == Translation(2.0f, 0.0f, 0.0f));
+		ASSERT_TRUE(GetWorldMatrix(h, c) == Translation(3.0f, 0.0f, 0.0f));
+		ASSERT_EQ(b, GetParent(h, c));
+		ASSERT_EQ(INVALID_TRANSFORM_ID, GetParent(h, a));
+	}
+
+	TEST(TransformSystemTest, RandomTreeTest) {
+		std::mt19937 rng(3);
+		transform_hierarchy_t h;
+		pn::vector<transform_id_t> ids;
+		for (int i = 0; i < 2000; ++i) {
+			auto parent = ids.empty() || rng() % 8 == 0 ? INVALID_TRANSFORM_ID : ids[rng() % ids.size()];
+			PushBack(ids, CreateTransform(h, RandomLocal(rng), parent));
+		}
+		UpdateTransforms(h);
+		CheckOrder(h);
+		for (auto id : ids) {
+			ASSERT_TRUE(IsClose(ExpectedWorld(h, id), GetWorldMatrix(h, id)));
+		}
+
+		// change a few nodes, only they and their subtrees should be rebuilt
+		for (int i = 0; i < 20; ++i) {
+			SetPosition(h, ids[rng() % ids.size()], RandomLocal(rng).position);
+		}
+		UpdateTransforms(h);
+		size_t changed = 0;
+		for (auto id : ids) {
+			ASSERT_TRUE(IsClose(ExpectedWorld(h, id), GetWorldMatrix(h, id)));
+			changed += h.world_changed[h.id_to_index[id]];
+		}
+		ASSERT_GT(changed, 0u);
+		ASSERT_LT(changed, ids.size());
+
+		UpdateTransforms(h);
+		for (auto id : ids) {
+			ASSERT_EQ(0, h.world_changed[h.id_to_index[id]]);
+		}
+	}
+
+	TEST(TransformSystemTest, ReparentTest) {
+		transform_hierarchy_t h;
+		transform_t local;
+		local.position = vec3f(0.0f, 1.0f, 0.0f);
+		auto a = CreateTransform(h, local);
+		auto b = CreateTransform(h, local, a);
+		auto c = CreateTransform(h, local, b);
+		UpdateTransforms(h);
+		ASSERT_TRUE(GetWorldMatrix(h, c) == Translation(0.0f, 3.0f, 0.0f));
+
+		SetParent(h, c, INVALID_TRANSFORM_ID);
+		UpdateTransforms(h);
+		CheckOrder(h);
+		ASSERT_TRUE(GetWorldMatrix(h, c) == Translation(0.0f, 1.0f, 0.0f));
+
+		// cycles are rejected
+		SetParent(h, c, a);
+		SetParent(h, a, c);
+		UpdateTransforms(h);
+		ASSERT_EQ(INVALID_TRANSFORM_ID, GetParent(h, a));
+		ASSERT_TRUE(GetWorldMatrix(h, c) == Translation(0.0f, 2.0f, 0.0f));
+	}
+
+	TEST(TransformSystemTest, DestroyTest) {
+		transform_hierarchy_t h;
+		auto a = CreateTransform(h);
+		auto b = CreateTransform(h, transform_t{}, a);
+		auto c = CreateTransform(h, transform_t{}, b);
+		auto d = CreateTransform(h);
+		UpdateTransforms(h);
+
+		DestroyTransform(h, b);
+		ASSERT_FALSE(IsValid(h, b));
+
+		// descendants go with the next update
+		ASSERT_TRUE(IsValid(h, c));
+		UpdateTransforms(h);
+		ASSERT_EQ(2u, Size(h));
+		ASSERT_TRUE(IsValid(h, a));
+		ASSERT_FALSE(IsValid(h, c));
+		ASSERT_TRUE(IsValid(h, d));
+		CheckOrder(h);
+
+		// released ids get reused
+		auto e = CreateTransform(h, transform_t{}, d);
+		ASSERT_TRUE(e == b || e == c);
+		UpdateTransforms(h);
+		CheckOrder(h);
+		ASSERT_EQ(d, GetParent(h, e));
+
+		// several destroys, one compaction
+		auto f = CreateTransform(h, transform_t{}, a);
+		auto g = CreateTransform(h, transform_t{}, f);
+		DestroyTransform(h, g);
+		DestroyTransform(h, f);
+		DestroyTransform(h, a);
+		ASSERT_EQ(5u, Size(h));
+		UpdateTransforms(h);
+		ASSERT_EQ(2u, Size(h));
+		ASSERT_TRUE(IsValid(h, d));
+		ASSERT_TRUE(IsValid(h, e));
+		CheckOrder(h);
+	}
+
+	TEST(TransformSystemTest, TransformViewTest) {
+		std::mt19937 rng(9);
+		transform_hierarchy_t h;
+		auto root = CreateTransform(h, RandomLocal(rng));
+		auto child = CreateTransform(h, RandomLocal(rng), root);
+		UpdateTransforms(h);
+
+		auto view = GetTransform(h, child);
+		ASSERT_TRUE(IsClose(LocalToWorldMatrix(view), GetWorldMatrix(h, child)));
+
+		TranslateWorld(view, vec3f(0.0f, 0.0f, 1.0f));
+		SetTransform(h, child, view);
+		UpdateTransforms(h);
+		ASSERT_TRUE(IsClose(ExpectedWorld(h, child), GetWorldMatrix(h, child)));
+	}
+
+	TEST(TransformSystemTest, ParallelLevelTest) {
+		jobs::Init(3);
+		std::mt19937 rng(21);
+		transform_hierarchy_t h;
+		auto root = CreateTransform(h, RandomLocal(rng));
+		pn::vector<transform_id_t> leaves;
+		for (size_t i = 0; i < 2 * PARALLEL_LEVEL_SIZE; ++i) {
+			PushBack(leaves, CreateTransform(h, RandomLocal(rng), root));
+		}
+		UpdateTransforms(h);
+		jobs::Shutdown();
+		for (auto id : leaves) {
+			ASSERT_TRUE(IsClose(ExpectedWorld(h, id), GetWorldMatrix(h, id)));
+		}
+	}
+}
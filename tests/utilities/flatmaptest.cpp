@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <Utilities/FlatMap.h>
+#include <Utilities/StringId.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <memory>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	TEST(FlatMapTest, InsertFindErase) {
+		flat_map<int, string> m;
+		EXPECT_TRUE(m.empty());
+		EXPECT_EQ(m.end(), m.find(1));
+		EXPECT_EQ(0u, m.capacity());
+
+		EXPECT_TRUE(m.emplace(1, "one").second);
+		EXPECT_TRUE(m.insert(std::make_pair(2, string("two"))).second);
+		m[3] = "three";
+		EXPECT_FALSE(m.emplace(1, "uno").second);
+		EXPECT_EQ(3u, m.size());
+
+		EXPECT_EQ("one", m.at(1));
+		EXPECT_EQ("three", m.find(3)->second);
+		EXPECT_TRUE(m.contains(2));
+		EXPECT_EQ(1u, m.count(2));
+		EXPECT_THROW(m.at(4), std::out_of_range);
+
+		EXPECT_EQ(1u, m.erase(2));
+		EXPECT_EQ(0u, m.erase(2));
+		EXPECT_FALSE(m.contains(2));
+		EXPECT_EQ(2u, m.size());
+
+		m.insert_or_assign(1, "uno");
+		EXPECT_EQ("uno", m.at(1));
+	}
+
+	// Random inserts and erases, checked against std::unordered_map
+	TEST(FlatMapTest, MatchesUnorderedMap) {
+		flat_map<uint64_t, int> m;
+		std::unordered_map<uint64_t, int> expected;
+		std::mt19937 rng(3);
+		for (int i = 0; i < 20000; ++i) {
+			const uint64_t key = rng() % 2000;
+			if (rng() % 3 == 0) {
+				EXPECT_EQ(expected.erase(key), m.erase(key));
+			}
+			else {
+				m[key] = i;
+				expected[key] = i;
+			}
+		}
+
+		ASSERT_EQ(expected.size(), m.size());
+		for (const auto& entry : expected) {
+			const auto it = m.find(entry.first);
+			ASSERT_NE(m.end(), it);
+			EXPECT_EQ(entry.second, it->second);
+		}
+
+		size_t visited = 0;
+		for (const auto& entry : m) {
+			EXPECT_EQ(expected.at(entry.first), entry.second);
+			++visited;
+		}
+		EXPECT_EQ(expected.size(), visited);
+		EXPECT_LE(m.load_factor(), m.max_load_factor());
+	}
+
+	TEST(FlatMapTest, EraseWhileIterating) {
+		flat_map<int, int> m;
+		for (int i = 0; i < 100; ++i) {
+			m[i] = i;
+		}
+		for (auto it = m.begin(); it != m.end();) {
+			if (it->first % 2 == 0) it = m.erase(it);
+			else ++it;
+		}
+		EXPECT_EQ(50u, m.size());
+		for (const auto& entry : m) {
+			EXPECT_EQ(1, entry.first % 2);
+		}
+	}
+
+	TEST(FlatMapTest, StringLookup) {
+		pn::map<string, int> m;
+		m["mesh"] = 1;
+		m["texture"] = 2;
+
+		// no string is built for these
+		const std::string_view name = "texture_atlas";
+		EXPECT_EQ(2, m.find(name.substr(0, 7))->second);
+		EXPECT_TRUE(m.contains("mesh"));
+		EXPECT_EQ(1, m.at(std::string_view("mesh")));
+		m.at(std::string_view("texture")) = 4;
+		EXPECT_EQ(4, std::as_const(m).at(std::string_view("texture")));
+		EXPECT_EQ(1u, m.erase(std::string_view("mesh")));
+		EXPECT_FALSE(Contains(m, string("mesh")));
+
+		pn::map<string_id_t, int> ids;
+		ids["shader"_id] = 3;
+		EXPECT_EQ(3, ids.at("shader"));
+	}
+
+	TEST(FlatMapTest, ReserveAndRehash) {
+		flat_map<int, int> m;
+		m.reserve(1000);
+		const auto capacity = m.capacity();
+		EXPECT_GE(capacity * 7 / 8, 1000u);
+		for (int i = 0; i < 1000; ++i) {
+			m[i] = i;
+		}
+		EXPECT_EQ(capacity, m.capacity());
+
+		for (int i = 0; i < 990; ++i) {
+			m.erase(i);
+		}
+		m.rehash(0);
+		EXPECT_LT(m.capacity(), capacity);
+		EXPECT_EQ(995, m.at(995));
+
+		m.clear();
+		EXPECT_TRUE(m.empty());
+		EXPECT_EQ(m.begin(), m.end());
+		m.rehash(0);
+		EXPECT_EQ(0u, m.capacity());
+	}
+
+	// Erased slots are reused, so churn at a steady size doesn't grow the table
+	TEST(FlatMapTest, ChurnKeepsCapacity) {
+		flat_map<int, int> m;
+		for (int i = 0; i < 100; ++i) {
+			m[i] = i;
+		}
+		const auto capacity = m.capacity();
+		for (int i = 100; i < 100000; ++i) {
+			m.erase(i - 100);
+			m[i] = i;
+		}
+		EXPECT_EQ(100u, m.size());
+		EXPECT_EQ(capacity, m.capacity());
+	}
+
+	TEST(FlatMapTest, CopyAndMove) {
+		flat_map<string, std::unique_ptr<int>> owners;
+		owners.emplace("a", std::make_unique<int>(1));
+		auto moved = std::move(owners);
+		EXPECT_TRUE(owners.empty());
+		EXPECT_EQ(1, *moved.at("a"));
+
+		flat_map<string, string> m{ { "a", "1" }, { "b", "2" } };
+		auto copy = m;
+		copy["c"] = "3";
+		EXPECT_EQ(2u, m.size());
+		EXPECT_EQ(3u, copy.size());
+		EXPECT_EQ("2", copy.at("b"));
+		copy.erase("c");
+		EXPECT_TRUE(copy == m);
+
+		m = std::move(copy);
+		EXPECT_EQ(2u, m.size());
+		m = flat_map<string, string>();
+		EXPECT_TRUE(m.empty());
+	}
+}
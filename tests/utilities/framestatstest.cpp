@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <IO/FileUtil.h>
+#include <Utilities/FrameStats.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	class FrameStatsTest : public ::testing::Test {
+	protected:
+		void SetUp() override {
+			ResetFrameStats();
+			SetFrameHitchThreshold(DEFAULT_HITCH_THRESHOLD_MS);
+		}
+
+		void TearDown() override {
+			ResetFrameStats();
+		}
+	};
+
+	TEST_F(FrameStatsTest, Percentiles) {
+		EXPECT_EQ(0u, GetFrameTimeStats(frame_phase_t::FRAME).samples);
+
+		// 1 to 100 ms, in no particular order
+		for (int i = 0; i < 100; ++i) {
+			const float ms = static_cast<float>((i * 37) % 100 + 1);
+			AddFramePhaseTime(frame_phase_t::UPDATE, ms / 4);
+			AddFramePhaseTime(frame_phase_t::UPDATE, ms / 4);
+			EndFrameStats(ms);
+		}
+
+		const auto frame = GetFrameTimeStats(frame_phase_t::FRAME);
+		EXPECT_EQ(100u, frame.samples);
+		EXPECT_FLOAT_EQ(1.0f, frame.min_ms);
+		EXPECT_FLOAT_EQ(50.5f, frame.avg_ms);
+		EXPECT_FLOAT_EQ(50.0f, frame.p50_ms);
+		EXPECT_FLOAT_EQ(95.0f, frame.p95_ms);
+		EXPECT_FLOAT_EQ(99.0f, frame.p99_ms);
+		EXPECT_FLOAT_EQ(100.0f, frame.max_ms);
+
+		// phases that run twice a frame add up
+		const auto update = GetFrameTimeStats(frame_phase_t::UPDATE);
+		EXPECT_FLOAT_EQ(50.0f, update.max_ms);
+		EXPECT_FLOAT_EQ(0.0f, GetFrameTimeStats(frame_phase_t::RENDER).max_ms);
+	}
+
+	TEST_F(FrameStatsTest, RollingWindow) {
+		for (size_t i = 0; i < FRAME_STATS_WINDOW; ++i) {
+			EndFrameStats(50.0f);
+		}
+		for (size_t i = 0; i < FRAME_STATS_WINDOW; ++i) {
+			EndFrameStats(10.0f);
+		}
+
+		const auto frame = GetFrameTimeStats(frame_phase_t::FRAME);
+		EXPECT_EQ(FRAME_STATS_WINDOW, frame.samples);
+		EXPECT_FLOAT_EQ(10.0f, frame.max_ms);
+
+		float times[FRAME_STATS_WINDOW + 10];
+		EXPECT_EQ(FRAME_STATS_WINDOW, CopyFrameTimes(frame_phase_t::FRAME, times, FRAME_STATS_WINDOW + 10));
+		EndFrameStats(20.0f);
+		ASSERT_EQ(3u, CopyFrameTimes(frame_phase_t::FRAME, times, 3));
+		EXPECT_FLOAT_EQ(10.0f, times[0]);
+
+		// the long frames left the window, they still count in the totals
+		const auto hitches = GetFrameHitchStats();
+		EXPECT_EQ(2 * FRAME_STATS_WINDOW + 1, hitches.frames);
+		EXPECT_EQ(FRAME_STATS_WINDOW, hitches.hitches);
+		EXPECT_EQ(0u, hitches.window_hitches);
+	}
+
+	TEST_F(FrameStatsTest, Hitches) {
+		SetFrameHitchThreshold(20.0f);
+		for (int i = 0; i < 50; ++i) {
+			EndFrameStats(10.0f);
+		}
+		EndFrameStats(25.0f);	// a hitch and a spike
+		EndFrameStats(19.0f);	// neither
+		EndFrameStats(60.0f);	// both
+
+		const auto hitches = GetFrameHitchStats();
+		EXPECT_EQ(53u, hitches.frames);
+		EXPECT_EQ(2u, hitches.hitches);
+		EXPECT_EQ(2u, hitches.window_hitches);
+		EXPECT_EQ(2u, hitches.spikes);
+		EXPECT_FLOAT_EQ(20.0f, hitches.threshold_ms);
+
+		float buckets[4];
+		FrameTimeHistogram(frame_phase_t::FRAME, buckets, 4, 10.0f);
+		EXPECT_FLOAT_EQ(0.0f, buckets[0]);
+		EXPECT_FLOAT_EQ(51.0f, buckets[1]);
+		EXPECT_FLOAT_EQ(1.0f, buckets[2]);
+		EXPECT_FLOAT_EQ(1.0f, buckets[3]);
+
+		ResetFrameStats();
+		EXPECT_EQ(0u, GetFrameHitchStats().frames);
+		EXPECT_FLOAT_EQ(20.0f, GetFrameHitchStats().threshold_ms);
+	}
+
+	TEST_F(FrameStatsTest, MeasuredFrames) {
+		// starts the clock, or closes a frame left open by another test
+		EndFrameStats();
+		ResetFrameStats();
+		for (int i = 0; i < 3; ++i) {
+			{
+				frame_phase_scope phase(frame_phase_t::RENDER);
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+			EndFrameStats();
+		}
+
+		const auto render = GetFrameTimeStats(frame_phase_t::RENDER);
+		const auto frame = GetFrameTimeStats(frame_phase_t::FRAME);
+		EXPECT_EQ(3u, frame.samples);
+		EXPECT_GE(render.min_ms, 1.9f);
+		EXPECT_GE(frame.min_ms, render.min_ms);
+	}
+
+	TEST_F(FrameStatsTest, Csv) {
+		const auto directory = std::filesystem::temp_directory_path();
+		const auto frames_path = (directory / "pn_frame_stats_test.csv").string();
+		const auto summary_path = (directory / "pn_frame_stats_summary_test.csv").string();
+		std::filesystem::remove(summary_path);
+
+		AddFramePhaseTime(frame_phase_t::PRESENT, 1.5f);
+		EndFrameStats(16.0f);
+		EndFrameStats(17.0f);
+
+		ASSERT_TRUE(WriteFrameStatsCsv(frames_path));
+		const auto frames_data = ReadFile(frames_path);
+		const std::string frames(frames_data.begin(), frames_data.end());
+		EXPECT_EQ("frame,messages_ms,fixed_update_ms,update_ms,cbuffers_ms,render_ms,present_ms,frame_ms\n"
+			"0,0.0000,0.0000,0.0000,0.0000,0.0000,1.5000,16.0000\n"
+			"1,0.0000,0.0000,0.0000,0.0000,0.0000,0.0000,17.0000\n", frames);
+
+		// appended each time, the header only once
+		ASSERT_TRUE(AppendFrameStatsSummaryCsv(summary_path));
+		ASSERT_TRUE(AppendFrameStatsSummaryCsv(summary_path));
+		const auto summary_data = ReadFile(summary_path);
+		const std::string summary(summary_data.begin(), summary_data.end());
+		EXPECT_EQ(0u, summary.find("revision,date,frames,phase,"));
+		EXPECT_EQ(summary.find("revision"), summary.rfind("revision"));
+		EXPECT_EQ(1 + 2 * static_cast<size_t>(frame_phase_t::COUNT), static_cast<size_t>(std::count(summary.begin(), summary.end(), '\n')));
+		EXPECT_NE(std::string::npos, summary.find(",frame,16,16.5,16,17,17,17,0,0\n"));
+
+		std::filesystem::remove(frames_path);
+		std::filesystem::remove(summary_path);
+	}
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <Utilities/Hash.h>
+
+#include <algorithm>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	// reference values from the xxHash project
+	TEST(HashTest, KnownValues) {
+		EXPECT_EQ(0xEF46DB3751D8E999ull, Hash64("", 0));
+		EXPECT_EQ(0xD24EC4F1A98C6E5Bull, Hash64("a", 1));
+		EXPECT_EQ(0x44BC2CF5AD770999ull, Hash64("abc", 3));
+		EXPECT_EQ(0xFBCEA83C8A378BF1ull, Hash64(string("Nobody inspects the spammish repetition")));
+	}
+
+	TEST(HashTest, SeedAndCombine) {
+		const string data = "partition";
+		EXPECT_NE(Hash64(data, 0), Hash64(data, 1));
+		EXPECT_EQ(Hash64(data, 7), Hash64(data.data(), data.size(), 7));
+		EXPECT_NE(HashCombine(HashCombine(0, 1), 2), HashCombine(HashCombine(0, 2), 1));
+	}
+
+	TEST(HashTest, EveryLengthDiffers) {
+		// covers the 32 byte stripes and every tail length
+		bytes data(100);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<char>(i * 31);
+		}
+		pn::vector<uint64_t> hashes;
+		for (size_t n = 0; n <= data.size(); ++n) {
+			PushBack(hashes, Hash64(data.data(), n));
+		}
+		std::sort(hashes.begin(), hashes.end());
+		EXPECT_EQ(hashes.end(), std::adjacent_find(hashes.begin(), hashes.end()));
+	}
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <IO/FileUtil.h>
+#include <Utilities/ProfileCapture.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	class ProfileCaptureTest : public ::testing::Test {
+	protected:
+		std::string path;
+
+		void SetUp() override {
+			path = (std::filesystem::temp_directory_path() / "pn_profile_capture_test.json").string();
+			std::filesystem::remove(path);
+			EndProfileFrame();
+		}
+
+		void TearDown() override {
+			FinishProfileCapture();
+			std::filesystem::remove(path);
+		}
+
+		std::string ReadTrace() {
+			const auto data = ReadFile(path);
+			return std::string(data.begin(), data.end());
+		}
+	};
+
+	TEST_F(ProfileCaptureTest, WritesChromeTrace) {
+		ASSERT_TRUE(StartProfileCapture(2, path));
+		EXPECT_TRUE(IsProfileCaptureRunning());
+		EXPECT_FALSE(StartProfileCapture(2, path));
+
+		// the frame the capture started in isn't part of it
+		{
+			PN_PROFILE_SCOPE("capture_test_before");
+		}
+		EndProfileFrame();
+
+		for (int frame = 0; frame < 2; ++frame) {
+			PN_PROFILE_SCOPE("capture_test_frame");
+			{
+				PN_PROFILE_SCOPE("capture \"quoted\" scope");
+			}
+			ProfileCounter("capture_test_counter", frame + 0.5);
+		}
+		EndProfileFrame();
+		EXPECT_TRUE(IsProfileCaptureRunning());
+		EndProfileFrame();
+		EXPECT_FALSE(IsProfileCaptureRunning());
+
+		const auto trace = ReadTrace();
+		ASSERT_FALSE(trace.empty());
+		EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+		EXPECT_EQ(trace.size() - 3, trace.rfind("]}\n"));
+		EXPECT_EQ(std::string::npos, trace.find(",\n]"));
+
+		EXPECT_EQ(std::string::npos, trace.find("capture_test_before"));
+		EXPECT_NE(std::string::npos, trace.find("{\"name\":\"capture_test_frame\",\"cat\":\"scope\",\"ph\":\"X\""));
+		EXPECT_NE(std::string::npos, trace.find("\"capture \\\"quoted\\\" scope\""));
+		EXPECT_NE(std::string::npos, trace.find("profilecapturetest.cpp"));
+		EXPECT_NE(std::string::npos, trace.find("\"cat\":\"frame\""));
+		EXPECT_NE(std::string::npos, trace.find("\"ph\":\"M\""));
+
+		// counters, the engine's and ours
+		EXPECT_NE(std::string::npos, trace.find("{\"name\":\"capture_test_counter\",\"ph\":\"C\""));
+		EXPECT_NE(std::string::npos, trace.find("\"value\":1.5"));
+		EXPECT_NE(std::string::npos, trace.find("\"Memory (KB)\""));
+		EXPECT_NE(std::string::npos, trace.find("\"general\":"));
+
+		size_t frames = 0;
+		for (size_t at = trace.find("\"cat\":\"frame\""); at != std::string::npos; at = trace.find("\"cat\":\"frame\"", at + 1)) {
+			++frames;
+		}
+		EXPECT_EQ(2u, frames);
+	}
+
+	TEST_F(ProfileCaptureTest, FinishEarly) {
+		EXPECT_FALSE(FinishProfileCapture());
+		EXPECT_FALSE(StartProfileCapture(0, path));
+
+		ASSERT_TRUE(StartProfileCapture(100, path));
+		EndProfileFrame();
+		{
+			PN_PROFILE_SCOPE("capture_test_early");
+		}
+		EndProfileFrame();
+
+		EXPECT_TRUE(FinishProfileCapture());
+		EXPECT_FALSE(IsProfileCaptureRunning());
+		EXPECT_NE(std::string::npos, ReadTrace().find("capture_test_early"));
+
+		// nothing is kept once it's written
+		ProfileCounter("capture_test_counter", 1.0);
+		EXPECT_EQ(std::string::npos, ProfileCaptureJson().find("capture_test"));
+	}
+}
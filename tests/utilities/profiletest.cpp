@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <Utilities/Profile.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	// The first node called name under parent, any thread's root for NO_PROFILE_NODE
+	static const profile_node_t* FindNode(const profile_frame_t& frame, const uint32_t parent, const char* name) {
+		for (const auto& node : frame.nodes) {
+			if (node.location == nullptr || std::strcmp(node.location->name, name) != 0) continue;
+			const bool root_child = frame.nodes[node.parent].parent == NO_PROFILE_NODE;
+			if ((parent == NO_PROFILE_NODE) ? root_child : node.parent == parent) return &node;
+		}
+		return nullptr;
+	}
+
+	static uint32_t IndexOf(const profile_frame_t& frame, const profile_node_t* node) {
+		return static_cast<uint32_t>(node - frame.nodes.data());
+	}
+
+	TEST(ProfileTest, NestedScopes) {
+		EndProfileFrame();
+		{
+			PN_PROFILE_SCOPE("profile_test_outer");
+			for (int i = 0; i < 3; ++i) {
+				PN_PROFILE_SCOPE("profile_test_inner");
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			{
+				PN_PROFILE_SCOPE("profile_test_leaf");
+			}
+		}
+		EndProfileFrame();
+
+		const auto& frame = GetProfileFrame();
+		EXPECT_EQ(0u, frame.dropped_events);
+		EXPECT_EQ(5u, frame.event_count);
+
+		const auto* outer = FindNode(frame, NO_PROFILE_NODE, "profile_test_outer");
+		ASSERT_NE(nullptr, outer);
+		EXPECT_EQ(1u, outer->calls);
+		EXPECT_NE(nullptr, std::strstr(outer->location->file, "profiletest.cpp"));
+
+		const auto* inner = FindNode(frame, IndexOf(frame, outer), "profile_test_inner");
+		const auto* leaf = FindNode(frame, IndexOf(frame, outer), "profile_test_leaf");
+		ASSERT_NE(nullptr, inner);
+		ASSERT_NE(nullptr, leaf);
+		EXPECT_EQ(3u, inner->calls);
+		EXPECT_EQ(1u, leaf->calls);
+
+		// in the order they first ran
+		EXPECT_EQ(IndexOf(frame, inner), outer->first_child);
+		EXPECT_EQ(IndexOf(frame, leaf), inner->next_sibling);
+
+		EXPECT_GE(inner->total_ns, 3000000u);
+		EXPECT_GE(outer->total_ns, inner->total_ns + leaf->total_ns);
+		EXPECT_EQ(outer->total_ns - inner->total_ns - leaf->total_ns, outer->self_ns);
+		EXPECT_EQ(inner->total_ns, inner->self_ns);
+
+		// the frame is replaced by the next one
+		EndProfileFrame();
+		EXPECT_EQ(nullptr, FindNode(GetProfileFrame(), NO_PROFILE_NODE, "profile_test_outer"));
+	}
+
+	TEST(ProfileTest, Threads) {
+		EndProfileFrame();
+		// all alive at once, an exited thread's ring goes to the next one started
+		std::atomic<int> running{ 0 };
+		std::thread threads[4];
+		for (int i = 0; i < 4; ++i) {
+			threads[i] = std::thread([i, &running] {
+				SetProfileThreadName(("profile test " + std::to_string(i)).c_str());
+				for (int j = 0; j <= i; ++j) {
+					PN_PROFILE_SCOPE("profile_test_thread");
+				}
+				running.fetch_add(1);
+				while (running.load() < 4) std::this_thread::yield();
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		EndProfileFrame();
+
+		const auto& frame = GetProfileFrame();
+		uint32_t calls = 0;
+		uint32_t named = 0;
+		for (const auto& node : frame.nodes) {
+			if (node.location == nullptr || std::strcmp(node.location->name, "profile_test_thread") != 0) continue;
+			calls += node.calls;
+			const char* name = ProfileThreadName(node.thread);
+			if (std::strncmp(name, "profile test ", 13) == 0) {
+				EXPECT_EQ(static_cast<uint32_t>(name[13] - '0') + 1, node.calls);
+				++named;
+			}
+		}
+		EXPECT_EQ(1u + 2u + 3u + 4u, calls);
+		EXPECT_EQ(4u, named);
+	}
+
+	// A scope that's still open when the frame ends is counted in the frame it closes in, its
+	// children that closed before then under the thread's root
+	TEST(ProfileTest, ScopeAcrossFrames) {
+		EndProfileFrame();
+		{
+			PN_PROFILE_SCOPE("profile_test_long");
+			{
+				PN_PROFILE_SCOPE("profile_test_short");
+			}
+			EndProfileFrame();
+			EXPECT_EQ(nullptr, FindNode(GetProfileFrame(), NO_PROFILE_NODE, "profile_test_long"));
+			EXPECT_NE(nullptr, FindNode(GetProfileFrame(), NO_PROFILE_NODE, "profile_test_short"));
+			{
+				PN_PROFILE_SCOPE("profile_test_short");
+			}
+		}
+		EndProfileFrame();
+
+		const auto& frame = GetProfileFrame();
+		const auto* long_scope = FindNode(frame, NO_PROFILE_NODE, "profile_test_long");
+		ASSERT_NE(nullptr, long_scope);
+		EXPECT_NE(nullptr, FindNode(frame, IndexOf(frame, long_scope), "profile_test_short"));
+	}
+
+	TEST(ProfileTest, DisabledAndDropped) {
+		EndProfileFrame();
+		SetProfilerEnabled(false);
+		{
+			PN_PROFILE_SCOPE("profile_test_disabled");
+			SetProfilerEnabled(true);
+		}
+		EndProfileFrame();
+		EXPECT_EQ(nullptr, FindNode(GetProfileFrame(), NO_PROFILE_NODE, "profile_test_disabled"));
+
+		for (size_t i = 0; i < PROFILE_RING_SIZE + 100; ++i) {
+			PN_PROFILE_SCOPE("profile_test_full");
+		}
+		EndProfileFrame();
+		const auto& frame = GetProfileFrame();
+		EXPECT_EQ(100u, frame.dropped_events);
+		EXPECT_EQ(PROFILE_RING_SIZE, FindNode(frame, NO_PROFILE_NODE, "profile_test_full")->calls);
+	}
+
+	TEST(ProfileTest, ClockCalibration) {
+		const uint64_t begin = ProfileTimestamp();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const double ms = ProfileTicksToMilliseconds(ProfileTimestamp() - begin);
+		EXPECT_GE(ms, 19.0);
+		EXPECT_LT(ms, 1000.0);
+	}
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <Utilities/SlotMap.h>
+
+#include <algorithm>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	TEST(SlotMapTest, InsertGetRemove) {
+		slot_map_t<string> m;
+		const auto a = Insert(m, string("a"));
+		const auto b = Insert(m, string("b"));
+		const auto c = Insert(m, string("c"));
+
+		EXPECT_NE(NULL_SLOT_HANDLE, a);
+		EXPECT_FALSE(IsValid(m, NULL_SLOT_HANDLE));
+		EXPECT_EQ(3u, Size(m));
+		EXPECT_EQ("b", Get(m, b));
+
+		// removing from the middle moves the last value into the hole
+		EXPECT_TRUE(Remove(m, b));
+		EXPECT_FALSE(IsValid(m, b));
+		EXPECT_EQ(nullptr, Find(m, b));
+		EXPECT_EQ(2u, Size(m));
+		EXPECT_EQ("a", Get(m, a));
+		EXPECT_EQ("c", Get(m, c));
+		EXPECT_FALSE(Remove(m, b));
+	}
+
+	TEST(SlotMapTest, StaleHandleAfterReuse) {
+		slot_map_t<int> m;
+		const auto first = Insert(m, 1);
+		Remove(m, first);
+		const auto second = Insert(m, 2);
+
+		// same slot, different generation
+		EXPECT_EQ(SlotIndex(first), SlotIndex(second));
+		EXPECT_NE(first, second);
+		EXPECT_FALSE(IsValid(m, first));
+		EXPECT_EQ(nullptr, Find(m, first));
+		EXPECT_EQ(2, *Find(m, second));
+	}
+
+	TEST(SlotMapTest, GenerationWrap) {
+		slot_map_t<int> m;
+		const auto first = Insert(m, 1);
+		m.generations[SlotIndex(first)] = UINT32_MAX;
+		const auto last = MakeSlotHandle(SlotIndex(first), UINT32_MAX);
+		ASSERT_TRUE(IsValid(m, last));
+
+		Remove(m, last);
+		const auto wrapped = Insert(m, 2);
+		EXPECT_NE(NULL_SLOT_HANDLE, wrapped);
+		EXPECT_EQ(1u, SlotGeneration(wrapped));
+		EXPECT_FALSE(IsValid(m, last));
+	}
+
+	TEST(SlotMapTest, HandlesSurviveChurn) {
+		slot_map_t<int> m;
+		pn::vector<slot_handle_t> live;
+		pn::vector<slot_handle_t> dead;
+		for (int i = 0; i < 1000; ++i) {
+			PushBack(live, Insert(m, i));
+			if (i % 3 == 0) {
+				const auto victim = live[(i * 7) % Size(live)];
+				Remove(m, victim);
+				pn::Erase(live, victim);
+				PushBack(dead, victim);
+			}
+		}
+
+		EXPECT_EQ(Size(live), Size(m));
+		for (const auto handle : live) {
+			ASSERT_TRUE(IsValid(m, handle));
+			EXPECT_EQ(handle, HandleAt(m, m.slot_values[SlotIndex(handle)]));
+		}
+		for (const auto handle : dead) {
+			EXPECT_FALSE(IsValid(m, handle));
+		}
+
+		Clear(m);
+		EXPECT_EQ(0u, Size(m));
+		EXPECT_TRUE(std::none_of(live.begin(), live.end(), [&m](const slot_handle_t h) { return IsValid(m, h); }));
+	}
+}
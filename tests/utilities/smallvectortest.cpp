@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <Utilities/SmallVector.h>
+#include <Utilities/UtilityTypes.h>
+
+#include <memory>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	TEST(SmallVectorTest, StaysInline) {
+		small_vector<int, 4> v;
+		EXPECT_TRUE(v.IsInline());
+		PushBack(v, 1, 2, 3, 4);
+		EXPECT_TRUE(v.IsInline());
+		EXPECT_EQ(4u, Size(v));
+		EXPECT_EQ(4u, v.capacity());
+		EXPECT_EQ(4, Pop(v));
+		EXPECT_EQ(3, v.back());
+	}
+
+	TEST(SmallVectorTest, ResizeStaysInline) {
+		small_vector<int, 4> v;
+		for (size_t k = 1; k <= 4; ++k) {
+			Resize(v, k);
+			EXPECT_TRUE(v.IsInline());
+			EXPECT_EQ(4u, v.capacity());
+		}
+		EXPECT_EQ(0, v[3]);
+		EXPECT_TRUE((small_vector<int, 4>(3).IsInline()));
+
+		Resize(v, 5);
+		EXPECT_FALSE(v.IsInline());
+		EXPECT_EQ(5u, Size(v));
+	}
+
+	TEST(SmallVectorTest, SpillsToHeap) {
+		small_vector<string, 2> v;
+		for (int i = 0; i < 100; ++i) {
+			EmplaceBack(v, "element " + std::to_string(i));
+		}
+		EXPECT_FALSE(v.IsInline());
+		EXPECT_EQ(100u, Size(v));
+		EXPECT_EQ("element 0", v.front());
+		EXPECT_EQ("element 99", v[99]);
+
+		// growing from an element of the vector itself
+		small_vector<string, 1> w{ "self" };
+		w.push_back(w[0]);
+		EXPECT_EQ("self", w[1]);
+	}
+
+	TEST(SmallVectorTest, CopyMoveAndErase) {
+		small_vector<std::unique_ptr<int>, 2> owners;
+		owners.emplace_back(std::make_unique<int>(1));
+		auto inline_moved = std::move(owners);
+		EXPECT_TRUE(owners.empty());
+		EXPECT_EQ(1, *inline_moved[0]);
+
+		// heap storage changes hands
+		for (int i = 2; i <= 4; ++i) {
+			inline_moved.emplace_back(std::make_unique<int>(i));
+		}
+		const auto* memory = inline_moved.data();
+		auto heap_moved = std::move(inline_moved);
+		EXPECT_EQ(memory, heap_moved.data());
+		EXPECT_TRUE(inline_moved.IsInline());
+
+		small_vector<int, 3> v{ 1, 2, 3, 4, 5 };
+		auto copy = v;
+		EXPECT_TRUE(copy == v);
+		Erase(copy, 3);
+		copy.erase(copy.begin());
+		copy.insert(copy.begin() + 1, 7);
+		EXPECT_TRUE((copy == small_vector<int, 3>{ 2, 7, 4, 5 }));
+
+		Resize(copy, 2);
+		EXPECT_EQ(2u, Size(copy));
+		copy.resize(4, 9);
+		EXPECT_EQ(9, copy[3]);
+	}
+
+	TEST(SmallVectorTest, FixedVector) {
+		fixed_vector<int, 3> v;
+		PushBack(v, 1, 2, 3);
+		EXPECT_TRUE(v.full());
+		EXPECT_EQ(3u, Size(v));
+		EXPECT_EQ(2, Get(v, 1));
+
+		v.erase(v.begin());
+		EXPECT_EQ(2, v.front());
+		EXPECT_EQ(3, Pop(v));
+
+		auto copy = v;
+		EXPECT_TRUE(copy == v);
+		copy.clear();
+		EXPECT_TRUE(copy.empty());
+	}
+
+#if defined(PN_CONTAINER_STATS)
+	TEST(SmallVectorTest, SpillCounter) {
+		ResetSmallVectorStats();
+		{
+			small_vector<int, 2> fits{ 1, 2 };
+			small_vector<int, 2> spills{ 1, 2, 3 };
+			small_vector<int, 2> unused;
+		}
+		const auto stats = GetSmallVectorStats();
+		EXPECT_EQ(2u, stats.small_vectors);
+		EXPECT_EQ(1u, stats.small_vector_spills);
+	}
+#endif
+
+	TEST(SmallVectorTest, Split) {
+		const auto pieces = Split("mesh.fbx", '.');
+		ASSERT_EQ(2u, Size(pieces));
+		EXPECT_EQ("mesh", pieces[0]);
+		EXPECT_EQ("fbx", pieces[1]);
+		EXPECT_TRUE(pieces.IsInline());
+
+		// same pieces as reading with getline
+		const auto empty = Split("a,,b,", ',');
+		ASSERT_EQ(3u, Size(empty));
+		EXPECT_EQ("", empty[1]);
+		EXPECT_EQ("b", empty[2]);
+		EXPECT_TRUE(Split("", ',').empty());
+	}
+}
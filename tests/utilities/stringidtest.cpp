@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <Utilities/StringId.h>
+
+using namespace pn;
+
+namespace UtilitiesUnitTest {
+	// reference values of 64-bit FNV-1a
+	TEST(StringIdTest, KnownValues) {
+		EXPECT_EQ(0xCBF29CE484222325ull, HashStringId(""));
+		EXPECT_EQ(0xAF63DC4C8601EC8Cull, HashStringId("a"));
+		EXPECT_EQ(0x85944171F73967E8ull, HashStringId("foobar"));
+	}
+
+	TEST(StringIdTest, CompileTime) {
+		constexpr string_id_t literal = "POSITION"_id;
+		static_assert(literal == string_id_t("POSITION"), "literal and pointer hashes differ");
+		static_assert(literal.Hash() == HashStringId("POSITION", 8), "lengths differ");
+		static_assert("a"_id != "b"_id, "");
+
+		switch (HashStringId(string("NORMAL").c_str())) {
+		case "POSITION"_id.Hash():	FAIL();	break;
+		case "NORMAL"_id.Hash():	SUCCEED(); break;
+		default:					FAIL();
+		}
+	}
+
+	TEST(StringIdTest, RuntimeMatchesLiteral) {
+		const string name = "global_constants";
+		EXPECT_EQ("global_constants"_id, string_id_t(name));
+		EXPECT_EQ(string_id_t(name.c_str()), string_id_t(name));
+		EXPECT_NE(string_id_t(name), string_id_t("global_constants2"));
+		EXPECT_TRUE(string_id_t().IsNull());
+		EXPECT_FALSE(string_id_t("").IsNull());
+	}
+
+	TEST(StringIdTest, Intern) {
+		const auto before = InternedStringCount();
+		const auto id = InternString("string_id_test_name");
+		EXPECT_EQ("string_id_test_name"_id, id);
+		EXPECT_EQ(before + 1, InternedStringCount());
+
+		// interning again changes nothing
+		EXPECT_EQ(id, InternString("string_id_test_name"));
+		EXPECT_EQ(before + 1, InternedStringCount());
+
+		EXPECT_EQ("string_id_test_name", StringIdName(id));
+		EXPECT_EQ("#00000000000000ff", StringIdName(string_id_t(uint64_t(0xFF))));
+	}
+
+	TEST(StringIdTest, HashMap) {
+		map<string_id_t, int> slots;
+		slots["albedo"_id] = 1;
+		slots[string_id_t(string("normal"))] = 2;
+		EXPECT_EQ(1, slots.at(string_id_t("albedo")));
+		EXPECT_EQ(2, slots.at("normal"_id));
+		EXPECT_FALSE(Contains(slots, "specular"_id));
+	}
+}
@@ -0,0 +1,80 @@
+// Cooks mesh files into the binary format LoadMesh maps at runtime.
+//
+//   MeshCook [--no-triangulate] [--right-handed] <mesh file or directory>...
+//
+// Every input is written next to itself with the .pnmesh extension. Directories are cooked
+// recursively, every .fbx inside them is picked up.
+
+#include <Graphics/MeshCook.h>
+
+#include <System/Jobs.h>
+
+#include <Utilities/Logging.h>
+
+#include <filesystem>
+#include <iostream>
+
+using namespace pn;
+
+namespace {
+
+void PrintUsage() {
+	std::cout << "usage: MeshCook [--no-triangulate] [--right-handed] <mesh file or directory>...\n";
+}
+
+bool CookOne(const string& source_path, const MeshLoadData& mesh_load_data) {
+	const auto cooked_path = CookedMeshPath(source_path);
+	if (!CookMeshFile(source_path, cooked_path, mesh_load_data)) {
+		std::cout << "FAILED  " << source_path << '\n';
+		return false;
+	}
+	std::cout << "cooked  " << source_path << " -> " << cooked_path << '\n';
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	MeshLoadData mesh_load_data = DEFAULT_MESH_LOAD_DATA;
+	pn::vector<string> inputs;
+	for (int i = 1; i < argc; ++i) {
+		const string arg = argv[i];
+		if (arg == "--no-triangulate") {
+			mesh_load_data.triangulate = false;
+		} else if (arg == "--right-handed") {
+			mesh_load_data.convert_left = false;
+		} else if (arg == "--help" || arg == "-h") {
+			PrintUsage();
+			return 0;
+		} else {
+			PushBack(inputs, arg);
+		}
+	}
+
+	if (inputs.empty()) {
+		PrintUsage();
+		return 1;
+	}
+
+	InitLogger();
+	jobs::Init();
+
+	int failures = 0;
+	for (const auto& input : inputs) {
+		std::error_code error;
+		if (!std::filesystem::is_directory(input, error)) {
+			failures += CookOne(input, mesh_load_data) ? 0 : 1;
+			continue;
+		}
+
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".fbx") {
+				failures += CookOne(entry.path().string(), mesh_load_data) ? 0 : 1;
+			}
+		}
+	}
+
+	jobs::Shutdown();
+	CloseLogger();
+	return (failures == 0) ? 0 : 1;
+}